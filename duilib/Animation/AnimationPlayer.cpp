@@ -43,7 +43,6 @@ void AnimationPlayerBase::InitBaseData()
     m_currentValue = 0;
     m_totalMillSeconds = AP_NO_VALUE;
     m_palyedMillSeconds = 0;
-    m_elapseMillSeconds = 0;
     m_reverseStart = false;
     m_bPlaying = false;
     m_startTime = std::chrono::steady_clock::now();
@@ -104,15 +103,14 @@ void AnimationPlayerBase::StartTimer()
         return;
     }
 
-    m_elapseMillSeconds = m_totalMillSeconds / std::abs(m_endValue - m_startValue);
-    if (m_elapseMillSeconds == 0) {
-        m_elapseMillSeconds = 1;
-    }
-
     Play();
+    if (!m_bPlaying || m_weakFlagOwner.HasUsed()) {
+        //已经播放完成，或者已经添加了帧回调
+        return;
+    }
+    //由帧时钟驱动，每帧根据已播放的时间计算当前值
     auto playCallback = UiBind(&AnimationPlayerBase::Play, this);
-    ASSERT(m_elapseMillSeconds <= INT32_MAX);
-    GlobalManager::Instance().Timer().AddTimer(m_weakFlagOwner.GetWeakFlag(), playCallback, (uint32_t)m_elapseMillSeconds);
+    GlobalManager::Instance().Clock().AddFrameCallback(m_weakFlagOwner.GetWeakFlag(), playCallback);
 }
 
 void AnimationPlayerBase::Play()
@@ -99,7 +99,7 @@ public:
     */
     virtual void ReverseContinue();
 
-    /** 启动动画定时器
+    /** 启动动画定时器（由帧时钟驱动）
     */
     virtual void StartTimer();
 
@@ -108,7 +108,7 @@ public:
     virtual int64_t GetCurrentValue() const = 0;
 
 private:
-    /** 播放一次动画（在定时器中触发调用）
+    /** 播放一次动画（在帧时钟中触发调用）
     */
     void Play();
 
@@ -149,10 +149,6 @@ protected:
     */
     int64_t m_palyedMillSeconds;
 
-    /** 动画播放的时间间隔，即定时器的触发时间间隔（毫秒）
-    */
-    int64_t m_elapseMillSeconds;
-
     /** 是否第一次播放
     */
     bool m_bFirstRun;
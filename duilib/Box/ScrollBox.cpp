@@ -4,6 +4,7 @@
 #include "duilib/Core/Window.h"
 #include "duilib/Core/Keyboard.h"
 #include "duilib/Core/GlobalManager.h"
+#include "duilib/Core/PaintItemIndex.h"
 #include "duilib/Utils/AttributeUtil.h"
 #include "duilib/Utils/StringUtil.h"
 
@@ -357,19 +358,8 @@ void ScrollBox::PaintChild(IRender* pRender, const UiRect& rcPaint)
         return;
     }
 
-    std::vector<Control*> delayItems;
-    for (Control* pControl : m_items) {
-        if (pControl == nullptr) {
-            continue;
-        }
-        if (!pControl->IsVisible()) {
-            continue;
-        }
-        if (pControl->GetPaintOrder() != 0) {
-            //设置了绘制顺序， 放入延迟绘制列表
-            delayItems.push_back(pControl);
-            continue;
-        }
+    //子控件的绘制区域、剪辑区域和窗口原点，对所有子控件都相同，在循环外设置
+    {
         UiSize scrollPos = GetScrollOffset();
         UiRect rcNewPaint = GetPosWithoutPadding();
         AutoClip alphaClip(pRender, rcNewPaint, IsClip());
@@ -378,30 +368,57 @@ void ScrollBox::PaintChild(IRender* pRender, const UiRect& rcPaint)
 
         UiPoint ptOffset(scrollPos.cx, scrollPos.cy);
         UiPoint ptOldOrg = pRender->OffsetWindowOrg(ptOffset);
-        pControl->AlphaPaint(pRender, rcNewPaint);
-        pRender->SetWindowOrg(ptOldOrg);
-    }
 
-    if (!delayItems.empty()) {
-        std::sort(delayItems.begin(), delayItems.end(), [](const Control* a, const Control* b) {
-            return a->GetPaintOrder() < b->GetPaintOrder();
-            });
-        //绘制延迟绘制的控件
-        for (auto pControl : delayItems) {
-            if (pControl == nullptr) {
-                continue;
+        const PaintItemIndex* pPaintItemIndex = GetPaintItemIndex();
+        if (pPaintItemIndex != nullptr) {
+            //只绘制与可见区域相交的子控件
+            size_t nBegin = 0;
+            size_t nEnd = 0;
+            pPaintItemIndex->GetVisibleRange(rcNewPaint, nBegin, nEnd);
+            const std::vector<Control*>& orderedItems = pPaintItemIndex->GetOrderedItems();
+            for (size_t nIndex = nBegin; nIndex < nEnd; ++nIndex) {
+                orderedItems[nIndex]->AlphaPaint(pRender, rcNewPaint);
+            }
+            for (Control* pControl : pPaintItemIndex->GetTailItems()) {
+                if (pControl->IsVisible()) {
+                    pControl->AlphaPaint(pRender, rcNewPaint);
+                }
+            }
+            //绘制延迟绘制的控件
+            for (Control* pControl : pPaintItemIndex->GetDelayItems()) {
+                pControl->AlphaPaint(pRender, rcNewPaint);
+            }
+        }
+        else {
+            std::vector<Control*> delayItems;
+            for (Control* pControl : m_items) {
+                if (pControl == nullptr) {
+                    continue;
+                }
+                if (!pControl->IsVisible()) {
+                    continue;
+                }
+                if (pControl->GetPaintOrder() != 0) {
+                    //设置了绘制顺序， 放入延迟绘制列表
+                    delayItems.push_back(pControl);
+                    continue;
+                }
+                pControl->AlphaPaint(pRender, rcNewPaint);
+            }
+
+            if (!delayItems.empty()) {
+                std::sort(delayItems.begin(), delayItems.end(), [](const Control* a, const Control* b) {
+                    return a->GetPaintOrder() < b->GetPaintOrder();
+                    });
+                //绘制延迟绘制的控件
+                for (auto pControl : delayItems) {
+                    if (pControl != nullptr) {
+                        pControl->AlphaPaint(pRender, rcNewPaint);
+                    }
+                }
             }
-            UiSize scrollPos = GetScrollOffset();
-            UiRect rcNewPaint = GetPosWithoutPadding();
-            AutoClip alphaClip(pRender, rcNewPaint, IsClip());
-            rcNewPaint.Offset(scrollPos.cx, scrollPos.cy);
-            rcNewPaint.Offset(GetRenderOffset().x, GetRenderOffset().y);
-
-            UiPoint ptOffset(scrollPos.cx, scrollPos.cy);
-            UiPoint ptOldOrg = pRender->OffsetWindowOrg(ptOffset);
-            pControl->AlphaPaint(pRender, rcNewPaint);
-            pRender->SetWindowOrg(ptOldOrg);
         }
+        pRender->SetWindowOrg(ptOldOrg);
     }
 
     if( (m_pHScrollBar != nullptr) && m_pHScrollBar->IsVisible()) {
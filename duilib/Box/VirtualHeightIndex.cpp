@@ -0,0 +1,241 @@
+#include "VirtualHeightIndex.h"
+#include <algorithm>
+
+namespace ui
+{
+
+VirtualHeightIndex::VirtualHeightIndex():
+    m_nTotalHeight(0),
+    m_nMinHeight(INT32_MAX)
+{
+}
+
+void VirtualHeightIndex::Clear()
+{
+    m_heights.clear();
+    m_measured.clear();
+    m_tree.clear();
+    m_nTotalHeight = 0;
+    m_nMinHeight = INT32_MAX;
+}
+
+size_t VirtualHeightIndex::GetCount() const
+{
+    return m_heights.size();
+}
+
+void VirtualHeightIndex::Resize(size_t nCount, int32_t nDefaultHeight)
+{
+    size_t nOldCount = m_heights.size();
+    if (nCount == nOldCount) {
+        return;
+    }
+    if (nCount == 0) {
+        Clear();
+        return;
+    }
+    nDefaultHeight = std::max(nDefaultHeight, 0);
+    if (nCount < nOldCount) {
+        //从尾部删除：树状数组中，每个节点只覆盖其下标之前的数据，所以直接截断即可
+        for (size_t nIndex = nCount; nIndex < nOldCount; ++nIndex) {
+            m_nTotalHeight -= m_heights[nIndex];
+        }
+        m_heights.resize(nCount);
+        m_measured.resize(nCount);
+        m_tree.resize(nCount + 1);
+        return;
+    }
+
+    //在尾部追加：第i个节点覆盖的范围是(i - lowbit(i), i]
+    m_heights.resize(nCount, nDefaultHeight);
+    m_measured.resize(nCount, false);
+    m_tree.resize(nCount + 1, 0);
+    for (size_t i = nOldCount + 1; i <= nCount; ++i) {
+        size_t nLowBit = i & (~i + 1);
+        int64_t nValue = nDefaultHeight;
+        //累加(i - lowbit(i), i - 1]范围内的子节点
+        for (size_t j = i - 1; j > i - nLowBit; j -= (j & (~j + 1))) {
+            nValue += m_tree[j];
+        }
+        m_tree[i] = nValue;
+    }
+    m_nTotalHeight += (int64_t)nDefaultHeight * (int64_t)(nCount - nOldCount);
+    m_nMinHeight = std::min(m_nMinHeight, nDefaultHeight);
+}
+
+void VirtualHeightIndex::Insert(size_t nIndex, size_t nCount, int32_t nDefaultHeight)
+{
+    ASSERT(nIndex <= m_heights.size());
+    if ((nCount == 0) || (nIndex > m_heights.size())) {
+        return;
+    }
+    if (nIndex == m_heights.size()) {
+        //在尾部追加
+        Resize(m_heights.size() + nCount, nDefaultHeight);
+        return;
+    }
+    nDefaultHeight = std::max(nDefaultHeight, 0);
+    m_heights.insert(m_heights.begin() + nIndex, nCount, nDefaultHeight);
+    m_measured.insert(m_measured.begin() + nIndex, nCount, false);
+    m_nMinHeight = std::min(m_nMinHeight, nDefaultHeight);
+    RebuildTree();
+}
+
+void VirtualHeightIndex::Erase(size_t nIndex, size_t nCount)
+{
+    ASSERT(nIndex < m_heights.size());
+    if ((nCount == 0) || (nIndex >= m_heights.size())) {
+        return;
+    }
+    nCount = std::min(nCount, m_heights.size() - nIndex);
+    if ((nIndex + nCount) == m_heights.size()) {
+        //从尾部删除
+        Resize(nIndex, 0);
+        return;
+    }
+    m_heights.erase(m_heights.begin() + nIndex, m_heights.begin() + nIndex + nCount);
+    m_measured.erase(m_measured.begin() + nIndex, m_measured.begin() + nIndex + nCount);
+    RebuildTree();
+}
+
+void VirtualHeightIndex::Assign(const std::vector<int32_t>& heights)
+{
+    Clear();
+    const size_t nCount = heights.size();
+    if (nCount == 0) {
+        return;
+    }
+    m_heights.resize(nCount, 0);
+    m_measured.resize(nCount, true);
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        int32_t nHeight = std::max(heights[nIndex], 0);
+        m_heights[nIndex] = nHeight;
+        m_nMinHeight = std::min(m_nMinHeight, nHeight);
+    }
+    RebuildTree();
+}
+
+int32_t VirtualHeightIndex::GetHeight(size_t nIndex) const
+{
+    ASSERT(nIndex < m_heights.size());
+    if (nIndex < m_heights.size()) {
+        return m_heights[nIndex];
+    }
+    return 0;
+}
+
+bool VirtualHeightIndex::SetHeight(size_t nIndex, int32_t nHeight)
+{
+    ASSERT(nIndex < m_heights.size());
+    if (nIndex >= m_heights.size()) {
+        return false;
+    }
+    nHeight = std::max(nHeight, 0);
+    int32_t nOldHeight = m_heights[nIndex];
+    if (nOldHeight == nHeight) {
+        return false;
+    }
+    m_heights[nIndex] = nHeight;
+    AddDelta(nIndex, (int64_t)nHeight - nOldHeight);
+    m_nTotalHeight += (int64_t)nHeight - nOldHeight;
+    m_nMinHeight = std::min(m_nMinHeight, nHeight);
+    return true;
+}
+
+bool VirtualHeightIndex::IsMeasured(size_t nIndex) const
+{
+    if (nIndex < m_measured.size()) {
+        return m_measured[nIndex];
+    }
+    return false;
+}
+
+void VirtualHeightIndex::SetMeasured(size_t nIndex, bool bMeasured)
+{
+    ASSERT(nIndex < m_measured.size());
+    if (nIndex < m_measured.size()) {
+        m_measured[nIndex] = bMeasured;
+    }
+}
+
+void VirtualHeightIndex::RebuildTree()
+{
+    const size_t nCount = m_heights.size();
+    m_tree.assign(nCount + 1, 0);
+    m_nTotalHeight = 0;
+    for (size_t i = 1; i <= nCount; ++i) {
+        int32_t nHeight = m_heights[i - 1];
+        m_nTotalHeight += nHeight;
+        //节点i的值加到其父节点上，父节点覆盖的范围包含节点i
+        m_tree[i] += nHeight;
+        size_t nParent = i + (i & (~i + 1));
+        if (nParent <= nCount) {
+            m_tree[nParent] += m_tree[i];
+        }
+    }
+}
+
+void VirtualHeightIndex::AddDelta(size_t nIndex, int64_t nDelta)
+{
+    const size_t nCount = m_heights.size();
+    for (size_t i = nIndex + 1; i <= nCount; i += (i & (~i + 1))) {
+        m_tree[i] += nDelta;
+    }
+}
+
+int64_t VirtualHeightIndex::GetPrefixHeight(size_t nCount) const
+{
+    if (nCount >= m_heights.size()) {
+        return m_nTotalHeight;
+    }
+    int64_t nHeight = 0;
+    for (size_t i = nCount; i > 0; i -= (i & (~i + 1))) {
+        nHeight += m_tree[i];
+    }
+    return nHeight;
+}
+
+int64_t VirtualHeightIndex::GetTotalHeight() const
+{
+    return m_nTotalHeight;
+}
+
+int32_t VirtualHeightIndex::GetMinHeight() const
+{
+    if (m_heights.empty()) {
+        return 0;
+    }
+    return m_nMinHeight;
+}
+
+size_t VirtualHeightIndex::FindIndexByOffset(int64_t nOffset, int32_t nSpacing) const
+{
+    const size_t nCount = m_heights.size();
+    if ((nCount == 0) || (nOffset < 0)) {
+        return 0;
+    }
+    size_t nStep = 1;
+    while ((nStep << 1) <= nCount) {
+        nStep <<= 1;
+    }
+    //二分查找：找到满足前pos个数据项的总高度(含间隔) <= nOffset 的最大pos
+    size_t nPos = 0;
+    int64_t nRemain = nOffset;
+    for (; nStep > 0; nStep >>= 1) {
+        size_t nNext = nPos + nStep;
+        if (nNext <= nCount) {
+            //节点nNext覆盖的范围是(nPos, nNext]，共nStep个数据项
+            int64_t nValue = m_tree[nNext] + (int64_t)nSpacing * (int64_t)nStep;
+            if (nValue <= nRemain) {
+                nPos = nNext;
+                nRemain -= nValue;
+            }
+        }
+    }
+    if (nPos >= nCount) {
+        nPos = nCount - 1;
+    }
+    return nPos;
+}
+
+} // namespace ui
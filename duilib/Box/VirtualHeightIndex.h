@@ -0,0 +1,127 @@
+#ifndef UI_BOX_VIRTUAL_HEIGHT_INDEX_H_
+#define UI_BOX_VIRTUAL_HEIGHT_INDEX_H_
+
+#include "duilib/duilib_defs.h"
+#include <vector>
+#include <cstdint>
+
+namespace ui
+{
+/** 虚表数据项高度的索引（树状数组实现，用于可变高度的虚表布局）
+*   支持以O(log n)的复杂度更新单个数据项的高度、查询前n个数据项的高度总和、根据偏移量查找数据项的索引号
+*/
+class UILIB_API VirtualHeightIndex
+{
+public:
+    VirtualHeightIndex();
+
+    /** 清空所有数据
+    */
+    void Clear();
+
+    /** 获取数据项的个数
+    */
+    size_t GetCount() const;
+
+    /** 调整数据项的个数：如果个数增加，新增的数据项在尾部追加，高度为默认值，并标记为未测量；如果个数减少，从尾部删除
+    * @param [in] nCount 新的数据项个数
+    * @param [in] nDefaultHeight 新增数据项的默认高度
+    */
+    void Resize(size_t nCount, int32_t nDefaultHeight);
+
+    /** 在指定位置插入数据项，新增的数据项高度为默认值，并标记为未测量（复杂度为O(n)）
+    * @param [in] nIndex 插入位置，范围：[0, GetCount()]
+    * @param [in] nCount 插入的数据项个数
+    * @param [in] nDefaultHeight 新增数据项的默认高度
+    */
+    void Insert(size_t nIndex, size_t nCount, int32_t nDefaultHeight);
+
+    /** 删除指定位置的数据项，其后数据项的高度和测量状态保持不变（复杂度为O(n)）
+    * @param [in] nIndex 删除的起始位置，范围：[0, GetCount())
+    * @param [in] nCount 删除的数据项个数
+    */
+    void Erase(size_t nIndex, size_t nCount);
+
+    /** 用一组高度值重建索引（复杂度为O(n)），所有数据项标记为已测量
+    * @param [in] heights 每个数据项的高度
+    */
+    void Assign(const std::vector<int32_t>& heights);
+
+    /** 获取数据项的高度
+    * @param [in] nIndex 数据项的索引号，范围：[0, GetCount())
+    */
+    int32_t GetHeight(size_t nIndex) const;
+
+    /** 设置数据项的高度
+    * @param [in] nIndex 数据项的索引号，范围：[0, GetCount())
+    * @param [in] nHeight 数据项的高度
+    * @return 如果高度发生变化返回true，否则返回false
+    */
+    bool SetHeight(size_t nIndex, int32_t nHeight);
+
+    /** 数据项的高度是否已经测量过（未测量时，高度为估算值）
+    * @param [in] nIndex 数据项的索引号，范围：[0, GetCount())
+    */
+    bool IsMeasured(size_t nIndex) const;
+
+    /** 设置数据项的高度是否已经测量过
+    * @param [in] nIndex 数据项的索引号，范围：[0, GetCount())
+    * @param [in] bMeasured true表示已经测量，false表示未测量
+    */
+    void SetMeasured(size_t nIndex, bool bMeasured);
+
+    /** 获取前nCount个数据项的高度总和（不含间隔）
+    * @param [in] nCount 数据项个数，如果大于GetCount()，则按GetCount()计算
+    */
+    int64_t GetPrefixHeight(size_t nCount) const;
+
+    /** 获取所有数据项的高度总和（不含间隔）
+    */
+    int64_t GetTotalHeight() const;
+
+    /** 获取数据项高度的下界（数据项的高度变大或者删除数据项时不会更新，所以可能比实际的最小高度小）
+    */
+    int32_t GetMinHeight() const;
+
+    /** 根据偏移量查找所在的数据项
+    * @param [in] nOffset 偏移量（从第一个数据项的顶部开始计算）
+    * @param [in] nSpacing 每个数据项之后附加的间隔
+    * @return 返回偏移量所在数据项的索引号，范围：[0, GetCount())，如果无数据项，返回0
+    *         (间隔为0时，会跳过高度为0的数据项，除非已经到达末尾)
+    */
+    size_t FindIndexByOffset(int64_t nOffset, int32_t nSpacing) const;
+
+private:
+    /** 在树状数组中，将第nIndex个数据项的值增加nDelta
+    */
+    void AddDelta(size_t nIndex, int64_t nDelta);
+
+    /** 根据每个数据项的高度重建树状数组和高度总和
+    */
+    void RebuildTree();
+
+private:
+    /** 每个数据项的高度
+    */
+    std::vector<int32_t> m_heights;
+
+    /** 每个数据项是否已经测量
+    */
+    std::vector<bool> m_measured;
+
+    /** 树状数组（下标从1开始，m_tree[0]不使用）
+    */
+    std::vector<int64_t> m_tree;
+
+    /** 所有数据项的高度总和
+    */
+    int64_t m_nTotalHeight;
+
+    /** 数据项高度的下界
+    */
+    int32_t m_nMinHeight;
+};
+
+} // namespace ui
+
+#endif // UI_BOX_VIRTUAL_HEIGHT_INDEX_H_
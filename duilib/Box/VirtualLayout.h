@@ -56,6 +56,25 @@ public:
     * @param[in] bToTop 是否在最上方
     */
     virtual void EnsureVisible(UiRect rc, size_t iIndex, bool bToTop) const = 0;
+
+    /** 数据内容发生变化（可变高度的布局，用于增量更新数据项的高度）
+    * @param [in] nStartElementIndex 数据的开始下标
+    * @param [in] nEndElementIndex 数据的结束下标
+    * @return 如果有数据项的高度发生变化，返回true，否则返回false
+    */
+    virtual bool OnElementsChanged(size_t /*nStartElementIndex*/, size_t /*nEndElementIndex*/) { return false; }
+
+    /** 在指定位置插入了数据项（可变高度的布局，用于在插入位置更新高度索引）
+    * @param [in] nStartElementIndex 插入的开始下标
+    * @param [in] nCount 插入的数据项个数
+    */
+    virtual void OnElementsInserted(size_t /*nStartElementIndex*/, size_t /*nCount*/) {}
+
+    /** 删除了指定位置的数据项（可变高度的布局，用于在删除位置更新高度索引）
+    * @param [in] nStartElementIndex 删除的开始下标
+    * @param [in] nCount 删除的数据项个数
+    */
+    virtual void OnElementsRemoved(size_t /*nStartElementIndex*/, size_t /*nCount*/) {}
 };
 
 } // namespace ui
@@ -7,14 +7,22 @@ namespace ui {
 
 VirtualListBoxElement::VirtualListBoxElement():
     m_pfnCountChangedNotify(),
-    m_pfnDataChangedNotify()
+    m_pfnDataChangedNotify(),
+    m_pfnRangeCountChangedNotify()
 {
 }
 
-void VirtualListBoxElement::RegNotifys(const DataChangedNotify& dcNotify, const CountChangedNotify& ccNotify)
+int32_t VirtualListBoxElement::GetElementHeight(size_t /*nElementIndex*/) const
+{
+    return -1;
+}
+
+void VirtualListBoxElement::RegNotifys(const DataChangedNotify& dcNotify, const CountChangedNotify& ccNotify,
+                                       const RangeCountChangedNotify& rcNotify)
 {
     m_pfnDataChangedNotify = dcNotify;
     m_pfnCountChangedNotify = ccNotify;
+    m_pfnRangeCountChangedNotify = rcNotify;
 }
 
 void VirtualListBoxElement::EmitDataChanged(size_t nStartIndex, size_t nEndIndex)
@@ -31,6 +39,26 @@ void VirtualListBoxElement::EmitCountChanged()
     }
 }
 
+void VirtualListBoxElement::EmitElementsInserted(size_t nStartElementIndex, size_t nCount)
+{
+    if (m_pfnRangeCountChangedNotify) {
+        m_pfnRangeCountChangedNotify(nStartElementIndex, nCount, true);
+    }
+    else {
+        EmitCountChanged();
+    }
+}
+
+void VirtualListBoxElement::EmitElementsRemoved(size_t nStartElementIndex, size_t nCount)
+{
+    if (m_pfnRangeCountChangedNotify) {
+        m_pfnRangeCountChangedNotify(nStartElementIndex, nCount, false);
+    }
+    else {
+        EmitCountChanged();
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 VirtualListBox::VirtualListBox(Window* pWindow, Layout* pLayout)
@@ -67,7 +95,9 @@ void VirtualListBox::SetDataProvider(VirtualListBoxElement* pProvider)
         //注册模型数据变动通知回调
         pProvider->RegNotifys(
             UiBind(&VirtualListBox::OnModelDataChanged, this, std::placeholders::_1, std::placeholders::_2),
-            UiBind(&VirtualListBox::OnModelCountChanged, this));
+            UiBind(&VirtualListBox::OnModelCountChanged, this),
+            UiBind(&VirtualListBox::OnModelRangeCountChanged, this, std::placeholders::_1,
+                   std::placeholders::_2, std::placeholders::_3));
     }
 }
 
@@ -402,6 +432,10 @@ void VirtualListBox::RefreshElements(const std::vector<size_t>& elementIndexs)
 
 void VirtualListBox::OnModelDataChanged(size_t nStartElementIndex, size_t nEndElementIndex)
 {
+    if ((m_pVirtualLayout != nullptr) && m_pVirtualLayout->OnElementsChanged(nStartElementIndex, nEndElementIndex)) {
+        //数据项的高度发生变化，需要重新布局
+        Arrange();
+    }
     VirtualListBox::RefreshDataList refreshDataList;
     VirtualListBox::RefreshData refreshData;
     size_t nItemCount = m_items.size();
@@ -436,6 +470,20 @@ void VirtualListBox::OnModelCountChanged()
     Refresh();
 }
 
+void VirtualListBox::OnModelRangeCountChanged(size_t nStartElementIndex, size_t nCount, bool bInserted)
+{
+    if (m_pVirtualLayout != nullptr) {
+        //先在变化的位置更新布局的高度索引，再刷新
+        if (bInserted) {
+            m_pVirtualLayout->OnElementsInserted(nStartElementIndex, nCount);
+        }
+        else {
+            m_pVirtualLayout->OnElementsRemoved(nStartElementIndex, nCount);
+        }
+    }
+    OnModelCountChanged();
+}
+
 bool VirtualListBox::IsEnableUpdateProvider() const
 {
     return m_bEnableUpdateProvider;
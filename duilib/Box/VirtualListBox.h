@@ -12,6 +12,7 @@ namespace ui {
 
 typedef std::function<void(size_t nStartIndex, size_t nEndIndex)> DataChangedNotify;
 typedef std::function<void()> CountChangedNotify;
+typedef std::function<void(size_t nStartIndex, size_t nCount, bool bInserted)> RangeCountChangedNotify;
 
 class VirtualListBox;
 class UILIB_API VirtualListBoxElement : public virtual SupportWeakCallback
@@ -62,12 +63,22 @@ public:
     */
     virtual void SetMultiSelect(bool bMultiSelect) = 0;
 
+    /** 获取数据项的高度（仅用于纵向布局的可变高度模式，即VirtualVLayout设置了"variable_height"属性）
+    * @param [in] nElementIndex 数据元素的索引ID，范围：[0, GetElementCount())
+    * @return 返回数据项的高度（需要已经做过DPI缩放）；如果返回值小于0，表示高度未知，
+    *         此时先以"item_size"中的高度作为估算值，在数据项填充到控件后，再根据控件的估算大小测量实际高度
+    *         数据项的高度发生变化时，可调用EmitDataChanged通知界面更新
+    */
+    virtual int32_t GetElementHeight(size_t nElementIndex) const;
+
 public:
     /** 注册事件通知回调
     * @param [in] dcNotify 数据内容变化通知接口
     * @param [in] ccNotify 数据项个数变化通知接口
+    * @param [in] rcNotify 在指定位置插入或者删除数据项的通知接口
     */
-    void RegNotifys(const DataChangedNotify& dcNotify, const CountChangedNotify& ccNotify);
+    void RegNotifys(const DataChangedNotify& dcNotify, const CountChangedNotify& ccNotify,
+                    const RangeCountChangedNotify& rcNotify = nullptr);
 
 protected:
 
@@ -81,6 +92,18 @@ protected:
     */
     void EmitCountChanged();
 
+    /** 发送通知：在指定位置插入了数据项（可变高度模式下，其他数据项已测量的高度保持不变）
+    * @param [in] nStartElementIndex 插入的开始下标
+    * @param [in] nCount 插入的数据项个数
+    */
+    void EmitElementsInserted(size_t nStartElementIndex, size_t nCount);
+
+    /** 发送通知：删除了指定位置的数据项（可变高度模式下，其他数据项已测量的高度保持不变）
+    * @param [in] nStartElementIndex 删除的开始下标
+    * @param [in] nCount 删除的数据项个数
+    */
+    void EmitElementsRemoved(size_t nStartElementIndex, size_t nCount);
+
 private:
 
     /** 数据内容发生变化的响应函数
@@ -90,6 +113,10 @@ private:
     /** 数据个数发生变化的响应函数
     */
     CountChangedNotify m_pfnCountChangedNotify;
+
+    /** 在指定位置插入或者删除数据项的响应函数
+    */
+    RangeCountChangedNotify m_pfnRangeCountChangedNotify;
 };
 
 /** 虚表实现的ListBox，支持大数据量，只支持纵向滚动条
@@ -394,6 +421,10 @@ protected:
     */
     void OnModelCountChanged();
 
+    /** 数据在指定位置插入或者删除
+    */
+    void OnModelRangeCountChanged(size_t nStartElementIndex, size_t nCount, bool bInserted);
+
     /** 是否允许从界面状态同步到存储状态
     */
     bool IsEnableUpdateProvider() const;
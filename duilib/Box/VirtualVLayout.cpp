@@ -5,7 +5,9 @@
 namespace ui 
 {
 
-VirtualVLayout::VirtualVLayout()
+VirtualVLayout::VirtualVLayout():
+    m_bVariableHeight(false),
+    m_nMaxItemMinHeight(0)
 {
 }
 
@@ -24,7 +26,14 @@ UiSize64 VirtualVLayout::ArrangeChild(const std::vector<ui::Control*>& items, ui
         return __super::ArrangeChild(items, rc);
     }
     DeflatePadding(rc);
-    int64_t nTotalHeight = GetElementsHeight(rc, Box::InvalidIndex);
+    int64_t nTotalHeight = 0;
+    if (m_bVariableHeight) {
+        SyncHeightIndex();
+        nTotalHeight = GetTotalElementsHeight();
+    }
+    else {
+        nTotalHeight = GetElementsHeight(rc, Box::InvalidIndex);
+    }
     UiSize64 sz(rc.Width(), rc.Height());
     sz.cy = std::max(nTotalHeight, sz.cy);
     LazyArrangeChild(rc);
@@ -79,6 +88,9 @@ bool VirtualVLayout::SetAttribute(const DString& strName, const DString& strValu
         dpiManager.ScaleSize(szItem);
         SetItemSize(szItem);
     }
+    else if (strName == _T("variable_height")) {
+        SetVariableHeight(strValue == _T("true"));
+    }
     else {
         hasAttribute = VLayout::SetAttribute(strName, strValue, dpiManager);
     }
@@ -90,6 +102,10 @@ void VirtualVLayout::ChangeDpiScale(const DpiManager& dpiManager, uint32_t nOldD
     UiSize szItem = GetItemSize();
     szItem = dpiManager.GetScaleSize(szItem, nOldDpiScale);
     SetItemSize(szItem);
+    if (m_bVariableHeight) {
+        //DPI变化后，数据项的高度需要重新获取和测量
+        m_heightIndex.Clear();
+    }
     __super::ChangeDpiScale(dpiManager, nOldDpiScale);
 }
 
@@ -111,6 +127,189 @@ const UiSize& VirtualVLayout::GetItemSize() const
     return m_szItem;
 }
 
+void VirtualVLayout::SetVariableHeight(bool bVariableHeight)
+{
+    if (m_bVariableHeight != bVariableHeight) {
+        m_bVariableHeight = bVariableHeight;
+        m_heightIndex.Clear();
+        m_nMaxItemMinHeight = 0;
+        if (GetOwner() != nullptr) {
+            GetOwner()->Arrange();
+        }
+    }
+}
+
+bool VirtualVLayout::IsVariableHeight() const
+{
+    return m_bVariableHeight;
+}
+
+void VirtualVLayout::SyncHeightIndex() const
+{
+    ASSERT(m_bVariableHeight);
+    VirtualListBox* pOwnerBox = GetOwnerBox();
+    if ((pOwnerBox == nullptr) || !pOwnerBox->HasDataProvider()) {
+        m_heightIndex.Clear();
+        return;
+    }
+    const size_t nOldCount = m_heightIndex.GetCount();
+    const size_t nNewCount = pOwnerBox->GetElementCount();
+    if (nOldCount == nNewCount) {
+        return;
+    }
+    //数据项个数变化时，已有数据项的高度保持不变（适用于在尾部追加或者删除数据的情况）；
+    //如果在中间插入或者删除了数据，数据提供者需要通过EmitElementsInserted/EmitElementsRemoved通知变化的位置
+    m_heightIndex.Resize(nNewCount, GetItemSize().cy);
+    UpdateProviderHeights(nOldCount, nNewCount);
+}
+
+void VirtualVLayout::UpdateProviderHeights(size_t nStartElementIndex, size_t nEndElementIndex) const
+{
+    VirtualListBox* pOwnerBox = GetOwnerBox();
+    if ((pOwnerBox == nullptr) || !pOwnerBox->HasDataProvider()) {
+        return;
+    }
+    VirtualListBoxElement* pProvider = pOwnerBox->GetDataProvider();
+    nEndElementIndex = std::min(nEndElementIndex, m_heightIndex.GetCount());
+    for (size_t nElementIndex = nStartElementIndex; nElementIndex < nEndElementIndex; ++nElementIndex) {
+        int32_t nHeight = pProvider->GetElementHeight(nElementIndex);
+        if (nHeight >= 0) {
+            m_heightIndex.SetHeight(nElementIndex, nHeight);
+            m_heightIndex.SetMeasured(nElementIndex, true);
+        }
+    }
+}
+
+void VirtualVLayout::OnElementsInserted(size_t nStartElementIndex, size_t nCount)
+{
+    VirtualListBox* pOwnerBox = GetOwnerBox();
+    if (!m_bVariableHeight || (nCount == 0) || (pOwnerBox == nullptr) || !pOwnerBox->HasDataProvider()) {
+        return;
+    }
+    const size_t nOldCount = m_heightIndex.GetCount();
+    if ((nOldCount == 0) || (nStartElementIndex > nOldCount) ||
+        ((nOldCount + nCount) != pOwnerBox->GetElementCount())) {
+        //高度索引与数据不一致（有未同步的变化），从头重建
+        m_heightIndex.Clear();
+        return;
+    }
+    m_heightIndex.Insert(nStartElementIndex, nCount, GetItemSize().cy);
+    UpdateProviderHeights(nStartElementIndex, nStartElementIndex + nCount);
+}
+
+void VirtualVLayout::OnElementsRemoved(size_t nStartElementIndex, size_t nCount)
+{
+    VirtualListBox* pOwnerBox = GetOwnerBox();
+    if (!m_bVariableHeight || (nCount == 0) || (pOwnerBox == nullptr) || !pOwnerBox->HasDataProvider()) {
+        return;
+    }
+    const size_t nOldCount = m_heightIndex.GetCount();
+    if ((nStartElementIndex >= nOldCount) || (nCount > (nOldCount - nStartElementIndex)) ||
+        ((nOldCount - nCount) != pOwnerBox->GetElementCount())) {
+        //高度索引与数据不一致（有未同步的变化），从头重建
+        m_heightIndex.Clear();
+        return;
+    }
+    m_heightIndex.Erase(nStartElementIndex, nCount);
+}
+
+int64_t VirtualVLayout::GetElementTop(size_t nElementIndex) const
+{
+    ASSERT(m_bVariableHeight);
+    int64_t iChildMargin = std::max(GetChildMarginY(), 0);
+    return m_heightIndex.GetPrefixHeight(nElementIndex) + iChildMargin * (int64_t)nElementIndex;
+}
+
+int64_t VirtualVLayout::GetTotalElementsHeight() const
+{
+    ASSERT(m_bVariableHeight);
+    const size_t nCount = m_heightIndex.GetCount();
+    if (nCount == 0) {
+        return 0;
+    }
+    int64_t iChildMargin = std::max(GetChildMarginY(), 0);
+    return m_heightIndex.GetTotalHeight() + iChildMargin * ((int64_t)nCount - 1);
+}
+
+bool VirtualVLayout::MeasureElementHeight(Control* pControl, size_t nElementIndex) const
+{
+    ASSERT(m_bVariableHeight);
+    if ((pControl == nullptr) || (nElementIndex >= m_heightIndex.GetCount())) {
+        return false;
+    }
+    if (m_heightIndex.IsMeasured(nElementIndex)) {
+        return false;
+    }
+    m_heightIndex.SetMeasured(nElementIndex, true);
+    //按子项的宽度，估算控件的实际高度（拉伸类型的高度无法测量，保持估算值）
+    UiSize szAvailable(GetItemSize().cx, 0);
+    VirtualListBox* pOwnerBox = GetOwnerBox();
+    if (pOwnerBox != nullptr) {
+        szAvailable.cy = pOwnerBox->GetPosWithoutPadding().Height();
+    }
+    pControl->SetReEstimateSize(true);
+    UiEstSize estSize = pControl->EstimateSize(szAvailable);
+    if (estSize.cy.IsStretch()) {
+        return false;
+    }
+    return m_heightIndex.SetHeight(nElementIndex, estSize.cy.GetInt32());
+}
+
+bool VirtualVLayout::OnElementsChanged(size_t nStartElementIndex, size_t nEndElementIndex)
+{
+    if (!m_bVariableHeight) {
+        return false;
+    }
+    VirtualListBox* pOwnerBox = GetOwnerBox();
+    if ((pOwnerBox == nullptr) || !pOwnerBox->HasDataProvider()) {
+        return false;
+    }
+    SyncHeightIndex();
+    const size_t nCount = m_heightIndex.GetCount();
+    if ((nCount == 0) || (nStartElementIndex >= nCount)) {
+        return false;
+    }
+    if (nEndElementIndex >= nCount) {
+        nEndElementIndex = nCount - 1;
+    }
+    //只更新变化范围内的数据项高度，总高度由高度索引增量维护
+    bool bChanged = false;
+    VirtualListBoxElement* pProvider = pOwnerBox->GetDataProvider();
+    for (size_t nElementIndex = nStartElementIndex; nElementIndex <= nEndElementIndex; ++nElementIndex) {
+        int32_t nHeight = pProvider->GetElementHeight(nElementIndex);
+        if (nHeight >= 0) {
+            if (m_heightIndex.SetHeight(nElementIndex, nHeight)) {
+                bChanged = true;
+            }
+            m_heightIndex.SetMeasured(nElementIndex, true);
+        }
+        else {
+            //高度未知，在下次填充到控件时重新测量
+            m_heightIndex.SetMeasured(nElementIndex, false);
+        }
+    }
+
+    //正在显示的数据项，重新测量高度
+    for (Control* pControl : pOwnerBox->m_items) {
+        if ((pControl == nullptr) || !pControl->IsVisible()) {
+            continue;
+        }
+        IListBoxItem* pListBoxItem = dynamic_cast<IListBoxItem*>(pControl);
+        if (pListBoxItem == nullptr) {
+            continue;
+        }
+        size_t nElementIndex = pListBoxItem->GetElementIndex();
+        if ((nElementIndex >= nStartElementIndex) && (nElementIndex <= nEndElementIndex) &&
+            !m_heightIndex.IsMeasured(nElementIndex)) {
+            pOwnerBox->FillElement(pControl, nElementIndex);
+            if (MeasureElementHeight(pControl, nElementIndex)) {
+                bChanged = true;
+            }
+        }
+    }
+    return bChanged;
+}
+
 int64_t VirtualVLayout::GetElementsHeight(UiRect /*rc*/, size_t nCount) const
 {
     UiSize szItem = GetItemSize();
@@ -162,9 +361,16 @@ void VirtualVLayout::LazyArrangeChild(UiRect rc) const
 
     //Y轴坐标的偏移，需要保持，避免滚动位置变动后，重新刷新界面出现偏差
     int32_t yOffset = 0;
-    int64_t itemHeight = GetElementsHeight(rc, 1);
-    if (itemHeight > 0) {
-        yOffset = TruncateToInt32(pOwnerBox->GetScrollPos().cy % itemHeight);
+    if (m_bVariableHeight) {
+        SyncHeightIndex();
+        size_t nTopIndex = GetTopElementIndex(rc);
+        yOffset = TruncateToInt32(pOwnerBox->GetScrollPos().cy - GetElementTop(nTopIndex));
+    }
+    else {
+        int64_t itemHeight = GetElementsHeight(rc, 1);
+        if (itemHeight > 0) {
+            yOffset = TruncateToInt32(pOwnerBox->GetScrollPos().cy % itemHeight);
+        }
     }
 
     //子项的顶部起始位置
@@ -182,22 +388,36 @@ void VirtualVLayout::LazyArrangeChild(UiRect rc) const
     size_t nTopIndex = GetTopElementIndex(rc);
     size_t iCount = 0;
     size_t nItemCount = pOwnerBox->m_items.size();
+    //可变高度模式下，是否有数据项的高度在测量后发生变化
+    bool bHeightChanged = false;
     for (size_t nItemIndex = 0; nItemIndex < nItemCount; ++nItemIndex) {
         Control* pControl = pOwnerBox->m_items[nItemIndex];
         if (pControl == nullptr) {
             continue;
         }
+        size_t nElementIndex = nTopIndex + iCount;
+        int32_t nItemHeight = szItem.cy;
+        if (m_bVariableHeight && (nElementIndex < pOwnerBox->GetElementCount())) {
+            //先填充数据，测量实际高度后，再设置控件位置
+            pOwnerBox->FillElement(pControl, nElementIndex);
+            if (MeasureElementHeight(pControl, nElementIndex)) {
+                bHeightChanged = true;
+            }
+            nItemHeight = m_heightIndex.GetHeight(nElementIndex);
+        }
+
         // Determine size
-        ui::UiRect rcTile(ptTile.x, ptTile.y, ptTile.x + szItem.cx, ptTile.y + szItem.cy);
+        ui::UiRect rcTile(ptTile.x, ptTile.y, ptTile.x + szItem.cx, ptTile.y + nItemHeight);
         pControl->SetPos(rcTile);
 
         // 填充数据
-        size_t nElementIndex = nTopIndex + iCount;
         if (nElementIndex < pOwnerBox->GetElementCount()) {
             if (!pControl->IsVisible()) {
                 pControl->SetVisible(true);
             }
-            pOwnerBox->FillElement(pControl, nElementIndex);
+            if (!m_bVariableHeight) {
+                pOwnerBox->FillElement(pControl, nElementIndex);
+            }
             refreshData.nItemIndex = nItemIndex;
             refreshData.pControl = pControl;
             refreshData.nElementIndex = nElementIndex;
@@ -212,11 +432,21 @@ void VirtualVLayout::LazyArrangeChild(UiRect rc) const
 
         //换行
         ptTile.x = iPosLeft;
-        ptTile.y += szItem.cy + GetChildMarginY();
+        ptTile.y += nItemHeight + GetChildMarginY();
     }
     if (!refreshDataList.empty()) {
         pOwnerBox->OnRefreshElements(refreshDataList);
     }
+    if (bHeightChanged) {
+        if ((m_nMaxItemMinHeight > 0) && (m_heightIndex.GetMinHeight() < m_nMaxItemMinHeight)) {
+            //数据项的高度变小，需要更多的控件才能填满显示区域
+            pOwnerBox->Refresh();
+        }
+        else {
+            //数据项的高度变化，总高度变化，需要重新布局以更新滚动条
+            pOwnerBox->Arrange();
+        }
+    }
 }
 
 size_t VirtualVLayout::AjustMaxItem(UiRect rc) const
@@ -229,6 +459,17 @@ size_t VirtualVLayout::AjustMaxItem(UiRect rc) const
     if (rc.IsEmpty()) {
         return 0;
     }
+    if (m_bVariableHeight) {
+        //按数据项的最小高度计算，确保真实控件填充满整个可显示区域
+        SyncHeightIndex();
+        int32_t nMinHeight = m_heightIndex.GetMinHeight();
+        if ((nMinHeight <= 0) || (nMinHeight > szItem.cy)) {
+            nMinHeight = szItem.cy;
+        }
+        m_nMaxItemMinHeight = nMinHeight;
+        int32_t nMinRows = rc.Height() / (nMinHeight + std::max(GetChildMarginY(), 0));
+        return (size_t)nMinRows + 2;
+    }
     int32_t nRows = rc.Height() / (szItem.cy + GetChildMarginY() / 2);
     //验证并修正
     if (nRows > 1) {
@@ -252,6 +493,10 @@ size_t VirtualVLayout::GetTopElementIndex(UiRect rc) const
     if (nPos < 0) {
         nPos = 0;
     }
+    if (m_bVariableHeight) {
+        SyncHeightIndex();
+        return m_heightIndex.FindIndexByOffset(nPos, std::max(GetChildMarginY(), 0));
+    }
     int64_t nHeight = GetElementsHeight(rc, 1);
     ASSERT(nHeight >= 0);
     if (nHeight <= 0) {
@@ -272,8 +517,25 @@ bool VirtualVLayout::IsElementDisplay(UiRect rc, size_t iIndex) const
     }
 
     int64_t nScrollPos = pOwnerBox->GetScrollPos().cy;
-    int64_t nElementPos = GetElementsHeight(rc, iIndex + 1);
-    int64_t nElementHeight = GetElementsHeight(rc, 1);
+    int64_t nElementPos = 0;
+    int64_t nElementHeight = 0;
+    if (m_bVariableHeight) {
+        SyncHeightIndex();
+        if (iIndex >= m_heightIndex.GetCount()) {
+            return false;
+        }
+        nElementHeight = m_heightIndex.GetHeight(iIndex);
+        nElementPos = GetElementTop(iIndex) + nElementHeight;
+        if ((nElementPos - nElementHeight) >= nScrollPos) { //矩形的top位置
+            int64_t nBoxHeight = pOwnerBox->GetHeight();
+            if (nElementPos <= (nScrollPos + nBoxHeight)) {//矩形的bottom位置
+                return true;
+            }
+        }
+        return false;
+    }
+    nElementPos = GetElementsHeight(rc, iIndex + 1);
+    nElementHeight = GetElementsHeight(rc, 1);
     if ((nElementPos - nElementHeight) > nScrollPos) { //矩形的top位置
         int64_t nBoxHeight = pOwnerBox->GetHeight();
         if (nElementPos <= (nScrollPos + nBoxHeight)) {//矩形的bottom位置
@@ -323,6 +585,22 @@ void VirtualVLayout::GetDisplayElements(UiRect rc, std::vector<size_t>& collecti
         return;
     }
 
+    if (m_bVariableHeight) {
+        SyncHeightIndex();
+        const size_t nCount = m_heightIndex.GetCount();
+        const int64_t nScrollPos = pOwnerBox->GetScrollPos().cy;
+        const int64_t nViewBottom = nScrollPos + rc.Height();
+        const size_t nMaxCount = pOwnerBox->GetItemCount();
+        size_t nElementIndex = GetTopElementIndex(rc);
+        int64_t nElementTop = GetElementTop(nElementIndex);
+        while ((nElementIndex < nCount) && (collection.size() < nMaxCount) && (nElementTop < nViewBottom)) {
+            collection.push_back(nElementIndex);
+            nElementTop += (int64_t)m_heightIndex.GetHeight(nElementIndex) + std::max(GetChildMarginY(), 0);
+            ++nElementIndex;
+        }
+        return;
+    }
+
     int64_t nEleHeight = GetElementsHeight(rc, 1);
     if (nEleHeight <= 0) {
         return;
@@ -359,6 +637,30 @@ void VirtualVLayout::EnsureVisible(UiRect rc, size_t iIndex, bool bToTop) const
         return;
     }
     int64_t nPos = pOwnerBox->GetScrollPos().cy;
+    if (m_bVariableHeight) {
+        SyncHeightIndex();
+        if (iIndex >= m_heightIndex.GetCount()) {
+            return;
+        }
+        int64_t nNewPos = GetElementTop(iIndex);
+        if (!bToTop) {
+            if (IsElementDisplay(rc, iIndex)) {
+                return;
+            }
+            if (iIndex > GetTopElementIndex(rc)) {
+                // 向下：让元素的底部与显示区域的底部对齐
+                nNewPos += (int64_t)m_heightIndex.GetHeight(iIndex) - pOwnerBox->GetRect().Height();
+            }
+        }
+        if (nNewPos > pOwnerBox->GetVScrollBar()->GetScrollRange()) {
+            nNewPos = pOwnerBox->GetVScrollBar()->GetScrollRange();
+        }
+        if (nNewPos < 0) {
+            nNewPos = 0;
+        }
+        pOwnerBox->SetScrollPos(ui::UiSize64(0, nNewPos));
+        return;
+    }
     int64_t elementHeight = GetElementsHeight(rc, 1);
     if (elementHeight <= 0) {
         return;
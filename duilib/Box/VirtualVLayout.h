@@ -3,6 +3,7 @@
 
 #include "duilib/Box/VLayout.h"
 #include "duilib/Box/VirtualLayout.h"
+#include "duilib/Box/VirtualHeightIndex.h"
 
 namespace ui 
 {
@@ -93,6 +94,37 @@ public:
     */
     virtual void EnsureVisible(UiRect rc, size_t iIndex, bool bToTop) const override;
 
+    /** 数据内容发生变化（可变高度模式下，增量更新数据项的高度）
+    * @param [in] nStartElementIndex 数据的开始下标
+    * @param [in] nEndElementIndex 数据的结束下标
+    * @return 如果有数据项的高度发生变化，返回true，否则返回false
+    */
+    virtual bool OnElementsChanged(size_t nStartElementIndex, size_t nEndElementIndex) override;
+
+    /** 在指定位置插入了数据项（可变高度模式下，在插入位置更新高度索引，其他数据项的高度保持不变）
+    * @param [in] nStartElementIndex 插入的开始下标
+    * @param [in] nCount 插入的数据项个数
+    */
+    virtual void OnElementsInserted(size_t nStartElementIndex, size_t nCount) override;
+
+    /** 删除了指定位置的数据项（可变高度模式下，在删除位置更新高度索引，其他数据项的高度保持不变）
+    * @param [in] nStartElementIndex 删除的开始下标
+    * @param [in] nCount 删除的数据项个数
+    */
+    virtual void OnElementsRemoved(size_t nStartElementIndex, size_t nCount) override;
+
+public:
+    /** 设置是否为可变高度模式（每个数据项的高度可以不同）
+    *   可变高度模式下，数据项的高度由 VirtualListBoxElement::GetElementHeight 提供，
+    *   如果未提供，则使用item_size中的高度作为估算值，在数据项填充到控件后测量实际高度
+    * @param [in] bVariableHeight true表示可变高度模式，false表示所有数据项高度相同
+    */
+    void SetVariableHeight(bool bVariableHeight);
+
+    /** 是否为可变高度模式
+    */
+    bool IsVariableHeight() const;
+
 private:
     /** 获取数据项的高度
     * @param [in] nCount 数据项个数，如果为Box::InvalidIndex，则获取所有数据项的高度总和
@@ -115,9 +147,45 @@ private:
      */
     const UiSize& GetItemSize() const;
 
+    /** 同步可变高度模式下的高度索引（数据项个数变化时，在尾部追加或者删除）
+    *   在中间插入或者删除的数据项，需要通过OnElementsInserted/OnElementsRemoved在变化的位置更新
+    */
+    void SyncHeightIndex() const;
+
+    /** 可变高度模式下，从数据提供者获取指定范围内数据项的高度（高度未知的数据项保持估算值）
+    * @param [in] nStartElementIndex 开始下标
+    * @param [in] nEndElementIndex 结束下标（不含）
+    */
+    void UpdateProviderHeights(size_t nStartElementIndex, size_t nEndElementIndex) const;
+
+    /** 可变高度模式下，获取数据项的顶部位置（相对于第一个数据项的顶部）
+    * @param [in] nElementIndex 数据元素的索引号
+    */
+    int64_t GetElementTop(size_t nElementIndex) const;
+
+    /** 可变高度模式下，获取所有数据项的高度总和（含间隔）
+    */
+    int64_t GetTotalElementsHeight() const;
+
+    /** 可变高度模式下，测量数据项的实际高度（数据项已经填充到控件中）
+    * @param [in] pControl 数据项关联的控件
+    * @param [in] nElementIndex 数据元素的索引号
+    * @return 如果高度发生变化返回true，否则返回false
+    */
+    bool MeasureElementHeight(Control* pControl, size_t nElementIndex) const;
+
 private:
     //子项大小, 该宽度和高度，是包含了控件的外边距和内边距的
     UiSize m_szItem;
+
+    //是否为可变高度模式
+    bool m_bVariableHeight;
+
+    //可变高度模式下，数据项的高度索引
+    mutable VirtualHeightIndex m_heightIndex;
+
+    //可变高度模式下，计算最大子项数时所用的数据项最小高度
+    mutable int32_t m_nMaxItemMinHeight;
 };
 } // namespace ui
 
@@ -679,14 +679,14 @@ void CheckBoxTemplate<InheritType>::PaintText(IRender* pRender)
             DString clrStateColor = GetSelectedStateTextColor(kControlStateNormal);
             if (!clrStateColor.empty()) {
                 UiColor dwWinColor = this->GetUiColor(clrStateColor);
-                pRender->DrawString(rc, textValue, dwWinColor, this->GetIFontById(this->GetFontId()), this->GetTextStyle());
+                pRender->DrawString(rc, textValue, dwWinColor, this->GetTextFont(), this->GetTextStyle());
             }
 
             if (this->GetHotAlpha() > 0) {
                 DString textColor = GetSelectedStateTextColor(kControlStateHot);
                 if (!textColor.empty()) {
                     UiColor dwTextColor = this->GetUiColor(textColor);
-                    pRender->DrawString(rc, textValue, dwTextColor, this->GetIFontById(this->GetFontId()), this->GetTextStyle(), (uint8_t)this->GetHotAlpha());
+                    pRender->DrawString(rc, textValue, dwTextColor, this->GetTextFont(), this->GetTextStyle(), (uint8_t)this->GetHotAlpha());
                 }
             }
 
@@ -694,7 +694,7 @@ void CheckBoxTemplate<InheritType>::PaintText(IRender* pRender)
         }
     }
 
-    pRender->DrawString(rc, textValue, dwClrColor, this->GetIFontById(this->GetFontId()), this->GetTextStyle());
+    pRender->DrawString(rc, textValue, dwClrColor, this->GetTextFont(), this->GetTextStyle());
 }
 
 template<typename InheritType>
@@ -101,6 +101,11 @@ public:
      */
     void SetFontId(const DString& strFontId);
 
+    /** 获取当前字体ID对应的字体接口（缓存解析结果，字体ID、DPI和字体资源未变化时，无需按字体ID查找）
+     * @return 成功返回字体接口，外部调用不需要释放资源；如果失败则返回nullptr
+     */
+    IFont* GetTextFont() const;
+
     /** 获取文字内边距
      * @return 返回文字的内边距信息
      */
@@ -153,6 +158,13 @@ private:
     UiString m_sText;
     UiString m_sTextId;
     StateColorMap* m_pTextColorMap;
+
+    //各个状态的文本颜色的颜色句柄（缓存解析后的颜色值），按ControlStateType索引
+    //每个状态使用独立的句柄，状态切换时不会互相覆盖缓存
+    ColorHandle m_textColorHandles[kControlStateDisabled + 1];
+
+    //字体的字体句柄（缓存解析后的字体接口）
+    mutable FontHandle m_fontHandle;
 };
 
 template<typename InheritType>
@@ -385,7 +397,7 @@ void LabelTemplate<InheritType>::CheckShowToolTip()
         width = rc.Width();
     }
 
-    UiRect rcMessure = pRender->MeasureString(sText, this->GetIFontById(this->GetFontId()), m_uTextStyle, width);
+    UiRect rcMessure = pRender->MeasureString(sText, GetTextFont(), m_uTextStyle, width);
     if (rc.Width() < rcMessure.Width() || rc.Height() < rcMessure.Height()) {
         m_sAutoShowTooltipCache = sText;
     }
@@ -477,7 +489,7 @@ UiSize LabelTemplate<InheritType>::EstimateText(UiSize szAvailable)
     if (!textValue.empty() && (this->GetWindow() != nullptr)) {
         auto pRender = this->GetWindow()->GetRender();
         if (pRender != nullptr) {
-            UiRect rect = pRender->MeasureString(textValue, this->GetIFontById(GetFontId()), m_uTextStyle, width);            
+            UiRect rect = pRender->MeasureString(textValue, GetTextFont(), m_uTextStyle, width);            
             if (this->GetFixedWidth().IsAuto()) {
                 fixedSize.cx = rect.Width() + rcTextPadding.left + rcTextPadding.right;
                 fixedSize.cx += (rcPadding.left + rcPadding.right);
@@ -509,7 +521,7 @@ void LabelTemplate<InheritType>::DoPaintText(const UiRect & rc, IRender * pRende
     }
 
     ControlStateType stateType = this->GetState();
-    UiColor dwClrColor = this->GetUiColor(GetPaintStateTextColor(this->GetState(), stateType));
+    DString clrColor = GetPaintStateTextColor(this->GetState(), stateType);
 
     if (m_bSingleLine) {
         m_uTextStyle |= TEXT_SINGLELINE;
@@ -517,21 +529,20 @@ void LabelTemplate<InheritType>::DoPaintText(const UiRect & rc, IRender * pRende
     else {
         m_uTextStyle &= ~TEXT_SINGLELINE;
     }
-    DString fontId = GetFontId();
     if (this->GetAnimationManager().GetAnimationPlayer(AnimationType::kAnimationHot)) {
         if ((stateType == kControlStateNormal || stateType == kControlStateHot) && 
             !GetStateTextColor(kControlStateHot).empty()) {
-            DString clrColor = GetStateTextColor(kControlStateNormal);
-            if (!clrColor.empty()) {
-                UiColor dwTextColor = this->GetUiColor(clrColor);
-                pRender->DrawString(rc, textValue, dwTextColor, this->GetIFontById(fontId), m_uTextStyle);
+            DString normalColor = GetStateTextColor(kControlStateNormal);
+            if (!normalColor.empty()) {
+                UiColor dwTextColor = this->GetUiColor(normalColor, m_textColorHandles[kControlStateNormal]);
+                pRender->DrawString(rc, textValue, dwTextColor, GetTextFont(), m_uTextStyle);
             }
 
             if (this->GetHotAlpha() > 0) {
                 DString textColor = GetStateTextColor(kControlStateHot);
                 if (!textColor.empty()) {
-                    UiColor dwTextColor = this->GetUiColor(textColor);
-                    pRender->DrawString(rc, textValue, dwTextColor, this->GetIFontById(fontId), m_uTextStyle, (uint8_t)this->GetHotAlpha());
+                    UiColor dwTextColor = this->GetUiColor(textColor, m_textColorHandles[kControlStateHot]);
+                    pRender->DrawString(rc, textValue, dwTextColor, GetTextFont(), m_uTextStyle, (uint8_t)this->GetHotAlpha());
                 }
             }
 
@@ -539,7 +550,9 @@ void LabelTemplate<InheritType>::DoPaintText(const UiRect & rc, IRender * pRende
         }
     }
 
-    pRender->DrawString(rc, textValue, dwClrColor, this->GetIFontById(fontId), m_uTextStyle);
+    ASSERT((stateType >= kControlStateNormal) && (stateType <= kControlStateDisabled));
+    UiColor dwClrColor = this->GetUiColor(clrColor, m_textColorHandles[stateType]);
+    pRender->DrawString(rc, textValue, dwClrColor, GetTextFont(), m_uTextStyle);
 }
 
 template<typename InheritType>
@@ -628,6 +641,12 @@ void LabelTemplate<InheritType>::SetFontId(const DString& strFontId)
     this->Invalidate();
 }
 
+template<typename InheritType>
+IFont* LabelTemplate<InheritType>::GetTextFont() const
+{
+    return this->GetIFontById(m_sFontId, m_fontHandle);
+}
+
 template<typename InheritType>
 UiPadding LabelTemplate<InheritType>::GetTextPadding() const
 {
@@ -36,6 +36,7 @@ ListCtrl::ListCtrl(Window* pWindow):
 
     m_pData = new ListCtrlData;
     m_pData->SetAutoCheckSelect(IsAutoCheckSelect());
+    m_pData->SetFilterCompletedCallback(UiBind(&ListCtrl::OnDataItemFilterCompleted, this));
 
     m_pReportView = new ListCtrlReportView(pWindow);
     m_pReportView->SetListCtrl(this);
@@ -1341,6 +1342,11 @@ size_t ListCtrl::GetDataItemCount() const
     return m_pData->GetDataItemCount();
 }
 
+size_t ListCtrl::GetDataMemorySize() const
+{
+    return m_pData->GetStorageMemorySize();
+}
+
 bool ListCtrl::SetDataItemCount(size_t itemCount)
 {
     bool bRet = m_pData->SetDataItemCount(itemCount);
@@ -1625,11 +1631,67 @@ bool ListCtrl::SortDataItems(size_t columnIndex, bool bSortedUp,
     return m_pData->SortDataItems(nColumnId, columnIndex, bSortedUp, pfnCompareFunc, pUserData);
 }
 
+bool ListCtrl::SortDataItems(const std::vector<ListCtrlSortKey>& sortKeys)
+{
+    std::vector<ListCtrlSortKey> dataSortKeys = sortKeys;
+    for (ListCtrlSortKey& sortKey : dataSortKeys) {
+        sortKey.nColumnId = GetColumnId(sortKey.nColumnIndex);
+        ASSERT(sortKey.nColumnId != Box::InvalidIndex);
+        if (sortKey.nColumnId == Box::InvalidIndex) {
+            return false;
+        }
+    }
+    return m_pData->SortDataItems(dataSortKeys);
+}
+
 void ListCtrl::SetSortCompareFunction(ListCtrlDataCompareFunc pfnCompareFunc, void* pUserData)
 {
     m_pData->SetSortCompareFunction(pfnCompareFunc, pUserData);
 }
 
+void ListCtrl::OnDataItemFilterCompleted()
+{
+    //过滤结果已经完整，同步表头的勾选状态
+    UpdateHeaderColumnCheckBox(Box::InvalidIndex);
+    UpdateHeaderCheckBox();
+}
+
+bool ListCtrl::SetDataItemFilter(const DString& filterText, const std::vector<size_t>& columnIndexs)
+{
+    std::vector<size_t> columnIds;
+    for (size_t columnIndex : columnIndexs) {
+        size_t nColumnId = GetColumnId(columnIndex);
+        ASSERT(nColumnId != Box::InvalidIndex);
+        if (nColumnId == Box::InvalidIndex) {
+            return false;
+        }
+        columnIds.push_back(nColumnId);
+    }
+    bool bRet = m_pData->SetFilter(filterText, columnIds);
+    if (bRet) {
+        UpdateHeaderColumnCheckBox(Box::InvalidIndex);
+        UpdateHeaderCheckBox();
+    }
+    return bRet;
+}
+
+void ListCtrl::ClearDataItemFilter()
+{
+    m_pData->ClearFilter();
+    UpdateHeaderColumnCheckBox(Box::InvalidIndex);
+    UpdateHeaderCheckBox();
+}
+
+bool ListCtrl::IsDataItemFilterCompleted() const
+{
+    return m_pData->IsFilterCompleted();
+}
+
+void ListCtrl::GetFilteredDataItems(std::vector<size_t>& itemIndexs) const
+{
+    m_pData->GetFilteredDataItems(itemIndexs);
+}
+
 bool ListCtrl::IsMultiSelect() const
 {
     return m_bMultiSelect;
@@ -154,6 +154,10 @@ public:
     */
     size_t GetDataItemCount() const;
 
+    /** 获取数据存储占用的内存大小（字节，含行数据、各列的存储、过滤状态和搜索索引，按已分配的容量计算）
+    */
+    size_t GetDataMemorySize() const;
+
     /** 设置数据项总个数(对应行数)
     * @param [in] itemCount 数据项的总数
     */
@@ -407,12 +411,42 @@ public:
                        ListCtrlDataCompareFunc pfnCompareFunc = nullptr,
                        void* pUserData = nullptr);
 
+    /** 按多列对数据排序（稳定排序，数据量较大时在多个线程中排序）
+    * @param [in] sortKeys 排序键，按顺序依次比较，列由ListCtrlSortKey::nColumnIndex指定
+    */
+    bool SortDataItems(const std::vector<ListCtrlSortKey>& sortKeys);
+
     /** 设置外部自定义的排序函数, 替换默认的排序函数
     * @param [in] pfnCompareFunc 数据比较函数
     * @param [in] pUserData 用户自定义数据，调用比较函数的时候，通过参数传回给比较函数
     */
     void SetSortCompareFunction(ListCtrlDataCompareFunc pfnCompareFunc, void* pUserData);
 
+public:
+    /** 设置过滤条件：只显示指定列中包含查询文本（不区分大小写）的行
+    *   在上次查询文本的基础上增加或者删除字符时，只检查可能发生变化的行；
+    *   数据量较大时，首批结果立即显示，其余结果陆续显示（可通过IsDataItemFilterCompleted判断是否完成）
+    *   注意：不满足过滤条件的行按隐藏行处理，只在Report视图中生效；
+    *        被过滤隐藏的行保持原来的选择和勾选状态，全选、全部勾选（含表头的勾选框）只作用于满足过滤条件的行
+    * @param [in] filterText 查询文本，为空表示取消过滤
+    * @param [in] columnIndexs 参与查询的列索引号，有效范围：[0, GetColumnCount())，为空表示所有列
+    */
+    bool SetDataItemFilter(const DString& filterText,
+                           const std::vector<size_t>& columnIndexs = std::vector<size_t>());
+
+    /** 取消过滤
+    */
+    void ClearDataItemFilter();
+
+    /** 过滤是否已经完成（所有行都已经检查）
+    */
+    bool IsDataItemFilterCompleted() const;
+
+    /** 获取过滤后显示的数据项（按显示顺序；过滤未完成时，为已经找到的结果）
+    * @param [out] itemIndexs 返回数据项的索引号，有效范围：[0, GetDataItemCount())
+    */
+    void GetFilteredDataItems(std::vector<size_t>& itemIndexs) const;
+
 public:
     /** 是否支持多选
     */
@@ -839,6 +873,10 @@ protected:
     */
     void UpdateHeaderCheckBox();
 
+    /** 过滤在定时器中分批检查完成，同步表头的勾选状态
+    */
+    void OnDataItemFilterCompleted();
+
 private:
     /** 进入编辑状态
     * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
@@ -0,0 +1,543 @@
+#include "ListCtrlColumnStorage.h"
+#include <algorithm>
+
+namespace ui
+{
+
+//文本缓冲区中，无用的字符个数超过该值，并且超过缓冲区的一半时，压缩文本缓冲区
+static const size_t kMinCompactTextGarbage = 4096;
+
+/** 按指定顺序调整数组元素的顺序：调整后的第i个元素，为调整前的第orders[i]个元素
+*/
+template<typename T>
+static void ReorderVector(std::vector<T>& values, const std::vector<size_t>& orders)
+{
+    std::vector<T> newValues;
+    newValues.reserve(orders.size());
+    for (size_t nOrder : orders) {
+        newValues.push_back(values[nOrder]);
+    }
+    values.swap(newValues);
+}
+
+ListCtrlColumnStorage::ListCtrlColumnStorage():
+    m_nTextGarbage(0),
+    m_nDirtyItemWidthCount(0),
+    m_nMaxItemWidth(0),
+    m_bMaxItemWidthValid(true)
+{
+}
+
+void ListCtrlColumnStorage::Resize(size_t nCount)
+{
+    if (nCount == 0) {
+        Clear();
+        return;
+    }
+    const size_t nOldCount = GetCount();
+    for (size_t nIndex = nCount; nIndex < nOldCount; ++nIndex) {
+        ReleaseText(nIndex);
+        RemoveItemWidth(nIndex);
+    }
+    if (!m_itemWidths.empty()) {
+        m_itemWidths.resize(nCount, 0);
+    }
+    m_textRefs.resize(nCount, TextRef{ 0, 0 });
+    m_textFormats.resize(nCount, 0);
+    m_imageIds.resize(nCount, -1);
+    m_flags.resize(nCount, 0);
+    if (nCount < nOldCount) {
+        auto iter = std::lower_bound(m_colors.begin(), m_colors.end(), nCount, [](const ColorData& a, size_t nIndex) {
+                return a.nIndex < nIndex;
+            });
+        m_colors.erase(iter, m_colors.end());
+        CheckCompactText();
+    }
+}
+
+void ListCtrlColumnStorage::InsertEmpty(size_t nIndex)
+{
+    ASSERT(nIndex <= GetCount());
+    if (nIndex > GetCount()) {
+        return;
+    }
+    m_textRefs.insert(m_textRefs.begin() + nIndex, TextRef{ 0, 0 });
+    m_textFormats.insert(m_textFormats.begin() + nIndex, (uint16_t)0);
+    m_imageIds.insert(m_imageIds.begin() + nIndex, -1);
+    m_flags.insert(m_flags.begin() + nIndex, (uint8_t)0);
+    if (!m_itemWidths.empty()) {
+        m_itemWidths.insert(m_itemWidths.begin() + nIndex, 0);
+    }
+    for (ColorData& colorData : m_colors) {
+        if (colorData.nIndex >= nIndex) {
+            ++colorData.nIndex;
+        }
+    }
+}
+
+void ListCtrlColumnStorage::Erase(size_t nIndex)
+{
+    ASSERT(nIndex < GetCount());
+    if (nIndex >= GetCount()) {
+        return;
+    }
+    ReleaseText(nIndex);
+    RemoveItemWidth(nIndex);
+    if (!m_itemWidths.empty()) {
+        m_itemWidths.erase(m_itemWidths.begin() + nIndex);
+    }
+    m_textRefs.erase(m_textRefs.begin() + nIndex);
+    m_textFormats.erase(m_textFormats.begin() + nIndex);
+    m_imageIds.erase(m_imageIds.begin() + nIndex);
+    m_flags.erase(m_flags.begin() + nIndex);
+    auto iter = FindColorData(nIndex);
+    if (iter != m_colors.end()) {
+        m_colors.erase(iter);
+    }
+    for (ColorData& colorData : m_colors) {
+        if (colorData.nIndex > nIndex) {
+            --colorData.nIndex;
+        }
+    }
+    CheckCompactText();
+}
+
+void ListCtrlColumnStorage::Clear()
+{
+    std::vector<TextRef>().swap(m_textRefs);
+    std::vector<DString::value_type>().swap(m_textArena);
+    m_nTextGarbage = 0;
+    std::vector<uint16_t>().swap(m_textFormats);
+    std::vector<int32_t>().swap(m_imageIds);
+    std::vector<uint8_t>().swap(m_flags);
+    std::vector<ColorData>().swap(m_colors);
+    std::vector<int32_t>().swap(m_itemWidths);
+    m_itemWidthKey.clear();
+    m_nDirtyItemWidthCount = 0;
+    m_nMaxItemWidth = 0;
+    m_bMaxItemWidthValid = true;
+}
+
+bool ListCtrlColumnStorage::ApplyOrder(const std::vector<size_t>& orders)
+{
+    const size_t nCount = GetCount();
+    ASSERT(orders.size() == nCount);
+    if (orders.size() != nCount) {
+        return false;
+    }
+    ReorderVector(m_textRefs, orders);
+    ReorderVector(m_textFormats, orders);
+    ReorderVector(m_imageIds, orders);
+    ReorderVector(m_flags, orders);
+    if (!m_itemWidths.empty()) {
+        ReorderVector(m_itemWidths, orders);
+    }
+    if (!m_colors.empty()) {
+        //稀疏表：按新的行号更新后重新排序
+        std::vector<size_t> newIndexs(nCount, 0);
+        for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+            newIndexs[orders[nIndex]] = nIndex;
+        }
+        for (ColorData& colorData : m_colors) {
+            colorData.nIndex = newIndexs[colorData.nIndex];
+        }
+        std::sort(m_colors.begin(), m_colors.end(), [](const ColorData& a, const ColorData& b) {
+                return a.nIndex < b.nIndex;
+            });
+    }
+    return true;
+}
+
+bool ListCtrlColumnStorage::HasData(size_t nIndex) const
+{
+    return (nIndex < m_flags.size()) && ((m_flags[nIndex] & kHasData) != 0);
+}
+
+void ListCtrlColumnStorage::EnsureData(size_t nIndex)
+{
+    if ((m_flags[nIndex] & kHasData) == 0) {
+        //默认值与ListCtrlSubItemData2的默认值保持一致
+        m_flags[nIndex] = kHasData | kShowCheckBox;
+        InvalidateItemWidth(nIndex);
+    }
+}
+
+bool ListCtrlColumnStorage::SetData(size_t nIndex, const ListCtrlSubItemData2& data)
+{
+    if (!SetText(nIndex, data.text.c_str())) {
+        return false;
+    }
+    m_textFormats[nIndex] = data.nTextFormat;
+    m_imageIds[nIndex] = data.nImageId;
+    SetColorData(nIndex, data.textColor, data.bkColor);
+    uint8_t nFlags = kHasData;
+    if (data.bShowCheckBox) {
+        nFlags |= kShowCheckBox;
+    }
+    if (data.bChecked) {
+        nFlags |= kChecked;
+    }
+    if (data.bEditable) {
+        nFlags |= kEditable;
+    }
+    m_flags[nIndex] = nFlags;
+    InvalidateItemWidth(nIndex);
+    return true;
+}
+
+bool ListCtrlColumnStorage::GetData(size_t nIndex, ListCtrlSubItemData2& data) const
+{
+    if (!HasData(nIndex)) {
+        data = ListCtrlSubItemData2();
+        return false;
+    }
+    if (m_textRefs[nIndex].nLength > 0) {
+        data.text = DString(GetText(nIndex), m_textRefs[nIndex].nLength);
+    }
+    else {
+        data.text.clear();
+    }
+    data.nTextFormat = m_textFormats[nIndex];
+    data.nImageId = m_imageIds[nIndex];
+    auto iter = FindColorData(nIndex);
+    if (iter != m_colors.end()) {
+        data.textColor = iter->textColor;
+        data.bkColor = iter->bkColor;
+    }
+    else {
+        data.textColor = UiColor();
+        data.bkColor = UiColor();
+    }
+    const uint8_t nFlags = m_flags[nIndex];
+    data.bShowCheckBox = (nFlags & kShowCheckBox) != 0;
+    data.bChecked = (nFlags & kChecked) != 0;
+    data.bEditable = (nFlags & kEditable) != 0;
+    return true;
+}
+
+const DString::value_type* ListCtrlColumnStorage::GetText(size_t nIndex) const
+{
+    const TextRef& textRef = m_textRefs[nIndex];
+    if (textRef.nLength == 0) {
+        return _T("");
+    }
+    return m_textArena.data() + textRef.nOffset;
+}
+
+size_t ListCtrlColumnStorage::GetTextLength(size_t nIndex) const
+{
+    return m_textRefs[nIndex].nLength;
+}
+
+bool ListCtrlColumnStorage::SetText(size_t nIndex, const DString& text)
+{
+    TextRef& textRef = m_textRefs[nIndex];
+    if (!text.empty() && (text.size() <= textRef.nLength)) {
+        //原来的空间足够，直接覆盖
+        InvalidateItemWidth(nIndex);
+        std::copy(text.begin(), text.end(), m_textArena.begin() + textRef.nOffset);
+        m_textArena[textRef.nOffset + text.size()] = _T('\0');
+        m_nTextGarbage += textRef.nLength - text.size();
+        textRef.nLength = static_cast<uint32_t>(text.size());
+        return true;
+    }
+    if (!text.empty() && !ReserveTextSpace(text.size())) {
+        //缓冲区已满（在缓冲区中的位置超出32位整数的范围），保留原来的文本
+        ASSERT(!"ListCtrlColumnStorage::SetText text arena is full!");
+        return false;
+    }
+    InvalidateItemWidth(nIndex);
+    ReleaseText(nIndex);
+    if (text.empty()) {
+        CheckCompactText();
+        return true;
+    }
+    textRef.nOffset = static_cast<uint32_t>(m_textArena.size());
+    textRef.nLength = static_cast<uint32_t>(text.size());
+    m_textArena.insert(m_textArena.end(), text.begin(), text.end());
+    m_textArena.push_back(_T('\0'));
+    CheckCompactText();
+    return true;
+}
+
+bool ListCtrlColumnStorage::ReserveTextSpace(size_t nLength)
+{
+    if ((m_textArena.size() + nLength + 1) <= UINT32_MAX) {
+        return true;
+    }
+    if (m_nTextGarbage > 0) {
+        //回收不再使用的文本后再检查
+        CompactText();
+        return (m_textArena.size() + nLength + 1) <= UINT32_MAX;
+    }
+    return false;
+}
+
+void ListCtrlColumnStorage::ReleaseText(size_t nIndex)
+{
+    TextRef& textRef = m_textRefs[nIndex];
+    if (textRef.nLength > 0) {
+        m_nTextGarbage += textRef.nLength + 1;
+    }
+    textRef.nOffset = 0;
+    textRef.nLength = 0;
+}
+
+void ListCtrlColumnStorage::CheckCompactText()
+{
+    if ((m_nTextGarbage < kMinCompactTextGarbage) || (m_nTextGarbage * 2 < m_textArena.size())) {
+        return;
+    }
+    CompactText();
+}
+
+void ListCtrlColumnStorage::CompactText()
+{
+    //按行的顺序，将使用中的文本复制到新的缓冲区
+    std::vector<DString::value_type> textArena;
+    textArena.reserve(m_textArena.size() - m_nTextGarbage);
+    for (TextRef& textRef : m_textRefs) {
+        if (textRef.nLength == 0) {
+            continue;
+        }
+        const uint32_t nOffset = static_cast<uint32_t>(textArena.size());
+        textArena.insert(textArena.end(),
+                         m_textArena.begin() + textRef.nOffset,
+                         m_textArena.begin() + textRef.nOffset + textRef.nLength + 1);
+        textRef.nOffset = nOffset;
+    }
+    m_textArena.swap(textArena);
+    m_nTextGarbage = 0;
+}
+
+void ListCtrlColumnStorage::SetTextFormat(size_t nIndex, uint16_t nTextFormat)
+{
+    if (m_textFormats[nIndex] != nTextFormat) {
+        m_textFormats[nIndex] = nTextFormat;
+        InvalidateItemWidth(nIndex);
+    }
+}
+
+void ListCtrlColumnStorage::SetImageId(size_t nIndex, int32_t nImageId)
+{
+    if (m_imageIds[nIndex] != nImageId) {
+        m_imageIds[nIndex] = nImageId;
+        InvalidateItemWidth(nIndex);
+    }
+}
+
+void ListCtrlColumnStorage::SetShowCheckBox(size_t nIndex, bool bShowCheckBox)
+{
+    if (IsShowCheckBox(nIndex) != bShowCheckBox) {
+        SetFlag(nIndex, kShowCheckBox, bShowCheckBox);
+        InvalidateItemWidth(nIndex);
+    }
+}
+
+UiColor ListCtrlColumnStorage::GetTextColor(size_t nIndex) const
+{
+    auto iter = FindColorData(nIndex);
+    return (iter != m_colors.end()) ? iter->textColor : UiColor();
+}
+
+void ListCtrlColumnStorage::SetTextColor(size_t nIndex, const UiColor& textColor)
+{
+    SetColorData(nIndex, textColor, GetBkColor(nIndex));
+}
+
+UiColor ListCtrlColumnStorage::GetBkColor(size_t nIndex) const
+{
+    auto iter = FindColorData(nIndex);
+    return (iter != m_colors.end()) ? iter->bkColor : UiColor();
+}
+
+void ListCtrlColumnStorage::SetBkColor(size_t nIndex, const UiColor& bkColor)
+{
+    SetColorData(nIndex, GetTextColor(nIndex), bkColor);
+}
+
+std::vector<ListCtrlColumnStorage::ColorData>::iterator ListCtrlColumnStorage::FindColorData(size_t nIndex)
+{
+    auto iter = std::lower_bound(m_colors.begin(), m_colors.end(), nIndex, [](const ColorData& a, size_t nIndex) {
+            return a.nIndex < nIndex;
+        });
+    if ((iter != m_colors.end()) && (iter->nIndex == nIndex)) {
+        return iter;
+    }
+    return m_colors.end();
+}
+
+std::vector<ListCtrlColumnStorage::ColorData>::const_iterator ListCtrlColumnStorage::FindColorData(size_t nIndex) const
+{
+    auto iter = std::lower_bound(m_colors.begin(), m_colors.end(), nIndex, [](const ColorData& a, size_t nIndex) {
+            return a.nIndex < nIndex;
+        });
+    if ((iter != m_colors.end()) && (iter->nIndex == nIndex)) {
+        return iter;
+    }
+    return m_colors.end();
+}
+
+void ListCtrlColumnStorage::SetColorData(size_t nIndex, const UiColor& textColor, const UiColor& bkColor)
+{
+    auto iter = std::lower_bound(m_colors.begin(), m_colors.end(), nIndex, [](const ColorData& a, size_t nIndex) {
+            return a.nIndex < nIndex;
+        });
+    const bool bFound = (iter != m_colors.end()) && (iter->nIndex == nIndex);
+    if (textColor.IsEmpty() && bkColor.IsEmpty()) {
+        if (bFound) {
+            m_colors.erase(iter);
+        }
+    }
+    else if (bFound) {
+        iter->textColor = textColor;
+        iter->bkColor = bkColor;
+    }
+    else {
+        m_colors.insert(iter, ColorData{ nIndex, textColor, bkColor });
+    }
+}
+
+void ListCtrlColumnStorage::SetFlag(size_t nIndex, uint8_t nFlag, bool bSet)
+{
+    if (bSet) {
+        m_flags[nIndex] |= nFlag;
+    }
+    else {
+        m_flags[nIndex] &= static_cast<uint8_t>(~nFlag);
+    }
+}
+
+void ListCtrlColumnStorage::SetAllChecked(bool bChecked)
+{
+    const size_t nCount = GetCount();
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        EnsureData(nIndex);
+        SetChecked(nIndex, bChecked);
+    }
+}
+
+size_t ListCtrlColumnStorage::GetMemorySize() const
+{
+    return m_textRefs.capacity() * sizeof(TextRef) +
+           m_textArena.capacity() * sizeof(DString::value_type) +
+           m_textFormats.capacity() * sizeof(uint16_t) +
+           m_imageIds.capacity() * sizeof(int32_t) +
+           m_flags.capacity() * sizeof(uint8_t) +
+           m_colors.capacity() * sizeof(ColorData) +
+           m_itemWidths.capacity() * sizeof(int32_t);
+}
+
+void ListCtrlColumnStorage::CheckItemWidthKey(const DString& measureKey) const
+{
+    const size_t nCount = GetCount();
+    if ((m_itemWidths.size() == nCount) && (m_itemWidthKey == measureKey)) {
+        return;
+    }
+    //首次使用或者测量标识变化：所有有文本的行都需要重新测量
+    m_itemWidthKey = measureKey;
+    m_itemWidths.assign(nCount, 0);
+    m_nDirtyItemWidthCount = 0;
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        if (HasData(nIndex) && (m_textRefs[nIndex].nLength > 0)) {
+            m_itemWidths[nIndex] = -1;
+            ++m_nDirtyItemWidthCount;
+        }
+    }
+    m_nMaxItemWidth = 0;
+    m_bMaxItemWidthValid = true;
+}
+
+void ListCtrlColumnStorage::GetDirtyItemWidths(std::vector<size_t>& itemIndexs) const
+{
+    itemIndexs.clear();
+    if (m_nDirtyItemWidthCount == 0) {
+        return;
+    }
+    const size_t nCount = m_itemWidths.size();
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        if (m_itemWidths[nIndex] != -1) {
+            continue;
+        }
+        if (HasData(nIndex) && (m_textRefs[nIndex].nLength > 0)) {
+            itemIndexs.push_back(nIndex);
+        }
+        else {
+            //没有数据或者文本为空的行，不需要测量
+            m_itemWidths[nIndex] = 0;
+            --m_nDirtyItemWidthCount;
+        }
+    }
+}
+
+void ListCtrlColumnStorage::SetItemWidth(size_t nIndex, int32_t nWidth) const
+{
+    ASSERT(nIndex < m_itemWidths.size());
+    if (nIndex >= m_itemWidths.size()) {
+        return;
+    }
+    if (nWidth < 0) {
+        nWidth = 0;
+    }
+    int32_t& nItemWidth = m_itemWidths[nIndex];
+    if (nItemWidth == -1) {
+        ASSERT(m_nDirtyItemWidthCount > 0);
+        --m_nDirtyItemWidthCount;
+    }
+    else if (m_bMaxItemWidthValid && (nItemWidth > nWidth) && (nItemWidth >= m_nMaxItemWidth)) {
+        m_bMaxItemWidthValid = false;
+    }
+    nItemWidth = nWidth;
+    if (m_bMaxItemWidthValid && (nWidth > m_nMaxItemWidth)) {
+        m_nMaxItemWidth = nWidth;
+    }
+}
+
+int32_t ListCtrlColumnStorage::GetMaxItemWidth() const
+{
+    if (!m_bMaxItemWidthValid) {
+        int32_t nMaxWidth = 0;
+        for (int32_t nWidth : m_itemWidths) {
+            if (nWidth > nMaxWidth) {
+                nMaxWidth = nWidth;
+            }
+        }
+        m_nMaxItemWidth = nMaxWidth;
+        m_bMaxItemWidthValid = true;
+    }
+    return m_nMaxItemWidth;
+}
+
+void ListCtrlColumnStorage::InvalidateItemWidth(size_t nIndex)
+{
+    if (nIndex >= m_itemWidths.size()) {
+        return;
+    }
+    int32_t& nItemWidth = m_itemWidths[nIndex];
+    if (nItemWidth == -1) {
+        return;
+    }
+    if (m_bMaxItemWidthValid && (nItemWidth > 0) && (nItemWidth >= m_nMaxItemWidth)) {
+        //最大值所在的行被修改，下次获取时重新查找
+        m_bMaxItemWidthValid = false;
+    }
+    nItemWidth = -1;
+    ++m_nDirtyItemWidthCount;
+}
+
+void ListCtrlColumnStorage::RemoveItemWidth(size_t nIndex)
+{
+    if (nIndex >= m_itemWidths.size()) {
+        return;
+    }
+    const int32_t nItemWidth = m_itemWidths[nIndex];
+    if (nItemWidth == -1) {
+        ASSERT(m_nDirtyItemWidthCount > 0);
+        --m_nDirtyItemWidthCount;
+    }
+    else if (m_bMaxItemWidthValid && (nItemWidth > 0) && (nItemWidth >= m_nMaxItemWidth)) {
+        m_bMaxItemWidthValid = false;
+    }
+}
+
+} //namespace ui
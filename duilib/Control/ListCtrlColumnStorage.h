@@ -0,0 +1,261 @@
+#ifndef UI_CONTROL_LIST_CTRL_COLUMN_STORAGE_H_
+#define UI_CONTROL_LIST_CTRL_COLUMN_STORAGE_H_
+
+#include "duilib/Control/ListCtrlDefs.h"
+#include <vector>
+
+namespace ui
+{
+/** ListCtrl一列数据的存储（按列存储，每个属性一个数组）
+*   (1) 文本格式、图标、标志位等属性，每个属性一个连续的数组，不需要为每个单元格单独分配内存
+*   (2) 文本保存在一块连续的字符缓冲区中（以'\0'结尾），数组中只保存文本在缓冲区中的位置和长度
+*   (3) 文本颜色和背景颜色很少设置，保存在按行号排序的稀疏表中
+*   注意：只能在UI线程中使用
+*/
+class ListCtrlColumnStorage
+{
+public:
+    ListCtrlColumnStorage();
+
+public:
+    /** 获取行数
+    */
+    size_t GetCount() const { return m_flags.size(); }
+
+    /** 设置行数（新增的行没有数据）
+    */
+    void Resize(size_t nCount);
+
+    /** 在指定位置插入一个没有数据的行
+    * @param [in] nIndex 插入位置，如果等于GetCount()表示在最后添加
+    */
+    void InsertEmpty(size_t nIndex);
+
+    /** 删除一行
+    */
+    void Erase(size_t nIndex);
+
+    /** 清空所有行
+    */
+    void Clear();
+
+    /** 按指定顺序调整行的顺序：调整后的第i行，为调整前的第orders[i]行
+    * @param [in] orders 行的顺序，个数必须与GetCount()相同
+    */
+    bool ApplyOrder(const std::vector<size_t>& orders);
+
+public:
+    /** 该行是否有数据（没有数据的行，界面上显示为默认属性）
+    */
+    bool HasData(size_t nIndex) const;
+
+    /** 标记该行有数据，如果原来没有数据，设置为默认值
+    */
+    void EnsureData(size_t nIndex);
+
+    /** 设置一行的数据
+    * @return 如果文本缓冲区已满（压缩后仍无法容纳文本），返回false，该行的数据保持不变
+    */
+    bool SetData(size_t nIndex, const ListCtrlSubItemData2& data);
+
+    /** 获取一行的数据
+    * @return 如果该行没有数据，返回false
+    */
+    bool GetData(size_t nIndex, ListCtrlSubItemData2& data) const;
+
+    /** 获取文本（以'\0'结尾，该指针在数据修改后失效）
+    */
+    const DString::value_type* GetText(size_t nIndex) const;
+
+    /** 获取文本长度
+    */
+    size_t GetTextLength(size_t nIndex) const;
+
+    /** 设置文本
+    * @return 如果文本缓冲区已满（压缩后仍无法容纳文本），返回false，原来的文本保持不变
+    */
+    bool SetText(size_t nIndex, const DString& text);
+
+    /** 文本格式
+    */
+    uint16_t GetTextFormat(size_t nIndex) const { return m_textFormats[nIndex]; }
+    void SetTextFormat(size_t nIndex, uint16_t nTextFormat);
+
+    /** 图标资源Id
+    */
+    int32_t GetImageId(size_t nIndex) const { return m_imageIds[nIndex]; }
+    void SetImageId(size_t nIndex, int32_t nImageId);
+
+    /** 文本颜色
+    */
+    UiColor GetTextColor(size_t nIndex) const;
+    void SetTextColor(size_t nIndex, const UiColor& textColor);
+
+    /** 背景颜色
+    */
+    UiColor GetBkColor(size_t nIndex) const;
+    void SetBkColor(size_t nIndex, const UiColor& bkColor);
+
+    /** 是否显示CheckBox
+    */
+    bool IsShowCheckBox(size_t nIndex) const { return (m_flags[nIndex] & kShowCheckBox) != 0; }
+    void SetShowCheckBox(size_t nIndex, bool bShowCheckBox);
+
+    /** CheckBox是否勾选
+    */
+    bool IsChecked(size_t nIndex) const { return (m_flags[nIndex] & kChecked) != 0; }
+    void SetChecked(size_t nIndex, bool bChecked) { SetFlag(nIndex, kChecked, bChecked); }
+
+    /** 是否可编辑
+    */
+    bool IsEditable(size_t nIndex) const { return (m_flags[nIndex] & kEditable) != 0; }
+    void SetEditable(size_t nIndex, bool bEditable) { SetFlag(nIndex, kEditable, bEditable); }
+
+    /** 设置所有行的勾选状态（没有数据的行，设置为默认值后再勾选）
+    */
+    void SetAllChecked(bool bChecked);
+
+    /** 估算占用的内存大小（字节）
+    */
+    size_t GetMemorySize() const;
+
+public:
+    /** 数据项宽度的缓存（用于自动调整列宽）：首次使用时创建，数据修改时只将修改的行标记为需要重新测量
+    *   测量标识（字体、DPI等）变化时，所有行都需要重新测量
+    * @param [in] measureKey 测量标识
+    */
+    void CheckItemWidthKey(const DString& measureKey) const;
+
+    /** 获取需要重新测量宽度的行
+    */
+    void GetDirtyItemWidths(std::vector<size_t>& itemIndexs) const;
+
+    /** 设置测量后的宽度
+    */
+    void SetItemWidth(size_t nIndex, int32_t nWidth) const;
+
+    /** 获取已测量的宽度最大值（如果最大值所在的行被修改或者删除，在已测量的宽度中重新查找）
+    */
+    int32_t GetMaxItemWidth() const;
+
+private:
+    /** 标志位
+    */
+    enum : uint8_t
+    {
+        kHasData      = 0x01,   //该行有数据
+        kShowCheckBox = 0x02,   //显示CheckBox
+        kChecked      = 0x04,   //CheckBox勾选
+        kEditable     = 0x08    //可编辑
+    };
+
+    /** 文本在缓冲区中的位置
+    */
+    struct TextRef
+    {
+        uint32_t nOffset;
+        uint32_t nLength;
+    };
+
+    /** 颜色数据（稀疏表）
+    */
+    struct ColorData
+    {
+        size_t nIndex;          //行号
+        UiColor textColor;      //文本颜色
+        UiColor bkColor;        //背景颜色
+    };
+
+private:
+    /** 设置标志位
+    */
+    void SetFlag(size_t nIndex, uint8_t nFlag, bool bSet);
+
+    /** 释放一行的文本（在缓冲区中的空间，在压缩时回收）
+    */
+    void ReleaseText(size_t nIndex);
+
+    /** 无用的文本过多时，压缩文本缓冲区
+    */
+    void CheckCompactText();
+
+    /** 压缩文本缓冲区：按行的顺序，只保留使用中的文本
+    */
+    void CompactText();
+
+    /** 文本缓冲区中是否还能追加指定长度的文本（文本在缓冲区中的位置为32位整数）
+    *   如果空间不足，先压缩文本缓冲区再检查
+    * @param [in] nLength 文本长度（不含结尾的'\0'）
+    */
+    bool ReserveTextSpace(size_t nLength);
+
+    /** 查找行的颜色数据
+    */
+    std::vector<ColorData>::iterator FindColorData(size_t nIndex);
+    std::vector<ColorData>::const_iterator FindColorData(size_t nIndex) const;
+
+    /** 设置行的颜色数据，两种颜色都为空时删除
+    */
+    void SetColorData(size_t nIndex, const UiColor& textColor, const UiColor& bkColor);
+
+    /** 影响宽度的数据修改后，标记该行需要重新测量宽度
+    */
+    void InvalidateItemWidth(size_t nIndex);
+
+    /** 行被删除前，更新宽度缓存
+    */
+    void RemoveItemWidth(size_t nIndex);
+
+private:
+    /** 每行文本在缓冲区中的位置
+    */
+    std::vector<TextRef> m_textRefs;
+
+    /** 文本缓冲区
+    */
+    std::vector<DString::value_type> m_textArena;
+
+    /** 文本缓冲区中，已经不再使用的字符个数
+    */
+    size_t m_nTextGarbage;
+
+    /** 每行的文本格式
+    */
+    std::vector<uint16_t> m_textFormats;
+
+    /** 每行的图标资源Id
+    */
+    std::vector<int32_t> m_imageIds;
+
+    /** 每行的标志位
+    */
+    std::vector<uint8_t> m_flags;
+
+    /** 设置了颜色的行（按行号排序）
+    */
+    std::vector<ColorData> m_colors;
+
+    /** 每行的宽度缓存：-1表示需要重新测量，0表示无需测量（没有数据或者文本为空）；为空表示未启用缓存
+    */
+    mutable std::vector<int32_t> m_itemWidths;
+
+    /** 宽度缓存对应的测量标识
+    */
+    mutable DString m_itemWidthKey;
+
+    /** 需要重新测量宽度的行数
+    */
+    mutable size_t m_nDirtyItemWidthCount;
+
+    /** 已测量的宽度最大值
+    */
+    mutable int32_t m_nMaxItemWidth;
+
+    /** 已测量的宽度最大值是否有效
+    */
+    mutable bool m_bMaxItemWidthValid;
+};
+
+} //namespace ui
+
+#endif //UI_CONTROL_LIST_CTRL_COLUMN_STORAGE_H_
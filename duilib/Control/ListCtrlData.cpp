@@ -1,11 +1,36 @@
 #include "ListCtrlData.h"
 #include "duilib/Control/ListCtrl.h"
 #include "duilib/Core/GlobalManager.h"
+#include "duilib/Core/FrameworkThread.h"
 #include <unordered_map>
 #include <set>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
 
 namespace ui
 {
+//过滤时，每批检查的时间限制（毫秒），首批在设置过滤条件时立即检查，保证输入时能及时看到结果
+static const int64_t kFilterBatchTimeMs = 8;
+
+//过滤时，分批检查的定时器间隔（毫秒）
+static const uint32_t kFilterTimerMs = 10;
+
+//过滤时，每检查多少行，检查一次是否超时
+static const size_t kFilterCheckTimeRows = 256;
+
+//行数达到该值时，才建立搜索索引（行数较少时，逐行检查已经足够快）
+static const size_t kMinSearchIndexRows = 10000;
+
+//并行排序时，每个线程最少排序的行数（行数较少时，单线程排序）
+static const size_t kMinParallelSortCount = 32 * 1024;
+
+//并行排序时，最多使用的线程个数（含当前线程）
+static const size_t kMaxParallelSortThreads = 4;
+
 ListCtrlData::ListCtrlData() :
     m_pListView(nullptr),
     m_pfnCompareFunc(nullptr),
@@ -17,10 +42,24 @@ ListCtrlData::ListCtrlData() :
     m_nSelectedIndex(Box::InvalidIndex),
     m_nDefaultTextStyle(0),
     m_nDefaultItemHeight(-1),
-    m_bAutoCheckSelect(false)
+    m_bAutoCheckSelect(false),
+    m_bRowHeightIndexDirty(false),
+    m_nAtTopRowsHeight(0),
+    m_bAtTopRowListDirty(false),
+    m_nFilterHideCount(0),
+    m_bFilterScanAll(false),
+    m_nFilterPendingPos(0)
 {
 }
 
+ListCtrlData::~ListCtrlData()
+{
+    for (std::unique_ptr<FrameworkThread>& pThread : m_sortThreads) {
+        pThread->Stop();
+    }
+    m_sortThreads.clear();
+}
+
 Control* ListCtrlData::CreateElement(ui::VirtualListBox* pVirtualListBox)
 {
     ASSERT(pVirtualListBox != nullptr);
@@ -45,7 +84,8 @@ bool ListCtrlData::FillElement(Control* pControl, size_t nElementIndex)
     }
     const ListCtrlItemData& itemData = m_rowDataList[nElementIndex];
     std::vector<ListCtrlSubItemData2Pair> subItemList;
-    if (!GetSubItemStorageList(nElementIndex, subItemList)) {
+    std::vector<Storage> storageList;
+    if (!GetSubItemStorageList(nElementIndex, subItemList, storageList)) {
         return false;
     }
 
@@ -59,28 +99,65 @@ bool ListCtrlData::FillElement(Control* pControl, size_t nElementIndex)
 
 int32_t ListCtrlData::GetMaxColumnWidth(size_t columnId) const
 {
-    int32_t nMaxWidth = -1;
-    std::vector<ListCtrlSubItemData2Ptr> subItemList;
     auto iter = m_dataMap.find(columnId);
     ASSERT(iter != m_dataMap.end());
-    if (iter != m_dataMap.end()) {
-        const StoragePtrList& storageList = iter->second;
-        const size_t nCount = storageList.size();
-        for (size_t index = 0; index < nCount; ++index) {
-            if (storageList[index] != nullptr) {
-                subItemList.push_back(storageList[index]);
-            }
-        }
+    if (iter == m_dataMap.end()) {
+        return -1;
+    }
+    ASSERT(m_pListView != nullptr);
+    if (m_pListView == nullptr) {
+        return -1;
+    }
+    const DString measureKey = m_pListView->GetDataItemMeasureKey();
+    if (measureKey.empty()) {
+        return -1;
+    }
+    //每列缓存每行的宽度，只测量新增或者修改过的行；数据没有变化时，直接返回缓存的最大值
+    const ListCtrlColumnStorage& columnStorage = iter->second;
+    columnStorage.CheckItemWidthKey(measureKey);
+    std::vector<size_t> dirtyIndexs;
+    columnStorage.GetDirtyItemWidths(dirtyIndexs);
+
+    //分批测量，避免一次生成过多的临时数据
+    const size_t nBatchSize = 4096;
+    std::vector<Storage> storageList;
+    std::vector<ListCtrlSubItemData2ConstPtr> subItemList;
+    std::vector<int32_t> itemWidths;
+    for (size_t nStart = 0; nStart < dirtyIndexs.size(); nStart += nBatchSize) {
+        const size_t nEnd = std::min(nStart + nBatchSize, dirtyIndexs.size());
+        storageList.resize(nEnd - nStart);
+        subItemList.clear();
+        for (size_t index = nStart; index < nEnd; ++index) {
+            Storage& storage = storageList[index - nStart];
+            columnStorage.GetData(dirtyIndexs[index], storage);
+            subItemList.push_back(&storage);
+        }
+        if (!m_pListView->MeasureDataItemWidths(subItemList, itemWidths) ||
+            (itemWidths.size() != subItemList.size())) {
+            return -1;
+        }
+        for (size_t index = nStart; index < nEnd; ++index) {
+            columnStorage.SetItemWidth(dirtyIndexs[index], itemWidths[index - nStart]);
+        }
+    }
+    int32_t nMaxWidth = columnStorage.GetMaxItemWidth();
+    if (nMaxWidth <= 0) {
+        nMaxWidth = -1;
     }
-    if (!subItemList.empty()) {
-        ASSERT(m_pListView != nullptr);
-        if (m_pListView != nullptr) {
-            nMaxWidth = m_pListView->GetMaxDataItemWidth(subItemList);
-        }
-    }    
     return nMaxWidth;
 }
 
+size_t ListCtrlData::GetStorageMemorySize() const
+{
+    size_t nMemorySize = m_rowDataList.capacity() * sizeof(ListCtrlItemData);
+    nMemorySize += m_filterStates.capacity() * sizeof(uint8_t);
+    nMemorySize += m_searchIndex.GetMemorySize();
+    for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
+        nMemorySize += iter->second.GetMemorySize();
+    }
+    return nMemorySize;
+}
+
 size_t ListCtrlData::GetElementCount() const
 {
     return GetDataItemCount();
@@ -203,7 +280,10 @@ void ListCtrlData::SetDefaultTextStyle(int32_t nTextStyle)
 
 void ListCtrlData::SetDefaultItemHeight(int32_t nItemHeight)
 {
-    m_nDefaultItemHeight = nItemHeight;
+    if (m_nDefaultItemHeight != nItemHeight) {
+        m_nDefaultItemHeight = nItemHeight;
+        InvalidateRowHeightIndex();
+    }
 }
 
 void ListCtrlData::ChangeDpiScale(const DpiManager& dpiManager, uint32_t nOldDpiScale)
@@ -213,6 +293,7 @@ void ListCtrlData::ChangeDpiScale(const DpiManager& dpiManager, uint32_t nOldDpi
             data.nItemHeight = ui::TruncateToUInt16(dpiManager.GetScaleInt((int32_t)data.nItemHeight, nOldDpiScale));
         }
     }
+    InvalidateRowHeightIndex();
 }
 
 void ListCtrlData::SubItemToStorage(const ListCtrlSubItemData& item, Storage& storage) const
@@ -265,9 +346,9 @@ bool ListCtrlData::AddColumn(size_t columnId)
     if ((columnId == Box::InvalidIndex) || (columnId == 0)) {
         return false;
     }
-    StoragePtrList& storageList = m_dataMap[columnId];
+    ListCtrlColumnStorage& columnStorage = m_dataMap[columnId];
     //列的长度与行保持一致
-    storageList.resize(m_rowDataList.size());
+    columnStorage.Resize(m_rowDataList.size());
     EmitCountChanged();
     return true;
 }
@@ -277,13 +358,33 @@ bool ListCtrlData::RemoveColumn(size_t columnId)
     auto iter = m_dataMap.find(columnId);
     if (iter != m_dataMap.end()) {
         m_dataMap.erase(iter);
+        auto iterFilter = std::find(m_filterColumnIds.begin(), m_filterColumnIds.end(), columnId);
+        if (iterFilter != m_filterColumnIds.end()) {
+            //参与查询的列被删除，搜索索引失效，过滤结果需要重新检查
+            m_filterColumnIds.erase(iterFilter);
+            ClearSearchIndex();
+            if (m_filterColumnIds.empty()) {
+                ClearFilter();
+            }
+            else if (IsFilterActive()) {
+                RestartFilter();
+            }
+        }
         if (m_dataMap.empty()) {
             //如果所有列都删除了，行也清空为0
             m_rowDataList.clear();
+            m_storageOrder.clear();
+            m_displayOrder.clear();
             m_nSelectedIndex = Box::InvalidIndex;
             m_hideRowCount = 0;
             m_heightRowCount = 0;
             m_atTopRowCount = 0;
+            m_filterFlag.Cancel();
+            m_filterStates.clear();
+            m_nFilterHideCount = 0;
+            m_filterPendingRows.clear();
+            m_nFilterPendingPos = 0;
+            m_bFilterScanAll = false;
         }
         EmitCountChanged();
         return true;
@@ -297,13 +398,23 @@ bool ListCtrlData::SetColumnCheck(size_t columnId, bool bChecked, bool bRefresh)
     auto iter = m_dataMap.find(columnId);
     ASSERT(iter != m_dataMap.end());
     if (iter != m_dataMap.end()) {
-        StoragePtrList& storageList = iter->second;
-        const size_t nCount = storageList.size();
-        for (size_t index = 0; index < nCount; ++index) {
-            if (storageList[index] == nullptr) {
-                storageList[index] = std::make_shared<Storage>();
+        ListCtrlColumnStorage& columnStorage = iter->second;
+        if (m_nFilterHideCount == 0) {
+            columnStorage.SetAllChecked(bChecked);
+        }
+        else {
+            //被过滤隐藏的行，保持原来的勾选状态
+            const size_t nCount = m_rowDataList.size();
+            for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
+                if (IsRowFilteredOut(itemIndex)) {
+                    continue;
+                }
+                const size_t nStorageIndex = GetStorageIndex(itemIndex);
+                if (nStorageIndex < columnStorage.GetCount()) {
+                    columnStorage.EnsureData(nStorageIndex);
+                    columnStorage.SetChecked(nStorageIndex, bChecked);
+                }
             }
-            storageList[index]->bChecked = bChecked;
         }
         bRet = true;
     }
@@ -313,63 +424,122 @@ bool ListCtrlData::SetColumnCheck(size_t columnId, bool bChecked, bool bRefresh)
     return bRet;
 }
 
-ListCtrlData::StoragePtr ListCtrlData::GetSubItemStorage(
-    size_t itemIndex, size_t nColumnId) const
+size_t ListCtrlData::GetStorageIndex(size_t itemIndex) const
+{
+    if (m_storageOrder.empty()) {
+        return itemIndex;
+    }
+    return (itemIndex < m_storageOrder.size()) ? m_storageOrder[itemIndex] : Box::InvalidIndex;
+}
+
+size_t ListCtrlData::GetDisplayIndex(size_t nStorageIndex) const
+{
+    if (m_displayOrder.empty()) {
+        return nStorageIndex;
+    }
+    return (nStorageIndex < m_displayOrder.size()) ? m_displayOrder[nStorageIndex] : Box::InvalidIndex;
+}
+
+void ListCtrlData::RebuildDisplayOrder()
+{
+    const size_t nCount = m_storageOrder.size();
+    m_displayOrder.resize(nCount);
+    for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
+        ASSERT(m_storageOrder[itemIndex] < nCount);
+        m_displayOrder[m_storageOrder[itemIndex]] = itemIndex;
+    }
+}
+
+void ListCtrlData::ApplyStorageOrder()
 {
-    StoragePtr pStorage;
+    if (m_storageOrder.empty()) {
+        return;
+    }
+    for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
+        iter->second.ApplyOrder(m_storageOrder);
+    }
+    if (m_filterStates.size() == m_storageOrder.size()) {
+        std::vector<uint8_t> filterStates;
+        filterStates.reserve(m_filterStates.size());
+        for (size_t nStorageIndex : m_storageOrder) {
+            filterStates.push_back(m_filterStates[nStorageIndex]);
+        }
+        m_filterStates.swap(filterStates);
+    }
+    std::vector<size_t>().swap(m_storageOrder);
+    std::vector<size_t>().swap(m_displayOrder);
+    //存储中的行号发生变化
+    ClearSearchIndex();
+    if (!IsFilterCompleted()) {
+        RestartFilter();
+    }
+}
+
+const ListCtrlColumnStorage* ListCtrlData::GetSubItemStorage(size_t itemIndex, size_t nColumnId,
+                                                             size_t& nStorageIndex) const
+{
+    nStorageIndex = Box::InvalidIndex;
+    const ListCtrlColumnStorage* pColumnStorage = nullptr;
     auto iter = m_dataMap.find(nColumnId);
     ASSERT(iter != m_dataMap.end());
     if (iter != m_dataMap.end()) {
-        const StoragePtrList& storageList = iter->second;
-        ASSERT(itemIndex < storageList.size());
-        if (itemIndex < storageList.size()) {
-            //关联列：获取数据
-            pStorage = storageList[itemIndex];
+        ASSERT(itemIndex < iter->second.GetCount());
+        if (itemIndex < iter->second.GetCount()) {
+            const size_t nIndex = GetStorageIndex(itemIndex);
+            if (iter->second.HasData(nIndex)) {
+                //关联列：该行有数据
+                pColumnStorage = &iter->second;
+                nStorageIndex = nIndex;
+            }
         }
     }
-    return pStorage;
+    return pColumnStorage;
 }
 
-ListCtrlData::StoragePtr ListCtrlData::GetSubItemStorageForWrite(
-    size_t itemIndex, size_t nColumnId)
+ListCtrlColumnStorage* ListCtrlData::GetSubItemStorageForWrite(size_t itemIndex, size_t nColumnId,
+                                                               size_t& nStorageIndex)
 {
-    StoragePtr pStorage;
+    nStorageIndex = Box::InvalidIndex;
+    ListCtrlColumnStorage* pColumnStorage = nullptr;
     auto iter = m_dataMap.find(nColumnId);
     ASSERT(iter != m_dataMap.end());
     if (iter != m_dataMap.end()) {
-        StoragePtrList& storageList = iter->second;
-        ASSERT(itemIndex < storageList.size());
-        if (itemIndex < storageList.size()) {
-            //关联列：获取数据
-            pStorage = storageList[itemIndex];
-            if (pStorage == nullptr) {
-                pStorage = std::make_shared<Storage>();
-                storageList[itemIndex] = pStorage;
-            }
+        ASSERT(itemIndex < iter->second.GetCount());
+        if (itemIndex < iter->second.GetCount()) {
+            //关联列：该行没有数据时，先设置为默认值
+            pColumnStorage = &iter->second;
+            nStorageIndex = GetStorageIndex(itemIndex);
+            pColumnStorage->EnsureData(nStorageIndex);
         }
     }
-    return pStorage;
+    return pColumnStorage;
 }
 
-bool ListCtrlData::GetSubItemStorageList(size_t itemIndex, std::vector<ListCtrlSubItemData2Pair>& subItemList) const
+bool ListCtrlData::GetSubItemStorageList(size_t itemIndex,
+                                         std::vector<ListCtrlSubItemData2Pair>& subItemList,
+                                         std::vector<Storage>& storageList) const
 {
     subItemList.clear();
+    storageList.clear();
     ASSERT(itemIndex < m_rowDataList.size());
     if (itemIndex >= m_rowDataList.size()) {
         return false;
     }
-    ListCtrlSubItemData2Pair dataPair;
-    for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
-        dataPair.nColumnId = iter->first;        
-        const StoragePtrList& dataList = iter->second;
-        ASSERT(itemIndex < dataList.size());
-        if (itemIndex < dataList.size()) {
-            dataPair.pSubItemData = dataList.at(itemIndex);
+    //先读取所有列的数据，再填充指针（避免容器扩容导致指针失效）
+    storageList.resize(m_dataMap.size());
+    subItemList.resize(m_dataMap.size());
+    size_t nColumn = 0;
+    for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter, ++nColumn) {
+        ListCtrlSubItemData2Pair& dataPair = subItemList[nColumn];
+        dataPair.nColumnId = iter->first;
+        const ListCtrlColumnStorage& columnStorage = iter->second;
+        ASSERT(itemIndex < columnStorage.GetCount());
+        if (columnStorage.GetData(GetStorageIndex(itemIndex), storageList[nColumn])) {
+            dataPair.pSubItemData = &storageList[nColumn];
         }
         else {
             dataPair.pSubItemData = nullptr;
         }
-        subItemList.push_back(dataPair);
     }
     return true;
 }
@@ -382,7 +552,153 @@ const ListCtrlData::RowDataList& ListCtrlData::GetItemDataList() const
 bool ListCtrlData::IsNormalMode() const
 {
     ASSERT((m_hideRowCount >= 0) && (m_heightRowCount >= 0) && (m_atTopRowCount >= 0));
-    return (m_hideRowCount == 0) && (m_heightRowCount == 0) && (m_atTopRowCount == 0);
+    return (m_hideRowCount == 0) && (m_heightRowCount == 0) && (m_atTopRowCount == 0) && (m_nFilterHideCount == 0);
+}
+
+bool ListCtrlData::IsRowVisible(size_t itemIndex) const
+{
+    if ((itemIndex >= m_rowDataList.size()) || !m_rowDataList[itemIndex].bVisible) {
+        return false;
+    }
+    if (m_nFilterHideCount == 0) {
+        return true;
+    }
+    const size_t nStorageIndex = GetStorageIndex(itemIndex);
+    return (nStorageIndex >= m_filterStates.size()) || (m_filterStates[nStorageIndex] != 0);
+}
+
+int32_t ListCtrlData::GetRowScrollHeight(const ListCtrlItemData& rowData) const
+{
+    if (!rowData.bVisible || (rowData.nAlwaysAtTop >= 0)) {
+        //隐藏行和置顶行，不占用滚动区域的高度
+        return 0;
+    }
+    int32_t nItemHeight = (rowData.nItemHeight < 0) ? m_nDefaultItemHeight : rowData.nItemHeight;
+    return std::max(nItemHeight, 0);
+}
+
+int32_t ListCtrlData::GetRowScrollHeight(size_t itemIndex) const
+{
+    if (!IsRowVisible(itemIndex)) {
+        return 0;
+    }
+    return GetRowScrollHeight(m_rowDataList[itemIndex]);
+}
+
+void ListCtrlData::UpdateRowHeightIndex(size_t itemIndex, const ListCtrlItemData& oldRowData)
+{
+    ASSERT(itemIndex < m_rowDataList.size());
+    if (itemIndex >= m_rowDataList.size()) {
+        return;
+    }
+    const ListCtrlItemData& rowData = m_rowDataList[itemIndex];
+    if ((rowData.bVisible == oldRowData.bVisible) &&
+        (rowData.nItemHeight == oldRowData.nItemHeight) &&
+        (rowData.nAlwaysAtTop == oldRowData.nAlwaysAtTop)) {
+        //与高度相关的属性无变化
+        return;
+    }
+    if (!m_bRowHeightIndexDirty) {
+        ASSERT(m_rowHeightIndex.GetCount() == m_rowDataList.size());
+        m_rowHeightIndex.SetHeight(itemIndex, GetRowScrollHeight(itemIndex));
+    }
+    if ((rowData.nAlwaysAtTop >= 0) || (oldRowData.nAlwaysAtTop >= 0)) {
+        m_bAtTopRowListDirty = true;
+    }
+}
+
+void ListCtrlData::InvalidateRowHeightIndex()
+{
+    m_bRowHeightIndexDirty = true;
+    m_bAtTopRowListDirty = true;
+}
+
+void ListCtrlData::CheckRowHeightIndex() const
+{
+    if (!m_bRowHeightIndexDirty && (m_rowHeightIndex.GetCount() == m_rowDataList.size())) {
+        return;
+    }
+    const size_t nCount = m_rowDataList.size();
+    std::vector<int32_t> heights;
+    heights.reserve(nCount);
+    for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
+        heights.push_back(GetRowScrollHeight(itemIndex));
+    }
+    m_rowHeightIndex.Assign(heights);
+    m_bRowHeightIndexDirty = false;
+}
+
+void ListCtrlData::CheckAtTopRowList() const
+{
+    if (!m_bAtTopRowListDirty) {
+        return;
+    }
+    m_bAtTopRowListDirty = false;
+    m_atTopRowList.clear();
+    m_nAtTopRowsHeight = 0;
+    if (m_atTopRowCount <= 0) {
+        return;
+    }
+    const size_t nCount = m_rowDataList.size();
+    for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
+        const ListCtrlItemData& rowData = m_rowDataList[itemIndex];
+        if ((rowData.nAlwaysAtTop < 0) || !IsRowVisible(itemIndex)) {
+            continue;
+        }
+        int32_t nItemHeight = (rowData.nItemHeight < 0) ? m_nDefaultItemHeight : rowData.nItemHeight;
+        if (nItemHeight <= 0) {
+            continue;
+        }
+        m_atTopRowList.push_back(itemIndex);
+        m_nAtTopRowsHeight += nItemHeight;
+    }
+    //nAlwaysAtTop值大的，排在前面
+    std::stable_sort(m_atTopRowList.begin(), m_atTopRowList.end(),
+        [this](size_t a, size_t b) {
+            return m_rowDataList[a].nAlwaysAtTop > m_rowDataList[b].nAlwaysAtTop;
+        });
+}
+
+int64_t ListCtrlData::GetRowsHeight(size_t itemIndex) const
+{
+    CheckRowHeightIndex();
+    return m_rowHeightIndex.GetPrefixHeight(itemIndex);
+}
+
+int64_t ListCtrlData::GetAtTopRowsHeight() const
+{
+    CheckAtTopRowList();
+    return m_nAtTopRowsHeight;
+}
+
+const std::vector<size_t>& ListCtrlData::GetAtTopRowList() const
+{
+    CheckAtTopRowList();
+    return m_atTopRowList;
+}
+
+size_t ListCtrlData::FindRowByOffset(int64_t nOffset) const
+{
+    CheckRowHeightIndex();
+    if ((nOffset < 0) || (nOffset >= m_rowHeightIndex.GetTotalHeight())) {
+        return Box::InvalidIndex;
+    }
+    return m_rowHeightIndex.FindIndexByOffset(nOffset, 0);
+}
+
+size_t ListCtrlData::GetNextRow(size_t itemIndex) const
+{
+    CheckRowHeightIndex();
+    const size_t nNextIndex = itemIndex + 1;
+    if (nNextIndex >= m_rowHeightIndex.GetCount()) {
+        return Box::InvalidIndex;
+    }
+    if (m_rowHeightIndex.GetHeight(nNextIndex) > 0) {
+        //大多数情况下，下一行即是可见行
+        return nNextIndex;
+    }
+    //跳过连续的隐藏行或置顶行
+    return FindRowByOffset(m_rowHeightIndex.GetPrefixHeight(nNextIndex));
 }
 
 size_t ListCtrlData::GetDataItemCount() const
@@ -390,7 +706,7 @@ size_t ListCtrlData::GetDataItemCount() const
 #ifdef _DEBUG
     auto iter = m_dataMap.begin();
     for (; iter != m_dataMap.end(); ++iter) {
-        ASSERT(iter->second.size() == m_rowDataList.size());
+        ASSERT(iter->second.GetCount() == m_rowDataList.size());
     }
 #endif
     return m_rowDataList.size();
@@ -407,18 +723,51 @@ bool ListCtrlData::SetDataItemCount(size_t itemCount)
         return true;
     }
     size_t nOldCount = m_rowDataList.size();
+    if ((itemCount < nOldCount) && !m_storageOrder.empty()) {
+        //行数变少时，被截断的行在存储中的位置不连续，先按显示顺序调整存储顺序
+        ApplyStorageOrder();
+    }
     m_rowDataList.resize(itemCount); 
     if (m_nSelectedIndex >= m_rowDataList.size()) {
         m_nSelectedIndex = Box::InvalidIndex;
     }
     for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
-        iter->second.resize(itemCount);
+        iter->second.Resize(itemCount);
+    }
+    if (itemCount < m_searchIndex.GetRowCount()) {
+        ClearSearchIndex();
+    }
+    if (IsFilterActive()) {
+        //新增的行没有数据，不满足过滤条件
+        for (size_t nIndex = itemCount; nIndex < m_filterStates.size(); ++nIndex) {
+            if (m_filterStates[nIndex] == 0) {
+                m_nFilterHideCount -= 1;
+            }
+        }
+        if (itemCount > m_filterStates.size()) {
+            m_nFilterHideCount += itemCount - m_filterStates.size();
+        }
+        //删除末尾的行不影响其他行的行号，待检查的行中超出范围的行在检查时跳过
+        m_filterStates.resize(itemCount, 0);
+        InvalidateRowHeightIndex();
+    }
+    for (size_t nIndex = m_storageOrder.size(); !m_storageOrder.empty() && (nIndex < itemCount); ++nIndex) {
+        //新增的行，在存储中追加到最后
+        m_storageOrder.push_back(nIndex);
+        m_displayOrder.push_back(nIndex);
     }
     if (itemCount < nOldCount) {
         //行数变少了
         if ((m_hideRowCount != 0) || (m_heightRowCount != 0) || (m_atTopRowCount != 0)) {
             UpdateNormalMode();
         }
+        if (m_atTopRowCount != 0) {
+            m_bAtTopRowListDirty = true;
+        }
+    }
+    if (!m_bRowHeightIndexDirty) {
+        //新增的行为默认属性（可见、默认行高、不置顶），在尾部追加或者截断即可
+        m_rowHeightIndex.Resize(itemCount, GetRowScrollHeight(ListCtrlItemData()));
     }
     EmitCountChanged();
     return true;
@@ -453,27 +802,44 @@ size_t ListCtrlData::AddDataItem(size_t columnId, const ListCtrlSubItemData& dat
     SubItemToStorage(dataItem, storage);
 
     size_t nDataItemIndex = Box::InvalidIndex;
-    for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
-        size_t id = iter->first;
-        StoragePtrList& storageList = iter->second;
-        if (id == columnId) {
-            //关联列：保存数据
-            storageList.push_back(std::make_shared<Storage>(storage));
-            nDataItemIndex = storageList.size() - 1;
-        }
-        else {
-            //其他列：插入空数据
-            storageList.push_back(nullptr);
-        }
+    if (!InsertStorageRow(m_rowDataList.size(), columnId, storage)) {
+        return Box::InvalidIndex;
     }
 
-    //行数据，插入1条数据
+    //行数据，插入1条数据（在存储中也是追加到最后）
+    if (!m_storageOrder.empty()) {
+        m_storageOrder.push_back(m_rowDataList.size());
+        m_displayOrder.push_back(m_rowDataList.size());
+    }
     m_rowDataList.push_back(ListCtrlItemData());
+    nDataItemIndex = m_rowDataList.size() - 1;
+    OnFilterRowInserted(GetStorageIndex(nDataItemIndex));
+    if (!m_bRowHeightIndexDirty) {
+        m_rowHeightIndex.Resize(m_rowDataList.size(), GetRowScrollHeight(nDataItemIndex));
+    }
 
     EmitCountChanged();
     return nDataItemIndex;
 }
 
+bool ListCtrlData::InsertStorageRow(size_t nStorageIndex, size_t columnId, const Storage& storage)
+{
+    for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
+        //所有列：插入空数据
+        iter->second.InsertEmpty(nStorageIndex);
+    }
+    //关联列：保存数据
+    auto iter = m_dataMap.find(columnId);
+    if ((iter != m_dataMap.end()) && !iter->second.SetData(nStorageIndex, storage)) {
+        //文本缓冲区已满，撤销插入的行
+        for (auto iterColumn = m_dataMap.begin(); iterColumn != m_dataMap.end(); ++iterColumn) {
+            iterColumn->second.Erase(nStorageIndex);
+        }
+        return false;
+    }
+    return true;
+}
+
 bool ListCtrlData::InsertDataItem(size_t itemIndex, size_t columnId, const ListCtrlSubItemData& dataItem)
 {
     ASSERT(IsValidDataColumnId(columnId));
@@ -488,17 +854,14 @@ bool ListCtrlData::InsertDataItem(size_t itemIndex, size_t columnId, const ListC
     Storage storage;
     SubItemToStorage(dataItem, storage);
 
-    for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
-        size_t id = iter->first;
-        StoragePtrList& storageList = iter->second;
-        if (id == columnId) {
-            //关联列：保存数据
-            storageList.insert(storageList.begin() + itemIndex, std::make_shared<Storage>(storage));
-        }
-        else {
-            //其他列：插入空数据
-            storageList.insert(storageList.begin() + itemIndex, nullptr);
-        }
+    //排序后，新的行在存储中追加到最后，只在显示顺序中插入
+    const size_t nStorageIndex = m_storageOrder.empty() ? itemIndex : m_storageOrder.size();
+    if (!InsertStorageRow(nStorageIndex, columnId, storage)) {
+        return false;
+    }
+    if (!m_storageOrder.empty()) {
+        m_storageOrder.insert(m_storageOrder.begin() + itemIndex, nStorageIndex);
+        RebuildDisplayOrder();
     }
 
     //行数据，插入1条数据
@@ -507,6 +870,8 @@ bool ListCtrlData::InsertDataItem(size_t itemIndex, size_t columnId, const ListC
         ++m_nSelectedIndex;
     }
     m_rowDataList.insert(m_rowDataList.begin() + itemIndex, ListCtrlItemData());
+    OnFilterRowInserted(nStorageIndex);
+    InvalidateRowHeightIndex();
 
     EmitCountChanged();
     return true;
@@ -519,12 +884,23 @@ bool ListCtrlData::DeleteDataItem(size_t itemIndex)
         return false;
     }
 
+    const size_t nStorageIndex = GetStorageIndex(itemIndex);
     for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
-        StoragePtrList& storageList = iter->second;
-        if (itemIndex < storageList.size()) {
-            storageList.erase(storageList.begin() + itemIndex);
+        ListCtrlColumnStorage& columnStorage = iter->second;
+        if (nStorageIndex < columnStorage.GetCount()) {
+            columnStorage.Erase(nStorageIndex);
         }
     }
+    if (!m_storageOrder.empty()) {
+        m_storageOrder.erase(m_storageOrder.begin() + itemIndex);
+        for (size_t& nIndex : m_storageOrder) {
+            if (nIndex > nStorageIndex) {
+                --nIndex;
+            }
+        }
+        RebuildDisplayOrder();
+    }
+    OnFilterRowRemoved(nStorageIndex);
 
     //删除一行
     if (itemIndex < m_rowDataList.size()) {
@@ -550,6 +926,7 @@ bool ListCtrlData::DeleteDataItem(size_t itemIndex)
             m_atTopRowCount -= 1;
             ASSERT(m_atTopRowCount >= 0);
         }
+        InvalidateRowHeightIndex();
     }
     EmitCountChanged();
     return true;
@@ -559,13 +936,14 @@ bool ListCtrlData::DeleteAllDataItems()
 {
     bool bDeleted = false;
     for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
-        StoragePtrList& storageList = iter->second;
-        if (!storageList.empty()) {
+        ListCtrlColumnStorage& columnStorage = iter->second;
+        if (columnStorage.GetCount() > 0) {
             bDeleted = true;
         }
-        StoragePtrList emptyList;
-        storageList.swap(emptyList);
+        columnStorage.Clear();
     }
+    std::vector<size_t>().swap(m_storageOrder);
+    std::vector<size_t>().swap(m_displayOrder);
     //清空行数据
     if (!m_rowDataList.empty()) {
         bDeleted = true;
@@ -575,6 +953,19 @@ bool ListCtrlData::DeleteAllDataItems()
     m_hideRowCount = 0;
     m_heightRowCount = 0;
     m_atTopRowCount = 0;
+    m_rowHeightIndex.Clear();
+    m_bRowHeightIndexDirty = false;
+    m_atTopRowList.clear();
+    m_nAtTopRowsHeight = 0;
+    m_bAtTopRowListDirty = false;
+    //保留过滤条件，新添加的数据仍然需要满足过滤条件
+    m_filterFlag.Cancel();
+    m_filterStates.clear();
+    m_nFilterHideCount = 0;
+    std::vector<size_t>().swap(m_filterPendingRows);
+    m_nFilterPendingPos = 0;
+    m_bFilterScanAll = false;
+    ClearSearchIndex();
 
     if (bDeleted) {
         EmitCountChanged();
@@ -648,6 +1039,7 @@ bool ListCtrlData::SetDataItemData(size_t itemIndex, const ListCtrlItemData& ite
             m_atTopRowCount += 1;
         }
         ASSERT(m_atTopRowCount >= 0);
+        UpdateRowHeightIndex(itemIndex, oldItemData);
         bRet = true;
     }
     if (bCountChanged) {
@@ -678,9 +1070,11 @@ bool ListCtrlData::SetDataItemVisible(size_t itemIndex, bool bVisible, bool& bCh
     ASSERT(itemIndex < m_rowDataList.size());
     if (itemIndex < m_rowDataList.size()) {        
         ListCtrlItemData& rowData = m_rowDataList[itemIndex];
+        const ListCtrlItemData oldRowData = rowData;
         bool bOldVisible = rowData.bVisible;
         bChanged = rowData.bVisible != bVisible;
         rowData.bVisible = bVisible;
+        UpdateRowHeightIndex(itemIndex, oldRowData);
 
         if (!bOldVisible && bVisible) {
             m_hideRowCount -= 1;
@@ -760,6 +1154,10 @@ bool ListCtrlData::SetAllDataItemsCheck(bool bChecked)
     bool bChanged = false;
     size_t nCount = m_rowDataList.size();
     for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
+        if (IsRowFilteredOut(itemIndex)) {
+            //被过滤隐藏的行，保持原来的勾选状态
+            continue;
+        }
         ListCtrlItemData& rowData = m_rowDataList[itemIndex];
         if (rowData.bChecked != bChecked) {
             rowData.bChecked = bChecked;
@@ -837,7 +1235,7 @@ void ListCtrlData::GetDataItemsCheckStatus(bool& bChecked, bool& bPartChecked) c
     }
     for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
         const ListCtrlItemData& rowData = m_rowDataList[itemIndex];
-        if (!rowData.bVisible) {
+        if (!IsRowVisible(itemIndex)) {
             continue;
         }
         if (rowData.bChecked) {
@@ -860,7 +1258,8 @@ void ListCtrlData::GetDataItemsCheckStatus(bool& bChecked, bool& bPartChecked) c
         bChecked = false;
     }
     else {
-        ASSERT(0);
+        //所有行都被过滤隐藏时，没有可统计的行
+        ASSERT(m_nFilterHideCount > 0);
     }
 }
 
@@ -876,7 +1275,7 @@ void ListCtrlData::GetDataItemsSelectStatus(bool& bSelected, bool& bPartSelected
     }
     for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
         const ListCtrlItemData& rowData = m_rowDataList[itemIndex];
-        if (!rowData.bVisible) {
+        if (!IsRowVisible(itemIndex)) {
             continue;
         }
         if (rowData.bSelected) {
@@ -899,7 +1298,8 @@ void ListCtrlData::GetDataItemsSelectStatus(bool& bSelected, bool& bPartSelected
         bSelected = false;
     }
     else {
-        ASSERT(0);
+        //所有行都被过滤隐藏时，没有可统计的行
+        ASSERT(m_nFilterHideCount > 0);
     }
 }
 
@@ -911,10 +1311,10 @@ void ListCtrlData::GetColumnCheckStatus(size_t columnId, bool& bChecked, bool& b
     if (iter == m_dataMap.end()) {
         return;
     }
-    const StoragePtrList& sortStorageList = iter->second;
+    const ListCtrlColumnStorage& columnStorage = iter->second;
     size_t nCheckCount = 0;
     size_t nUnCheckCount = 0;
-    const size_t nCount = sortStorageList.size();
+    const size_t nCount = columnStorage.GetCount();
     if (nCount == 0) {
         return;
     }
@@ -924,18 +1324,17 @@ void ListCtrlData::GetColumnCheckStatus(size_t columnId, bool& bChecked, bool& b
     }
 
     for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
-        const ListCtrlItemData& rowData = m_rowDataList[itemIndex];
-        if (!rowData.bVisible) {
+        if (!IsRowVisible(itemIndex)) {
             continue;
         }
-        const StoragePtr& pStorage = sortStorageList[itemIndex];
-        if (pStorage == nullptr) {
+        const size_t nStorageIndex = GetStorageIndex(itemIndex);
+        if (!columnStorage.HasData(nStorageIndex)) {
             continue;
         }
-        if (!pStorage->bShowCheckBox) {
+        if (!columnStorage.IsShowCheckBox(nStorageIndex)) {
             continue;
         }
-        if (pStorage->bChecked) {
+        if (columnStorage.IsChecked(nStorageIndex)) {
             nCheckCount++;
         }
         else {
@@ -994,9 +1393,11 @@ bool ListCtrlData::SetDataItemAlwaysAtTop(size_t itemIndex, int8_t nAlwaysAtTop,
     ASSERT(itemIndex < m_rowDataList.size());
     if (itemIndex < m_rowDataList.size()) {
         ListCtrlItemData& rowData = m_rowDataList[itemIndex];
+        const ListCtrlItemData oldRowData = rowData;
         int8_t nOldAlwaysAtTop = rowData.nAlwaysAtTop;
         bChanged = rowData.nAlwaysAtTop != nAlwaysAtTop;
         rowData.nAlwaysAtTop = nAlwaysAtTop;
+        UpdateRowHeightIndex(itemIndex, oldRowData);
         if ((nOldAlwaysAtTop >= 0) && (nAlwaysAtTop < 0)) {
             m_atTopRowCount -= 1;
         }
@@ -1036,10 +1437,12 @@ bool ListCtrlData::SetDataItemHeight(size_t itemIndex, int32_t nItemHeight, bool
     ASSERT(itemIndex < m_rowDataList.size());
     if (itemIndex < m_rowDataList.size()) {
         ListCtrlItemData& rowData = m_rowDataList[itemIndex];
+        const ListCtrlItemData oldRowData = rowData;
         int16_t nOldItemHeight = rowData.nItemHeight;
         bChanged = rowData.nItemHeight != nItemHeight;
         ASSERT(nItemHeight <= INT16_MAX);
         rowData.nItemHeight = (int16_t)nItemHeight;
+        UpdateRowHeightIndex(itemIndex, oldRowData);
         if ((nOldItemHeight >= 0) && (nItemHeight < 0)) {
             m_heightRowCount -= 1;
         }
@@ -1104,28 +1507,25 @@ bool ListCtrlData::SetSubItemData(size_t itemIndex, size_t columnId,
     ASSERT(iter != m_dataMap.end());
     if (iter != m_dataMap.end()) {
         //关联列：更新数据
-        StoragePtrList& storageList = iter->second;
-        ASSERT(itemIndex < storageList.size());
-        if (itemIndex < storageList.size()) {
-            StoragePtr pStorage = storageList[itemIndex];
-            if (pStorage == nullptr) {
-                storageList[itemIndex] = std::make_shared<Storage>(storage);
-                if (storage.bChecked) {
-                    bCheckChanged = true;
-                }
+        ListCtrlColumnStorage& columnStorage = iter->second;
+        ASSERT(itemIndex < columnStorage.GetCount());
+        if (itemIndex < columnStorage.GetCount()) {
+            const size_t nStorageIndex = GetStorageIndex(itemIndex);
+            bool bOldChecked = columnStorage.HasData(nStorageIndex) && columnStorage.IsChecked(nStorageIndex);
+            if (storage.bChecked != bOldChecked) {
+                bCheckChanged = true;
             }
-            else {
-                if (storage.bChecked != pStorage->bChecked) {
-                    bCheckChanged = true;
-                }
-                *pStorage = storage;
-            }
-            bRet = true;
+            bRet = columnStorage.SetData(nStorageIndex, storage);
         }
     }
 
     if (bRet) {
-        EmitDataChanged(itemIndex, itemIndex);
+        if (OnFilterTextChanged(itemIndex, columnId)) {
+            EmitCountChanged();
+        }
+        else {
+            EmitDataChanged(itemIndex, itemIndex);
+        }
     }
     return bRet;
 }
@@ -1138,12 +1538,12 @@ bool ListCtrlData::GetSubItemData(size_t itemIndex, size_t columnId, ListCtrlSub
     auto iter = m_dataMap.find(columnId);
     ASSERT(iter != m_dataMap.end());
     if (iter != m_dataMap.end()) {
-        const StoragePtrList& storageList = iter->second;
-        ASSERT(itemIndex < storageList.size());
-        if (itemIndex < storageList.size()) {
-            StoragePtr pStorage = storageList[itemIndex];
-            if (pStorage != nullptr) {
-                StorageToSubItem(*pStorage, subItemData);
+        const ListCtrlColumnStorage& columnStorage = iter->second;
+        ASSERT(itemIndex < columnStorage.GetCount());
+        if (itemIndex < columnStorage.GetCount()) {
+            Storage storage;
+            if (columnStorage.GetData(GetStorageIndex(itemIndex), storage)) {
+                StorageToSubItem(storage, subItemData);
             }
             bRet = true;
         }
@@ -1153,40 +1553,51 @@ bool ListCtrlData::GetSubItemData(size_t itemIndex, size_t columnId, ListCtrlSub
 
 bool ListCtrlData::SetSubItemText(size_t itemIndex, size_t columnId, const DString& text)
 {
-    StoragePtr pStorage = GetSubItemStorageForWrite(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    ListCtrlColumnStorage* pStorage = GetSubItemStorageForWrite(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    if (pStorage->text != text) {
-        pStorage->text = text;
-        EmitDataChanged(itemIndex, itemIndex);
+    if (text.compare(pStorage->GetText(nStorageIndex)) != 0) {
+        if (!pStorage->SetText(nStorageIndex, text)) {
+            //文本缓冲区已满
+            return false;
+        }
+        if (OnFilterTextChanged(itemIndex, columnId)) {
+            EmitCountChanged();
+        }
+        else {
+            EmitDataChanged(itemIndex, itemIndex);
+        }
     }    
     return true;
 }
 
 DString ListCtrlData::GetSubItemText(size_t itemIndex, size_t columnId) const
 {
-    StoragePtr pStorage = GetSubItemStorage(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    const ListCtrlColumnStorage* pStorage = GetSubItemStorage(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return DString();
     }
-    return pStorage->text.c_str();
+    return DString(pStorage->GetText(nStorageIndex), pStorage->GetTextLength(nStorageIndex));
 }
 
 bool ListCtrlData::SetSubItemTextColor(size_t itemIndex, size_t columnId, const UiColor& textColor)
 {
-    StoragePtr pStorage = GetSubItemStorageForWrite(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    ListCtrlColumnStorage* pStorage = GetSubItemStorageForWrite(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    if (pStorage->textColor != textColor) {
-        pStorage->textColor = textColor;
+    if (pStorage->GetTextColor(nStorageIndex) != textColor) {
+        pStorage->SetTextColor(nStorageIndex, textColor);
         EmitDataChanged(itemIndex, itemIndex);
     }    
     return true;
@@ -1195,19 +1606,21 @@ bool ListCtrlData::SetSubItemTextColor(size_t itemIndex, size_t columnId, const
 bool ListCtrlData::GetSubItemTextColor(size_t itemIndex, size_t columnId, UiColor& textColor) const
 {
     textColor = UiColor();
-    StoragePtr pStorage = GetSubItemStorage(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    const ListCtrlColumnStorage* pStorage = GetSubItemStorage(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    textColor = pStorage->textColor;
+    textColor = pStorage->GetTextColor(nStorageIndex);
     return true;
 }
 
 bool ListCtrlData::SetSubItemTextFormat(size_t itemIndex, size_t columnId, int32_t nTextFormat)
 {
-    StoragePtr pStorage = GetSubItemStorageForWrite(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    ListCtrlColumnStorage* pStorage = GetSubItemStorageForWrite(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
@@ -1247,8 +1660,8 @@ bool ListCtrlData::SetSubItemTextFormat(size_t itemIndex, size_t columnId, int32
         nValidTextFormat |= TEXT_NOCLIP;
     }
 
-    if (pStorage->nTextFormat != nValidTextFormat) {
-        pStorage->nTextFormat = ui::TruncateToUInt16(nValidTextFormat);
+    if (pStorage->GetTextFormat(nStorageIndex) != nValidTextFormat) {
+        pStorage->SetTextFormat(nStorageIndex, ui::TruncateToUInt16(nValidTextFormat));
         EmitDataChanged(itemIndex, itemIndex);
     }
     return true;
@@ -1257,10 +1670,11 @@ bool ListCtrlData::SetSubItemTextFormat(size_t itemIndex, size_t columnId, int32
 int32_t ListCtrlData::GetSubItemTextFormat(size_t itemIndex, size_t columnId) const
 {
     int32_t nTextFormat = 0;
-    StoragePtr pStorage = GetSubItemStorage(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    const ListCtrlColumnStorage* pStorage = GetSubItemStorage(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage != nullptr) {
-        nTextFormat = pStorage->nTextFormat;
+        nTextFormat = pStorage->GetTextFormat(nStorageIndex);
         if (nTextFormat <= 0) {
             nTextFormat = m_nDefaultTextStyle;
         }
@@ -1270,14 +1684,15 @@ int32_t ListCtrlData::GetSubItemTextFormat(size_t itemIndex, size_t columnId) co
 
 bool ListCtrlData::SetSubItemBkColor(size_t itemIndex, size_t columnId, const UiColor& bkColor)
 {
-    StoragePtr pStorage = GetSubItemStorageForWrite(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    ListCtrlColumnStorage* pStorage = GetSubItemStorageForWrite(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    if (pStorage->bkColor != bkColor) {
-        pStorage->bkColor = bkColor;
+    if (pStorage->GetBkColor(nStorageIndex) != bkColor) {
+        pStorage->SetBkColor(nStorageIndex, bkColor);
         EmitDataChanged(itemIndex, itemIndex);
     }    
     return true;
@@ -1286,37 +1701,40 @@ bool ListCtrlData::SetSubItemBkColor(size_t itemIndex, size_t columnId, const Ui
 bool ListCtrlData::GetSubItemBkColor(size_t itemIndex, size_t columnId, UiColor& bkColor) const
 {
     bkColor = UiColor();
-    StoragePtr pStorage = GetSubItemStorage(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    const ListCtrlColumnStorage* pStorage = GetSubItemStorage(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    bkColor = pStorage->bkColor;
+    bkColor = pStorage->GetBkColor(nStorageIndex);
     return true;
 }
 
 bool ListCtrlData::IsSubItemShowCheckBox(size_t itemIndex, size_t columnId) const
 {
-    StoragePtr pStorage = GetSubItemStorage(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    const ListCtrlColumnStorage* pStorage = GetSubItemStorage(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    return pStorage->bShowCheckBox;
+    return pStorage->IsShowCheckBox(nStorageIndex);
 }
 
 bool ListCtrlData::SetSubItemShowCheckBox(size_t itemIndex, size_t columnId, bool bShowCheckBox)
 {
-    StoragePtr pStorage = GetSubItemStorageForWrite(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    ListCtrlColumnStorage* pStorage = GetSubItemStorageForWrite(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    if (pStorage->bShowCheckBox != bShowCheckBox) {
-        pStorage->bShowCheckBox = bShowCheckBox;
+    if (pStorage->IsShowCheckBox(nStorageIndex) != bShowCheckBox) {
+        pStorage->SetShowCheckBox(nStorageIndex, bShowCheckBox);
         EmitDataChanged(itemIndex, itemIndex);
     }    
     return true;
@@ -1324,16 +1742,17 @@ bool ListCtrlData::SetSubItemShowCheckBox(size_t itemIndex, size_t columnId, boo
 
 bool ListCtrlData::SetSubItemCheck(size_t itemIndex, size_t columnId, bool bChecked, bool bRefresh)
 {
-    StoragePtr pStorage = GetSubItemStorageForWrite(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    ListCtrlColumnStorage* pStorage = GetSubItemStorageForWrite(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    ASSERT(pStorage->bShowCheckBox);
-    if (pStorage->bShowCheckBox) {
-        if (pStorage->bChecked != bChecked) {
-            pStorage->bChecked = bChecked;
+    ASSERT(pStorage->IsShowCheckBox(nStorageIndex));
+    if (pStorage->IsShowCheckBox(nStorageIndex)) {
+        if (pStorage->IsChecked(nStorageIndex) != bChecked) {
+            pStorage->SetChecked(nStorageIndex, bChecked);
             if (bRefresh) {
                 EmitDataChanged(itemIndex, itemIndex);
             }            
@@ -1346,15 +1765,16 @@ bool ListCtrlData::SetSubItemCheck(size_t itemIndex, size_t columnId, bool bChec
 bool ListCtrlData::GetSubItemCheck(size_t itemIndex, size_t columnId, bool& bChecked) const
 {
     bChecked = false;
-    StoragePtr pStorage = GetSubItemStorage(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    const ListCtrlColumnStorage* pStorage = GetSubItemStorage(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    ASSERT(pStorage->bShowCheckBox);
-    if (pStorage->bShowCheckBox) {
-        bChecked = pStorage->bChecked;
+    ASSERT(pStorage->IsShowCheckBox(nStorageIndex));
+    if (pStorage->IsShowCheckBox(nStorageIndex)) {
+        bChecked = pStorage->IsChecked(nStorageIndex);
         return true;
     }
     return false;
@@ -1362,7 +1782,8 @@ bool ListCtrlData::GetSubItemCheck(size_t itemIndex, size_t columnId, bool& bChe
 
 bool ListCtrlData::SetSubItemImageId(size_t itemIndex, size_t columnId, int32_t imageId)
 {
-    StoragePtr pStorage = GetSubItemStorageForWrite(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    ListCtrlColumnStorage* pStorage = GetSubItemStorageForWrite(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
@@ -1371,8 +1792,8 @@ bool ListCtrlData::SetSubItemImageId(size_t itemIndex, size_t columnId, int32_t
     if (imageId < -1) {
         imageId = -1;
     }
-    if (pStorage->nImageId != imageId) {
-        pStorage->nImageId = imageId;
+    if (pStorage->GetImageId(nStorageIndex) != imageId) {
+        pStorage->SetImageId(nStorageIndex, imageId);
         EmitDataChanged(itemIndex, itemIndex);
     }
     return true;
@@ -1381,24 +1802,26 @@ bool ListCtrlData::SetSubItemImageId(size_t itemIndex, size_t columnId, int32_t
 int32_t ListCtrlData::GetSubItemImageId(size_t itemIndex, size_t columnId) const
 {
     int32_t nImageId = -1;
-    StoragePtr pStorage = GetSubItemStorage(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    const ListCtrlColumnStorage* pStorage = GetSubItemStorage(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage != nullptr) {
-        nImageId = pStorage->nImageId;
+        nImageId = pStorage->GetImageId(nStorageIndex);
     }
     return nImageId;
 }
 
 bool ListCtrlData::SetSubItemEditable(size_t itemIndex, size_t columnId, bool bEditable)
 {
-    StoragePtr pStorage = GetSubItemStorageForWrite(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    ListCtrlColumnStorage* pStorage = GetSubItemStorageForWrite(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage == nullptr) {
         //索引号无效
         return false;
     }
-    if (pStorage->bEditable != bEditable) {
-        pStorage->bEditable = bEditable;
+    if (pStorage->IsEditable(nStorageIndex) != bEditable) {
+        pStorage->SetEditable(nStorageIndex, bEditable);
         EmitDataChanged(itemIndex, itemIndex);
     }
     return true;
@@ -1407,10 +1830,11 @@ bool ListCtrlData::SetSubItemEditable(size_t itemIndex, size_t columnId, bool bE
 bool ListCtrlData::IsSubItemEditable(size_t itemIndex, size_t columnId) const
 {
     bool bEditable = false;
-    StoragePtr pStorage = GetSubItemStorage(itemIndex, columnId);
+    size_t nStorageIndex = 0;
+    const ListCtrlColumnStorage* pStorage = GetSubItemStorage(itemIndex, columnId, nStorageIndex);
     ASSERT(pStorage != nullptr);
     if (pStorage != nullptr) {
-        bEditable = pStorage->bEditable;
+        bEditable = pStorage->IsEditable(nStorageIndex);
     }
     return bEditable;
 }
@@ -1423,115 +1847,850 @@ bool ListCtrlData::SortDataItems(size_t nColumnId, size_t nColumnIndex, bool bSo
     if (iter == m_dataMap.end()) {
         return false;
     }
-    StoragePtrList sortStorageList = iter->second;
-    if (sortStorageList.empty()) {
+    if (pfnCompareFunc == nullptr) {
+        //如果无有效参数，则使用外部设置的排序函数
+        pfnCompareFunc = m_pfnCompareFunc;
+        pUserData = m_pUserData;
+    }
+    if (pfnCompareFunc == nullptr) {
+        //使用默认的排序方式：按字符串比较
+        ListCtrlSortKey sortKey;
+        sortKey.nColumnIndex = nColumnIndex;
+        sortKey.nColumnId = nColumnId;
+        sortKey.bSortedUp = bSortedUp;
+        return SortDataItems(std::vector<ListCtrlSortKey>{ sortKey });
+    }
+
+    std::vector<size_t> sortedOrders;
+    if (!SortByCompareFunc(sortedOrders, iter->second, nColumnId, nColumnIndex, bSortedUp, pfnCompareFunc, pUserData)) {
         return false;
     }
-    std::vector<StorageData> sortedDataList;
-    const size_t dataCount = sortStorageList.size();
-    for (size_t index = 0; index < dataCount; ++index) {
-        sortedDataList.push_back({index, sortStorageList[index] });
-    }    
-    SortStorageData(sortedDataList, nColumnId, nColumnIndex, bSortedUp, pfnCompareFunc, pUserData);
-
-    //对原数据进行顺序调整
-    const size_t sortedDataCount = sortedDataList.size();
-    StoragePtrList orgStorageList; //副本数据
-    for (iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
-        orgStorageList = iter->second; 
-        StoragePtrList& storageList = iter->second;   //修改目标
-        ASSERT(storageList.size() == sortedDataList.size());
-        if (storageList.size() != sortedDataList.size()) {
+    ApplySortedOrders(sortedOrders);
+    return true;
+}
+
+bool ListCtrlData::SortDataItems(const std::vector<ListCtrlSortKey>& sortKeys)
+{
+    ASSERT(!sortKeys.empty());
+    if (sortKeys.empty() || m_rowDataList.empty()) {
+        return false;
+    }
+    for (const ListCtrlSortKey& sortKey : sortKeys) {
+        ASSERT(IsValidDataColumnId(sortKey.nColumnId));
+        if (!IsValidDataColumnId(sortKey.nColumnId)) {
             return false;
         }
-        for (size_t index = 0; index < sortedDataCount; ++index) {
-            const StorageData& sortedData = sortedDataList[index];
-            storageList[index] = orgStorageList[sortedData.index]; //赋值原数据
-        }
     }
+    std::vector<size_t> sortedOrders;
+    if (!SortBySortKeys(sortedOrders, sortKeys)) {
+        return false;
+    }
+    ApplySortedOrders(sortedOrders);
+    return true;
+}
+
+void ListCtrlData::ApplySortedOrders(const std::vector<size_t>& sortedOrders)
+{
+    //只调整显示顺序到存储顺序的映射，各列的数据不移动
+    const size_t sortedDataCount = sortedOrders.size();
+    ASSERT(sortedDataCount == m_rowDataList.size());
+    std::vector<size_t> storageOrder;
+    storageOrder.resize(sortedDataCount);
+    for (size_t index = 0; index < sortedDataCount; ++index) {
+        storageOrder[index] = GetStorageIndex(sortedOrders[index]);
+    }
+    m_storageOrder.swap(storageOrder);
+    RebuildDisplayOrder();
 
     //对行数据进行排序
     bool bFoundSelectedIndex = false;
-    ASSERT(sortedDataCount == m_rowDataList.size());
     RowDataList rowDataList = m_rowDataList;
     for (size_t index = 0; index < sortedDataCount; ++index) {
-        const StorageData& sortedData = sortedDataList[index];
-        m_rowDataList[index] = rowDataList[sortedData.index]; //赋值原数据
-        if (!bFoundSelectedIndex && (m_nSelectedIndex == sortedData.index)) {
+        const size_t nOrgIndex = sortedOrders[index];
+        m_rowDataList[index] = rowDataList[nOrgIndex]; //赋值原数据
+        if (!bFoundSelectedIndex && (m_nSelectedIndex == nOrgIndex)) {
             m_nSelectedIndex = index;
             bFoundSelectedIndex = true;
         }
     }
+    InvalidateRowHeightIndex();
 
     EmitCountChanged();
-    return true;
 }
 
-bool ListCtrlData::SortStorageData(std::vector<StorageData>& dataList,                                            
-                                   size_t nColumnId, size_t nColumnIndex, bool bSortedUp,
-                                   ListCtrlDataCompareFunc pfnCompareFunc, void* pUserData)
+void ListCtrlData::RunParallelTasks(const std::vector<StdClosure>& tasks) const
 {
-    if (dataList.empty()) {
-        return false;
+    if (tasks.empty()) {
+        return;
+    }
+    if (m_sortThreads.empty() && (tasks.size() > 1)) {
+        //首次使用时创建后台线程，之后的排序复用这些线程
+        size_t nThreadCount = std::thread::hardware_concurrency();
+        nThreadCount = (nThreadCount > 1) ? std::min(nThreadCount - 1, kMaxParallelSortThreads - 1) : 0;
+        for (size_t nIndex = 0; nIndex < nThreadCount; ++nIndex) {
+            std::unique_ptr<FrameworkThread> pThread(new FrameworkThread(_T("ListCtrlSortThread"), kThreadNone));
+            if (pThread->Start()) {
+                m_sortThreads.push_back(std::move(pThread));
+            }
+        }
     }
 
-    if (pfnCompareFunc == nullptr) {
-        //如果无有效参数，则使用外部设置的排序函数
-        pfnCompareFunc = m_pfnCompareFunc;
-        pUserData = m_pUserData;
+    //后台线程中未完成的任务个数
+    struct PendingTasks
+    {
+        std::mutex mutex;
+        std::condition_variable cond;
+        size_t nCount = 0;
+    };
+    std::shared_ptr<PendingTasks> pendingTasks = std::make_shared<PendingTasks>();
+    std::vector<const StdClosure*> localTasks;
+    localTasks.push_back(&tasks[0]);
+    for (size_t nIndex = 1; nIndex < tasks.size(); ++nIndex) {
+        bool bPosted = false;
+        if (!m_sortThreads.empty()) {
+            FrameworkThread* pThread = m_sortThreads[(nIndex - 1) % m_sortThreads.size()].get();
+            {
+                std::lock_guard<std::mutex> guard(pendingTasks->mutex);
+                pendingTasks->nCount++;
+            }
+            const StdClosure* pTask = &tasks[nIndex];
+            bPosted = pThread->PostTask([pTask, pendingTasks]() {
+                    (*pTask)();
+                    std::lock_guard<std::mutex> guard(pendingTasks->mutex);
+                    pendingTasks->nCount--;
+                    pendingTasks->cond.notify_all();
+                }) != 0;
+            if (!bPosted) {
+                std::lock_guard<std::mutex> guard(pendingTasks->mutex);
+                pendingTasks->nCount--;
+            }
+        }
+        if (!bPosted) {
+            localTasks.push_back(&tasks[nIndex]);
+        }
+    }
+    for (const StdClosure* pTask : localTasks) {
+        (*pTask)();
+    }
+    //等待后台线程中的任务完成（任务引用了当前线程中的数据，必须等待）
+    std::unique_lock<std::mutex> lock(pendingTasks->mutex);
+    pendingTasks->cond.wait(lock, [&pendingTasks]() { return pendingTasks->nCount == 0; });
+}
+
+/** 稳定排序：数据量较大时，分段在多个线程中排序，然后逐级归并
+* @param [in,out] dataList 待排序的数据
+* @param [in] compareFunc 比较函数（会在多个线程中同时调用，必须是线程安全的）
+* @param [in] runTasks 并行执行一组任务的函数，所有任务执行完成后返回
+*/
+template<typename TCompare, typename TRunTasks>
+static void ParallelStableSort(std::vector<size_t>& dataList, const TCompare& compareFunc, const TRunTasks& runTasks)
+{
+    //数据量较小时，单线程排序，避免线程调度的开销
+    const size_t nDataCount = dataList.size();
+    size_t nThreadCount = std::thread::hardware_concurrency();
+    nThreadCount = std::min(nThreadCount, nDataCount / kMinParallelSortCount);
+    nThreadCount = std::min(nThreadCount, kMaxParallelSortThreads);
+    if (nThreadCount < 2) {
+        std::stable_sort(dataList.begin(), dataList.end(), compareFunc);
+        return;
+    }
+
+    //分段排序，各段的边界
+    std::vector<size_t> bounds;
+    for (size_t nIndex = 0; nIndex <= nThreadCount; ++nIndex) {
+        bounds.push_back(nDataCount * nIndex / nThreadCount);
+    }
+    std::vector<StdClosure> tasks;
+    for (size_t nIndex = 0; nIndex < nThreadCount; ++nIndex) {
+        const size_t nBegin = bounds[nIndex];
+        const size_t nEnd = bounds[nIndex + 1];
+        tasks.push_back([&dataList, &compareFunc, nBegin, nEnd]() {
+                std::stable_sort(dataList.begin() + nBegin, dataList.begin() + nEnd, compareFunc);
+            });
+    }
+    runTasks(tasks);
+
+    //逐级两两归并相邻的段（std::inplace_merge是稳定的）
+    while (bounds.size() > 2) {
+        std::vector<size_t> newBounds;
+        tasks.clear();
+        for (size_t nIndex = 0; nIndex + 2 < bounds.size(); nIndex += 2) {
+            const size_t nBegin = bounds[nIndex];
+            const size_t nMiddle = bounds[nIndex + 1];
+            const size_t nEnd = bounds[nIndex + 2];
+            tasks.push_back([&dataList, &compareFunc, nBegin, nMiddle, nEnd]() {
+                    std::inplace_merge(dataList.begin() + nBegin, dataList.begin() + nMiddle, dataList.begin() + nEnd, compareFunc);
+                });
+            newBounds.push_back(nBegin);
+        }
+        if ((bounds.size() % 2) == 0) {
+            //段数为奇数，最后一段保留到下一级归并
+            newBounds.push_back(bounds[bounds.size() - 2]);
+        }
+        newBounds.push_back(bounds.back());
+        runTasks(tasks);
+        bounds.swap(newBounds);
+    }
+}
+
+/** 字符串排序键的前缀：将文本开头的若干个字符按无符号数值拼接为一个64位整数（不足的位置补0），
+*   前缀的大小顺序与StringUtil::StringCompare逐个字符比较的顺序一致，多数比较只需要比较前缀
+*/
+static const size_t kSortPrefixChars = sizeof(uint64_t) / sizeof(DString::value_type);
+
+static uint64_t MakeSortPrefix(const DString::value_type* pText, size_t nLength)
+{
+    typedef std::make_unsigned<DString::value_type>::type UnsignedChar;
+    const size_t nBits = sizeof(DString::value_type) * 8;
+    uint64_t nPrefix = 0;
+    for (size_t nIndex = 0; nIndex < kSortPrefixChars; ++nIndex) {
+        uint64_t nChar = 0;
+        if (nIndex < nLength) {
+            nChar = static_cast<UnsignedChar>(pText[nIndex]);
+        }
+        nPrefix = (nBits < 64) ? ((nPrefix << nBits) | nChar) : nChar;
+    }
+    return nPrefix;
+}
+
+bool ListCtrlData::SortBySortKeys(std::vector<size_t>& sortedOrders,
+                                  const std::vector<ListCtrlSortKey>& sortKeys) const
+{
+    //预先提取排序键（每次排序只计算一次）：字符串排序时取文本指针和前缀，数值排序时解析为数值，
+    //排序过程中不再访问列存储
+    struct SortKeyData
+    {
+        const DString::value_type* pText = nullptr; //文本，为nullptr表示该行没有数据
+        uint64_t nPrefix = 0;                       //文本前缀（参见MakeSortPrefix）
+        size_t nLength = 0;                         //文本长度
+        double fValue = 0;                          //数值
+    };
+    struct SortKeyColumn
+    {
+        std::vector<SortKeyData> keys;
+        bool bSortedUp = true;
+        bool bNumeric = false;
+    };
+    const size_t nDataCount = m_rowDataList.size();
+    std::vector<SortKeyColumn> keyColumns;
+    keyColumns.resize(sortKeys.size());
+    for (size_t nKey = 0; nKey < sortKeys.size(); ++nKey) {
+        const ListCtrlSortKey& sortKey = sortKeys[nKey];
+        auto iter = m_dataMap.find(sortKey.nColumnId);
+        if (iter == m_dataMap.end()) {
+            return false;
+        }
+        const ListCtrlColumnStorage& columnStorage = iter->second;
+        ASSERT(columnStorage.GetCount() == nDataCount);
+        if (columnStorage.GetCount() != nDataCount) {
+            return false;
+        }
+        SortKeyColumn& keyColumn = keyColumns[nKey];
+        keyColumn.bSortedUp = sortKey.bSortedUp;
+        keyColumn.bNumeric = sortKey.bNumeric;
+        keyColumn.keys.resize(nDataCount);
+        for (size_t index = 0; index < nDataCount; ++index) {
+            const size_t nStorageIndex = GetStorageIndex(index);
+            if (!columnStorage.HasData(nStorageIndex)) {
+                continue;
+            }
+            SortKeyData& keyData = keyColumn.keys[index];
+            keyData.pText = columnStorage.GetText(nStorageIndex);
+            if (sortKey.bNumeric) {
+                keyData.fValue = StringUtil::StringToDouble(keyData.pText);
+            }
+            else {
+                keyData.nLength = columnStorage.GetTextLength(nStorageIndex);
+                keyData.nPrefix = MakeSortPrefix(keyData.pText, keyData.nLength);
+            }
+        }
     }
 
-    if (pfnCompareFunc != nullptr) {
-        //使用自定义的比较函数排序
-        ListCtrlCompareParam param;
-        param.nColumnId = nColumnId;
-        param.nColumnIndex = nColumnIndex;
-        param.pUserData = pUserData;
-        std::sort(dataList.begin(), dataList.end(), [this, pfnCompareFunc, &param](const StorageData& a, const StorageData& b) {
-                //实现(a < b)的比较逻辑
-                if (b.pStorage == nullptr) {
-                    return false;
+    sortedOrders.resize(nDataCount);
+    for (size_t index = 0; index < nDataCount; ++index) {
+        sortedOrders[index] = index;
+    }
+    auto compareFunc = [&keyColumns](size_t a, size_t b) {
+            //实现(a < b)的比较逻辑：按排序键依次比较，全部相等时保持原顺序
+            for (const SortKeyColumn& keyColumn : keyColumns) {
+                const SortKeyData& keyA = keyColumn.keys[a];
+                const SortKeyData& keyB = keyColumn.keys[b];
+                int32_t nResult = 0;
+                if ((keyA.pText == nullptr) || (keyB.pText == nullptr)) {
+                    //没有数据的行，排在最小的位置
+                    nResult = (keyA.pText != nullptr) ? 1 : ((keyB.pText != nullptr) ? -1 : 0);
+                }
+                else if (keyColumn.bNumeric) {
+                    nResult = (keyA.fValue < keyB.fValue) ? -1 : ((keyB.fValue < keyA.fValue) ? 1 : 0);
+                }
+                else if (keyA.nPrefix != keyB.nPrefix) {
+                    nResult = (keyA.nPrefix < keyB.nPrefix) ? -1 : 1;
+                }
+                else if (keyA.nLength >= kSortPrefixChars) {
+                    //前缀相同，并且文本不短于前缀（此时两个文本都不短于前缀），比较剩余部分
+                    nResult = StringUtil::StringCompare(keyA.pText + kSortPrefixChars, keyB.pText + kSortPrefixChars);
                 }
-                if (a.pStorage == nullptr) {
-                    return true;
+                //前缀相同且文本比前缀短：两个文本相同
+                if (nResult != 0) {
+                    return keyColumn.bSortedUp ? (nResult < 0) : (nResult > 0);
                 }
-                const Storage& storageA = *a.pStorage;
-                const Storage& storageB = *b.pStorage;
-                return pfnCompareFunc(storageA, storageB, param);
+            }
+            return false;
+        };
+    ParallelStableSort(sortedOrders, compareFunc, [this](const std::vector<StdClosure>& tasks) {
+            RunParallelTasks(tasks);
+        });
+    return true;
+}
+
+bool ListCtrlData::SortByCompareFunc(std::vector<size_t>& sortedOrders,
+                                     const ListCtrlColumnStorage& columnStorage,
+                                     size_t nColumnId, size_t nColumnIndex, bool bSortedUp,
+                                     ListCtrlDataCompareFunc pfnCompareFunc, void* pUserData) const
+{
+    ASSERT(pfnCompareFunc != nullptr);
+    const size_t nDataCount = m_rowDataList.size();
+    if ((pfnCompareFunc == nullptr) || (nDataCount == 0) || (columnStorage.GetCount() != nDataCount)) {
+        return false;
+    }
+
+    //使用自定义的比较函数排序：只读取排序列的数据
+    //自定义的比较函数不保证线程安全，在当前线程中排序
+    ListCtrlCompareParam param;
+    param.nColumnId = nColumnId;
+    param.nColumnIndex = nColumnIndex;
+    param.pUserData = pUserData;
+    sortedOrders.resize(nDataCount);
+    for (size_t index = 0; index < nDataCount; ++index) {
+        sortedOrders[index] = index;
+    }
+
+    //比较时通过列存储的接口读取数据，不复制整列数据
+    //排序过程中，相邻两次比较通常有一行是相同的，保留最近读取的两行数据，相同的行不再重复读取
+    Storage slotData[2];
+    size_t slotIndex[2] = { Box::InvalidIndex, Box::InvalidIndex };
+    auto loadSlot = [this, &columnStorage, &slotData, &slotIndex](size_t index, size_t nKeepSlot) {
+            if (slotIndex[0] == index) {
+                return (size_t)0;
+            }
+            if (slotIndex[1] == index) {
+                return (size_t)1;
+            }
+            const size_t nSlot = (nKeepSlot == 0) ? 1 : 0;
+            columnStorage.GetData(GetStorageIndex(index), slotData[nSlot]);
+            slotIndex[nSlot] = index;
+            return nSlot;
+        };
+    auto lessFunc = [this, pfnCompareFunc, &param, &columnStorage, &slotData, &slotIndex, &loadSlot](size_t a, size_t b) {
+            //实现(a < b)的比较逻辑
+            if (!columnStorage.HasData(GetStorageIndex(b))) {
+                return false;
+            }
+            if (!columnStorage.HasData(GetStorageIndex(a))) {
+                return true;
+            }
+            //读取a时，不覆盖已经读取的b
+            const size_t nKeepSlot = (slotIndex[0] == b) ? 0 : ((slotIndex[1] == b) ? 1 : Box::InvalidIndex);
+            const size_t nSlotA = loadSlot(a, nKeepSlot);
+            const size_t nSlotB = loadSlot(b, nSlotA);
+            return pfnCompareFunc(slotData[nSlotA], slotData[nSlotB], param);
+        };
+    if (bSortedUp) {
+        std::stable_sort(sortedOrders.begin(), sortedOrders.end(), lessFunc);
+    }
+    else {
+        //降序：交换比较的参数，相等的数据保持原顺序
+        std::stable_sort(sortedOrders.begin(), sortedOrders.end(), [&lessFunc](size_t a, size_t b) {
+                return lessFunc(b, a);
             });
     }
+    return true;
+}
+
+void ListCtrlData::SetSortCompareFunction(ListCtrlDataCompareFunc pfnCompareFunc, void* pUserData)
+{
+    m_pfnCompareFunc = pfnCompareFunc;
+    m_pUserData = pUserData;
+}
+
+bool ListCtrlData::SetFilter(const DString& filterText, const std::vector<size_t>& columnIds)
+{
+    const DString lowerText = StringUtil::MakeLowerString(filterText);
+    if (lowerText.empty()) {
+        ClearFilter();
+        return true;
+    }
+    std::vector<size_t> filterColumnIds;
+    if (columnIds.empty()) {
+        for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
+            filterColumnIds.push_back(iter->first);
+        }
+    }
     else {
-        //排序：升序，使用默认的排序函数
-        std::sort(dataList.begin(), dataList.end(), [this](const StorageData& a, const StorageData& b) {
-                //实现(a < b)的比较逻辑
-                if (b.pStorage == nullptr) {
-                    return false;
+        for (size_t columnId : columnIds) {
+            ASSERT(IsValidDataColumnId(columnId));
+            if (IsValidDataColumnId(columnId)) {
+                filterColumnIds.push_back(columnId);
+            }
+        }
+    }
+    std::sort(filterColumnIds.begin(), filterColumnIds.end());
+    filterColumnIds.erase(std::unique(filterColumnIds.begin(), filterColumnIds.end()), filterColumnIds.end());
+    if (filterColumnIds.empty()) {
+        return false;
+    }
+
+    const size_t nCount = m_rowDataList.size();
+    bool bIncremental = IsFilterActive() && (m_filterStates.size() == nCount);
+    if (filterColumnIds != m_filterColumnIds) {
+        //参与查询的列发生变化，搜索索引和上次的过滤结果都不能再使用
+        m_filterColumnIds.swap(filterColumnIds);
+        ClearSearchIndex();
+        bIncremental = false;
+    }
+    if (bIncremental && (lowerText == m_filterText)) {
+        //过滤条件没有变化
+        return true;
+    }
+
+    m_filterFlag.Cancel();
+    const bool bNarrow = bIncremental && (lowerText.find(m_filterText) != DString::npos);
+    const bool bWiden = bIncremental && !bNarrow && (m_filterText.find(lowerText) != DString::npos);
+
+    //上次的过滤尚未完成时，已检查过的行状态是准确的，未检查的行需要在新的条件下检查
+    std::vector<uint8_t> uncheckedFlags;
+    if (bNarrow || bWiden) {
+        GetFilterUncheckedRows(uncheckedFlags);
+    }
+    std::vector<size_t>().swap(m_filterPendingRows);
+    m_nFilterPendingPos = 0;
+    m_bFilterScanAll = false;
+
+    std::vector<size_t> candidateRows;
+    const bool bUseIndex = GetFilterCandidateRows(lowerText, candidateRows);
+    std::vector<size_t> changedRows;
+    bool bChanged = false;
+    if (bNarrow || bWiden) {
+        //查询文本增加了字符：只有满足上次条件的行，才可能满足新的条件
+        //查询文本删除了字符：满足上次条件的行，仍然满足新的条件，只需要检查其他的行
+        const uint8_t nCheckState = bNarrow ? 1 : 0;
+        size_t nCandidate = 0;
+        for (size_t nStorageIndex = 0; nStorageIndex < nCount; ++nStorageIndex) {
+            const uint8_t nState = m_filterStates[nStorageIndex];
+            if ((nState != nCheckState) && (uncheckedFlags.empty() || (uncheckedFlags[nStorageIndex] == 0))) {
+                continue;
+            }
+            if (bUseIndex) {
+                while ((nCandidate < candidateRows.size()) && (candidateRows[nCandidate] < nStorageIndex)) {
+                    ++nCandidate;
                 }
-                if (a.pStorage == nullptr) {
-                    return true;
+                if ((nCandidate >= candidateRows.size()) || (candidateRows[nCandidate] != nStorageIndex)) {
+                    //不在候选行中，一定不满足新的条件
+                    if (SetFilterState(nStorageIndex, false)) {
+                        changedRows.push_back(nStorageIndex);
+                    }
+                    continue;
                 }
-                const Storage& storageA = *a.pStorage;
-                const Storage& storageB = *b.pStorage;
-                return SortDataCompareFunc(storageA, storageB);
-            });
+            }
+            m_filterPendingRows.push_back(nStorageIndex);
+        }
     }
-    if (!bSortedUp) {
-        //降序
-        std::reverse(dataList.begin(), dataList.end());
+    else {
+        //新的查询：先隐藏所有的行，满足条件的行陆续显示
+        m_filterStates.assign(nCount, 0);
+        m_nFilterHideCount = nCount;
+        if (bUseIndex) {
+            m_filterPendingRows.swap(candidateRows);
+        }
+        else {
+            m_bFilterScanAll = true;
+        }
+        InvalidateRowHeightIndex();
+        bChanged = true;
     }
+    m_filterText = lowerText;
+    if (!changedRows.empty()) {
+        UpdateFilterRowHeights(changedRows);
+        bChanged = true;
+    }
+    StartFilterJob(bChanged);
     return true;
 }
 
-bool ListCtrlData::SortDataCompareFunc(const ListCtrlSubItemData2& a, const ListCtrlSubItemData2& b) const
+void ListCtrlData::ClearFilter()
 {
-    //默认按字符串比较, 区分大小写
-    return StringUtil::StringCompare(a.text.c_str(), b.text.c_str()) < 0;
+    m_filterFlag.Cancel();
+    const bool bChanged = (m_nFilterHideCount > 0);
+    m_filterText.clear();
+    std::vector<uint8_t>().swap(m_filterStates);
+    m_nFilterHideCount = 0;
+    std::vector<size_t>().swap(m_filterPendingRows);
+    m_nFilterPendingPos = 0;
+    m_bFilterScanAll = false;
+    if (bChanged) {
+        InvalidateRowHeightIndex();
+        EmitCountChanged();
+    }
 }
 
-void ListCtrlData::SetSortCompareFunction(ListCtrlDataCompareFunc pfnCompareFunc, void* pUserData)
+bool ListCtrlData::IsFilterActive() const
 {
-    m_pfnCompareFunc = pfnCompareFunc;
-    m_pUserData = pUserData;
+    return !m_filterText.empty();
+}
+
+bool ListCtrlData::IsFilterCompleted() const
+{
+    if (!IsFilterActive()) {
+        return true;
+    }
+    if (m_bFilterScanAll) {
+        return m_nFilterPendingPos >= m_filterStates.size();
+    }
+    return m_nFilterPendingPos >= m_filterPendingRows.size();
+}
+
+void ListCtrlData::GetFilteredDataItems(std::vector<size_t>& itemIndexs) const
+{
+    itemIndexs.clear();
+    const size_t nCount = m_rowDataList.size();
+    for (size_t itemIndex = 0; itemIndex < nCount; ++itemIndex) {
+        if (IsRowVisible(itemIndex)) {
+            itemIndexs.push_back(itemIndex);
+        }
+    }
+}
+
+void ListCtrlData::SetFilterCompletedCallback(const StdClosure& callback)
+{
+    m_filterCompletedCallback = callback;
+}
+
+bool ListCtrlData::GetFilterUncheckedRows(std::vector<uint8_t>& uncheckedFlags) const
+{
+    uncheckedFlags.clear();
+    if (IsFilterCompleted()) {
+        return false;
+    }
+    const size_t nCount = m_filterStates.size();
+    uncheckedFlags.resize(nCount, 0);
+    if (m_bFilterScanAll) {
+        for (size_t nStorageIndex = m_nFilterPendingPos; nStorageIndex < nCount; ++nStorageIndex) {
+            uncheckedFlags[nStorageIndex] = 1;
+        }
+    }
+    else {
+        for (size_t nPos = m_nFilterPendingPos; nPos < m_filterPendingRows.size(); ++nPos) {
+            const size_t nStorageIndex = m_filterPendingRows[nPos];
+            if (nStorageIndex < nCount) {
+                uncheckedFlags[nStorageIndex] = 1;
+            }
+        }
+    }
+    return true;
+}
+
+void ListCtrlData::GetFilterColumns(std::vector<const ListCtrlColumnStorage*>& columns) const
+{
+    columns.clear();
+    for (size_t columnId : m_filterColumnIds) {
+        auto iter = m_dataMap.find(columnId);
+        if (iter != m_dataMap.end()) {
+            columns.push_back(&iter->second);
+        }
+    }
+}
+
+bool ListCtrlData::MatchFilterRow(size_t nStorageIndex, const std::vector<const ListCtrlColumnStorage*>& columns)
+{
+    //按存储顺序依次检查时，同时建立搜索索引
+    const bool bAddToIndex = (nStorageIndex == m_searchIndex.GetRowCount()) &&
+                             (m_rowDataList.size() >= kMinSearchIndexRows);
+    bool bMatched = false;
+    for (const ListCtrlColumnStorage* pColumn : columns) {
+        if ((nStorageIndex >= pColumn->GetCount()) || !pColumn->HasData(nStorageIndex)) {
+            continue;
+        }
+        const size_t nLength = pColumn->GetTextLength(nStorageIndex);
+        if (nLength == 0) {
+            continue;
+        }
+        const DString::value_type* text = pColumn->GetText(nStorageIndex);
+        if (bAddToIndex) {
+            m_searchIndex.AddText(text, nLength);
+        }
+        if (!bMatched) {
+            bMatched = ListCtrlSearchIndex::MatchText(text, nLength, m_filterText);
+        }
+    }
+    if (bAddToIndex) {
+        m_searchIndex.EndRow();
+    }
+    return bMatched;
+}
+
+bool ListCtrlData::SetFilterState(size_t nStorageIndex, bool bMatched)
+{
+    uint8_t& nState = m_filterStates[nStorageIndex];
+    if ((nState != 0) == bMatched) {
+        return false;
+    }
+    nState = bMatched ? 1 : 0;
+    if (bMatched) {
+        ASSERT(m_nFilterHideCount > 0);
+        m_nFilterHideCount -= 1;
+    }
+    else {
+        m_nFilterHideCount += 1;
+    }
+    return true;
+}
+
+bool ListCtrlData::IsRowFilteredOut(size_t itemIndex) const
+{
+    if (m_nFilterHideCount == 0) {
+        return false;
+    }
+    const size_t nStorageIndex = GetStorageIndex(itemIndex);
+    return (nStorageIndex < m_filterStates.size()) && (m_filterStates[nStorageIndex] == 0);
+}
+
+bool ListCtrlData::GetFilterCandidateRows(const DString& lowerText, std::vector<size_t>& rows) const
+{
+    rows.clear();
+    const size_t nIndexCount = m_searchIndex.GetRowCount();
+    if ((nIndexCount == 0) || !m_searchIndex.GetCandidateRows(lowerText, rows)) {
+        rows.clear();
+        return false;
+    }
+    //索引建立后修改过文本的行、尚未建立索引的行，都需要检查
+    rows.insert(rows.end(), m_searchDirtyRows.begin(), m_searchDirtyRows.end());
+    const size_t nCount = m_rowDataList.size();
+    for (size_t nStorageIndex = nIndexCount; nStorageIndex < nCount; ++nStorageIndex) {
+        rows.push_back(nStorageIndex);
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    return true;
+}
+
+void ListCtrlData::StartFilterJob(bool bChanged)
+{
+    m_filterFlag.Cancel();
+    if (!ProcessFilterRows(kFilterBatchTimeMs, bChanged)) {
+        //剩余的行，在定时器中分批检查
+        GlobalManager::Instance().Timer().AddTimer(m_filterFlag.GetWeakFlag(),
+                                                   UiBind(&ListCtrlData::OnFilterTimer, this),
+                                                   kFilterTimerMs, 1);
+    }
+}
+
+void ListCtrlData::OnFilterTimer()
+{
+    if (!ProcessFilterRows(kFilterBatchTimeMs, false)) {
+        GlobalManager::Instance().Timer().AddTimer(m_filterFlag.GetWeakFlag(),
+                                                   UiBind(&ListCtrlData::OnFilterTimer, this),
+                                                   kFilterTimerMs, 1);
+    }
+    else if (m_filterCompletedCallback) {
+        //最后一批检查完成，通知外部更新与过滤结果相关的状态
+        m_filterCompletedCallback();
+    }
+}
+
+bool ListCtrlData::ProcessFilterRows(int64_t nTimeLimitMs, bool bChanged)
+{
+    std::vector<const ListCtrlColumnStorage*> columns;
+    GetFilterColumns(columns);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<size_t> changedRows;
+    size_t nCheckedRows = 0;
+    bool bCompleted = false;
+    while (true) {
+        size_t nStorageIndex = 0;
+        if (m_bFilterScanAll) {
+            if (m_nFilterPendingPos >= m_filterStates.size()) {
+                bCompleted = true;
+                break;
+            }
+            nStorageIndex = m_nFilterPendingPos++;
+        }
+        else {
+            if (m_nFilterPendingPos >= m_filterPendingRows.size()) {
+                bCompleted = true;
+                break;
+            }
+            nStorageIndex = m_filterPendingRows[m_nFilterPendingPos++];
+            if (nStorageIndex >= m_filterStates.size()) {
+                continue;
+            }
+        }
+        if (SetFilterState(nStorageIndex, MatchFilterRow(nStorageIndex, columns))) {
+            changedRows.push_back(nStorageIndex);
+        }
+        if ((++nCheckedRows % kFilterCheckTimeRows) == 0) {
+            const int64_t nElapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::steady_clock::now() - startTime).count();
+            if (nElapsedMs >= nTimeLimitMs) {
+                break;
+            }
+        }
+    }
+    if (bCompleted) {
+        std::vector<size_t>().swap(m_filterPendingRows);
+        m_nFilterPendingPos = 0;
+        m_bFilterScanAll = false;
+    }
+    if (!changedRows.empty()) {
+        UpdateFilterRowHeights(changedRows);
+        bChanged = true;
+    }
+    if (bChanged) {
+        EmitCountChanged();
+    }
+    return bCompleted;
+}
+
+void ListCtrlData::UpdateFilterRowHeights(const std::vector<size_t>& changedRows)
+{
+    if (changedRows.empty()) {
+        return;
+    }
+    if (m_atTopRowCount > 0) {
+        m_bAtTopRowListDirty = true;
+    }
+    if (m_bRowHeightIndexDirty || (m_rowHeightIndex.GetCount() != m_rowDataList.size())) {
+        return;
+    }
+    if (changedRows.size() > (m_rowDataList.size() / 16 + 1)) {
+        //变化的行较多时，重建行高索引
+        InvalidateRowHeightIndex();
+        return;
+    }
+    for (size_t nStorageIndex : changedRows) {
+        //排序后存储顺序与显示顺序不同，通过逆映射找到显示的行
+        const size_t itemIndex = GetDisplayIndex(nStorageIndex);
+        if (itemIndex < m_rowHeightIndex.GetCount()) {
+            m_rowHeightIndex.SetHeight(itemIndex, GetRowScrollHeight(itemIndex));
+        }
+    }
+}
+
+void ListCtrlData::RestartFilter()
+{
+    if (!IsFilterActive()) {
+        return;
+    }
+    m_filterFlag.Cancel();
+    //保留当前的过滤状态（界面显示不变），重新检查所有行，状态变化的行陆续更新
+    std::vector<size_t>().swap(m_filterPendingRows);
+    m_nFilterPendingPos = 0;
+    m_bFilterScanAll = true;
+    GlobalManager::Instance().Timer().AddTimer(m_filterFlag.GetWeakFlag(),
+                                               UiBind(&ListCtrlData::OnFilterTimer, this),
+                                               kFilterTimerMs, 1);
+}
+
+void ListCtrlData::OnFilterRowInserted(size_t nStorageIndex)
+{
+    if (nStorageIndex < m_searchIndex.GetRowCount()) {
+        //插入位置之后的行号都发生了变化
+        ClearSearchIndex();
+    }
+    if (!IsFilterActive()) {
+        return;
+    }
+    ASSERT(nStorageIndex <= m_filterStates.size());
+    if (nStorageIndex > m_filterStates.size()) {
+        return;
+    }
+    m_filterStates.insert(m_filterStates.begin() + nStorageIndex, (uint8_t)0);
+    m_nFilterHideCount += 1;
+    std::vector<const ListCtrlColumnStorage*> columns;
+    GetFilterColumns(columns);
+    SetFilterState(nStorageIndex, MatchFilterRow(nStorageIndex, columns));
+    if (IsFilterCompleted()) {
+        return;
+    }
+    //未完成的过滤：调整待检查的行号（新插入的行已经检查过）
+    if (m_bFilterScanAll) {
+        if (nStorageIndex < m_nFilterPendingPos) {
+            m_nFilterPendingPos += 1;
+        }
+    }
+    else {
+        for (size_t nPos = m_nFilterPendingPos; nPos < m_filterPendingRows.size(); ++nPos) {
+            if (m_filterPendingRows[nPos] >= nStorageIndex) {
+                m_filterPendingRows[nPos] += 1;
+            }
+        }
+    }
+}
+
+void ListCtrlData::OnFilterRowRemoved(size_t nStorageIndex)
+{
+    if (nStorageIndex < m_searchIndex.GetRowCount()) {
+        //删除位置之后的行号都发生了变化
+        ClearSearchIndex();
+    }
+    if (!IsFilterActive() || (nStorageIndex >= m_filterStates.size())) {
+        return;
+    }
+    if (m_filterStates[nStorageIndex] == 0) {
+        ASSERT(m_nFilterHideCount > 0);
+        m_nFilterHideCount -= 1;
+    }
+    m_filterStates.erase(m_filterStates.begin() + nStorageIndex);
+    if (IsFilterCompleted()) {
+        return;
+    }
+    //未完成的过滤：调整待检查的行号，并去掉被删除的行
+    if (m_bFilterScanAll) {
+        if (nStorageIndex < m_nFilterPendingPos) {
+            m_nFilterPendingPos -= 1;
+        }
+    }
+    else {
+        size_t nNewPos = m_nFilterPendingPos;
+        for (size_t nPos = m_nFilterPendingPos; nPos < m_filterPendingRows.size(); ++nPos) {
+            const size_t nPendingIndex = m_filterPendingRows[nPos];
+            if (nPendingIndex != nStorageIndex) {
+                m_filterPendingRows[nNewPos++] = (nPendingIndex > nStorageIndex) ? (nPendingIndex - 1) : nPendingIndex;
+            }
+        }
+        m_filterPendingRows.resize(nNewPos);
+    }
+}
+
+bool ListCtrlData::OnFilterTextChanged(size_t itemIndex, size_t columnId)
+{
+    if (std::find(m_filterColumnIds.begin(), m_filterColumnIds.end(), columnId) == m_filterColumnIds.end()) {
+        return false;
+    }
+    const size_t nStorageIndex = GetStorageIndex(itemIndex);
+    if (nStorageIndex < m_searchIndex.GetRowCount()) {
+        //索引中该行的文本已经过期，查询时总是需要检查该行；修改的行过多时，重建索引
+        m_searchDirtyRows.push_back(nStorageIndex);
+        if (m_searchDirtyRows.size() > std::max(kMinSearchIndexRows, m_searchIndex.GetRowCount() / 8)) {
+            ClearSearchIndex();
+        }
+    }
+    if (!IsFilterActive() || (nStorageIndex >= m_filterStates.size())) {
+        return false;
+    }
+    std::vector<const ListCtrlColumnStorage*> columns;
+    GetFilterColumns(columns);
+    if (!SetFilterState(nStorageIndex, MatchFilterRow(nStorageIndex, columns))) {
+        return false;
+    }
+    UpdateFilterRowHeights(std::vector<size_t>{ nStorageIndex });
+    return true;
+}
+
+void ListCtrlData::ClearSearchIndex()
+{
+    m_searchIndex.Clear();
+    std::vector<size_t>().swap(m_searchDirtyRows);
 }
 
 void ListCtrlData::SetSelectedElements(const std::vector<size_t>& selectedIndexs,
@@ -1604,7 +2763,7 @@ bool ListCtrlData::IsSelectableElement(size_t nElementIndex) const
     const ListCtrlData::RowDataList& itemDataList = GetItemDataList();
     if (nElementIndex < itemDataList.size()) {
         const ListCtrlItemData& rowData = itemDataList[nElementIndex];
-        bSelectable = IsSelectableRowData(rowData);
+        bSelectable = IsSelectableRowData(rowData) && IsRowVisible(nElementIndex);
     }
     return bSelectable;
 }
@@ -2,26 +2,29 @@
 #define UI_CONTROL_LIST_CTRL_DATA_PROVIDER_H_
 
 #include "duilib/Box/VirtualListBox.h"
+#include "duilib/Box/VirtualHeightIndex.h"
 #include "duilib/Control/ListCtrlDefs.h"
+#include "duilib/Control/ListCtrlColumnStorage.h"
+#include "duilib/Control/ListCtrlSearchIndex.h"
 
 namespace ui
 {
 /** 列表项的数据管理器
 */
 class ListCtrl;
+class FrameworkThread;
 struct ListCtrlSubItemData;
 class ListCtrlData : public ui::VirtualListBoxElement
 {
 public:
-    //用于存储的数据结构
+    //用于交换数据的数据结构（存储时按列存储，见ListCtrlColumnStorage）
     typedef ListCtrlSubItemData2 Storage;
-    typedef std::shared_ptr<Storage> StoragePtr;
-    typedef std::vector<StoragePtr> StoragePtrList;
-    typedef std::unordered_map<size_t, StoragePtrList> StorageMap;
+    typedef std::unordered_map<size_t, ListCtrlColumnStorage> StorageMap;
     typedef std::vector<ListCtrlItemData> RowDataList;
 
 public:
     ListCtrlData();
+    virtual ~ListCtrlData() override;
 
     /** 创建一个数据项
     * @param [in] pVirtualListBox 关联的虚表的接口
@@ -109,7 +112,12 @@ public:
     */
     int32_t GetMaxColumnWidth(size_t columnId) const;
 
+    /** 获取数据存储占用的内存大小（估算值，单位：字节）
+    */
+    size_t GetStorageMemorySize() const;
+
     /** 设置一列的勾选状态（Checked或者UnChecked）
+    *   设置了过滤条件时，只设置满足过滤条件的行，被过滤隐藏的行保持原来的勾选状态
     * @param [in] columnId 列的ID
     * @param [in] bChecked true表示选择，false表示取消选择
     * @param [in] bRefresh 是否刷新界面显示
@@ -222,6 +230,7 @@ public:
     bool IsDataItemChecked(size_t itemIndex) const;
 
     /** 设置所有行的勾选状态（Checked或者UnChecked）, 并刷新界面显示
+    *   设置了过滤条件时，只设置满足过滤条件的行，被过滤隐藏的行保持原来的勾选状态
     * @param [in] bChecked true表示勾选，false表示取消勾选
     */
     bool SetAllDataItemsCheck(bool bChecked);
@@ -428,12 +437,47 @@ public:
     bool SortDataItems(size_t nColumnId, size_t nColumnIndex, bool bSortedUp,
                        ListCtrlDataCompareFunc pfnCompareFunc, void* pUserData);
 
+    /** 按多列对数据排序（稳定排序，数据量较大时在多个线程中排序），并刷新界面显示
+    * @param [in] sortKeys 排序键，按顺序依次比较，各个排序键中的列ID必须有效
+    */
+    bool SortDataItems(const std::vector<ListCtrlSortKey>& sortKeys);
+
     /** 设置外部自定义的排序函数, 替换默认的排序函数
     * @param [in] pfnCompareFunc 数据比较函数
     * @param [in] pUserData 用户自定义数据，调用比较函数的时候，通过参数传回给比较函数
     */
     void SetSortCompareFunction(ListCtrlDataCompareFunc pfnCompareFunc, void* pUserData);
 
+public:
+    /** 设置过滤条件：只显示指定列中包含查询文本（不区分大小写）的行，并刷新界面显示
+    *   (1) 在上次查询文本的基础上增加或者删除字符时，只检查可能发生变化的行
+    *   (2) 数据量较大时，通过搜索索引查找候选行；首批结果立即显示，其余的行在定时器中分批检查，结果陆续显示
+    * @param [in] filterText 查询文本，为空表示取消过滤
+    * @param [in] columnIds 参与查询的列ID，为空表示当前所有列
+    */
+    bool SetFilter(const DString& filterText, const std::vector<size_t>& columnIds);
+
+    /** 取消过滤，并刷新界面显示
+    */
+    void ClearFilter();
+
+    /** 当前是否设置了过滤条件
+    */
+    bool IsFilterActive() const;
+
+    /** 过滤是否已经完成（所有行都已经检查）
+    */
+    bool IsFilterCompleted() const;
+
+    /** 获取过滤后显示的数据项（按显示顺序；过滤未完成时，为已经找到的结果）
+    * @param [out] itemIndexs 返回数据项的索引号，有效范围：[0, GetDataItemCount())
+    */
+    void GetFilteredDataItems(std::vector<size_t>& itemIndexs) const;
+
+    /** 设置过滤在定时器中分批检查完成后的回调函数（用于更新表头的勾选状态等）
+    */
+    void SetFilterCompletedCallback(const StdClosure& callback);
+
 public:
     /** 批量设置选择元素, 不更新界面显示
     * @param [in] selectedIndexs 需要设置选择的元素列表，有效范围：[0, GetElementCount())
@@ -489,68 +533,237 @@ private:
     */
     bool IsValidDataColumnId(size_t nColumnId) const;
 
-    /** 获取指定数据项的数据, 读取
+    /** 获取数据项在列存储中的索引号
+    * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
+    */
+    size_t GetStorageIndex(size_t itemIndex) const;
+
+    /** 按显示顺序调整各列存储中的数据顺序，调整后存储顺序与显示顺序相同
+    */
+    void ApplyStorageOrder();
+
+    /** 获取列存储中的行对应的数据项索引号（显示顺序）
+    * @param [in] nStorageIndex 数据项在列存储中的索引号
+    */
+    size_t GetDisplayIndex(size_t nStorageIndex) const;
+
+    /** 显示顺序到存储顺序的映射发生变化后，重建其逆映射
+    */
+    void RebuildDisplayOrder();
+
+    /** 获取指定数据项所在列的存储, 读取
     * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
     * @param [in] columnId 列的ID
-    * @return 如果失败则返回nullptr
+    * @param [out] nStorageIndex 返回数据项在列存储中的索引号
+    * @return 如果失败或者该数据项没有数据，则返回nullptr
     */
-    StoragePtr GetSubItemStorage(size_t itemIndex, size_t nColumnId) const;
+    const ListCtrlColumnStorage* GetSubItemStorage(size_t itemIndex, size_t nColumnId, size_t& nStorageIndex) const;
 
-    /** 获取指定数据项的数据, 写入
+    /** 获取指定数据项所在列的存储, 写入（该数据项没有数据时，设置为默认值）
     * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
     * @param [in] columnId 列的ID
+    * @param [out] nStorageIndex 返回数据项在列存储中的索引号
     * @return 如果失败则返回nullptr
     */
-    StoragePtr GetSubItemStorageForWrite(size_t itemIndex, size_t nColumnId);
+    ListCtrlColumnStorage* GetSubItemStorageForWrite(size_t itemIndex, size_t nColumnId, size_t& nStorageIndex);
+
+    /** 在所有列的存储中插入一行，并保存关联列的数据
+    * @param [in] nStorageIndex 插入位置（列存储中的索引号）
+    * @param [in] columnId 关联列的ID
+    * @param [in] storage 关联列的数据
+    * @return 如果文本缓冲区已满，撤销插入的行并返回false
+    */
+    bool InsertStorageRow(size_t nStorageIndex, size_t columnId, const Storage& storage);
 
     /** 获取各个列的数据，用于UI展示
     * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
-    * @param [out] subItemList 返回改行所有列的数据列表
+    * @param [out] subItemList 返回改行所有列的数据列表（数据指针指向storageList中的元素）
+    * @param [out] storageList 返回改行所有列的数据
     */
-    bool GetSubItemStorageList(size_t itemIndex, std::vector<ListCtrlSubItemData2Pair>& subItemList) const;
+    bool GetSubItemStorageList(size_t itemIndex,
+                               std::vector<ListCtrlSubItemData2Pair>& subItemList,
+                               std::vector<Storage>& storageList) const;
 
 public:
     /** 获取行属性数据
     */
     const RowDataList& GetItemDataList() const;
 
-    /** 是否为标准模式（行高都为默认行高，无隐藏行，无置顶行）
+    /** 是否为标准模式（行高都为默认行高，无隐藏行，无置顶行，无过滤）
     */
     bool IsNormalMode() const;
 
-private:
-    /** 排序数据
+    /** 数据项是否可见（设置为可见，并且满足过滤条件）
+    * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
+    */
+    bool IsRowVisible(size_t itemIndex) const;
+
+    /** 获取前itemIndex行中，可见且非置顶的行的高度总和（不含置顶行）
+    * @param [in] itemIndex 数据项的索引号，如果大于等于GetDataItemCount()，则统计所有行
     */
-    struct StorageData
-    {
-        size_t index;       //原来的数据索引号
-        StoragePtr pStorage;
-    };
+    int64_t GetRowsHeight(size_t itemIndex) const;
 
-    /** 对数据排序
-    * @param [in] dataList 待排序的数据
+    /** 获取所有可见的置顶行的高度总和
+    */
+    int64_t GetAtTopRowsHeight() const;
+
+    /** 获取可见的置顶行列表（已经按置顶优先级排序，优先级高的在前面）
+    */
+    const std::vector<size_t>& GetAtTopRowList() const;
+
+    /** 根据纵向滚动偏移量，查找所在的行（可见且非置顶的行）
+    * @param [in] nOffset 纵向滚动偏移量（不含置顶行）
+    * @return 返回行的索引号，如果偏移量超出范围，返回Box::InvalidIndex
+    */
+    size_t FindRowByOffset(int64_t nOffset) const;
+
+    /** 查找下一个可见且非置顶的行
+    * @param [in] itemIndex 当前行的索引号
+    * @return 返回下一行的索引号，如果没有，返回Box::InvalidIndex
+    */
+    size_t GetNextRow(size_t itemIndex) const;
+
+    /** 获取行在滚动区域中所占的高度（隐藏行、置顶行的高度为0）
+    */
+    int32_t GetRowScrollHeight(const ListCtrlItemData& rowData) const;
+
+    /** 获取行在滚动区域中所占的高度（隐藏行、不满足过滤条件的行、置顶行的高度为0）
+    * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
+    */
+    int32_t GetRowScrollHeight(size_t itemIndex) const;
+
+private:
+    /** 使用自定义的比较函数，计算排序后的顺序（稳定排序）
+    * @param [out] sortedOrders 返回排序后的顺序：排序后的第i行，为排序前的第sortedOrders[i]行
+    * @param [in] columnStorage 排序列的数据
     * @param [in] nColumnId 列的ID
     * @param [in] nColumnIndex 列的序号
     * @param [in] bSortedUp true表示升序，false表示降序
     * @param [in] pfnCompareFunc 数据比较函数
     * @param [in] pUserData 用户自定义数据，调用比较函数的时候，通过参数传回给比较函数
     */
-    bool SortStorageData(std::vector<StorageData>& dataList,
-                         size_t nColumnId, size_t nColumnIndex, bool bSortedUp,
-                         ListCtrlDataCompareFunc pfnCompareFunc,
-                         void* pUserData);
+    bool SortByCompareFunc(std::vector<size_t>& sortedOrders,
+                           const ListCtrlColumnStorage& columnStorage,
+                           size_t nColumnId, size_t nColumnIndex, bool bSortedUp,
+                           ListCtrlDataCompareFunc pfnCompareFunc,
+                           void* pUserData) const;
+
+    /** 按排序键，计算排序后的顺序（稳定排序，数据量较大时在多个线程中排序）
+    * @param [out] sortedOrders 返回排序后的顺序：排序后的第i行，为排序前的第sortedOrders[i]行
+    * @param [in] sortKeys 排序键
+    */
+    bool SortBySortKeys(std::vector<size_t>& sortedOrders,
+                        const std::vector<ListCtrlSortKey>& sortKeys) const;
 
-    /** 默认的数据比较函数
-    * @param [in] a 第一个比较数据
-    * @param [in] b 第二个比较数据
-    * @return 如果 (a < b)，返回true，否则返回false
+    /** 应用排序后的顺序：更新显示顺序到存储顺序的映射，并调整行数据的顺序
     */
-    bool SortDataCompareFunc(const ListCtrlSubItemData2& a, const ListCtrlSubItemData2& b) const;
+    void ApplySortedOrders(const std::vector<size_t>& sortedOrders);
+
+    /** 并行执行一组任务，等待所有任务执行完成后返回
+    *   第一个任务在当前线程中执行，其他任务投递到排序的后台线程（首次使用时创建）；投递失败的任务在当前线程中执行
+    * @param [in] tasks 任务列表，任务之间不能有依赖关系
+    */
+    void RunParallelTasks(const std::vector<StdClosure>& tasks) const;
 
     /** 更新个性化数据（隐藏行、行高、置顶等）
     */
     void UpdateNormalMode();
 
+    /** 行数据变化后，更新行高索引
+    * @param [in] itemIndex 数据项的索引号
+    * @param [in] oldRowData 修改前的行数据
+    */
+    void UpdateRowHeightIndex(size_t itemIndex, const ListCtrlItemData& oldRowData);
+
+    /** 标记行高索引和置顶行列表需要重建（插入、删除、排序等操作后调用）
+    */
+    void InvalidateRowHeightIndex();
+
+    /** 检查并重建行高索引
+    */
+    void CheckRowHeightIndex() const;
+
+    /** 检查并重建置顶行列表
+    */
+    void CheckAtTopRowList() const;
+
+private:
+    /** 获取参与查询的列的存储
+    */
+    void GetFilterColumns(std::vector<const ListCtrlColumnStorage*>& columns) const;
+
+    /** 判断一行是否满足过滤条件（该行是下一个需要建立索引的行时，同时添加到搜索索引）
+    * @param [in] nStorageIndex 数据项在列存储中的索引号
+    * @param [in] columns 参与查询的列的存储
+    */
+    bool MatchFilterRow(size_t nStorageIndex, const std::vector<const ListCtrlColumnStorage*>& columns);
+
+    /** 设置一行的过滤状态
+    * @return 如果状态发生变化，返回true
+    */
+    bool SetFilterState(size_t nStorageIndex, bool bMatched);
+
+    /** 数据项是否因不满足过滤条件而隐藏
+    * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
+    */
+    bool IsRowFilteredOut(size_t itemIndex) const;
+
+    /** 获取未完成的过滤中尚未检查的行
+    * @param [out] uncheckedFlags 返回每行是否尚未检查（按列存储中的索引号），过滤已完成时为空
+    * @return 如果存在尚未检查的行，返回true
+    */
+    bool GetFilterUncheckedRows(std::vector<uint8_t>& uncheckedFlags) const;
+
+    /** 获取通过搜索索引查到的候选行（含索引建立后修改过文本的行、未建立索引的行）
+    * @param [in] lowerText 查询文本（已转换为小写）
+    * @param [out] rows 返回候选行在列存储中的索引号（升序）
+    * @return 如果不能使用搜索索引，返回false
+    */
+    bool GetFilterCandidateRows(const DString& lowerText, std::vector<size_t>& rows) const;
+
+    /** 开始分批检查待检查的行
+    * @param [in] bChanged 检查之前，过滤状态是否已经发生变化
+    */
+    void StartFilterJob(bool bChanged);
+
+    /** 定时器回调：检查下一批行
+    */
+    void OnFilterTimer();
+
+    /** 在时间限制内检查一批行，并刷新界面显示
+    * @param [in] nTimeLimitMs 时间限制（毫秒）
+    * @param [in] bChanged 检查之前，过滤状态是否已经发生变化
+    * @return 如果所有行都已经检查完成，返回true
+    */
+    bool ProcessFilterRows(int64_t nTimeLimitMs, bool bChanged);
+
+    /** 过滤状态变化后，更新行高索引
+    * @param [in] changedRows 过滤状态变化的行在列存储中的索引号
+    */
+    void UpdateFilterRowHeights(const std::vector<size_t>& changedRows);
+
+    /** 存储中行号整体发生变化（调整存储顺序、删除参与查询的列等）后，重新检查所有行
+    *   保留当前的过滤状态，检查过程中界面不会先隐藏所有的行
+    */
+    void RestartFilter();
+
+    /** 列存储中插入了一行，更新过滤状态和搜索索引
+    */
+    void OnFilterRowInserted(size_t nStorageIndex);
+
+    /** 列存储中删除了一行，更新过滤状态和搜索索引
+    */
+    void OnFilterRowRemoved(size_t nStorageIndex);
+
+    /** 数据项的文本发生变化，更新过滤状态和搜索索引
+    * @return 如果过滤状态发生变化，返回true
+    */
+    bool OnFilterTextChanged(size_t itemIndex, size_t columnId);
+
+    /** 清空搜索索引（存储中行号发生变化后，索引中的行号失效）
+    */
+    void ClearSearchIndex();
+
 private:
     /** 视图控件接口
     */
@@ -560,7 +773,7 @@ private:
     */
     bool m_bAutoCheckSelect;
 
-    /** 数据，按列保存，每个列一个数组
+    /** 数据，按列保存，每个列一个列存储
     */
     StorageMap m_dataMap;
 
@@ -568,10 +781,24 @@ private:
     */
     RowDataList m_rowDataList;
 
+    /** 显示顺序到存储顺序的映射：第i行的数据，保存在各列存储的第m_storageOrder[i]个元素中
+    *   排序时只修改该映射，不移动各列的数据；为空时表示存储顺序与显示顺序相同
+    */
+    std::vector<size_t> m_storageOrder;
+
+    /** 存储顺序到显示顺序的映射（m_storageOrder的逆映射）：列存储中第i个元素，显示在第m_displayOrder[i]行
+    *   用于过滤状态变化时，按存储中的行号更新行高索引；m_storageOrder为空时，该映射也为空
+    */
+    std::vector<size_t> m_displayOrder;
+
     /** 外部设置的排序函数
     */
     ListCtrlDataCompareFunc m_pfnCompareFunc;
 
+    /** 并行排序的后台线程（首次并行排序时创建）
+    */
+    mutable std::vector<std::unique_ptr<FrameworkThread>> m_sortThreads;
+
     /** 外部设置的排序函数附加数据
     */
     void* m_pUserData;
@@ -603,6 +830,70 @@ private:
     /** 当前默认的行高
     */
     int32_t m_nDefaultItemHeight;
+
+    /** 行高索引（可见且非置顶的行，按行高计算；其他行的高度为0），用于非标准模式下快速定位行
+    */
+    mutable VirtualHeightIndex m_rowHeightIndex;
+
+    /** 行高索引是否需要重建
+    */
+    mutable bool m_bRowHeightIndexDirty;
+
+    /** 可见的置顶行列表（按置顶优先级排序）
+    */
+    mutable std::vector<size_t> m_atTopRowList;
+
+    /** 可见的置顶行的高度总和
+    */
+    mutable int64_t m_nAtTopRowsHeight;
+
+    /** 置顶行列表是否需要重建
+    */
+    mutable bool m_bAtTopRowListDirty;
+
+    /** 过滤：查询文本（已转换为小写），为空表示未设置过滤条件
+    */
+    DString m_filterText;
+
+    /** 过滤：参与查询的列ID（已排序），也是搜索索引对应的列
+    */
+    std::vector<size_t> m_filterColumnIds;
+
+    /** 过滤：每行是否满足过滤条件（按列存储中的索引号），设置过滤条件后与行数相同
+    */
+    std::vector<uint8_t> m_filterStates;
+
+    /** 过滤：不满足过滤条件的行数
+    */
+    size_t m_nFilterHideCount;
+
+    /** 过滤：待检查的行（列存储中的索引号，升序）
+    */
+    std::vector<size_t> m_filterPendingRows;
+
+    /** 过滤：是否需要检查所有行（此时不使用m_filterPendingRows）
+    */
+    bool m_bFilterScanAll;
+
+    /** 过滤：检查进度
+    */
+    size_t m_nFilterPendingPos;
+
+    /** 过滤：分批检查的定时器取消机制
+    */
+    WeakCallbackFlag m_filterFlag;
+
+    /** 过滤：在定时器中分批检查完成后的回调函数
+    */
+    StdClosure m_filterCompletedCallback;
+
+    /** 搜索索引（按列存储中的索引号）
+    */
+    ListCtrlSearchIndex m_searchIndex;
+
+    /** 搜索索引建立后，文本被修改过的行（列存储中的索引号），查询时总是需要检查
+    */
+    std::vector<size_t> m_searchDirtyRows;
 };
 
 }//namespace ui
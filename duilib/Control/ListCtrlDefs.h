@@ -75,13 +75,21 @@ struct ListCtrlSubItemData2
     bool bEditable = false;         //是否可编辑
 };
 
-//列数据的智能指针
+//列数据的指针（指向临时读取的数据，只在回调函数中有效，不可保存）
+typedef const ListCtrlSubItemData2* ListCtrlSubItemData2ConstPtr;
+
+//[已废弃] 列数据按列存储后，不再为每个单元格创建共享指针，内部已不再使用该类型，仅保留用于兼容
+//IListCtrlView接口、ListCtrlSubItemData2Pair中的列数据，已改为ListCtrlSubItemData2ConstPtr类型
 typedef std::shared_ptr<ListCtrlSubItemData2> ListCtrlSubItemData2Ptr;
 
+/** 列的ID与列的数据
+*   注意：pSubItemData原为ListCtrlSubItemData2Ptr（共享指针），现为只读的原始指针，只在FillDataItem回调中有效；
+*   通过"->"访问数据的代码不需要修改，调用get()、保存或者修改该指针的代码需要调整（需要保存时，复制一份数据）
+*/
 struct ListCtrlSubItemData2Pair
 {
     size_t nColumnId = 0; //列的ID
-    ListCtrlSubItemData2Ptr pSubItemData; //列的数据
+    ListCtrlSubItemData2ConstPtr pSubItemData = nullptr; //列的数据（只读，不可保存）
 };
 
 /** 比较数据的附加信息
@@ -93,6 +101,16 @@ struct ListCtrlCompareParam
     void* pUserData = nullptr; //用户自定义数据，设置比较函数的时候一同传入
 };
 
+/** 多列排序的排序键
+*/
+struct ListCtrlSortKey
+{
+    size_t nColumnIndex = 0;   //列的索引号，有效范围：[0, GetColumnCount())
+    size_t nColumnId = 0;      //列的ID（通过ListCtrl排序时，由ListCtrl根据nColumnIndex设置）
+    bool bSortedUp = true;     //true表示升序，false表示降序
+    bool bNumeric = false;     //true表示将文本解析为数值后比较，false表示按字符串比较（区分大小写）
+};
+
 /** 存储数据的比较函数的原型, 实现升序的比较(a < b)
 * @param [in] a 第一个比较数据
 * @param [in] b 第二个比较数据
@@ -125,11 +143,23 @@ public:
                               const std::vector<ListCtrlSubItemData2Pair>& subItemList) = 0;
 
 
-    /** 获取某列的宽度最大值
+    /** 获取测量数据项宽度的标识（数据项的样式、DPI、字体等），标识变化后，之前测量的宽度全部失效
+    *   （替代原来的GetMaxDataItemWidth接口；默认实现返回空串，即不支持测量，自定义视图不需要自动调整列宽时可不实现）
+    * @return 返回测量标识；如果不支持测量，返回空串
+    */
+    virtual DString GetDataItemMeasureKey() { return DString(); }
+
+    /** 测量数据项的宽度（用于自动调整列宽），仅当GetDataItemMeasureKey返回非空串时调用
     * @param [in] subItemList 数据子项（代表每一列的数据）
-    * @return 返回该列宽度的最大值，返回的是DPI自适应后的值； 如果失败返回-1
+    * @param [out] itemWidths 返回每个数据子项的宽度，与subItemList一一对应，返回的是DPI自适应后的值
+    * @return 成功返回true，失败返回false（默认实现返回false）
     */
-    virtual int32_t GetMaxDataItemWidth(const std::vector<ListCtrlSubItemData2Ptr>& subItemList) = 0;
+    virtual bool MeasureDataItemWidths(const std::vector<ListCtrlSubItemData2ConstPtr>& /*subItemList*/,
+                                       std::vector<int32_t>& itemWidths)
+    {
+        itemWidths.clear();
+        return false;
+    }
 };
 
 /** 列表中使用的Label控件，用于显示文本，并提供文本编辑功能
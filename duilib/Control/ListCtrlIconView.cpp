@@ -190,7 +190,7 @@ bool ListCtrlIconView::FillDataItem(Control* pControl,
     if ((pControl == nullptr) || (m_pListCtrl == nullptr)) {
         return false;
     }
-    ListCtrlSubItemData2Ptr pSubItemData;
+    ListCtrlSubItemData2ConstPtr pSubItemData;
     int32_t nImageId = -1;
     size_t nColumnId = m_pListCtrl->GetColumnId(0); //取第一列的ID
     for (const ListCtrlSubItemData2Pair& pair : subItemList) {
@@ -294,10 +294,18 @@ bool ListCtrlIconView::FillDataItem(Control* pControl,
     return true;
 }
 
-int32_t ListCtrlIconView::GetMaxDataItemWidth(const std::vector<ListCtrlSubItemData2Ptr>& /*subItemList*/)
+DString ListCtrlIconView::GetDataItemMeasureKey()
 {
     //不需要实现
-    return -1;
+    return DString();
+}
+
+bool ListCtrlIconView::MeasureDataItemWidths(const std::vector<ListCtrlSubItemData2ConstPtr>& /*subItemList*/,
+                                             std::vector<int32_t>& itemWidths)
+{
+    //不需要实现
+    itemWidths.clear();
+    return false;
 }
 
 }//namespace ui
@@ -60,11 +60,18 @@ protected:
                               const std::vector<ListCtrlSubItemData2Pair>& subItemList) override;
 
 
-    /** 获取某列的宽度最大值
+    /** 获取测量数据项宽度的标识（数据项的样式、DPI等），标识变化后，之前测量的宽度全部失效
+    * @return 返回测量标识；如果不支持测量，返回空串
+    */
+    virtual DString GetDataItemMeasureKey() override;
+
+    /** 测量数据项的宽度（用于自动调整列宽）
     * @param [in] subItemList 数据子项（代表每一列的数据）
-    * @return 返回该列宽度的最大值，返回的是DPI自适应后的值； 如果失败返回-1
+    * @param [out] itemWidths 返回每个数据子项的宽度，与subItemList一一对应，返回的是DPI自适应后的值
+    * @return 成功返回true，失败返回false
     */
-    virtual int32_t GetMaxDataItemWidth(const std::vector<ListCtrlSubItemData2Ptr>& subItemList) override;
+    virtual bool MeasureDataItemWidths(const std::vector<ListCtrlSubItemData2ConstPtr>& subItemList,
+                                       std::vector<int32_t>& itemWidths) override;
 
 private:
     /** ListCtrl 控件接口
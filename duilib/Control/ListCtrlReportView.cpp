@@ -1,6 +1,8 @@
 #include "ListCtrlReportView.h" 
 #include "ListCtrl.h"
 #include "duilib/Render/AutoClip.h"
+#include <tuple>
+#include <unordered_map>
 
 //包含类：ListCtrlReportView / ListCtrlReportLayout
 
@@ -207,26 +209,10 @@ size_t ListCtrlReportView::GetTopDataItemIndex(int64_t nScrollPosY) const
     if (pDataProvider == nullptr) {
         return itemIndex;
     }
-    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;
-    const size_t dataItemCount = itemDataList.size();
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = rowData.nItemHeight;
-        if (nItemHeight < 0) {
-            //取默认行高
-            nItemHeight = m_pListCtrl->GetDataItemHeight();
-        }
-        if (!rowData.bVisible || (nItemHeight  == 0)){
-            continue;
-        }
-        totalItemHeight += nItemHeight;
-        //如果每行高度都相同，相当于 nScrollPosY / ItemHeight
-        if (totalItemHeight > nScrollPosY) {
-            itemIndex = index;
-            break;
-        }
+    //通过行高索引查找，如果每行高度都相同，相当于 nScrollPosY / ItemHeight
+    size_t nTopIndex = pDataProvider->FindRowByOffset(nScrollPosY);
+    if (nTopIndex != Box::InvalidIndex) {
+        itemIndex = nTopIndex;
     }
     return itemIndex;
 }
@@ -279,71 +265,32 @@ void ListCtrlReportView::GetDataItemsToShow(int64_t nScrollPosY, size_t maxCount
     if (pDataProvider == nullptr) {
         return;
     }
-    size_t nTopDataItemIndex = Box::InvalidIndex; //顶部可见的第一个元素序号
-    const int32_t nDefaultItemHeight = m_pListCtrl->GetDataItemHeight(); //默认行高
-    //置顶的元素序号
-    struct AlwaysAtTopData
-    {
-        int8_t nAlwaysAtTop;    //置顶优先级
-        size_t nItemIndex;      //元素索引
-        int32_t nItemHeight;    //元素的高度
-    };
-    std::vector<AlwaysAtTopData> alwaysAtTopItemList;
-    
-    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;
-    const size_t dataItemCount = itemDataList.size();
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
-            //不可见的，跳过
-            continue;
-        }
+    const size_t nDataItemCount = pDataProvider->GetDataItemCount();
 
-        if (rowData.nAlwaysAtTop >= 0) {
-            //置顶的元素
-            if (alwaysAtTopItemList.size() < maxCount) {
-                alwaysAtTopItemList.push_back({ rowData.nAlwaysAtTop, index, nItemHeight });
-            }
-            continue;
-        }
-
-        if (nTopDataItemIndex == Box::InvalidIndex) {
-            totalItemHeight += nItemHeight;
-            //如果每行高度都相同，相当于 nScrollPosY / ItemHeight
-            if (totalItemHeight > nScrollPosY) {
-                nTopDataItemIndex = index;
-                nPrevItemHeights = totalItemHeight - nItemHeight;
-            }
-        }
-
-        if ((nTopDataItemIndex != Box::InvalidIndex) && (itemIndexList.size() < maxCount)){
-            itemIndexList.push_back({ index, nItemHeight });
+    //置顶的元素（已经按置顶优先级排序）
+    const std::vector<size_t>& atTopRowList = pDataProvider->GetAtTopRowList();
+    for (size_t index : atTopRowList) {
+        if (atTopItemIndexList.size() >= maxCount) {
+            break;
         }
-    }
-
-    //对置顶的排序
-    if (!alwaysAtTopItemList.empty()) {
-        std::stable_sort(alwaysAtTopItemList.begin(), alwaysAtTopItemList.end(),
-            [](const AlwaysAtTopData& a, const AlwaysAtTopData& b) {
-                //nAlwaysAtTop值大的，排在前面
-                return a.nAlwaysAtTop > b.nAlwaysAtTop;
-            });
-    }
-    for (const AlwaysAtTopData& item : alwaysAtTopItemList) {
-        atTopItemIndexList.push_back({ item.nItemIndex, item.nItemHeight });
+        atTopItemIndexList.push_back({ index, GetDataItemHeight(index) });
     }
     if (atTopItemIndexList.size() >= maxCount) {
-        atTopItemIndexList.resize(maxCount);
-        itemIndexList.clear();
+        return;
     }
-    else {
-        size_t nLeftCount = maxCount - atTopItemIndexList.size();
-        if (itemIndexList.size() > nLeftCount) {
-            itemIndexList.resize(nLeftCount);
-        }
+    const size_t nLeftCount = maxCount - atTopItemIndexList.size();
+
+    //顶部可见的第一个元素序号
+    size_t nTopDataItemIndex = pDataProvider->FindRowByOffset(nScrollPosY);
+    if (nTopDataItemIndex == Box::InvalidIndex) {
+        return;
+    }
+    nPrevItemHeights = pDataProvider->GetRowsHeight(nTopDataItemIndex);
+    size_t index = nTopDataItemIndex;
+    while ((index != Box::InvalidIndex) && (itemIndexList.size() < nLeftCount)) {
+        ASSERT_UNUSED_VARIABLE(index < nDataItemCount);
+        itemIndexList.push_back({ index, pDataProvider->GetRowScrollHeight(index) });
+        index = pDataProvider->GetNextRow(index);
     }
     ASSERT((itemIndexList.size() + atTopItemIndexList.size()) <= maxCount);
 }
@@ -355,6 +302,9 @@ int32_t ListCtrlReportView::GetMaxDataItemsToShow(int64_t nScrollPosY, int32_t n
     if (pItemIndexList) {
         pItemIndexList->clear();
     }
+    if (pAtTopItemIndexList) {
+        pAtTopItemIndexList->clear();
+    }
     ASSERT(m_pListCtrl != nullptr);
     if (m_pListCtrl == nullptr) {
         return 0;
@@ -372,95 +322,45 @@ int32_t ListCtrlReportView::GetMaxDataItemsToShow(int64_t nScrollPosY, int32_t n
     if (pDataProvider == nullptr) {
         return 0;
     }
-    size_t nTopDataItemIndex = Box::InvalidIndex; //顶部可见的第一个元素序号
-    const int32_t nDefaultItemHeight = m_pListCtrl->GetDataItemHeight(); //默认行高
-    //置顶的元素序号
-    struct AlwaysAtTopData
-    {
-        int8_t nAlwaysAtTop;
-        size_t index;
-    };
-    std::vector<AlwaysAtTopData> alwaysAtTopItemList;
-    std::vector<size_t> itemIndexList;
-
-    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;
-    const size_t dataItemCount = itemDataList.size();
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
-            //不可见的，跳过
-            continue;
-        }
-
-        if (rowData.nAlwaysAtTop >= 0) {
-            //置顶的元素
-            alwaysAtTopItemList.push_back({ rowData.nAlwaysAtTop, index });
-            continue;
-        }
+    const size_t nDataItemCount = pDataProvider->GetDataItemCount();
+    int32_t nShowItemCount = 0;
+    int64_t nTotalHeight = 0;
 
-        if (nTopDataItemIndex == Box::InvalidIndex) {
-            totalItemHeight += nItemHeight;
-            //如果每行高度都相同，相当于 nScrollPosY / ItemHeight
-            if (totalItemHeight > nScrollPosY) {
-                nTopDataItemIndex = index;
+    //置顶的元素显示在最上面
+    const std::vector<size_t>& atTopRowList = pDataProvider->GetAtTopRowList();
+    for (size_t index : atTopRowList) {
+        nTotalHeight += GetDataItemHeight(index);
+        if (nTotalHeight < nRectHeight) {
+            if (pItemIndexList) {
+                pItemIndexList->push_back(index);
+            }
+            if (pAtTopItemIndexList != nullptr) {
+                pAtTopItemIndexList->push_back(index);
             }
+            ++nShowItemCount;
         }
-
-        if (nTopDataItemIndex != Box::InvalidIndex) {
-            itemIndexList.push_back(index);
+        else {
+            nShowItemCount += 2;
+            return nShowItemCount;
         }
     }
 
-    //对置顶的排序
-    if (!alwaysAtTopItemList.empty()) {
-        std::stable_sort(alwaysAtTopItemList.begin(), alwaysAtTopItemList.end(),
-            [](const AlwaysAtTopData& a, const AlwaysAtTopData& b) {
-                //nAlwaysAtTop值大的，排在前面
-                return a.nAlwaysAtTop > b.nAlwaysAtTop;
-            });
-    }
-    std::vector<size_t> atTopIndexList;
-    std::vector<size_t> tempItemIndexList;
-    tempItemIndexList.swap(itemIndexList);
-    for (const AlwaysAtTopData& item : alwaysAtTopItemList) {
-        itemIndexList.push_back(item.index);
-        atTopIndexList.push_back(item.index);
-    }
-    for (size_t index : tempItemIndexList) {
-        itemIndexList.push_back(index);
-    }
-    int32_t nShowItemCount = 0;
-    int64_t nTotalHeight = 0;
-    for (size_t index : itemIndexList) {
-        if (index >= dataItemCount) {
-            continue;
-        }
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = rowData.nItemHeight;
-        if (nItemHeight < 0) {
-            //取默认行高
-            nItemHeight = nDefaultItemHeight;
-        }
-        nTotalHeight += nItemHeight;
+    //从顶部可见的第一个元素开始，逐行向下统计
+    size_t index = pDataProvider->FindRowByOffset(nScrollPosY);
+    while (index != Box::InvalidIndex) {
+        ASSERT_UNUSED_VARIABLE(index < nDataItemCount);
+        nTotalHeight += pDataProvider->GetRowScrollHeight(index);
         if (nTotalHeight < nRectHeight) {
             if (pItemIndexList) {
                 pItemIndexList->push_back(index);
             }
-            if (pAtTopItemIndexList != nullptr) {
-                if (std::find(atTopIndexList.begin(),
-                              atTopIndexList.end(), index) != atTopIndexList.end()) {
-                    pAtTopItemIndexList->push_back(index);
-                }
-            }
             ++nShowItemCount;
         }
         else {
             nShowItemCount += 2;
             break;
         }
+        index = pDataProvider->GetNextRow(index);
     }
     return nShowItemCount;
 }
@@ -476,33 +376,10 @@ int64_t ListCtrlReportView::GetDataItemTotalHeights(size_t itemIndex, bool bIncl
     if (pDataProvider == nullptr) {
         return 0;
     }
-    const int32_t nDefaultItemHeight = m_pListCtrl->GetDataItemHeight(); //默认行高
-    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;
-    const size_t dataItemCount = itemDataList.size();
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
-            //不可见的，跳过
-            continue;
-        }
-
-        if (rowData.nAlwaysAtTop >= 0) {
-            //置顶的元素，需要统计在内
-            if (bIncludeAtTops) {
-                totalItemHeight += nItemHeight;
-            }            
-        }
-        else if (index < itemIndex) {
-            //符合要求的元素
-            totalItemHeight += nItemHeight;
-        }
-        else if (!bIncludeAtTops) {
-            //已经完成
-            break;
-        }
+    int64_t totalItemHeight = pDataProvider->GetRowsHeight(itemIndex);
+    if (bIncludeAtTops) {
+        //置顶的元素，需要统计在内
+        totalItemHeight += pDataProvider->GetAtTopRowsHeight();
     }
     return totalItemHeight;
 }
@@ -871,7 +748,7 @@ bool ListCtrlReportView::FillDataItem(Control* pControl,
     //          2. 每一列，放置一个ListCtrlSubItem控件
     //          3. ListCtrlSubItem 是LabelBox的子类
 
-    std::map<size_t, ListCtrlSubItemData2Ptr> subItemDataMap;
+    std::map<size_t, ListCtrlSubItemData2ConstPtr> subItemDataMap;
     for (const ListCtrlSubItemData2Pair& dataPair : subItemList) {
         subItemDataMap[dataPair.nColumnId] = dataPair.pSubItemData;
     }
@@ -881,7 +758,7 @@ bool ListCtrlReportView::FillDataItem(Control* pControl,
     {
         size_t nColumnId = Box::InvalidIndex;
         int32_t nColumnWidth = 0;
-        ListCtrlSubItemData2Ptr pStorage;
+        ListCtrlSubItemData2ConstPtr pStorage;
     };
     std::vector<ElementData> elementDataList;
     const size_t nColumnCount = pHeaderCtrl->GetColumnCount();
@@ -962,7 +839,7 @@ bool ListCtrlReportView::FillDataItem(Control* pControl,
 
         //填充数据，设置属性        
         pSubItem->SetFixedWidth(UiFixedInt(elementData.nColumnWidth), true, false);
-        const ListCtrlSubItemData2Ptr& pStorage = elementData.pStorage;
+        const ListCtrlSubItemData2ConstPtr& pStorage = elementData.pStorage;
         if (pStorage != nullptr) {
             pSubItem->SetText(pStorage->text.c_str());
             if (pStorage->nTextFormat != 0) {
@@ -1024,11 +901,44 @@ bool ListCtrlReportView::FillDataItem(Control* pControl,
     return true;
 }
 
-int32_t ListCtrlReportView::GetMaxDataItemWidth(const std::vector<ListCtrlSubItemData2Ptr>& subItemList)
+DString ListCtrlReportView::GetDataItemMeasureKey()
 {
-    int32_t nMaxWidth = -1;
     if (m_pListCtrl == nullptr) {
-        return nMaxWidth;
+        return DString();
+    }
+    //测量结果与数据项的样式、DPI、图片列表中图标的大小、字体、文本内边距相关
+    UiSize imageSize;
+    const ImageList* pImageList = m_pListCtrl->GetImageList(ListCtrlType::Report);
+    if (pImageList != nullptr) {
+        imageSize = pImageList->GetImageSize();
+    }
+    //字体和文本内边距由子项的样式决定，样式中的字体ID对应的字体可能变化（字体列表的版本号）
+    ListCtrlSubItem defaultSubItem(m_pListCtrl->GetWindow());
+    defaultSubItem.SetClass(m_pListCtrl->GetDataSubItemClass());
+    const UiPadding rcTextPadding = defaultSubItem.GetTextPadding();
+    return StringUtil::Printf(_T("%s|%s|%u|%d|%d|%s|%u|%d,%d,%d,%d"),
+                              m_pListCtrl->GetDataItemClass().c_str(),
+                              m_pListCtrl->GetDataSubItemClass().c_str(),
+                              Dpi().GetScale(), imageSize.cx, imageSize.cy,
+                              defaultSubItem.GetFontId().c_str(),
+                              GlobalManager::Instance().Font().GetFontEpoch(),
+                              rcTextPadding.left, rcTextPadding.top,
+                              rcTextPadding.right, rcTextPadding.bottom);
+}
+
+bool ListCtrlReportView::MeasureDataItemWidths(const std::vector<ListCtrlSubItemData2ConstPtr>& subItemList,
+                                               std::vector<int32_t>& itemWidths)
+{
+    itemWidths.clear();
+    if (m_pListCtrl == nullptr) {
+        return false;
+    }
+    IRender* pRender = nullptr;
+    if (GetWindow() != nullptr) {
+        pRender = GetWindow()->GetRender();
+    }
+    if (pRender == nullptr) {
+        return false;
     }
 
     //默认属性
@@ -1045,39 +955,67 @@ int32_t ListCtrlReportView::GetMaxDataItemWidth(const std::vector<ListCtrlSubIte
     subItem.SetClass(defaultSubItemClass);
     subItem.SetListCtrlItem(&defaultItem);
 
-    for (const ListCtrlSubItemData2Ptr& pStorage : subItemList) {
-        if (pStorage == nullptr) {
-            continue;
-        }
-        if (pStorage->text.empty()) {
-            continue;
-        }
+    /** 测量参数：除文本以外的宽度（内边距、CheckBox、图标等）只与文本格式、是否显示CheckBox、图标相关，
+    *   每种组合只通过控件估算一次，之后每个数据项只需要测量文本的宽度
+    */
+    struct MeasureStyle
+    {
+        IFont* pFont;           //字体
+        UINT uTextStyle;        //测量文本时使用的文本格式
+        int32_t nExtraWidth;    //除文本以外的宽度
+    };
+    std::map<std::tuple<uint16_t, bool, int32_t>, MeasureStyle> measureStyles;
 
-        subItem.SetText(pStorage->text.c_str());
-        if (pStorage->nTextFormat != 0) {
-            subItem.SetTextStyle(pStorage->nTextFormat, false);
-        }
-        else {
-            subItem.SetTextStyle(defaultSubItem.GetTextStyle(), false);
-        }
-        subItem.SetTextPadding(defaultSubItem.GetTextPadding(), false);
-        subItem.SetCheckBoxVisible(pStorage->bShowCheckBox);
-        subItem.SetImageId(pStorage->nImageId);
-        subItem.SetFixedWidth(UiFixedInt::MakeAuto(), false, false);
-        subItem.SetFixedHeight(UiFixedInt::MakeAuto(), false, false);
-        subItem.SetReEstimateSize(true);
-        UiEstSize sz = subItem.EstimateSize(UiSize(0, 0));
-        nMaxWidth = std::max(nMaxWidth, sz.cx.GetInt32());
-    }
+    //相同的文本和格式，只测量一次
+    std::map<UINT, std::unordered_map<DString, int32_t>> textWidths;
 
-    if (nMaxWidth <= 0) {
-        nMaxWidth = -1;
-    }
-    else {
-        //增加一点余量
-        nMaxWidth += Dpi().GetScaleInt(4);
+    //增加一点余量
+    const int32_t nMargin = Dpi().GetScaleInt(4);
+    const DString sampleText = _T("X");
+
+    itemWidths.reserve(subItemList.size());
+    for (const ListCtrlSubItemData2ConstPtr& pStorage : subItemList) {
+        if ((pStorage == nullptr) || pStorage->text.empty()) {
+            itemWidths.push_back(0);
+            continue;
+        }
+        const auto styleKey = std::make_tuple(pStorage->nTextFormat, pStorage->bShowCheckBox, pStorage->nImageId);
+        auto iterStyle = measureStyles.find(styleKey);
+        if (iterStyle == measureStyles.end()) {
+            subItem.SetText(sampleText);
+            if (pStorage->nTextFormat != 0) {
+                subItem.SetTextStyle(pStorage->nTextFormat, false);
+            }
+            else {
+                subItem.SetTextStyle(defaultSubItem.GetTextStyle(), false);
+            }
+            subItem.SetTextPadding(defaultSubItem.GetTextPadding(), false);
+            subItem.SetCheckBoxVisible(pStorage->bShowCheckBox);
+            subItem.SetImageId(pStorage->nImageId);
+            subItem.SetFixedWidth(UiFixedInt::MakeAuto(), false, false);
+            subItem.SetFixedHeight(UiFixedInt::MakeAuto(), false, false);
+            subItem.SetReEstimateSize(true);
+            UiEstSize sz = subItem.EstimateSize(UiSize(0, 0));
+
+            MeasureStyle measureStyle;
+            measureStyle.pFont = subItem.GetTextFont();
+            measureStyle.uTextStyle = subItem.GetTextStyle();
+            UiRect rcSample = pRender->MeasureString(sampleText, measureStyle.pFont, measureStyle.uTextStyle, 0);
+            measureStyle.nExtraWidth = sz.cx.GetInt32() - rcSample.Width();
+            iterStyle = measureStyles.emplace(styleKey, measureStyle).first;
+        }
+        const MeasureStyle& measureStyle = iterStyle->second;
+        std::unordered_map<DString, int32_t>& widthCache = textWidths[measureStyle.uTextStyle];
+        DString text = pStorage->text.c_str();
+        auto iterWidth = widthCache.find(text);
+        if (iterWidth == widthCache.end()) {
+            UiRect rcText = pRender->MeasureString(text, measureStyle.pFont, measureStyle.uTextStyle, 0);
+            iterWidth = widthCache.emplace(std::move(text), rcText.Width()).first;
+        }
+        int32_t nWidth = iterWidth->second + measureStyle.nExtraWidth;
+        itemWidths.push_back((nWidth > 0) ? (nWidth + nMargin) : 0);
     }
-    return nMaxWidth;
+    return true;
 }
 
 void ListCtrlReportView::AdjustSubItemWidth(const std::map<size_t, int32_t>& subItemWidths)
@@ -1238,7 +1176,7 @@ bool ListCtrlReportView::OnFrameSelection(int64_t left, int64_t /*right*/, int64
     for (size_t index = 0; index < dataItemCount; ++index) {
         const ListCtrlItemData& rowData = itemDataList[index];
         nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
+        if ((nItemHeight == 0) || !pDataProvider->IsRowVisible(index)) {
             //不可见的，跳过
             continue;
         }
@@ -1261,7 +1199,7 @@ bool ListCtrlReportView::OnFrameSelection(int64_t left, int64_t /*right*/, int64
     for (size_t index = 0; index < dataItemCount; ++index) {
         const ListCtrlItemData& rowData = itemDataList[index];
         nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
+        if ((nItemHeight == 0) || !pDataProvider->IsRowVisible(index)) {
             //不可见的，跳过
             continue;
         }
@@ -0,0 +1,133 @@
+#include "ListCtrlSearchIndex.h"
+#include <algorithm>
+#include <type_traits>
+
+namespace ui
+{
+
+ListCtrlSearchIndex::ListCtrlSearchIndex():
+    m_nRowCount(0)
+{
+}
+
+void ListCtrlSearchIndex::Clear()
+{
+    std::unordered_map<uint64_t, std::vector<uint32_t>>().swap(m_postings);
+    m_nRowCount = 0;
+}
+
+uint64_t ListCtrlSearchIndex::MakeKey(DString::value_type ch0, DString::value_type ch1, DString::value_type ch2)
+{
+    typedef std::make_unsigned<DString::value_type>::type UnsignedChar;
+    //每个字符占21位，可容纳所有的Unicode码点
+    const uint64_t nMask = 0x1FFFFF;
+    return (static_cast<uint64_t>(static_cast<UnsignedChar>(ch0)) & nMask) |
+           ((static_cast<uint64_t>(static_cast<UnsignedChar>(ch1)) & nMask) << 21) |
+           ((static_cast<uint64_t>(static_cast<UnsignedChar>(ch2)) & nMask) << 42);
+}
+
+void ListCtrlSearchIndex::AddText(const DString::value_type* text, size_t nLength)
+{
+    if ((text == nullptr) || (nLength < 3)) {
+        return;
+    }
+    DString::value_type ch0 = ToLower(text[0]);
+    DString::value_type ch1 = ToLower(text[1]);
+    for (size_t nPos = 2; nPos < nLength; ++nPos) {
+        const DString::value_type ch2 = ToLower(text[nPos]);
+        std::vector<uint32_t>& rows = m_postings[MakeKey(ch0, ch1, ch2)];
+        if (rows.empty() || (rows.back() != m_nRowCount)) {
+            //同一行中重复的三元组，只记录一次
+            rows.push_back(m_nRowCount);
+        }
+        ch0 = ch1;
+        ch1 = ch2;
+    }
+}
+
+void ListCtrlSearchIndex::EndRow()
+{
+    ASSERT(m_nRowCount < UINT32_MAX);
+    ++m_nRowCount;
+}
+
+bool ListCtrlSearchIndex::GetCandidateRows(const DString& lowerQuery, std::vector<size_t>& rows) const
+{
+    rows.clear();
+    if (lowerQuery.size() < 3) {
+        return false;
+    }
+    //查询文本中各个三元组的倒排表，从短到长依次求交集
+    std::vector<const std::vector<uint32_t>*> postingList;
+    for (size_t nPos = 2; nPos < lowerQuery.size(); ++nPos) {
+        auto iter = m_postings.find(MakeKey(lowerQuery[nPos - 2], lowerQuery[nPos - 1], lowerQuery[nPos]));
+        if (iter == m_postings.end()) {
+            //有三元组不存在，没有匹配的行
+            return true;
+        }
+        postingList.push_back(&iter->second);
+    }
+    //查询文本中重复的三元组只需求一次交集：先按地址排序去重，再按倒排表长度排序
+    std::sort(postingList.begin(), postingList.end());
+    postingList.erase(std::unique(postingList.begin(), postingList.end()), postingList.end());
+    std::sort(postingList.begin(), postingList.end(), [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) {
+            return a->size() < b->size();
+        });
+
+    std::vector<uint32_t> candidates = *postingList.front();
+    for (size_t nList = 1; (nList < postingList.size()) && !candidates.empty(); ++nList) {
+        const std::vector<uint32_t>& postings = *postingList[nList];
+        auto iterStart = postings.begin();
+        size_t nKeep = 0;
+        for (uint32_t nRow : candidates) {
+            //倒排表是有序的，每次从上次的位置开始二分查找
+            iterStart = std::lower_bound(iterStart, postings.end(), nRow);
+            if (iterStart == postings.end()) {
+                break;
+            }
+            if (*iterStart == nRow) {
+                candidates[nKeep++] = nRow;
+            }
+        }
+        candidates.resize(nKeep);
+    }
+    rows.assign(candidates.begin(), candidates.end());
+    return true;
+}
+
+size_t ListCtrlSearchIndex::GetMemorySize() const
+{
+    size_t nMemorySize = m_postings.bucket_count() * sizeof(void*);
+    for (auto iter = m_postings.begin(); iter != m_postings.end(); ++iter) {
+        nMemorySize += sizeof(*iter) + iter->second.capacity() * sizeof(uint32_t);
+    }
+    return nMemorySize;
+}
+
+bool ListCtrlSearchIndex::MatchText(const DString::value_type* text, size_t nLength, const DString& lowerQuery)
+{
+    const size_t nQueryLength = lowerQuery.size();
+    if (nQueryLength == 0) {
+        return true;
+    }
+    if ((text == nullptr) || (nLength < nQueryLength)) {
+        return false;
+    }
+    const DString::value_type chFirst = lowerQuery[0];
+    const size_t nLastPos = nLength - nQueryLength;
+    for (size_t nPos = 0; nPos <= nLastPos; ++nPos) {
+        if (ToLower(text[nPos]) != chFirst) {
+            continue;
+        }
+        size_t nMatch = 1;
+        while ((nMatch < nQueryLength) && (ToLower(text[nPos + nMatch]) == lowerQuery[nMatch])) {
+            ++nMatch;
+        }
+        if (nMatch == nQueryLength) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} //namespace ui
@@ -0,0 +1,83 @@
+#ifndef UI_CONTROL_LIST_CTRL_SEARCH_INDEX_H_
+#define UI_CONTROL_LIST_CTRL_SEARCH_INDEX_H_
+
+#include "duilib/duilib_defs.h"
+#include <unordered_map>
+#include <vector>
+
+namespace ui
+{
+/** ListCtrl的文本搜索索引（三元组倒排索引，不区分大小写，只转换ASCII字母）
+*   (1) 对行的文本，按连续的3个字符（三元组）建立倒排表，倒排表中的行号按升序排列
+*   (2) 查询时，取查询文本中所有三元组的倒排表的交集作为候选行，候选行需要再逐行匹配确认
+*   (3) 行号为列存储中的索引号（排序不影响行号），只支持按顺序追加行
+*   注意：只能在UI线程中使用
+*/
+class ListCtrlSearchIndex
+{
+public:
+    ListCtrlSearchIndex();
+
+public:
+    /** 清空索引
+    */
+    void Clear();
+
+    /** 获取已经建立索引的行数（行号范围：[0, GetRowCount())）
+    */
+    size_t GetRowCount() const { return m_nRowCount; }
+
+    /** 添加当前行（行号为GetRowCount()）的一段文本，一行有多段文本时，可多次调用
+    * @param [in] text 文本内容
+    * @param [in] nLength 文本长度
+    */
+    void AddText(const DString::value_type* text, size_t nLength);
+
+    /** 当前行的文本添加完成，开始下一行
+    */
+    void EndRow();
+
+    /** 查询可能包含指定文本的行
+    * @param [in] lowerQuery 查询文本（已转换为小写）
+    * @param [out] rows 返回候选行的行号（按升序排列，范围：[0, GetRowCount())）
+    * @return 如果查询文本少于3个字符，无法使用索引，返回false
+    */
+    bool GetCandidateRows(const DString& lowerQuery, std::vector<size_t>& rows) const;
+
+    /** 估算占用的内存大小（字节）
+    */
+    size_t GetMemorySize() const;
+
+public:
+    /** 字符转换为小写（只转换ASCII字母，与StringUtil::MakeLowerString保持一致）
+    */
+    static DString::value_type ToLower(DString::value_type ch)
+    {
+        return ((ch >= _T('A')) && (ch <= _T('Z'))) ? static_cast<DString::value_type>(ch + (_T('a') - _T('A'))) : ch;
+    }
+
+    /** 判断文本中是否包含查询文本（不区分大小写）
+    * @param [in] text 文本内容
+    * @param [in] nLength 文本长度
+    * @param [in] lowerQuery 查询文本（已转换为小写）
+    */
+    static bool MatchText(const DString::value_type* text, size_t nLength, const DString& lowerQuery);
+
+private:
+    /** 三元组的键值
+    */
+    static uint64_t MakeKey(DString::value_type ch0, DString::value_type ch1, DString::value_type ch2);
+
+private:
+    /** 倒排表：三元组 -> 包含该三元组的行号（升序，不重复）
+    */
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_postings;
+
+    /** 已经建立索引的行数
+    */
+    uint32_t m_nRowCount;
+};
+
+} //namespace ui
+
+#endif //UI_CONTROL_LIST_CTRL_SEARCH_INDEX_H_
@@ -337,6 +337,36 @@ void Progress::Play()
     Invalidate();
 }
 
+void Progress::StartMarquee()
+{
+    m_timer.Cancel();
+    m_marqueeTime = std::chrono::steady_clock::now();
+    GlobalManager::Instance().Clock().AddFrameCallback(m_timer.GetWeakFlag(), UiBind(&Progress::OnMarqueeFrame, this));
+}
+
+void Progress::OnMarqueeFrame()
+{
+    if (!m_bMarquee) {
+        m_timer.Cancel();
+        return;
+    }
+    const int64_t nElapsed = (m_nMarqueeElapsed > 0) ? m_nMarqueeElapsed : 1;
+    const std::chrono::steady_clock::time_point frameTime = GlobalManager::Instance().Clock().GetFrameTime();
+    int64_t nSteps = std::chrono::duration_cast<std::chrono::milliseconds>(frameTime - m_marqueeTime).count() / nElapsed;
+    if (nSteps <= 0) {
+        return;
+    }
+    m_marqueeTime += std::chrono::milliseconds(nSteps * nElapsed);
+    if (nSteps > 10) {
+        //落后太多（比如界面卡顿），不追赶进度
+        nSteps = 1;
+        m_marqueeTime = frameTime;
+    }
+    for (int64_t i = 0; i < nSteps; ++i) {
+        Play();
+    }
+}
+
 void Progress::PaintMarquee(IRender* pRender) 
 {
     ASSERT(pRender != nullptr);
@@ -376,8 +406,7 @@ void Progress::SetMarquee(bool bMarquee)
     m_nMarqueePos = 0;
 
     if (m_bMarquee) {
-        auto playCallback = UiBind(&Progress::Play, this);
-        GlobalManager::Instance().Timer().AddTimer(m_timer.GetWeakFlag(), playCallback, m_nMarqueeElapsed);
+        StartMarquee();
     }
     else {
         m_timer.Cancel();
@@ -435,10 +464,7 @@ void Progress::SetMarqueeElapsed(int32_t nMarqueeElapsed)
     }
 
     m_nMarqueeElapsed = nMarqueeElapsed;
-    m_timer.Cancel();
-
-    auto playCallback = UiBind(&Progress::Play, this);
-    GlobalManager::Instance().Timer().AddTimer(m_timer.GetWeakFlag(), playCallback, m_nMarqueeElapsed);
+    StartMarquee();
 
     Invalidate();
 }
@@ -177,11 +177,23 @@ protected:
     int32_t m_nMarqueeElapsed;
     int32_t m_nMarqueePos;
 
+    //上次播放Marquee的时间（由帧时钟驱动）
+    std::chrono::steady_clock::time_point m_marqueeTime;
+
     //是否倒数（进度从100 到 0）
     bool m_bReverse;
 
     //定时器取消机制
     WeakCallbackFlag m_timer;
+
+private:
+    /** 帧时钟的回调函数，按已经过的时间播放Marquee
+    */
+    void OnMarqueeFrame();
+
+    /** 启动Marquee的帧回调
+    */
+    void StartMarquee();
 };
 
 } // namespace ui
@@ -0,0 +1,583 @@
+#include "VirtualTreeIndex.h"
+#include "duilib/Control/VirtualTreeView.h"
+#include <algorithm>
+
+namespace ui
+{
+
+VirtualTreeIndex::VirtualTreeIndex(VirtualTreeView* pTreeView):
+    m_pTreeView(pTreeView),
+    m_pDataProvider(nullptr),
+    m_pSelectedNode(nullptr),
+    m_bMultiSelect(false)
+{
+    m_pRoot.reset(new NodeRecord);
+    m_pRoot->nNodeId = VirtualTreeDataProvider::RootNodeId;
+    m_pRoot->bExpand = true;
+}
+
+VirtualTreeIndex::~VirtualTreeIndex()
+{
+}
+
+Control* VirtualTreeIndex::CreateElement(VirtualListBox* /*pVirtualListBox*/)
+{
+    ASSERT(m_pDataProvider != nullptr);
+    if (m_pDataProvider == nullptr) {
+        return nullptr;
+    }
+    VirtualTreeNode* pTreeNode = m_pDataProvider->CreateNodeElement(m_pTreeView);
+    ASSERT(pTreeNode != nullptr);
+    if (pTreeNode != nullptr) {
+        pTreeNode->SetTreeView(m_pTreeView);
+        if (m_pTreeView != nullptr) {
+            pTreeNode->SetExpandImageClass(m_pTreeView->GetExpandImageClass());
+        }
+    }
+    return pTreeNode;
+}
+
+bool VirtualTreeIndex::FillElement(Control* pControl, size_t nElementIndex)
+{
+    VirtualTreeNode* pTreeNode = dynamic_cast<VirtualTreeNode*>(pControl);
+    ASSERT(pTreeNode != nullptr);
+    if ((pTreeNode == nullptr) || (m_pDataProvider == nullptr)) {
+        return false;
+    }
+    NodeLocation location;
+    if (!FindElement(nElementIndex, location)) {
+        return false;
+    }
+    const size_t nNodeId = GetLocationNodeId(location);
+    const uint16_t nDepth = (uint16_t)(location.pParent->nDepth + 1);
+    bool bExpand = false;
+    bool bHasChild = false;
+    if ((location.pNode != nullptr) && location.pNode->bExpand) {
+        //已展开的节点，子节点个数已知
+        bExpand = true;
+        bHasChild = location.pNode->nChildCount > 0;
+    }
+    else {
+        bHasChild = m_pDataProvider->HasChildNodes(nNodeId);
+    }
+    pTreeNode->SetNodeState(nNodeId, nDepth, bHasChild, bExpand);
+    return m_pDataProvider->FillNodeElement(pTreeNode, nNodeId);
+}
+
+size_t VirtualTreeIndex::GetElementCount() const
+{
+    return m_pRoot->nVisibleCount;
+}
+
+void VirtualTreeIndex::SetElementSelected(size_t nElementIndex, bool bSelected)
+{
+    NodeLocation location;
+    if (!FindElement(nElementIndex, location)) {
+        return;
+    }
+    if (bSelected) {
+        NodeRecord* pNode = GetOrCreateRecord(location);
+        if (pNode != nullptr) {
+            SetRecordSelected(pNode, true);
+        }
+    }
+    else if (location.pNode != nullptr) {
+        //没有记录的节点，一定是未选择状态
+        SetRecordSelected(location.pNode, false);
+    }
+}
+
+bool VirtualTreeIndex::IsElementSelected(size_t nElementIndex) const
+{
+    NodeLocation location;
+    if (!FindElement(nElementIndex, location)) {
+        return false;
+    }
+    return (location.pNode != nullptr) && location.pNode->bSelected;
+}
+
+void VirtualTreeIndex::GetSelectedElements(std::vector<size_t>& selectedIndexs) const
+{
+    selectedIndexs.clear();
+    if (!m_bMultiSelect) {
+        if (m_pSelectedNode != nullptr) {
+            size_t nElementIndex = GetRecordElementIndex(m_pSelectedNode);
+            if (nElementIndex != Box::InvalidIndex) {
+                selectedIndexs.push_back(nElementIndex);
+            }
+        }
+        return;
+    }
+    for (auto iter = m_records.begin(); iter != m_records.end(); ++iter) {
+        const NodeRecord* pNode = iter->second.get();
+        if (pNode->bSelected) {
+            //收起的节点中，被隐藏的子孙节点不返回
+            size_t nElementIndex = GetRecordElementIndex(pNode);
+            if (nElementIndex != Box::InvalidIndex) {
+                selectedIndexs.push_back(nElementIndex);
+            }
+        }
+    }
+    std::sort(selectedIndexs.begin(), selectedIndexs.end());
+}
+
+bool VirtualTreeIndex::IsMultiSelect() const
+{
+    return m_bMultiSelect;
+}
+
+void VirtualTreeIndex::SetMultiSelect(bool bMultiSelect)
+{
+    bool bChanged = m_bMultiSelect != bMultiSelect;
+    m_bMultiSelect = bMultiSelect;
+    if (bChanged && !bMultiSelect) {
+        //从多选变单选，只保留一个选择项
+        std::vector<NodeRecord*> selectedNodes;
+        for (auto iter = m_records.begin(); iter != m_records.end(); ++iter) {
+            NodeRecord* pNode = iter->second.get();
+            if (pNode->bSelected && (pNode != m_pSelectedNode)) {
+                selectedNodes.push_back(pNode);
+            }
+        }
+        for (NodeRecord* pNode : selectedNodes) {
+            pNode->bSelected = false;
+            ReleaseRecord(pNode);
+        }
+    }
+}
+
+void VirtualTreeIndex::SetDataProvider(VirtualTreeDataProvider* pProvider)
+{
+    m_pDataProvider = pProvider;
+    Reset();
+}
+
+void VirtualTreeIndex::Reset()
+{
+    m_pSelectedNode = nullptr;
+    m_records.clear();
+    m_pRoot->children.clear();
+    m_pRoot->nChildCount = 0;
+    m_pRoot->nVisibleCount = 0;
+    if (m_pDataProvider != nullptr) {
+        m_pRoot->nChildCount = m_pDataProvider->GetChildNodeCount(m_pRoot->nNodeId);
+        m_pRoot->nVisibleCount = m_pRoot->nChildCount;
+    }
+    EmitCountChanged();
+}
+
+size_t VirtualTreeIndex::GetElementNodeId(size_t nElementIndex) const
+{
+    NodeLocation location;
+    if (!FindElement(nElementIndex, location)) {
+        return Box::InvalidIndex;
+    }
+    return GetLocationNodeId(location);
+}
+
+uint16_t VirtualTreeIndex::GetElementDepth(size_t nElementIndex) const
+{
+    NodeLocation location;
+    if (!FindElement(nElementIndex, location)) {
+        return 0;
+    }
+    return (uint16_t)(location.pParent->nDepth + 1);
+}
+
+bool VirtualTreeIndex::IsElementExpand(size_t nElementIndex) const
+{
+    NodeLocation location;
+    if (!FindElement(nElementIndex, location)) {
+        return false;
+    }
+    return (location.pNode != nullptr) && location.pNode->bExpand;
+}
+
+bool VirtualTreeIndex::SetElementExpand(size_t nElementIndex, bool bExpand)
+{
+    NodeLocation location;
+    if (!FindElement(nElementIndex, location)) {
+        return false;
+    }
+    if ((location.pNode == nullptr) && !bExpand) {
+        //没有记录的节点，一定是收起状态
+        return false;
+    }
+    if (bExpand && !HasChildNodes(GetLocationNodeId(location))) {
+        //叶子节点不能展开，不创建节点记录
+        return false;
+    }
+    NodeRecord* pNode = GetOrCreateRecord(location);
+    if (pNode == nullptr) {
+        return false;
+    }
+    bool bChanged = SetRecordExpand(pNode, bExpand);
+    ReleaseRecord(pNode);
+    return bChanged;
+}
+
+size_t VirtualTreeIndex::GetNodeElementIndex(size_t nNodeId) const
+{
+    const NodeRecord* pNode = GetRecord(nNodeId);
+    if (pNode == nullptr) {
+        return Box::InvalidIndex;
+    }
+    return GetRecordElementIndex(pNode);
+}
+
+bool VirtualTreeIndex::IsNodeExpand(size_t nNodeId) const
+{
+    const NodeRecord* pNode = GetRecord(nNodeId);
+    return (pNode != nullptr) && pNode->bExpand;
+}
+
+bool VirtualTreeIndex::SetNodeExpand(size_t nNodeId, bool bExpand)
+{
+    NodeRecord* pNode = GetRecord(nNodeId);
+    if (pNode == nullptr) {
+        return false;
+    }
+    bool bChanged = SetRecordExpand(pNode, bExpand);
+    ReleaseRecord(pNode);
+    return bChanged;
+}
+
+void VirtualTreeIndex::CollapseAll()
+{
+    //与SetNodeExpand一致，收起前通知数据提供者（先记录节点ID，回调中可能修改记录）
+    std::vector<size_t> expandNodeIds;
+    for (auto iter = m_records.begin(); iter != m_records.end(); ++iter) {
+        if (iter->second->bExpand) {
+            expandNodeIds.push_back(iter->first);
+        }
+    }
+    if (m_pDataProvider != nullptr) {
+        for (size_t nNodeId : expandNodeIds) {
+            m_pDataProvider->OnNodeExpand(nNodeId, false);
+        }
+    }
+
+    std::vector<NodeRecord*> leafNodes;
+    for (auto iter = m_records.begin(); iter != m_records.end(); ++iter) {
+        NodeRecord* pNode = iter->second.get();
+        pNode->bExpand = false;
+        if (pNode->children.empty()) {
+            leafNodes.push_back(pNode);
+        }
+    }
+    //从叶子节点向上删除不再需要的记录（叶子节点不会是其他叶子节点的祖先，删除过程中不会失效）
+    for (NodeRecord* pNode : leafNodes) {
+        ReleaseRecord(pNode);
+    }
+    m_pRoot->nVisibleCount = m_pRoot->nChildCount;
+}
+
+bool VirtualTreeIndex::UpdateChildNodes(size_t nParentId)
+{
+    NodeRecord* pNode = nullptr;
+    if (nParentId == m_pRoot->nNodeId) {
+        pNode = m_pRoot.get();
+    }
+    else {
+        pNode = GetRecord(nParentId);
+    }
+    if (pNode == nullptr) {
+        //没有记录的节点，展开时才会获取子节点
+        return false;
+    }
+    const size_t nOldCount = pNode->nVisibleCount;
+    const size_t nNewCount = UpdateChildRecords(pNode);
+    ChangeVisibleCount(pNode, nOldCount, nNewCount);
+    return true;
+}
+
+void VirtualTreeIndex::NotifyDataChanged()
+{
+    if (m_pRoot->nVisibleCount > 0) {
+        EmitDataChanged(0, m_pRoot->nVisibleCount - 1);
+    }
+}
+
+void VirtualTreeIndex::NotifyCountChanged()
+{
+    EmitCountChanged();
+}
+
+void VirtualTreeIndex::NotifyCountChanged(size_t nElementIndex, size_t nOldCount)
+{
+    const size_t nNewCount = m_pRoot->nVisibleCount;
+    if ((nElementIndex >= nNewCount) || (nElementIndex >= nOldCount) || (nNewCount == nOldCount)) {
+        EmitCountChanged();
+    }
+    else if (nNewCount > nOldCount) {
+        //展开：子节点插入到该节点之后
+        EmitElementsInserted(nElementIndex + 1, nNewCount - nOldCount);
+    }
+    else {
+        //收起：删除该节点之后的子节点
+        EmitElementsRemoved(nElementIndex + 1, nOldCount - nNewCount);
+    }
+}
+
+bool VirtualTreeIndex::FindElement(size_t nElementIndex, NodeLocation& location) const
+{
+    if (nElementIndex >= m_pRoot->nVisibleCount) {
+        return false;
+    }
+    NodeRecord* pParent = m_pRoot.get();
+    size_t nOffset = nElementIndex;
+    for (;;) {
+        //两个有记录的子节点之间，每个子节点占一行；有记录的子节点展开时，还需要跳过其子孙节点的行
+        size_t nPrevIndex = 0;
+        NodeRecord* pNextParent = nullptr;
+        for (NodeRecord* pChild : pParent->children) {
+            const size_t nGap = pChild->nChildIndex - nPrevIndex;
+            if (nOffset < nGap) {
+                break;
+            }
+            nOffset -= nGap;
+            if (nOffset == 0) {
+                location.pParent = pParent;
+                location.nChildIndex = pChild->nChildIndex;
+                location.pNode = pChild;
+                return true;
+            }
+            nOffset -= 1;
+            const size_t nChildRows = pChild->bExpand ? pChild->nVisibleCount : 0;
+            if (nOffset < nChildRows) {
+                pNextParent = pChild;
+                break;
+            }
+            nOffset -= nChildRows;
+            nPrevIndex = pChild->nChildIndex + 1;
+        }
+        if (pNextParent != nullptr) {
+            pParent = pNextParent;
+            continue;
+        }
+        location.pParent = pParent;
+        location.nChildIndex = nPrevIndex + nOffset;
+        location.pNode = nullptr;
+        ASSERT(location.nChildIndex < pParent->nChildCount);
+        return location.nChildIndex < pParent->nChildCount;
+    }
+}
+
+size_t VirtualTreeIndex::GetLocationNodeId(const NodeLocation& location) const
+{
+    if (location.pNode != nullptr) {
+        return location.pNode->nNodeId;
+    }
+    if ((m_pDataProvider == nullptr) || (location.pParent == nullptr)) {
+        return Box::InvalidIndex;
+    }
+    return m_pDataProvider->GetChildNodeId(location.pParent->nNodeId, location.nChildIndex);
+}
+
+size_t VirtualTreeIndex::GetRecordElementIndex(const NodeRecord* pNode) const
+{
+    ASSERT((pNode != nullptr) && (pNode != m_pRoot.get()));
+    if ((pNode == nullptr) || (pNode == m_pRoot.get())) {
+        return Box::InvalidIndex;
+    }
+    size_t nElementIndex = 0;
+    while (pNode->pParent != nullptr) {
+        const NodeRecord* pParent = pNode->pParent;
+        if (!pParent->bExpand) {
+            return Box::InvalidIndex;
+        }
+        //前面的兄弟节点各占一行，展开的兄弟节点还需要加上其子孙节点的行
+        nElementIndex += pNode->nChildIndex;
+        for (const NodeRecord* pChild : pParent->children) {
+            if (pChild->nChildIndex >= pNode->nChildIndex) {
+                break;
+            }
+            if (pChild->bExpand) {
+                nElementIndex += pChild->nVisibleCount;
+            }
+        }
+        if (pParent != m_pRoot.get()) {
+            //父节点本身占一行
+            nElementIndex += 1;
+        }
+        pNode = pParent;
+    }
+    return nElementIndex;
+}
+
+VirtualTreeIndex::NodeRecord* VirtualTreeIndex::GetRecord(size_t nNodeId) const
+{
+    auto iter = m_records.find(nNodeId);
+    if (iter != m_records.end()) {
+        return iter->second.get();
+    }
+    return nullptr;
+}
+
+VirtualTreeIndex::NodeRecord* VirtualTreeIndex::GetOrCreateRecord(NodeLocation& location)
+{
+    if (location.pNode != nullptr) {
+        return location.pNode;
+    }
+    NodeRecord* pParent = location.pParent;
+    ASSERT(pParent != nullptr);
+    if (pParent == nullptr) {
+        return nullptr;
+    }
+    ASSERT(pParent->nDepth < UINT16_MAX);//最大为65535个层级
+    if (pParent->nDepth >= UINT16_MAX) {
+        return nullptr;
+    }
+    const size_t nNodeId = GetLocationNodeId(location);
+    ASSERT((nNodeId != VirtualTreeDataProvider::RootNodeId) && (m_records.find(nNodeId) == m_records.end()));
+    if ((nNodeId == VirtualTreeDataProvider::RootNodeId) || (m_records.find(nNodeId) != m_records.end())) {
+        //节点ID必须唯一
+        return nullptr;
+    }
+    std::unique_ptr<NodeRecord> pNewNode(new NodeRecord);
+    NodeRecord* pNode = pNewNode.get();
+    pNode->nNodeId = nNodeId;
+    pNode->pParent = pParent;
+    pNode->nChildIndex = location.nChildIndex;
+    pNode->nDepth = (uint16_t)(pParent->nDepth + 1);
+    m_records[nNodeId] = std::move(pNewNode);
+
+    auto iter = std::lower_bound(pParent->children.begin(), pParent->children.end(), pNode->nChildIndex,
+                                 [](const NodeRecord* pChild, size_t nChildIndex) {
+                                     return pChild->nChildIndex < nChildIndex;
+                                 });
+    pParent->children.insert(iter, pNode);
+    location.pNode = pNode;
+    return pNode;
+}
+
+void VirtualTreeIndex::ReleaseRecord(NodeRecord* pNode)
+{
+    while ((pNode != nullptr) && (pNode != m_pRoot.get()) &&
+           !pNode->bExpand && !pNode->bSelected && pNode->children.empty()) {
+        NodeRecord* pParent = pNode->pParent;
+        auto iter = std::find(pParent->children.begin(), pParent->children.end(), pNode);
+        ASSERT(iter != pParent->children.end());
+        if (iter != pParent->children.end()) {
+            pParent->children.erase(iter);
+        }
+        m_records.erase(pNode->nNodeId);
+        pNode = pParent;
+    }
+}
+
+void VirtualTreeIndex::RemoveRecordTree(NodeRecord* pNode)
+{
+    for (NodeRecord* pChild : pNode->children) {
+        RemoveRecordTree(pChild);
+    }
+    if (m_pSelectedNode == pNode) {
+        m_pSelectedNode = nullptr;
+    }
+    m_records.erase(pNode->nNodeId);
+}
+
+size_t VirtualTreeIndex::UpdateChildRecords(NodeRecord* pNode)
+{
+    const size_t nChildCount = (m_pDataProvider != nullptr) ? m_pDataProvider->GetChildNodeCount(pNode->nNodeId) : 0;
+    pNode->nChildCount = nChildCount;
+
+    std::vector<NodeRecord*> children;
+    children.swap(pNode->children);
+    for (NodeRecord* pChild : children) {
+        size_t nChildIndex = pChild->nChildIndex;
+        if ((nChildIndex >= nChildCount) ||
+            (m_pDataProvider->GetChildNodeId(pNode->nNodeId, nChildIndex) != pChild->nNodeId)) {
+            //子节点的位置发生变化，重新查找（只有子节点发生变化时才需要，不影响展开的耗时）
+            nChildIndex = Box::InvalidIndex;
+            for (size_t nIndex = 0; nIndex < nChildCount; ++nIndex) {
+                if (m_pDataProvider->GetChildNodeId(pNode->nNodeId, nIndex) == pChild->nNodeId) {
+                    nChildIndex = nIndex;
+                    break;
+                }
+            }
+        }
+        if (nChildIndex == Box::InvalidIndex) {
+            //子节点已经被删除
+            RemoveRecordTree(pChild);
+        }
+        else {
+            pChild->nChildIndex = nChildIndex;
+            pNode->children.push_back(pChild);
+        }
+    }
+    std::sort(pNode->children.begin(), pNode->children.end(), [](const NodeRecord* a, const NodeRecord* b) {
+            return a->nChildIndex < b->nChildIndex;
+        });
+
+    size_t nVisibleCount = nChildCount;
+    for (const NodeRecord* pChild : pNode->children) {
+        if (pChild->bExpand) {
+            nVisibleCount += pChild->nVisibleCount;
+        }
+    }
+    return nVisibleCount;
+}
+
+void VirtualTreeIndex::ChangeVisibleCount(NodeRecord* pNode, size_t nRemoveCount, size_t nAddCount)
+{
+    //无符号数的加减：只要最终结果不为负数，中间结果溢出不影响正确性
+    pNode->nVisibleCount = pNode->nVisibleCount + nAddCount - nRemoveCount;
+    while (pNode->bExpand && (pNode->pParent != nullptr)) {
+        pNode = pNode->pParent;
+        pNode->nVisibleCount = pNode->nVisibleCount + nAddCount - nRemoveCount;
+    }
+}
+
+bool VirtualTreeIndex::HasChildNodes(size_t nNodeId) const
+{
+    return (m_pDataProvider != nullptr) && (nNodeId != Box::InvalidIndex) && m_pDataProvider->HasChildNodes(nNodeId);
+}
+
+bool VirtualTreeIndex::SetRecordExpand(NodeRecord* pNode, bool bExpand)
+{
+    ASSERT((pNode != nullptr) && (pNode != m_pRoot.get()));
+    if ((pNode == nullptr) || (pNode == m_pRoot.get()) || (pNode->bExpand == bExpand)) {
+        return false;
+    }
+    if (bExpand && !HasChildNodes(pNode->nNodeId)) {
+        //叶子节点不能展开
+        return false;
+    }
+    if (m_pDataProvider != nullptr) {
+        m_pDataProvider->OnNodeExpand(pNode->nNodeId, bExpand);
+    }
+    if (bExpand) {
+        //收起状态下，可见行数的变化不影响祖先节点
+        pNode->nVisibleCount = UpdateChildRecords(pNode);
+        pNode->bExpand = true;
+        ChangeVisibleCount(pNode->pParent, 0, pNode->nVisibleCount);
+    }
+    else {
+        pNode->bExpand = false;
+        ChangeVisibleCount(pNode->pParent, pNode->nVisibleCount, 0);
+    }
+    return true;
+}
+
+void VirtualTreeIndex::SetRecordSelected(NodeRecord* pNode, bool bSelected)
+{
+    pNode->bSelected = bSelected;
+    if (bSelected) {
+        //m_pSelectedNode记录最后选择的节点，单选时需要取消原来的选择
+        NodeRecord* pOldNode = m_pSelectedNode;
+        m_pSelectedNode = pNode;
+        if (!m_bMultiSelect && (pOldNode != nullptr) && (pOldNode != pNode)) {
+            pOldNode->bSelected = false;
+            ReleaseRecord(pOldNode);
+        }
+    }
+    else {
+        if (m_pSelectedNode == pNode) {
+            m_pSelectedNode = nullptr;
+        }
+        ReleaseRecord(pNode);
+    }
+}
+
+} //namespace ui
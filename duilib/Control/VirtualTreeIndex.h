@@ -0,0 +1,207 @@
+#ifndef UI_CONTROL_VIRTUAL_TREE_INDEX_H_
+#define UI_CONTROL_VIRTUAL_TREE_INDEX_H_
+
+#include "duilib/Box/VirtualListBox.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ui
+{
+class VirtualTreeView;
+class VirtualTreeDataProvider;
+
+/** 虚表树的可见行索引：将树的数据展开为可见行的列表，作为虚表的数据接口
+*   (1) 只为"展开、选择过的节点及其祖先节点"建立节点记录，其他节点只通过(父节点, 子节点索引号)定位，不占用内存
+*   (2) 每个节点记录保存展开后子孙节点的可见行数，展开/收起时只需沿祖先链更新行数，与子节点个数无关
+*   (3) 行号到节点的查找，自根节点向下逐层跳过有记录的子节点的可见行数，复杂度与层级和有记录的子节点个数相关
+*   注意：只能在UI线程中使用
+*/
+class VirtualTreeIndex : public VirtualListBoxElement
+{
+public:
+    explicit VirtualTreeIndex(VirtualTreeView* pTreeView);
+    virtual ~VirtualTreeIndex() override;
+
+    /// 重写父类接口，提供个性化功能，请参考父类声明
+    virtual Control* CreateElement(VirtualListBox* pVirtualListBox) override;
+    virtual bool FillElement(Control* pControl, size_t nElementIndex) override;
+    virtual size_t GetElementCount() const override;
+    virtual void SetElementSelected(size_t nElementIndex, bool bSelected) override;
+    virtual bool IsElementSelected(size_t nElementIndex) const override;
+    virtual void GetSelectedElements(std::vector<size_t>& selectedIndexs) const override;
+    virtual bool IsMultiSelect() const override;
+    virtual void SetMultiSelect(bool bMultiSelect) override;
+
+public:
+    /** 设置树的数据接口（所有节点的展开和选择状态被清除）
+    */
+    void SetDataProvider(VirtualTreeDataProvider* pProvider);
+
+    /** 重新加载所有数据（所有节点的展开和选择状态被清除）
+    */
+    void Reset();
+
+    /** 获取元素对应的节点ID
+    * @param [in] nElementIndex 元素索引号，有效范围：[0, GetElementCount())
+    * @return 返回节点ID，如果失败返回Box::InvalidIndex
+    */
+    size_t GetElementNodeId(size_t nElementIndex) const;
+
+    /** 获取元素对应的节点层级（一级节点的层级为1）
+    */
+    uint16_t GetElementDepth(size_t nElementIndex) const;
+
+    /** 元素对应的节点是否为展开状态
+    */
+    bool IsElementExpand(size_t nElementIndex) const;
+
+    /** 设置元素对应的节点展开状态（没有子节点的叶子节点不能展开）
+    * @return 如果状态有变化返回true，否则返回false
+    */
+    bool SetElementExpand(size_t nElementIndex, bool bExpand);
+
+    /** 获取节点对应的元素索引号
+    * @param [in] nNodeId 节点ID，只支持已展开、已选择的节点及其祖先节点
+    * @return 返回元素索引号，如果节点未知或者不可见，返回Box::InvalidIndex
+    */
+    size_t GetNodeElementIndex(size_t nNodeId) const;
+
+    /** 节点是否为展开状态
+    */
+    bool IsNodeExpand(size_t nNodeId) const;
+
+    /** 设置节点的展开状态（没有子节点的叶子节点不能展开）
+    * @param [in] nNodeId 节点ID，只支持已展开、已选择的节点及其祖先节点
+    * @return 如果状态有变化返回true，否则返回false
+    */
+    bool SetNodeExpand(size_t nNodeId, bool bExpand);
+
+    /** 收起所有节点，每个已展开的节点都会通知数据提供者OnNodeExpand(nNodeId, false)
+    */
+    void CollapseAll();
+
+    /** 节点的子节点发生变化（添加、删除或者调整顺序），重新获取子节点
+    * @param [in] nParentId 父节点ID，只有有记录的节点需要更新（未展开过的节点，展开时才获取子节点）
+    * @return 如果该节点有记录，返回true，否则返回false
+    */
+    bool UpdateChildNodes(size_t nParentId);
+
+    /** 发送通知：数据内容发生变化
+    */
+    void NotifyDataChanged();
+
+    /** 发送通知：可见行数发生变化
+    */
+    void NotifyCountChanged();
+
+    /** 发送通知：展开或者收起节点后，该节点之后的可见行数发生变化（可变高度的布局只需在该位置插入或者删除）
+    * @param [in] nElementIndex 展开或者收起的节点的元素索引号
+    * @param [in] nOldCount 展开或者收起之前的元素总数
+    */
+    void NotifyCountChanged(size_t nElementIndex, size_t nOldCount);
+
+private:
+    /** 节点记录
+    */
+    struct NodeRecord
+    {
+        size_t nNodeId = 0;                 //节点ID
+        NodeRecord* pParent = nullptr;      //父节点
+        size_t nChildIndex = 0;             //在父节点中的索引号
+        uint16_t nDepth = 0;                //层级（根节点为0）
+        bool bExpand = false;               //是否展开
+        bool bSelected = false;             //是否选择
+        size_t nChildCount = 0;             //子节点个数（展开时从数据接口获取）
+        size_t nVisibleCount = 0;           //展开后子孙节点的可见行数（不含自身）
+        std::vector<NodeRecord*> children;  //有记录的子节点，按nChildIndex升序排列
+    };
+
+    /** 行对应的节点位置
+    */
+    struct NodeLocation
+    {
+        NodeRecord* pParent = nullptr;      //父节点
+        size_t nChildIndex = 0;             //在父节点中的索引号
+        NodeRecord* pNode = nullptr;        //节点记录，如果节点没有记录为nullptr
+    };
+
+private:
+    /** 查找行对应的节点位置
+    */
+    bool FindElement(size_t nElementIndex, NodeLocation& location) const;
+
+    /** 获取节点位置对应的节点ID
+    */
+    size_t GetLocationNodeId(const NodeLocation& location) const;
+
+    /** 获取节点记录所在的行号，如果不可见返回Box::InvalidIndex
+    */
+    size_t GetRecordElementIndex(const NodeRecord* pNode) const;
+
+    /** 获取节点记录
+    */
+    NodeRecord* GetRecord(size_t nNodeId) const;
+
+    /** 获取节点位置对应的节点记录，如果没有记录则创建
+    */
+    NodeRecord* GetOrCreateRecord(NodeLocation& location);
+
+    /** 节点记录不再需要时（未展开、未选择、没有子节点记录），删除该节点记录，并向上检查父节点
+    */
+    void ReleaseRecord(NodeRecord* pNode);
+
+    /** 删除节点记录及其所有子孙节点记录（不更新父节点的子节点列表）
+    */
+    void RemoveRecordTree(NodeRecord* pNode);
+
+    /** 从数据接口重新获取子节点个数，更新子节点记录的位置
+    * @return 返回展开后子孙节点的可见行数
+    */
+    size_t UpdateChildRecords(NodeRecord* pNode);
+
+    /** 节点的可见行数变化，沿着展开的祖先节点更新可见行数
+    */
+    void ChangeVisibleCount(NodeRecord* pNode, size_t nRemoveCount, size_t nAddCount);
+
+    /** 节点是否有子节点（通过数据接口查询）
+    */
+    bool HasChildNodes(size_t nNodeId) const;
+
+    /** 设置节点记录的展开状态
+    */
+    bool SetRecordExpand(NodeRecord* pNode, bool bExpand);
+
+    /** 设置节点记录的选择状态
+    */
+    void SetRecordSelected(NodeRecord* pNode, bool bSelected);
+
+private:
+    /** 关联的树控件
+    */
+    VirtualTreeView* m_pTreeView;
+
+    /** 树的数据接口
+    */
+    VirtualTreeDataProvider* m_pDataProvider;
+
+    /** 根节点记录（虚拟节点，不显示，始终为展开状态）
+    */
+    std::unique_ptr<NodeRecord> m_pRoot;
+
+    /** 所有的节点记录（不含根节点）：节点ID -> 节点记录
+    */
+    std::unordered_map<size_t, std::unique_ptr<NodeRecord>> m_records;
+
+    /** 最后选择的节点记录（单选时，为当前选择的节点）
+    */
+    NodeRecord* m_pSelectedNode;
+
+    /** 是否多选
+    */
+    bool m_bMultiSelect;
+};
+
+} //namespace ui
+
+#endif //UI_CONTROL_VIRTUAL_TREE_INDEX_H_
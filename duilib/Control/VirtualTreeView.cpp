@@ -0,0 +1,541 @@
+#include "VirtualTreeView.h"
+#include "duilib/Control/VirtualTreeIndex.h"
+#include <algorithm>
+
+namespace ui
+{
+
+VirtualTreeDataProvider::VirtualTreeDataProvider():
+    m_pfnNodeDataChangedNotify(),
+    m_pfnChildNodesChangedNotify()
+{
+}
+
+bool VirtualTreeDataProvider::HasChildNodes(size_t nNodeId)
+{
+    return GetChildNodeCount(nNodeId) > 0;
+}
+
+VirtualTreeNode* VirtualTreeDataProvider::CreateNodeElement(VirtualTreeView* pTreeView)
+{
+    ASSERT(pTreeView != nullptr);
+    if (pTreeView == nullptr) {
+        return nullptr;
+    }
+    return new VirtualTreeNode(pTreeView->GetWindow());
+}
+
+void VirtualTreeDataProvider::OnNodeExpand(size_t /*nNodeId*/, bool /*bExpand*/)
+{
+}
+
+void VirtualTreeDataProvider::RegNotifys(const TreeNodeDataChangedNotify& dcNotify, const TreeChildNodesChangedNotify& ccNotify)
+{
+    m_pfnNodeDataChangedNotify = dcNotify;
+    m_pfnChildNodesChangedNotify = ccNotify;
+}
+
+void VirtualTreeDataProvider::EmitNodeDataChanged()
+{
+    if (m_pfnNodeDataChangedNotify) {
+        m_pfnNodeDataChangedNotify();
+    }
+}
+
+void VirtualTreeDataProvider::EmitChildNodesChanged(size_t nParentId)
+{
+    if (m_pfnChildNodesChangedNotify) {
+        m_pfnChildNodesChangedNotify(nParentId);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+VirtualTreeNode::VirtualTreeNode(Window* pWindow) :
+    ListBoxItem(pWindow),
+    m_pTreeView(nullptr),
+    m_nNodeId(Box::InvalidIndex),
+    m_nDepth(0),
+    m_bHasChild(false),
+    m_bExpand(false),
+    m_nIndentPadding(0),
+    m_expandIndent(0),
+    m_expandIconPadding(0),
+    m_expandTextPadding(0)
+{
+    SetExpandIndent(4, true);
+}
+
+DString VirtualTreeNode::GetType() const { return DUI_CTR_VIRTUAL_TREENODE; }
+
+void VirtualTreeNode::SetAttribute(const DString& strName, const DString& strValue)
+{
+    if (strName == _T("expand_normal_image")) {
+        SetExpandStateImage(kControlStateNormal, strValue);
+    }
+    else if (strName == _T("expand_hot_image")) {
+        SetExpandStateImage(kControlStateHot, strValue);
+    }
+    else if (strName == _T("expand_pushed_image")) {
+        SetExpandStateImage(kControlStatePushed, strValue);
+    }
+    else if (strName == _T("expand_disabled_image")) {
+        SetExpandStateImage(kControlStateDisabled, strValue);
+    }
+    else if (strName == _T("collapse_normal_image")) {
+        SetCollapseStateImage(kControlStateNormal, strValue);
+    }
+    else if (strName == _T("collapse_hot_image")) {
+        SetCollapseStateImage(kControlStateHot, strValue);
+    }
+    else if (strName == _T("collapse_pushed_image")) {
+        SetCollapseStateImage(kControlStatePushed, strValue);
+    }
+    else if (strName == _T("collapse_disabled_image")) {
+        SetCollapseStateImage(kControlStateDisabled, strValue);
+    }
+    else if (strName == _T("expand_image_right_space")) {
+        int32_t iValue = StringUtil::StringToInt32(strValue);
+        SetExpandIndent(iValue, true);
+    }
+    else {
+        __super::SetAttribute(strName, strValue);
+    }
+}
+
+void VirtualTreeNode::ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale)
+{
+    ASSERT(nNewDpiScale == Dpi().GetScale());
+    if (nNewDpiScale != Dpi().GetScale()) {
+        return;
+    }
+
+    int32_t iValue = GetExpandIndent();
+    iValue = Dpi().GetScaleInt(iValue, nOldDpiScale);
+    SetExpandIndent(iValue, false);
+
+    //缩进和[展开/收起]图标的内边距，已经包含在控件的内边距中，在基类中一起缩放
+    m_nIndentPadding = Dpi().GetScaleInt(m_nIndentPadding, nOldDpiScale);
+    if (m_expandIconPadding > 0) {
+        m_expandIconPadding = ui::TruncateToUInt16(Dpi().GetScaleInt((int32_t)m_expandIconPadding, nOldDpiScale));
+    }
+    if (m_expandTextPadding > 0) {
+        m_expandTextPadding = ui::TruncateToUInt16(Dpi().GetScaleInt((int32_t)m_expandTextPadding, nOldDpiScale));
+    }
+    __super::ChangeDpiScale(nOldDpiScale, nNewDpiScale);
+}
+
+void VirtualTreeNode::PaintStateImages(IRender* pRender)
+{
+    __super::PaintStateImages(pRender);
+    if (!m_bHasChild) {
+        //没有子节点，不绘制[展开/收起]图标
+        return;
+    }
+    if (m_bExpand) {
+        if (m_expandImage != nullptr) {
+            m_expandImage->PaintStateImage(pRender, GetState(), _T(""), &m_rcExpandImage);
+        }
+    }
+    else {
+        if (m_collapseImage != nullptr) {
+            m_collapseImage->PaintStateImage(pRender, GetState(), _T(""), &m_rcCollapseImage);
+        }
+    }
+}
+
+bool VirtualTreeNode::ButtonDown(const EventArgs& msg)
+{
+    bool bRet = __super::ButtonDown(msg);
+    if (msg.IsSenderExpired()) {
+        return false;
+    }
+    if (!IsEnabled() || !m_bHasChild || (m_pTreeView == nullptr)) {
+        return bRet;
+    }
+    UiRect pos = GetPos();
+    UiPoint pt(msg.ptMouse);
+    pt.Offset(GetScrollOffsetInScrollBox());
+    if (!pos.ContainsPt(pt)) {
+        return bRet;
+    }
+    //如果点击在[展开/收起]图标上，则切换展开状态
+    bool bClickImage = false;
+    if (m_bExpand) {
+        bClickImage = (m_expandImage != nullptr) && m_rcExpandImage.ContainsPt(pt);
+    }
+    else {
+        bClickImage = (m_collapseImage != nullptr) && m_rcCollapseImage.ContainsPt(pt);
+    }
+    if (bClickImage) {
+        m_pTreeView->OnNodeExpandClick(this);
+    }
+    return bRet;
+}
+
+void VirtualTreeNode::SetTreeView(VirtualTreeView* pTreeView)
+{
+    m_pTreeView = pTreeView;
+}
+
+VirtualTreeView* VirtualTreeNode::GetTreeView() const
+{
+    return m_pTreeView;
+}
+
+void VirtualTreeNode::SetNodeState(size_t nNodeId, uint16_t nDepth, bool bHasChild, bool bExpand)
+{
+    bool bStateChanged = (m_bHasChild != bHasChild) || (m_bExpand != bExpand);
+    m_nNodeId = nNodeId;
+    m_nDepth = nDepth;
+    m_bHasChild = bHasChild;
+    m_bExpand = bExpand;
+
+    //一级节点不缩进，每增加一级，缩进一个indent单位
+    int32_t nIndentPadding = 0;
+    if ((nDepth > 1) && (m_pTreeView != nullptr)) {
+        nIndentPadding = (int32_t)(nDepth - 1) * m_pTreeView->GetIndent();
+    }
+    if (nIndentPadding != m_nIndentPadding) {
+        UiPadding padding = GetPadding();
+        padding.left += nIndentPadding - m_nIndentPadding;
+        m_nIndentPadding = nIndentPadding;
+        SetPadding(padding, false);
+    }
+    if (bStateChanged) {
+        Invalidate();
+    }
+}
+
+void VirtualTreeNode::SetExpandImageClass(const DString& expandClass)
+{
+    if (!expandClass.empty()) {
+        //开启展开标志功能
+        SetClass(expandClass);
+    }
+    else {
+        //关闭展开标志功能
+        m_expandImage.reset();
+        m_collapseImage.reset();
+        m_rcExpandImage.Clear();
+        m_rcCollapseImage.Clear();
+    }
+    AdjustExpandImagePadding();
+}
+
+DString VirtualTreeNode::GetExpandStateImage(ControlStateType stateType)
+{
+    Image* pImage = nullptr;
+    if (m_expandImage != nullptr) {
+        pImage = m_expandImage->GetStateImage(stateType);
+    }
+    if (pImage != nullptr) {
+        return pImage->GetImageString();
+    }
+    return DString();
+}
+
+void VirtualTreeNode::SetExpandStateImage(ControlStateType stateType, const DString& strImage)
+{
+    if (m_expandImage == nullptr) {
+        m_expandImage.reset(new StateImage);
+        m_expandImage->SetControl(this);
+    }
+    m_expandImage->SetImageString(stateType, strImage, Dpi());
+}
+
+DString VirtualTreeNode::GetCollapseStateImage(ControlStateType stateType)
+{
+    Image* pImage = nullptr;
+    if (m_collapseImage != nullptr) {
+        pImage = m_collapseImage->GetStateImage(stateType);
+    }
+    if (pImage != nullptr) {
+        return pImage->GetImageString();
+    }
+    return DString();
+}
+
+void VirtualTreeNode::SetCollapseStateImage(ControlStateType stateType, const DString& strImage)
+{
+    if (m_collapseImage == nullptr) {
+        m_collapseImage.reset(new StateImage);
+        m_collapseImage->SetControl(this);
+    }
+    m_collapseImage->SetImageString(stateType, strImage, Dpi());
+}
+
+void VirtualTreeNode::SetExpandIndent(int32_t nExpandIndent, bool bNeedDpiScale)
+{
+    if (nExpandIndent < 0) {
+        nExpandIndent = 4;
+    }
+    if (bNeedDpiScale) {
+        Dpi().ScaleInt(nExpandIndent);
+    }
+    m_expandIndent = ui::TruncateToUInt16(nExpandIndent);
+}
+
+uint16_t VirtualTreeNode::GetExpandIndent() const
+{
+    return m_expandIndent;
+}
+
+int32_t VirtualTreeNode::GetExpandImagePadding() const
+{
+    int32_t imageWidth = 0;
+    Image* pImage = nullptr;
+    if (m_collapseImage != nullptr) {
+        pImage = m_collapseImage->GetStateImage(kControlStateNormal);
+    }
+    if (pImage == nullptr) {
+        if (m_expandImage != nullptr) {
+            pImage = m_expandImage->GetStateImage(kControlStateNormal);
+        }
+    }
+    if (pImage != nullptr) {
+        LoadImageData(*pImage);
+        if (pImage->GetImageCache() != nullptr) {
+            imageWidth = pImage->GetImageCache()->GetWidth();
+        }
+    }
+    if (imageWidth > 0) {
+        imageWidth += GetExpandIndent();
+    }
+    return imageWidth;
+}
+
+void VirtualTreeNode::AdjustExpandImagePadding()
+{
+    //没有子节点的节点也保留[展开/收起]图标的位置，使同一层级的节点文字对齐
+    const uint16_t expandPadding = ui::TruncateToUInt16(GetExpandImagePadding());
+    if (expandPadding != m_expandIconPadding) {
+        UiPadding rcBkPadding = GetBkImagePadding();
+        rcBkPadding.left = std::max(rcBkPadding.left - (int32_t)m_expandIconPadding, 0) + (int32_t)expandPadding;
+        if (SetBkImagePadding(rcBkPadding, false)) {
+            m_expandIconPadding = expandPadding;
+        }
+    }
+    if (expandPadding != m_expandTextPadding) {
+        UiPadding rcTextPadding = GetTextPadding();
+        rcTextPadding.left = std::max(rcTextPadding.left - (int32_t)m_expandTextPadding, 0) + (int32_t)expandPadding;
+        SetTextPadding(rcTextPadding, false);
+        m_expandTextPadding = expandPadding;
+    }
+    Invalidate();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+VirtualTreeView::VirtualTreeView(Window* pWindow) :
+    VirtualListBox(pWindow, new VirtualVLayout),
+    m_pTreeDataProvider(nullptr),
+    m_nIndent(0)
+{
+    VirtualLayout* pVirtualLayout = dynamic_cast<VirtualVLayout*>(GetLayout());
+    SetVirtualLayout(pVirtualLayout);
+
+    //可见行索引作为虚表的数据接口，树的数据接口由开发者设置
+    m_pTreeIndex.reset(new VirtualTreeIndex(this));
+    SetDataProvider(m_pTreeIndex.get());
+
+    //缩进默认设置为20个像素
+    SetIndent(20, true);
+
+    //监听双击事件：用于展开子节点
+    AttachDoubleClick(UiBind(&VirtualTreeView::OnElementDoubleClick, this, std::placeholders::_1));
+}
+
+VirtualTreeView::~VirtualTreeView()
+{
+    if (m_pTreeDataProvider != nullptr) {
+        m_pTreeDataProvider->RegNotifys(nullptr, nullptr);
+        m_pTreeDataProvider = nullptr;
+    }
+    SetDataProvider(nullptr);
+}
+
+DString VirtualTreeView::GetType() const { return DUI_CTR_VIRTUAL_TREEVIEW; }
+
+void VirtualTreeView::SetAttribute(const DString& strName, const DString& strValue)
+{
+    if (strName == _T("indent")) {
+        //树节点的缩进（每层节点缩进一个indent单位）
+        SetIndent(StringUtil::StringToInt32(strValue), true);
+    }
+    else if (strName == _T("expand_image_class")) {
+        //是否显示[展开/收起]图标
+        SetExpandImageClass(strValue);
+    }
+    else {
+        __super::SetAttribute(strName, strValue);
+    }
+}
+
+void VirtualTreeView::ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale)
+{
+    ASSERT(nNewDpiScale == Dpi().GetScale());
+    if (nNewDpiScale != Dpi().GetScale()) {
+        return;
+    }
+    int32_t iValue = GetIndent();
+    iValue = Dpi().GetScaleInt(iValue, nOldDpiScale);
+    SetIndent(iValue, false);
+
+    __super::ChangeDpiScale(nOldDpiScale, nNewDpiScale);
+}
+
+void VirtualTreeView::SetTreeDataProvider(VirtualTreeDataProvider* pProvider)
+{
+    if ((m_pTreeDataProvider != pProvider) && (m_pTreeDataProvider != nullptr)) {
+        //注销原来的关联关系
+        m_pTreeDataProvider->RegNotifys(nullptr, nullptr);
+    }
+    m_pTreeDataProvider = pProvider;
+    if (pProvider != nullptr) {
+        //注册数据变动通知回调
+        pProvider->RegNotifys(
+            UiBind(&VirtualTreeView::OnNodeDataChanged, this),
+            UiBind(&VirtualTreeView::OnChildNodesChanged, this, std::placeholders::_1));
+    }
+    m_pTreeIndex->SetDataProvider(pProvider);
+}
+
+VirtualTreeDataProvider* VirtualTreeView::GetTreeDataProvider() const
+{
+    return m_pTreeDataProvider;
+}
+
+void VirtualTreeView::ReloadNodes()
+{
+    m_pTreeIndex->Reset();
+}
+
+void VirtualTreeView::SetIndent(int32_t indent, bool bNeedDpiScale)
+{
+    ASSERT(indent >= 0);
+    if (bNeedDpiScale) {
+        Dpi().ScaleInt(indent);
+    }
+    if ((indent >= 0) && (indent != m_nIndent)) {
+        m_nIndent = indent;
+        //重新填充界面上显示的节点，更新缩进
+        m_pTreeIndex->NotifyDataChanged();
+    }
+}
+
+void VirtualTreeView::SetExpandImageClass(const DString& className)
+{
+    bool isChanged = m_expandImageClass != className;
+    m_expandImageClass = className;
+    if (isChanged) {
+        for (Control* pControl : m_items) {
+            VirtualTreeNode* pTreeNode = dynamic_cast<VirtualTreeNode*>(pControl);
+            if (pTreeNode != nullptr) {
+                pTreeNode->SetExpandImageClass(className);
+            }
+        }
+    }
+}
+
+DString VirtualTreeView::GetExpandImageClass() const
+{
+    return m_expandImageClass.c_str();
+}
+
+size_t VirtualTreeView::GetElementNodeId(size_t nElementIndex) const
+{
+    return m_pTreeIndex->GetElementNodeId(nElementIndex);
+}
+
+uint16_t VirtualTreeView::GetElementDepth(size_t nElementIndex) const
+{
+    return m_pTreeIndex->GetElementDepth(nElementIndex);
+}
+
+bool VirtualTreeView::IsElementExpand(size_t nElementIndex) const
+{
+    return m_pTreeIndex->IsElementExpand(nElementIndex);
+}
+
+bool VirtualTreeView::SetElementExpand(size_t nElementIndex, bool bExpand, bool bTriggerEvent)
+{
+    const size_t nNodeId = m_pTreeIndex->GetElementNodeId(nElementIndex);
+    const size_t nOldCount = m_pTreeIndex->GetElementCount();
+    if (!m_pTreeIndex->SetElementExpand(nElementIndex, bExpand)) {
+        return false;
+    }
+    //子节点在该节点之后插入或者删除，重新填充界面上显示的节点
+    m_pTreeIndex->NotifyCountChanged(nElementIndex, nOldCount);
+    if (bTriggerEvent) {
+        SendEvent(bExpand ? kEventExpand : kEventCollapse, nElementIndex, (LPARAM)nNodeId);
+    }
+    return true;
+}
+
+size_t VirtualTreeView::GetNodeElementIndex(size_t nNodeId) const
+{
+    return m_pTreeIndex->GetNodeElementIndex(nNodeId);
+}
+
+bool VirtualTreeView::IsNodeExpand(size_t nNodeId) const
+{
+    return m_pTreeIndex->IsNodeExpand(nNodeId);
+}
+
+bool VirtualTreeView::SetNodeExpand(size_t nNodeId, bool bExpand)
+{
+    const size_t nElementIndex = m_pTreeIndex->GetNodeElementIndex(nNodeId);
+    const size_t nOldCount = m_pTreeIndex->GetElementCount();
+    if (!m_pTreeIndex->SetNodeExpand(nNodeId, bExpand)) {
+        return false;
+    }
+    m_pTreeIndex->NotifyCountChanged(nElementIndex, nOldCount);
+    return true;
+}
+
+void VirtualTreeView::CollapseAll()
+{
+    m_pTreeIndex->CollapseAll();
+    m_pTreeIndex->NotifyCountChanged();
+}
+
+void VirtualTreeView::OnNodeDataChanged()
+{
+    m_pTreeIndex->NotifyDataChanged();
+}
+
+void VirtualTreeView::OnChildNodesChanged(size_t nParentId)
+{
+    if (m_pTreeIndex->UpdateChildNodes(nParentId)) {
+        m_pTreeIndex->NotifyCountChanged();
+    }
+    else {
+        //未展开过的节点，只需要更新[展开/收起]图标
+        m_pTreeIndex->NotifyDataChanged();
+    }
+}
+
+bool VirtualTreeView::OnElementDoubleClick(const EventArgs& args)
+{
+    //wParam为子项控件的索引号，双击在空白处时为Box::InvalidIndex
+    VirtualTreeNode* pTreeNode = dynamic_cast<VirtualTreeNode*>(GetItemAt(args.wParam));
+    if ((pTreeNode != nullptr) && pTreeNode->HasChildNodes()) {
+        OnNodeExpandClick(pTreeNode);
+    }
+    return true;
+}
+
+void VirtualTreeView::OnNodeExpandClick(VirtualTreeNode* pTreeNode)
+{
+    ASSERT(pTreeNode != nullptr);
+    if (pTreeNode == nullptr) {
+        return;
+    }
+    size_t nElementIndex = pTreeNode->GetElementIndex();
+    if (nElementIndex < GetElementCount()) {
+        SetElementExpand(nElementIndex, !IsElementExpand(nElementIndex), true);
+    }
+}
+
+} //namespace ui
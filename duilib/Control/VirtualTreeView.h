@@ -0,0 +1,379 @@
+#ifndef UI_CONTROL_VIRTUAL_TREEVIEW_H_
+#define UI_CONTROL_VIRTUAL_TREEVIEW_H_
+
+#include "duilib/Box/VirtualListBox.h"
+#include <memory>
+
+namespace ui
+{
+
+typedef std::function<void()> TreeNodeDataChangedNotify;
+typedef std::function<void(size_t nParentId)> TreeChildNodesChangedNotify;
+
+class VirtualTreeView;
+class VirtualTreeNode;
+class VirtualTreeIndex;
+
+/** 虚表树的数据接口，由开发者实现，提供树的结构和节点数据
+*   节点以ID标识（由数据接口定义，在整个树中必须唯一），根节点是一个虚拟节点，ID为RootNodeId
+*/
+class UILIB_API VirtualTreeDataProvider : public virtual SupportWeakCallback
+{
+public:
+    /** 根节点的ID（根节点是虚拟节点，不显示，其子节点为一级节点）
+    */
+    static constexpr auto RootNodeId{ static_cast<size_t>(-1) };
+
+    VirtualTreeDataProvider();
+
+    /** 获取子节点个数（节点展开时调用）
+    * @param [in] nParentId 父节点ID
+    */
+    virtual size_t GetChildNodeCount(size_t nParentId) = 0;
+
+    /** 获取子节点的ID
+    * @param [in] nParentId 父节点ID
+    * @param [in] nChildIndex 子节点的索引号，范围：[0, GetChildNodeCount(nParentId))
+    */
+    virtual size_t GetChildNodeId(size_t nParentId, size_t nChildIndex) = 0;
+
+    /** 节点是否有子节点（用于显示[展开/收起]图标，节点未展开时调用）
+    *   默认实现调用GetChildNodeCount，如果获取子节点个数的代价较高（比如需要加载数据），可重写此函数
+    * @param [in] nNodeId 节点ID
+    */
+    virtual bool HasChildNodes(size_t nNodeId);
+
+    /** 创建一个节点控件（控件会被循环使用，用于显示不同的节点）
+    * @param [in] pTreeView 关联的树控件
+    */
+    virtual VirtualTreeNode* CreateNodeElement(VirtualTreeView* pTreeView);
+
+    /** 填充节点控件（节点的层级和展开状态已经由树控件设置）
+    * @param [in] pTreeNode 节点控件
+    * @param [in] nNodeId 节点ID
+    */
+    virtual bool FillNodeElement(VirtualTreeNode* pTreeNode, size_t nNodeId) = 0;
+
+    /** 节点的展开状态即将变化（可在展开前加载子节点的数据）
+    * @param [in] nNodeId 节点ID
+    * @param [in] bExpand true表示即将展开，false表示即将收起
+    */
+    virtual void OnNodeExpand(size_t nNodeId, bool bExpand);
+
+public:
+    /** 注册事件通知回调
+    * @param [in] dcNotify 节点数据内容变化通知接口
+    * @param [in] ccNotify 子节点变化通知接口
+    */
+    void RegNotifys(const TreeNodeDataChangedNotify& dcNotify, const TreeChildNodesChangedNotify& ccNotify);
+
+protected:
+    /** 发送通知：节点的数据内容发生变化（刷新界面上显示的节点）
+    */
+    void EmitNodeDataChanged();
+
+    /** 发送通知：子节点发生变化（添加、删除或者调整顺序）
+    * @param [in] nParentId 父节点ID
+    */
+    void EmitChildNodesChanged(size_t nParentId);
+
+private:
+    /** 节点数据内容变化的响应函数
+    */
+    TreeNodeDataChangedNotify m_pfnNodeDataChangedNotify;
+
+    /** 子节点变化的响应函数
+    */
+    TreeChildNodesChangedNotify m_pfnChildNodesChangedNotify;
+};
+
+/** 虚表树的节点控件，控件被循环使用，每次显示时由树控件设置节点的层级和展开状态
+*/
+class UILIB_API VirtualTreeNode : public ListBoxItem
+{
+public:
+    explicit VirtualTreeNode(Window* pWindow);
+    VirtualTreeNode(const VirtualTreeNode& r) = delete;
+    VirtualTreeNode& operator=(const VirtualTreeNode& r) = delete;
+
+    /// 重写父类方法，提供个性化功能，请参考父类声明
+    virtual DString GetType() const override;
+    virtual void SetAttribute(const DString& strName, const DString& strValue) override;
+
+    /** DPI发生变化，更新控件大小和布局
+    * @param [in] nOldDpiScale 旧的DPI缩放百分比
+    * @param [in] nNewDpiScale 新的DPI缩放百分比，与Dpi().GetScale()的值一致
+    */
+    virtual void ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale) override;
+
+private:
+    virtual void PaintStateImages(IRender* pRender) override;
+    virtual bool ButtonDown(const EventArgs& msg) override;
+
+public:
+    /** 设置所属的树控件
+    */
+    void SetTreeView(VirtualTreeView* pTreeView);
+
+    /** 获取所属的树控件
+    */
+    VirtualTreeView* GetTreeView() const;
+
+    /** 设置节点状态（由树控件在填充数据前调用）
+    * @param [in] nNodeId 节点ID
+    * @param [in] nDepth 节点层级，一级节点的层级为1
+    * @param [in] bHasChild 是否有子节点
+    * @param [in] bExpand 是否展开
+    */
+    void SetNodeState(size_t nNodeId, uint16_t nDepth, bool bHasChild, bool bExpand);
+
+    /** 获取节点ID
+    */
+    size_t GetNodeId() const { return m_nNodeId; }
+
+    /** 获取节点层级，一级节点的层级为1
+    */
+    uint16_t GetDepth() const { return m_nDepth; }
+
+    /** 是否有子节点
+    */
+    bool HasChildNodes() const { return m_bHasChild; }
+
+    /** 是否展开状态
+    */
+    bool IsExpand() const { return m_bExpand; }
+
+    /** 设置[展开/收起]图标的Class
+    * @param [in] expandClass 图标的Class属性，为空表示不显示[展开/收起]图标
+    */
+    void SetExpandImageClass(const DString& expandClass);
+
+    /** 获取/设置展开状态的图片
+    */
+    DString GetExpandStateImage(ControlStateType stateType);
+    void SetExpandStateImage(ControlStateType stateType, const DString& strImage);
+
+    /** 获取/设置收起状态的图片
+    */
+    DString GetCollapseStateImage(ControlStateType stateType);
+    void SetCollapseStateImage(ControlStateType stateType, const DString& strImage);
+
+    /** 设置[展开/收起]图标后面的间隔
+    */
+    void SetExpandIndent(int32_t nExpandIndent, bool bNeedDpiScale);
+
+    /** 获取[展开/收起]图标后面的间隔
+    */
+    uint16_t GetExpandIndent() const;
+
+private:
+    /** 获取[展开/收起]图标占用的宽度（图片宽度与后面的间隔之和）
+    */
+    int32_t GetExpandImagePadding() const;
+
+    /** 按[展开/收起]图标的宽度，调整文字和背景图片的内边距
+    */
+    void AdjustExpandImagePadding();
+
+private:
+    /** 所属的树控件
+    */
+    VirtualTreeView* m_pTreeView;
+
+    /** 节点ID
+    */
+    size_t m_nNodeId;
+
+    /** 节点层级
+    */
+    uint16_t m_nDepth;
+
+    /** 是否有子节点
+    */
+    bool m_bHasChild;
+
+    /** 是否展开
+    */
+    bool m_bExpand;
+
+    /** 按层级缩进的左内边距（已经包含在控件的内边距中）
+    */
+    int32_t m_nIndentPadding;
+
+    /** [展开/收起]图标后面的间隔
+    */
+    uint16_t m_expandIndent;
+
+    /** [展开/收起]图标关联的背景图片/文字内边距（DPI相关）
+    */
+    uint16_t m_expandIconPadding;
+    uint16_t m_expandTextPadding;
+
+    /** 展开状态的图片
+    */
+    std::unique_ptr<StateImage> m_expandImage;
+    UiRect m_rcExpandImage;//每次绘制后会更新此值
+
+    /** 收起状态的图片
+    */
+    std::unique_ptr<StateImage> m_collapseImage;
+    UiRect m_rcCollapseImage;//每次绘制后会更新此值
+};
+
+/** 虚表实现的树控件，支持大数据量
+*   (1) 树的结构和节点数据由数据接口（VirtualTreeDataProvider）提供，树控件只记录节点的展开和选择状态
+*   (2) 只为界面上可见的行创建节点控件，并循环使用；展开/收起节点时，只更新可见行索引，耗时与子节点个数无关
+*   (3) 只支持固定行高（不支持VirtualVLayout的"variable_height"属性）
+*/
+class UILIB_API VirtualTreeView : public VirtualListBox
+{
+    friend class VirtualTreeNode;
+public:
+    explicit VirtualTreeView(Window* pWindow);
+    virtual ~VirtualTreeView() override;
+
+    /// 重写父类方法，提供个性化功能，请参考父类声明
+    virtual DString GetType() const override;
+    virtual void SetAttribute(const DString& strName, const DString& strValue) override;
+
+    /** DPI发生变化，更新控件大小和布局
+    * @param [in] nOldDpiScale 旧的DPI缩放百分比
+    * @param [in] nNewDpiScale 新的DPI缩放百分比，与Dpi().GetScale()的值一致
+    */
+    virtual void ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale) override;
+
+    /** 设置树的数据接口（所有节点的展开和选择状态被清除）
+    * @param [in] pProvider 开发者需要重写 VirtualTreeDataProvider 的接口来作为数据接口
+    */
+    void SetTreeDataProvider(VirtualTreeDataProvider* pProvider);
+
+    /** 获取树的数据接口
+    */
+    VirtualTreeDataProvider* GetTreeDataProvider() const;
+
+    /** 重新加载所有数据（所有节点的展开和选择状态被清除）
+    */
+    void ReloadNodes();
+
+public:
+    /** 获取节点的缩进（每层节点缩进一个indent单位）
+    */
+    int32_t GetIndent() const { return m_nIndent; }
+
+    /** 设置节点的缩进
+    * @param [in] indent 缩进值
+    * @param [in] bNeedDpiScale 是否需要对indent值进行DPI缩放
+    */
+    void SetIndent(int32_t indent, bool bNeedDpiScale);
+
+    /** 设置[展开/收起]图标的Class
+    * @param [in] className 展开标志图片的Class属性
+    */
+    void SetExpandImageClass(const DString& className);
+
+    /** 获取[展开/收起]图标的Class
+    */
+    DString GetExpandImageClass() const;
+
+public:
+    /** 获取元素对应的节点ID
+    * @param [in] nElementIndex 元素索引号，有效范围：[0, GetElementCount())
+    * @return 返回节点ID，如果失败返回Box::InvalidIndex
+    */
+    size_t GetElementNodeId(size_t nElementIndex) const;
+
+    /** 获取元素对应的节点层级（一级节点的层级为1）
+    * @param [in] nElementIndex 元素索引号，有效范围：[0, GetElementCount())
+    */
+    uint16_t GetElementDepth(size_t nElementIndex) const;
+
+    /** 元素对应的节点是否为展开状态
+    * @param [in] nElementIndex 元素索引号，有效范围：[0, GetElementCount())
+    */
+    bool IsElementExpand(size_t nElementIndex) const;
+
+    /** 设置元素对应的节点展开状态（没有子节点的叶子节点不能展开）
+    * @param [in] nElementIndex 元素索引号，有效范围：[0, GetElementCount())
+    * @param [in] bExpand 为 true 时展开，为 false 是收起
+    * @param [in] bTriggerEvent 是否触发kEventExpand/kEventCollapse事件
+    * @return 如果状态有变化返回true，否则返回false
+    */
+    bool SetElementExpand(size_t nElementIndex, bool bExpand, bool bTriggerEvent = false);
+
+    /** 获取节点对应的元素索引号
+    * @param [in] nNodeId 节点ID，只支持已展开、已选择的节点及其祖先节点
+    * @return 返回元素索引号，如果节点未知或者不可见，返回Box::InvalidIndex
+    */
+    size_t GetNodeElementIndex(size_t nNodeId) const;
+
+    /** 节点是否为展开状态
+    * @param [in] nNodeId 节点ID
+    */
+    bool IsNodeExpand(size_t nNodeId) const;
+
+    /** 设置节点的展开状态（没有子节点的叶子节点不能展开）
+    * @param [in] nNodeId 节点ID，只支持已展开、已选择的节点及其祖先节点
+    * @param [in] bExpand 为 true 时展开，为 false 是收起
+    * @return 如果状态有变化返回true，否则返回false
+    */
+    bool SetNodeExpand(size_t nNodeId, bool bExpand);
+
+    /** 收起所有节点
+    */
+    void CollapseAll();
+
+public:
+    /** 监听节点展开事件
+     * @param[in] callback 节点展开时的回调函数
+     *  参数说明:
+     *    wParam: 节点对应的元素索引号，有效范围：[0, GetElementCount())
+     *    lParam: 节点ID
+     */
+    void AttachExpand(const EventCallback& callback) { AttachEvent(kEventExpand, callback); }
+
+    /** 监听节点收起事件
+     * @param[in] callback 节点收起时的回调函数
+     *  参数说明:
+     *    wParam: 节点对应的元素索引号，有效范围：[0, GetElementCount())
+     *    lParam: 节点ID
+     */
+    void AttachCollapse(const EventCallback& callback) { AttachEvent(kEventCollapse, callback); }
+
+private:
+    /** 节点的数据内容发生变化
+    */
+    void OnNodeDataChanged();
+
+    /** 子节点发生变化
+    */
+    void OnChildNodesChanged(size_t nParentId);
+
+    /** 双击节点，切换展开状态
+    */
+    bool OnElementDoubleClick(const EventArgs& args);
+
+    /** 节点控件的[展开/收起]图标被点击
+    */
+    void OnNodeExpandClick(VirtualTreeNode* pTreeNode);
+
+private:
+    /** 可见行索引（虚表的数据接口）
+    */
+    std::unique_ptr<VirtualTreeIndex> m_pTreeIndex;
+
+    /** 树的数据接口
+    */
+    VirtualTreeDataProvider* m_pTreeDataProvider;
+
+    /** 子节点的缩进
+    */
+    int32_t m_nIndent;
+
+    /** 展开标志图片的Class
+    */
+    UiString m_expandImageClass;
+};
+
+} //namespace ui
+
+#endif //UI_CONTROL_VIRTUAL_TREEVIEW_H_
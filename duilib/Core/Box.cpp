@@ -1,9 +1,24 @@
 #include "Box.h"
 #include "duilib/Core/Window.h"
+#include "duilib/Core/HitTestGrid.h"
+#include "duilib/Core/PaintItemIndex.h"
 #include "duilib/Utils/StringUtil.h"
+#include "duilib/Utils/PerformanceUtil.h"
 
 namespace ui
 {
+//子控件数量达到该值时，按坐标查找子控件时使用命中测试索引
+static const size_t kMinHitTestGridItemCount = 32;
+
+//命中测试索引重建次数的计数项（预先注册，避免每次重建构造名称和查找计数项）
+static PerformanceUtil::Counter* const s_pHitTestGridRebuildCounter = PerformanceUtil::Instance().RegisterCounter(_T("Box::HitTestGridRebuild"));
+
+//子控件数量达到该值时，绘制子控件时使用绘制索引，只绘制与绘制区域相交的子控件
+static const size_t kMinPaintItemIndexCount = 32;
+
+//绘制索引重建次数的计数项
+static PerformanceUtil::Counter* const s_pPaintItemIndexRebuildCounter = PerformanceUtil::Instance().RegisterCounter(_T("Box::PaintItemIndexRebuild"));
+
 Box::Box(Window* pWindow, Layout* pLayout) :
     Control(pWindow),
     m_pLayout(pLayout),
@@ -126,6 +141,31 @@ void Box::PaintChild(IRender* pRender, const UiRect& rcPaint)
         return;
     }
 
+    const PaintItemIndex* pPaintItemIndex = GetPaintItemIndex();
+    if (pPaintItemIndex != nullptr) {
+        //只绘制与绘制区域相交的子控件
+        size_t nBegin = 0;
+        size_t nEnd = 0;
+        pPaintItemIndex->GetVisibleRange(rcPaint, nBegin, nEnd);
+        const std::vector<Control*>& orderedItems = pPaintItemIndex->GetOrderedItems();
+        for (size_t nIndex = nBegin; nIndex < nEnd; ++nIndex) {
+            orderedItems[nIndex]->AlphaPaint(pRender, rcPaint);
+        }
+        for (Control* pControl : pPaintItemIndex->GetTailItems()) {
+            if (pControl->IsVisible()) {
+                pControl->AlphaPaint(pRender, rcPaint);
+            }
+        }
+        //绘制延迟绘制的控件
+        for (Control* pControl : pPaintItemIndex->GetDelayItems()) {
+            pControl->AlphaPaint(pRender, rcPaint);
+        }
+        if ((pRender != nullptr) && IsShowFocusRect() && IsFocused()) {
+            DoPaintFocusRect(pRender);    //绘制焦点状态
+        }
+        return;
+    }
+
     std::vector<Control*> delayItems;
     for (auto pControl : m_items) {
         if (pControl == nullptr) {
@@ -301,7 +341,26 @@ Control* Box::FindControlInItems(const std::vector<Control*>& items,
     UiPoint boxPt(ptMouse);
     boxPt.Offset(scrollPos);
     UiRect rc = GetRectWithoutPadding();
-    if ((uFlags & UIFIND_TOP_FIRST) != 0) {
+    const uint32_t* pCandidateBegin = nullptr;
+    const uint32_t* pCandidateEnd = nullptr;
+    if (GetHitTestCandidates(items, uFlags, boxPt, pCandidateBegin, pCandidateEnd)) {
+        //使用命中测试索引，只检查区域包含该坐标的子控件（候选列表按子控件顺序排列）
+        const bool bTopFirst = (uFlags & UIFIND_TOP_FIRST) != 0;
+        const size_t nCandidateCount = pCandidateEnd - pCandidateBegin;
+        for (size_t nCandidate = 0; nCandidate < nCandidateCount; ++nCandidate) {
+            const uint32_t nIndex = bTopFirst ? pCandidateBegin[nCandidateCount - nCandidate - 1] : pCandidateBegin[nCandidate];
+            Control* pControl = items[nIndex]->FindControl(Proc, pProcData, uFlags, boxPt);
+            if (pControl != nullptr) {
+                if (!pControl->IsFloat() && !rc.ContainsPt(ptMouse)) {
+                    continue;
+                }
+                else {
+                    return pControl;
+                }
+            }
+        }
+    }
+    else if ((uFlags & UIFIND_TOP_FIRST) != 0) {
         //倒序
         for (int32_t it = (int32_t)items.size() - 1; it >= 0; --it) {
             if (items[it] == nullptr) {
@@ -345,6 +404,57 @@ Control* Box::FindControlInItems(const std::vector<Control*>& items,
     return pResult;
 }
 
+bool Box::GetHitTestCandidates(const std::vector<Control*>& items, uint32_t uFlags, const UiPoint& boxPt,
+                               const uint32_t*& pBegin, const uint32_t*& pEnd)
+{
+    //只有按坐标命中测试本容器的子控件列表时，才使用索引（子控件不命中时，其FindControl函数必然返回nullptr）
+    if (((uFlags & UIFIND_HITTEST) == 0) || (&items != &m_items) || (items.size() < kMinHitTestGridItemCount)) {
+        return false;
+    }
+    if (m_pHitTestGrid == nullptr) {
+        m_pHitTestGrid = std::make_unique<HitTestGrid>();
+    }
+    if (m_pHitTestGrid->IsDirty()) {
+        PerformanceUtil::AddCount(s_pHitTestGridRebuildCounter);
+        if (!m_pHitTestGrid->Rebuild(m_items)) {
+            return false;
+        }
+    }
+    return m_pHitTestGrid->GetCandidates(boxPt, pBegin, pEnd);
+}
+
+void Box::SetChildIndexDirty()
+{
+    if (m_pHitTestGrid != nullptr) {
+        m_pHitTestGrid->SetDirty();
+    }
+    if (m_pPaintItemIndex != nullptr) {
+        m_pPaintItemIndex->SetDirty();
+    }
+}
+
+const PaintItemIndex* Box::GetPaintItemIndex()
+{
+    //只有子控件沿纵向或者横向依次排列的布局，才能使用绘制索引
+    if ((m_items.size() < kMinPaintItemIndexCount) || (m_pLayout == nullptr)) {
+        return nullptr;
+    }
+    const bool bVertical = m_pLayout->IsVLayout();
+    if (!bVertical && !m_pLayout->IsHLayout()) {
+        return nullptr;
+    }
+    if (m_pPaintItemIndex == nullptr) {
+        m_pPaintItemIndex = std::make_unique<PaintItemIndex>();
+    }
+    if (m_pPaintItemIndex->IsDirty()) {
+        PerformanceUtil::AddCount(s_pPaintItemIndexRebuildCounter);
+        if (!m_pPaintItemIndex->Rebuild(m_items, bVertical)) {
+            return nullptr;
+        }
+    }
+    return m_pPaintItemIndex->IsValid() ? m_pPaintItemIndex.get() : nullptr;
+}
+
 Control* Box::FindSubControl(const DString& pstrSubControlName)
 {
     Control* pSubControl = GetWindow()->FindSubControlByName(this, pstrSubControlName);
@@ -422,6 +532,7 @@ bool Box::SetItemIndex(Control* pControl, size_t iIndex)
             Arrange();            
             m_items.erase(it);
             m_items.insert(m_items.begin() + iIndex, pControl);
+            SetChildIndexDirty();
             return true;
         }
     }
@@ -454,6 +565,7 @@ bool Box::DoAddItemAt(Control* pControl, size_t iIndex)
         return false;
     }
     m_items.insert(m_items.begin() + iIndex, pControl);
+    SetChildIndexDirty();
     Window* pWindow = GetWindow();
     if (pWindow != nullptr) {
         pWindow->InitControls(pControl);
@@ -491,6 +603,7 @@ bool Box::DoRemoveItem(Control* pControl)
     for (auto it = m_items.begin(); it != m_items.end(); ++it) {
         if (*it == pControl) {
             m_items.erase(it);
+            SetChildIndexDirty();
             if (m_bAutoDestroyChild) {
                 delete pControl;
             }
@@ -505,6 +618,7 @@ void Box::RemoveAllItems()
 {
     std::vector<Control*> items;
     items.swap(m_items);
+    SetChildIndexDirty();
     if (m_bAutoDestroyChild) {
         for(Control* pControl : items) {
             delete pControl;
@@ -521,6 +635,7 @@ void Box::ReSetLayout(Layout* pLayout)
     if (pLayout != nullptr) {
         m_pLayout = pLayout;
         m_pLayout->SetOwner(this);
+        SetChildIndexDirty();
     }    
 }
 
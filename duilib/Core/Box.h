@@ -6,6 +6,8 @@
 
 namespace ui 
 {
+class HitTestGrid;
+class PaintItemIndex;
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
@@ -207,6 +209,29 @@ protected:
                                 const UiPoint& ptMouse, 
                                 const UiPoint& scrollPos);
 
+public:
+    /** 子控件的位置、可见性、浮动属性或者绘制顺序发生变化，标记子控件的命中测试索引和绘制索引需要重建
+    */
+    void SetChildIndexDirty();
+
+protected:
+    /** 获取子控件的绘制索引（子控件数量较多且沿布局方向有序排列时可用）
+    * @return 如果不能使用绘制索引，返回nullptr，此时需要逐个绘制所有子控件
+    */
+    const PaintItemIndex* GetPaintItemIndex();
+
+private:
+    /** 获取按坐标命中测试时，需要检查的候选子控件（使用命中测试索引）
+    * @param [in] items 子控件列表
+    * @param [in] uFlags 查找标志
+    * @param [in] boxPt 子控件坐标系下的坐标
+    * @param [out] pBegin 候选子控件索引号列表的起始位置
+    * @param [out] pEnd 候选子控件索引号列表的结束位置
+    * @return 如果不能使用命中测试索引，返回false，此时需要遍历所有子控件
+    */
+    bool GetHitTestCandidates(const std::vector<Control*>& items, uint32_t uFlags, const UiPoint& boxPt,
+                              const uint32_t*& pBegin, const uint32_t*& pEnd);
+
 private:
     /**@brief 向指定位置添加一个控件
      * @param[in] pControl 控件指针
@@ -240,6 +265,12 @@ private:
 
     //是否支持拖拽拖出该容器：如果不等于0，支持拖出，否则不支持拖出（拖出到DropInId==DragOutId的容器）
     uint8_t m_nDragOutId;
+
+    //子控件的命中测试索引（子控件数量较多时，按需创建）
+    std::unique_ptr<HitTestGrid> m_pHitTestGrid;
+
+    //子控件的绘制索引（子控件数量较多时，按需创建）
+    std::unique_ptr<PaintItemIndex> m_pPaintItemIndex;
 };
 
 } // namespace ui
@@ -45,7 +45,8 @@ void ColorMap::RemoveAllColors()
     m_colorMap.clear();
 }
 
-ColorManager::ColorManager()
+ColorManager::ColorManager():
+    m_nColorEpoch(1)
 {
     //初始化标准颜色表, 字符串不区分大小写
     std::vector<std::pair<DString, int32_t>> uiColors;
@@ -101,11 +102,13 @@ UiColor ColorManager::ConvertToUiColor(const DString& strColor)
 void ColorManager::AddColor(const DString& strName, const DString& strValue)
 {
     m_colorMap.AddColor(strName, strValue);
+    IncreaseColorEpoch();
 }
 
 void ColorManager::AddColor(const DString& strName, UiColor argb)
 {
     m_colorMap.AddColor(strName, argb);
+    IncreaseColorEpoch();
 }
 
 UiColor ColorManager::GetColor(const DString& strName) const
@@ -124,6 +127,7 @@ void ColorManager::RemoveAllColors()
     m_colorMap.RemoveAllColors();
     m_defaultDisabledTextColor.clear();
     m_defaultTextColor.clear();
+    IncreaseColorEpoch();
 }
 
 void ColorManager::Clear()
@@ -132,6 +136,20 @@ void ColorManager::Clear()
     m_standardColorMap.RemoveAllColors();
 }
 
+uint32_t ColorManager::GetColorEpoch() const
+{
+    return m_nColorEpoch;
+}
+
+void ColorManager::IncreaseColorEpoch()
+{
+    ++m_nColorEpoch;
+    if (m_nColorEpoch == 0) {
+        //0表示未解析，跳过
+        m_nColorEpoch = 1;
+    }
+}
+
 const DString& ColorManager::GetDefaultDisabledTextColor()
 {
     return m_defaultDisabledTextColor;
@@ -152,5 +170,55 @@ void ColorManager::SetDefaultTextColor(const DString& strColor)
     m_defaultTextColor = strColor;
 }
 
+ColorHandle::ColorHandle():
+    m_pWindow(nullptr),
+    m_nColorEpoch(0),
+    m_bImmediate(false)
+{
+}
+
+bool ColorHandle::IsResolved(const UiString& colorName, const Window* pWindow) const
+{
+    if ((m_nColorEpoch == 0) || (m_colorName != colorName)) {
+        return false;
+    }
+    return IsEpochValid(pWindow);
+}
+
+bool ColorHandle::IsResolved(const DString& colorName, const Window* pWindow) const
+{
+    if ((m_nColorEpoch == 0) || (m_colorName != colorName)) {
+        return false;
+    }
+    return IsEpochValid(pWindow);
+}
+
+bool ColorHandle::IsEpochValid(const Window* pWindow) const
+{
+    if (m_bImmediate) {
+        return true;
+    }
+    return (m_pWindow == pWindow) && (m_nColorEpoch == GlobalManager::Instance().Color().GetColorEpoch());
+}
+
+void ColorHandle::SetColor(const DString& colorName, UiColor color, const Window* pWindow)
+{
+    m_colorName = colorName;
+    m_color = color;
+    m_pWindow = pWindow;
+    m_nColorEpoch = GlobalManager::Instance().Color().GetColorEpoch();
+    //以'#'开头的具体颜色值，解析结果不依赖颜色表
+    m_bImmediate = !colorName.empty() && (colorName.at(0) == _T('#')) && !color.IsEmpty();
+}
+
+void ColorHandle::Reset()
+{
+    m_colorName.clear();
+    m_color = UiColor();
+    m_pWindow = nullptr;
+    m_nColorEpoch = 0;
+    m_bImmediate = false;
+}
+
 } // namespace ui
 
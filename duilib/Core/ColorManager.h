@@ -2,11 +2,14 @@
 #define UI_CORE_COLOR_MANAGER_H_
 
 #include "duilib/Core/UiColor.h"
+#include "duilib/Core/UiString.h"
 #include <unordered_map>
 #include <string>
 
 namespace ui 
 {
+class Window;
+
 /** 颜色值的管理容器
 */
 class UILIB_API ColorMap
@@ -87,6 +90,15 @@ public:
      */
     void Clear();
 
+    /** 获取颜色表的版本号，颜色表发生变化（添加、删除颜色，切换主题或者重新加载资源等）时，版本号递增
+     *  用于判断ColorHandle中缓存的颜色值是否需要重新解析
+     */
+    uint32_t GetColorEpoch() const;
+
+    /** 递增颜色表的版本号（窗口中定义的颜色发生变化时也需要调用）
+     */
+    void IncreaseColorEpoch();
+
 public:
     /** 获取默认禁用状态下字体颜色
      * @return 默认禁用状态颜色的字符串表示，对应 global.xml 中指定颜色值
@@ -121,6 +133,69 @@ private:
     /** 默认正常状态的字体颜色
     */
     DString m_defaultTextColor;
+
+    /** 颜色表的版本号
+    */
+    uint32_t m_nColorEpoch;
+};
+
+/** 颜色句柄：缓存颜色字符串解析后的颜色值，绘制时直接使用，避免每次绘制都按颜色名称查找颜色表
+ *  (1) 具体颜色值（如 #FFFFFFFF）：解析一次以后不再变化
+ *  (2) 颜色名称：颜色表的版本号或者所属窗口发生变化时，需要重新解析
+ *  使用方法参见：Control::GetUiColor(const UiString&, ColorHandle&)
+ */
+class UILIB_API ColorHandle
+{
+public:
+    ColorHandle();
+
+    /** 缓存的颜色值是否有效（颜色名称相同，且无需重新解析）
+    * @param [in] colorName 颜色名称或者具体颜色值
+    * @param [in] pWindow 颜色所属的窗口
+    */
+    bool IsResolved(const UiString& colorName, const Window* pWindow) const;
+    bool IsResolved(const DString& colorName, const Window* pWindow) const;
+
+    /** 设置解析后的颜色值
+    * @param [in] colorName 颜色名称或者具体颜色值
+    * @param [in] color 解析后的颜色值
+    * @param [in] pWindow 颜色所属的窗口
+    */
+    void SetColor(const DString& colorName, UiColor color, const Window* pWindow);
+
+    /** 获取缓存的颜色值
+    */
+    UiColor GetColor() const { return m_color; }
+
+    /** 清除缓存的颜色值
+    */
+    void Reset();
+
+private:
+    /** 检查版本号和所属窗口
+    */
+    bool IsEpochValid(const Window* pWindow) const;
+
+private:
+    /** 颜色名称或者具体颜色值
+    */
+    UiString m_colorName;
+
+    /** 解析后的颜色值
+    */
+    UiColor m_color;
+
+    /** 解析时所属的窗口（窗口中可以定义颜色），只用于比较，不访问
+    */
+    const Window* m_pWindow;
+
+    /** 解析时颜色表的版本号，为0表示未解析
+    */
+    uint32_t m_nColorEpoch;
+
+    /** 是否为具体颜色值（不依赖颜色表）
+    */
+    bool m_bImmediate;
 };
 
 } // namespace ui
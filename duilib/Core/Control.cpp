@@ -12,6 +12,7 @@
 #include "duilib/Animation/AnimationManager.h"
 #include "duilib/Utils/StringUtil.h"
 #include "duilib/Utils/AttributeUtil.h"
+#include <unordered_map>
 
 namespace ui 
 {
@@ -59,6 +60,9 @@ Control::~Control()
     }    
     m_animationManager.reset();
 
+    //绘制缓存的画布放回窗口的复用池
+    ClearRender();
+
     Window* pWindow = GetWindow();
     if (pWindow) {
         pWindow->ReapObjects(this);
@@ -93,386 +97,755 @@ Control::~Control()
 
 DString Control::GetType() const { return DUI_CTR_CONTROL; }
 
+/** Control的属性ID：属性名称预先映射为整数ID，设置属性时按ID分发，避免逐个比较属性名称
+*/
+enum class ControlAttributeId: uint8_t
+{
+    kUnknown = 0,
+    kClass,
+    kHalign,
+    kValign,
+    kMargin,
+    kPadding,
+    kControlPadding,
+    kBkcolor,
+    kBkcolor2,
+    kBkcolor2Direction,
+    kBorderSize,
+    kBorderRound,
+    kBoxShadow,
+    kWidth,
+    kHeight,
+    kState,
+    kCursorType,
+    kRenderOffset,
+    kNormalColor,
+    kHotColor,
+    kPushedColor,
+    kDisabledColor,
+    kBorderColor,
+    kNormalBorderColor,
+    kHotBorderColor,
+    kPushedBorderColor,
+    kDisabledBorderColor,
+    kFocusBorderColor,
+    kLeftBorderSize,
+    kTopBorderSize,
+    kRightBorderSize,
+    kBottomBorderSize,
+    kBkimage,
+    kMinWidth,
+    kMaxWidth,
+    kMinHeight,
+    kMaxHeight,
+    kName,
+    kTooltipText,
+    kTooltipTextId,
+    kTooltipWidth,
+    kDataId,
+    kUserDataId,
+    kEnabled,
+    kMouseEnabled,
+    kKeyboardEnabled,
+    kVisible,
+    kFadeVisible,
+    kFloat,
+    kCache,
+    kNoFocus,
+    kAlpha,
+    kNormalImage,
+    kHotImage,
+    kPushedImage,
+    kDisabledImage,
+    kForeNormalImage,
+    kForeHotImage,
+    kForePushedImage,
+    kForeDisabledImage,
+    kFadeAlpha,
+    kFadeHot,
+    kFadeWidth,
+    kFadeHeight,
+    kFadeInOutXFromLeft,
+    kFadeInOutXFromRight,
+    kFadeInOutYFromTop,
+    kFadeInOutYFromBottom,
+    kTabStop,
+    kLoadingImage,
+    kLoadingBkcolor,
+    kShowFocusRect,
+    kFocusRectColor,
+    kPaintOrder,
+    kStartGifPlay,
+    kStopGifPlay,
+};
+
+/** 获取属性名称对应的属性ID
+* @param [in] strName 属性名称
+* @return 如果不是Control支持的属性，返回ControlAttributeId::kUnknown
+*/
+static ControlAttributeId GetControlAttributeId(const DString& strName)
+{
+    static const std::unordered_map<DString, ControlAttributeId> attributeIdMap = {
+        { _T("class"), ControlAttributeId::kClass },
+        { _T("halign"), ControlAttributeId::kHalign },
+        { _T("valign"), ControlAttributeId::kValign },
+        { _T("margin"), ControlAttributeId::kMargin },
+        { _T("padding"), ControlAttributeId::kPadding },
+        { _T("control_padding"), ControlAttributeId::kControlPadding },
+        { _T("bkcolor"), ControlAttributeId::kBkcolor },
+        { _T("bkcolor2"), ControlAttributeId::kBkcolor2 },
+        { _T("bkcolor2_direction"), ControlAttributeId::kBkcolor2Direction },
+        { _T("border_size"), ControlAttributeId::kBorderSize },
+        { _T("bordersize"), ControlAttributeId::kBorderSize },
+        { _T("border_round"), ControlAttributeId::kBorderRound },
+        { _T("borderround"), ControlAttributeId::kBorderRound },
+        { _T("box_shadow"), ControlAttributeId::kBoxShadow },
+        { _T("boxshadow"), ControlAttributeId::kBoxShadow },
+        { _T("width"), ControlAttributeId::kWidth },
+        { _T("height"), ControlAttributeId::kHeight },
+        { _T("state"), ControlAttributeId::kState },
+        { _T("cursor_type"), ControlAttributeId::kCursorType },
+        { _T("cursortype"), ControlAttributeId::kCursorType },
+        { _T("render_offset"), ControlAttributeId::kRenderOffset },
+        { _T("renderoffset"), ControlAttributeId::kRenderOffset },
+        { _T("normal_color"), ControlAttributeId::kNormalColor },
+        { _T("normalcolor"), ControlAttributeId::kNormalColor },
+        { _T("hot_color"), ControlAttributeId::kHotColor },
+        { _T("hotcolor"), ControlAttributeId::kHotColor },
+        { _T("pushed_color"), ControlAttributeId::kPushedColor },
+        { _T("pushedcolor"), ControlAttributeId::kPushedColor },
+        { _T("disabled_color"), ControlAttributeId::kDisabledColor },
+        { _T("disabledcolor"), ControlAttributeId::kDisabledColor },
+        { _T("border_color"), ControlAttributeId::kBorderColor },
+        { _T("bordercolor"), ControlAttributeId::kBorderColor },
+        { _T("normal_border_color"), ControlAttributeId::kNormalBorderColor },
+        { _T("hot_border_color"), ControlAttributeId::kHotBorderColor },
+        { _T("pushed_border_color"), ControlAttributeId::kPushedBorderColor },
+        { _T("disabled_border_color"), ControlAttributeId::kDisabledBorderColor },
+        { _T("focus_border_color"), ControlAttributeId::kFocusBorderColor },
+        { _T("left_border_size"), ControlAttributeId::kLeftBorderSize },
+        { _T("leftbordersize"), ControlAttributeId::kLeftBorderSize },
+        { _T("top_border_size"), ControlAttributeId::kTopBorderSize },
+        { _T("topbordersize"), ControlAttributeId::kTopBorderSize },
+        { _T("right_border_size"), ControlAttributeId::kRightBorderSize },
+        { _T("rightbordersize"), ControlAttributeId::kRightBorderSize },
+        { _T("bottom_border_size"), ControlAttributeId::kBottomBorderSize },
+        { _T("bottombordersize"), ControlAttributeId::kBottomBorderSize },
+        { _T("bkimage"), ControlAttributeId::kBkimage },
+        { _T("min_width"), ControlAttributeId::kMinWidth },
+        { _T("minwidth"), ControlAttributeId::kMinWidth },
+        { _T("max_width"), ControlAttributeId::kMaxWidth },
+        { _T("maxwidth"), ControlAttributeId::kMaxWidth },
+        { _T("min_height"), ControlAttributeId::kMinHeight },
+        { _T("minheight"), ControlAttributeId::kMinHeight },
+        { _T("max_height"), ControlAttributeId::kMaxHeight },
+        { _T("maxheight"), ControlAttributeId::kMaxHeight },
+        { _T("name"), ControlAttributeId::kName },
+        { _T("tooltip_text"), ControlAttributeId::kTooltipText },
+        { _T("tooltiptext"), ControlAttributeId::kTooltipText },
+        { _T("tooltip_text_id"), ControlAttributeId::kTooltipTextId },
+        { _T("tooltip_textid"), ControlAttributeId::kTooltipTextId },
+        { _T("tooltiptextid"), ControlAttributeId::kTooltipTextId },
+        { _T("tooltip_width"), ControlAttributeId::kTooltipWidth },
+        { _T("data_id"), ControlAttributeId::kDataId },
+        { _T("dataid"), ControlAttributeId::kDataId },
+        { _T("user_data_id"), ControlAttributeId::kUserDataId },
+        { _T("user_dataid"), ControlAttributeId::kUserDataId },
+        { _T("enabled"), ControlAttributeId::kEnabled },
+        { _T("mouse_enabled"), ControlAttributeId::kMouseEnabled },
+        { _T("mouse"), ControlAttributeId::kMouseEnabled },
+        { _T("keyboard_enabled"), ControlAttributeId::kKeyboardEnabled },
+        { _T("keyboard"), ControlAttributeId::kKeyboardEnabled },
+        { _T("visible"), ControlAttributeId::kVisible },
+        { _T("fade_visible"), ControlAttributeId::kFadeVisible },
+        { _T("fadevisible"), ControlAttributeId::kFadeVisible },
+        { _T("float"), ControlAttributeId::kFloat },
+        { _T("cache"), ControlAttributeId::kCache },
+        { _T("no_focus"), ControlAttributeId::kNoFocus },
+        { _T("nofocus"), ControlAttributeId::kNoFocus },
+        { _T("alpha"), ControlAttributeId::kAlpha },
+        { _T("normal_image"), ControlAttributeId::kNormalImage },
+        { _T("normalimage"), ControlAttributeId::kNormalImage },
+        { _T("hot_image"), ControlAttributeId::kHotImage },
+        { _T("hotimage"), ControlAttributeId::kHotImage },
+        { _T("pushed_image"), ControlAttributeId::kPushedImage },
+        { _T("pushedimage"), ControlAttributeId::kPushedImage },
+        { _T("disabled_image"), ControlAttributeId::kDisabledImage },
+        { _T("disabledimage"), ControlAttributeId::kDisabledImage },
+        { _T("fore_normal_image"), ControlAttributeId::kForeNormalImage },
+        { _T("forenormalimage"), ControlAttributeId::kForeNormalImage },
+        { _T("fore_hot_image"), ControlAttributeId::kForeHotImage },
+        { _T("forehotimage"), ControlAttributeId::kForeHotImage },
+        { _T("fore_pushed_image"), ControlAttributeId::kForePushedImage },
+        { _T("forepushedimage"), ControlAttributeId::kForePushedImage },
+        { _T("fore_disabled_image"), ControlAttributeId::kForeDisabledImage },
+        { _T("foredisabledimage"), ControlAttributeId::kForeDisabledImage },
+        { _T("fade_alpha"), ControlAttributeId::kFadeAlpha },
+        { _T("fadealpha"), ControlAttributeId::kFadeAlpha },
+        { _T("fade_hot"), ControlAttributeId::kFadeHot },
+        { _T("fadehot"), ControlAttributeId::kFadeHot },
+        { _T("fade_width"), ControlAttributeId::kFadeWidth },
+        { _T("fadewidth"), ControlAttributeId::kFadeWidth },
+        { _T("fade_height"), ControlAttributeId::kFadeHeight },
+        { _T("fadeheight"), ControlAttributeId::kFadeHeight },
+        { _T("fade_in_out_x_from_left"), ControlAttributeId::kFadeInOutXFromLeft },
+        { _T("fadeinoutxfromleft"), ControlAttributeId::kFadeInOutXFromLeft },
+        { _T("fade_in_out_x_from_right"), ControlAttributeId::kFadeInOutXFromRight },
+        { _T("fadeinoutxfromright"), ControlAttributeId::kFadeInOutXFromRight },
+        { _T("fade_in_out_y_from_top"), ControlAttributeId::kFadeInOutYFromTop },
+        { _T("fadeinoutyfromtop"), ControlAttributeId::kFadeInOutYFromTop },
+        { _T("fade_in_out_y_from_bottom"), ControlAttributeId::kFadeInOutYFromBottom },
+        { _T("fadeinoutyfrombottom"), ControlAttributeId::kFadeInOutYFromBottom },
+        { _T("tab_stop"), ControlAttributeId::kTabStop },
+        { _T("tabstop"), ControlAttributeId::kTabStop },
+        { _T("loading_image"), ControlAttributeId::kLoadingImage },
+        { _T("loadingimage"), ControlAttributeId::kLoadingImage },
+        { _T("loading_bkcolor"), ControlAttributeId::kLoadingBkcolor },
+        { _T("loadingbkcolor"), ControlAttributeId::kLoadingBkcolor },
+        { _T("show_focus_rect"), ControlAttributeId::kShowFocusRect },
+        { _T("focus_rect_color"), ControlAttributeId::kFocusRectColor },
+        { _T("paint_order"), ControlAttributeId::kPaintOrder },
+        { _T("start_gif_play"), ControlAttributeId::kStartGifPlay },
+        { _T("stop_gif_play"), ControlAttributeId::kStopGifPlay },
+    };
+    auto iter = attributeIdMap.find(strName);
+    if (iter != attributeIdMap.end()) {
+        return iter->second;
+    }
+    return ControlAttributeId::kUnknown;
+}
+
 void Control::SetAttribute(const DString& strName, const DString& strValue)
 {
     ASSERT(GetWindow() != nullptr);//由于需要做DPI感知功能，所以必须先设置关联窗口
-    if (strName == _T("class")) {
-        SetClass(strValue);
-    }
-    else if (strName == _T("halign")) {
-        if (strValue == _T("left")) {
-            SetHorAlignType(kHorAlignLeft);
+    switch (GetControlAttributeId(strName)) {
+    case ControlAttributeId::kClass:
+        {
+            SetClass(strValue);
         }
-        else if (strValue == _T("center")) {
-            SetHorAlignType(kHorAlignCenter);
+        break;
+    case ControlAttributeId::kHalign:
+        {
+            if (strValue == _T("left")) {
+                SetHorAlignType(kHorAlignLeft);
+            }
+            else if (strValue == _T("center")) {
+                SetHorAlignType(kHorAlignCenter);
+            }
+            else if (strValue == _T("right")) {
+                SetHorAlignType(kHorAlignRight);
+            }
+            else {
+                ASSERT(0);
+            }
         }
-        else if (strValue == _T("right")) {
-            SetHorAlignType(kHorAlignRight);
+        break;
+    case ControlAttributeId::kValign:
+        {
+            if (strValue == _T("top")) {
+                SetVerAlignType(kVerAlignTop);
+            }
+            else if (strValue == _T("center")) {
+                SetVerAlignType(kVerAlignCenter);
+            }
+            else if (strValue == _T("bottom")) {
+                SetVerAlignType(kVerAlignBottom);
+            }
+            else {
+                ASSERT(0);
+            }
         }
-        else {
-            ASSERT(0);
+        break;
+    case ControlAttributeId::kMargin:
+        {
+            UiMargin rcMargin;
+            AttributeUtil::ParseMarginValue(strValue.c_str(), rcMargin);
+            SetMargin(rcMargin, true);
         }
-    }
-    else if (strName == _T("valign")) {
-        if (strValue == _T("top")) {
-            SetVerAlignType(kVerAlignTop);
+        break;
+    case ControlAttributeId::kPadding:
+        {
+            UiPadding rcPadding;
+            AttributeUtil::ParsePaddingValue(strValue.c_str(), rcPadding);
+            SetPadding(rcPadding, true);
         }
-        else if (strValue == _T("center")) {
-            SetVerAlignType(kVerAlignCenter);
+        break;
+    case ControlAttributeId::kControlPadding:
+        {
+            SetEnableControlPadding(strValue == _T("true"));
         }
-        else if (strValue == _T("bottom")) {
-            SetVerAlignType(kVerAlignBottom);
+        break;
+    case ControlAttributeId::kBkcolor:
+        {
+            //背景色
+            SetBkColor(strValue);
         }
-        else {
-            ASSERT(0);
+        break;
+    case ControlAttributeId::kBkcolor2:
+        {
+            //第二背景色（实现渐变背景色）
+            SetBkColor2(strValue);
         }
-    }
-    else if (strName == _T("margin")) {
-        UiMargin rcMargin;
-        AttributeUtil::ParseMarginValue(strValue.c_str(), rcMargin);
-        SetMargin(rcMargin, true);
-    }
-    else if (strName == _T("padding")) {
-        UiPadding rcPadding;
-        AttributeUtil::ParsePaddingValue(strValue.c_str(), rcPadding);
-        SetPadding(rcPadding, true);
-    }
-    else if (strName == _T("control_padding")) {
-        SetEnableControlPadding(strValue == _T("true"));
-    }
-    else if (strName == _T("bkcolor")) {
-        //背景色
-        SetBkColor(strValue);
-    }
-    else if (strName == _T("bkcolor2")) {
-        //第二背景色（实现渐变背景色）
-        SetBkColor2(strValue);
-    }
-    else if (strName == _T("bkcolor2_direction")) {
-        //第二背景色的方向："1": 左->右，"2": 上->下，"3": 左上->右下，"4": 右上->左下
-        SetBkColor2Direction(strValue);
-    }
-    else if ((strName == _T("border_size")) || (strName == _T("bordersize"))) {
-        DString nValue = strValue;
-        if (nValue.find(_T(',')) == DString::npos) {
-            int32_t nBorderSize = StringUtil::StringToInt32(strValue);
-            if (nBorderSize < 0) {
-                nBorderSize = 0;
-            }
-            UiRect rcBorder(nBorderSize, nBorderSize, nBorderSize, nBorderSize);
-            SetBorderSize(rcBorder, true);
+        break;
+    case ControlAttributeId::kBkcolor2Direction:
+        {
+            //第二背景色的方向："1": 左->右，"2": 上->下，"3": 左上->右下，"4": 右上->左下
+            SetBkColor2Direction(strValue);
         }
-        else {
-            UiMargin rcMargin;
-            AttributeUtil::ParseMarginValue(strValue.c_str(), rcMargin);
-            UiRect rcBorder(rcMargin.left, rcMargin.top, rcMargin.right, rcMargin.bottom);
-            SetBorderSize(rcBorder, true);
+        break;
+    case ControlAttributeId::kBorderSize:
+        {
+            DString nValue = strValue;
+            if (nValue.find(_T(',')) == DString::npos) {
+                int32_t nBorderSize = StringUtil::StringToInt32(strValue);
+                if (nBorderSize < 0) {
+                    nBorderSize = 0;
+                }
+                UiRect rcBorder(nBorderSize, nBorderSize, nBorderSize, nBorderSize);
+                SetBorderSize(rcBorder, true);
+            }
+            else {
+                UiMargin rcMargin;
+                AttributeUtil::ParseMarginValue(strValue.c_str(), rcMargin);
+                UiRect rcBorder(rcMargin.left, rcMargin.top, rcMargin.right, rcMargin.bottom);
+                SetBorderSize(rcBorder, true);
+            }
         }
-    }
-    else if ((strName == _T("border_round")) || (strName == _T("borderround"))) {
-        UiSize cxyRound;
-        AttributeUtil::ParseSizeValue(strValue.c_str(), cxyRound);
-        SetBorderRound(cxyRound, true);
-    }
-    else if ((strName == _T("box_shadow")) || (strName == _T("boxshadow"))) {
-        SetBoxShadow(strValue);
-    }
-    else if (strName == _T("width")) {
-        if (strValue == _T("stretch")) {
-            //宽度为拉伸：由父容器负责分配宽度
-            SetFixedWidth(UiFixedInt::MakeStretch(), true, true);
+        break;
+    case ControlAttributeId::kBorderRound:
+        {
+            UiSize cxyRound;
+            AttributeUtil::ParseSizeValue(strValue.c_str(), cxyRound);
+            SetBorderRound(cxyRound, true);
         }
-        else if (strValue == _T("auto")) {
-            //宽度为自动：根据控件的文本、图片等自动计算宽度
-            SetFixedWidth(UiFixedInt::MakeAuto(), true, true);
+        break;
+    case ControlAttributeId::kBoxShadow:
+        {
+            SetBoxShadow(strValue);
         }
-        else if (!strValue.empty()) {
-            if (strValue.back() == _T('%')) {
-                //宽度为拉伸：由父容器负责按百分比分配宽度，比如 width="30%"，代表该控件的宽度期望值为父控件宽度的30%
-                int32_t iValue = StringUtil::StringToInt32(strValue);
-                if ((iValue <= 0) || (iValue > 100)) {
-                    iValue = 100;
+        break;
+    case ControlAttributeId::kWidth:
+        {
+            if (strValue == _T("stretch")) {
+                //宽度为拉伸：由父容器负责分配宽度
+                SetFixedWidth(UiFixedInt::MakeStretch(), true, true);
+            }
+            else if (strValue == _T("auto")) {
+                //宽度为自动：根据控件的文本、图片等自动计算宽度
+                SetFixedWidth(UiFixedInt::MakeAuto(), true, true);
+            }
+            else if (!strValue.empty()) {
+                if (strValue.back() == _T('%')) {
+                    //宽度为拉伸：由父容器负责按百分比分配宽度，比如 width="30%"，代表该控件的宽度期望值为父控件宽度的30%
+                    int32_t iValue = StringUtil::StringToInt32(strValue);
+                    if ((iValue <= 0) || (iValue > 100)) {
+                        iValue = 100;
+                    }
+                    SetFixedWidth(UiFixedInt::MakeStretch(iValue), true, false);
+                }
+                else {
+                    //宽度为固定值
+                    ASSERT(StringUtil::StringToInt32(strValue) >= 0);
+                    SetFixedWidth(UiFixedInt(StringUtil::StringToInt32(strValue)), true, true);
                 }
-                SetFixedWidth(UiFixedInt::MakeStretch(iValue), true, false);
             }
             else {
-                //宽度为固定值
-                ASSERT(StringUtil::StringToInt32(strValue) >= 0);
-                SetFixedWidth(UiFixedInt(StringUtil::StringToInt32(strValue)), true, true);
+                SetFixedWidth(UiFixedInt(0), true, true);
             }
         }
-        else {
-            SetFixedWidth(UiFixedInt(0), true, true);
-        }
-    }
-    else if (strName == _T("height")) {
-        if (strValue == _T("stretch")) {
-            //高度为拉伸：由父容器负责分配高度
-            SetFixedHeight(UiFixedInt::MakeStretch(), true, true);
+        break;
+    case ControlAttributeId::kHeight:
+        {
+            if (strValue == _T("stretch")) {
+                //高度为拉伸：由父容器负责分配高度
+                SetFixedHeight(UiFixedInt::MakeStretch(), true, true);
+            }
+            else if (strValue == _T("auto")) {
+                //高度为自动：根据控件的文本、图片等自动计算高度
+                SetFixedHeight(UiFixedInt::MakeAuto(), true, true);
+            }
+            else if (!strValue.empty()) {
+                if (strValue.back() == _T('%')) {
+                    //高度为拉伸：由父容器负责按百分比分配高度，比如 height="30%"，代表该控件的高度期望值为父控件高度的30%
+                    int32_t iValue = StringUtil::StringToInt32(strValue);
+                    if ((iValue <= 0) || (iValue > 100)) {
+                        iValue = 100;
+                    }
+                    SetFixedHeight(UiFixedInt::MakeStretch(iValue), true, false);
+                }
+                else {
+                    //高度为固定值
+                    ASSERT(StringUtil::StringToInt32(strValue) >= 0);
+                    SetFixedHeight(UiFixedInt(StringUtil::StringToInt32(strValue)), true, true);
+                }
+            }
+            else {
+                SetFixedHeight(UiFixedInt(0), true, true);
+            }
         }
-        else if (strValue == _T("auto")) {
-            //高度为自动：根据控件的文本、图片等自动计算高度
-            SetFixedHeight(UiFixedInt::MakeAuto(), true, true);
+        break;
+    case ControlAttributeId::kState:
+        {
+            if (strValue == _T("normal")) {
+                SetState(kControlStateNormal);
+            }
+            else if (strValue == _T("hot")) {
+                SetState(kControlStateHot);
+            }
+            else if (strValue == _T("pushed")) {
+                SetState(kControlStatePushed);
+            }
+            else if (strValue == _T("disabled")) {
+                SetState(kControlStateDisabled);
+            }
+            else {
+                ASSERT(0);
+            }
         }
-        else if (!strValue.empty()) {
-            if (strValue.back() == _T('%')) {
-                //高度为拉伸：由父容器负责按百分比分配高度，比如 height="30%"，代表该控件的高度期望值为父控件高度的30%
-                int32_t iValue = StringUtil::StringToInt32(strValue);
-                if ((iValue <= 0) || (iValue > 100)) {
-                    iValue = 100;
-                }
-                SetFixedHeight(UiFixedInt::MakeStretch(iValue), true, false);
+        break;
+    case ControlAttributeId::kCursorType:
+        {
+            if (strValue == _T("arrow")) {
+                SetCursorType(CursorType::kCursorArrow);
+            }
+            else if (strValue == _T("ibeam")) {
+                SetCursorType(CursorType::kCursorIBeam);
+            }
+            else if (strValue == _T("hand")) {
+                SetCursorType(CursorType::kCursorHand);
+            }
+            else if (strValue == _T("wait")) {
+                SetCursorType(CursorType::kCursorWait);
+            }
+            else if (strValue == _T("cross")) {
+                SetCursorType(CursorType::kCursorCross);
+            }
+            else if (strValue == _T("size_we")) {
+                SetCursorType(CursorType::kCursorSizeWE);
+            }
+            else if (strValue == _T("size_ns")) {
+                SetCursorType(CursorType::kCursorSizeNS);
+            }
+            else if (strValue == _T("size_nwse")) {
+                SetCursorType(CursorType::kCursorSizeNWSE);
+            }
+            else if (strValue == _T("size_nesw")) {
+                SetCursorType(CursorType::kCursorSizeNESW);
+            }
+            else if (strValue == _T("size_all")) {
+                SetCursorType(CursorType::kCursorSizeAll);
+            }
+            else if (strValue == _T("no")) {
+                SetCursorType(CursorType::kCursorNo);
             }
             else {
-                //高度为固定值
-                ASSERT(StringUtil::StringToInt32(strValue) >= 0);
-                SetFixedHeight(UiFixedInt(StringUtil::StringToInt32(strValue)), true, true);
+                ASSERT(0);
             }
         }
-        else {
-            SetFixedHeight(UiFixedInt(0), true, true);
+        break;
+    case ControlAttributeId::kRenderOffset:
+        {
+            UiPoint renderOffset;
+            AttributeUtil::ParsePointValue(strValue.c_str(), renderOffset);
+            SetRenderOffset(renderOffset, true);
         }
-    }
-    else if (strName == _T("state")) {
-        if (strValue == _T("normal")) {
-            SetState(kControlStateNormal);
+        break;
+    case ControlAttributeId::kNormalColor:
+        {
+            SetStateColor(kControlStateNormal, strValue);
         }
-        else if (strValue == _T("hot")) {
-            SetState(kControlStateHot);
+        break;
+    case ControlAttributeId::kHotColor:
+        {
+            SetStateColor(kControlStateHot, strValue);
         }
-        else if (strValue == _T("pushed")) {
-            SetState(kControlStatePushed);
+        break;
+    case ControlAttributeId::kPushedColor:
+        {
+            SetStateColor(kControlStatePushed, strValue);
         }
-        else if (strValue == _T("disabled")) {
-            SetState(kControlStateDisabled);
+        break;
+    case ControlAttributeId::kDisabledColor:
+        {
+            SetStateColor(kControlStateDisabled, strValue);
         }
-        else {
-            ASSERT(0);
+        break;
+    case ControlAttributeId::kBorderColor:
+        {
+            SetBorderColor(strValue);
         }
-    }
-    else if ((strName == _T("cursor_type")) || (strName == _T("cursortype"))) {
-        if (strValue == _T("arrow")) {
-            SetCursorType(CursorType::kCursorArrow);
+        break;
+    case ControlAttributeId::kNormalBorderColor:
+        {
+            SetBorderColor(kControlStateNormal, strValue);
         }
-        else if (strValue == _T("ibeam")) {
-            SetCursorType(CursorType::kCursorIBeam);
+        break;
+    case ControlAttributeId::kHotBorderColor:
+        {
+            SetBorderColor(kControlStateHot, strValue);
         }
-        else if (strValue == _T("hand")) {
-            SetCursorType(CursorType::kCursorHand);
+        break;
+    case ControlAttributeId::kPushedBorderColor:
+        {
+            SetBorderColor(kControlStatePushed, strValue);
         }
-        else if (strValue == _T("wait")) {
-            SetCursorType(CursorType::kCursorWait);
+        break;
+    case ControlAttributeId::kDisabledBorderColor:
+        {
+            SetBorderColor(kControlStateDisabled, strValue);
         }
-        else if (strValue == _T("cross")) {
-            SetCursorType(CursorType::kCursorCross);
+        break;
+    case ControlAttributeId::kFocusBorderColor:
+        {
+            SetFocusBorderColor(strValue);
         }
-        else if (strValue == _T("size_we")) {
-            SetCursorType(CursorType::kCursorSizeWE);
+        break;
+    case ControlAttributeId::kLeftBorderSize:
+        {
+            SetLeftBorderSize(StringUtil::StringToInt32(strValue), true);
         }
-        else if (strValue == _T("size_ns")) {
-            SetCursorType(CursorType::kCursorSizeNS);
+        break;
+    case ControlAttributeId::kTopBorderSize:
+        {
+            SetTopBorderSize(StringUtil::StringToInt32(strValue), true);
         }
-        else if (strValue == _T("size_nwse")) {
-            SetCursorType(CursorType::kCursorSizeNWSE);
+        break;
+    case ControlAttributeId::kRightBorderSize:
+        {
+            SetRightBorderSize(StringUtil::StringToInt32(strValue), true);
         }
-        else if (strValue == _T("size_nesw")) {
-            SetCursorType(CursorType::kCursorSizeNESW);
+        break;
+    case ControlAttributeId::kBottomBorderSize:
+        {
+            SetBottomBorderSize(StringUtil::StringToInt32(strValue), true);
         }
-        else if (strValue == _T("size_all")) {
-            SetCursorType(CursorType::kCursorSizeAll);
+        break;
+    case ControlAttributeId::kBkimage:
+        {
+            SetBkImage(strValue);
         }
-        else if (strValue == _T("no")) {
-            SetCursorType(CursorType::kCursorNo);
+        break;
+    case ControlAttributeId::kMinWidth:
+        {
+            SetMinWidth(StringUtil::StringToInt32(strValue), true);
         }
-        else {
-            ASSERT(0);
+        break;
+    case ControlAttributeId::kMaxWidth:
+        {
+            SetMaxWidth(StringUtil::StringToInt32(strValue), true);
         }
-    }
-    else if ((strName == _T("render_offset")) || (strName == _T("renderoffset"))) {
-        UiPoint renderOffset;
-        AttributeUtil::ParsePointValue(strValue.c_str(), renderOffset);
-        SetRenderOffset(renderOffset, true);
-    }
-    else if ((strName == _T("normal_color")) || (strName == _T("normalcolor"))) {
-        SetStateColor(kControlStateNormal, strValue);
-    }
-    else if ((strName == _T("hot_color")) || (strName == _T("hotcolor"))) {
-        SetStateColor(kControlStateHot, strValue);
-    }
-    else if ((strName == _T("pushed_color")) || (strName == _T("pushedcolor"))) {
-        SetStateColor(kControlStatePushed, strValue);
-    }
-    else if ((strName == _T("disabled_color")) || (strName == _T("disabledcolor"))) {
-        SetStateColor(kControlStateDisabled, strValue);
-    }
-    else if ((strName == _T("border_color")) || (strName == _T("bordercolor"))) {
-        SetBorderColor(strValue);
-    }
-    else if (strName == _T("normal_border_color")) {
-        SetBorderColor(kControlStateNormal, strValue);
-    }
-    else if (strName == _T("hot_border_color")) {
-        SetBorderColor(kControlStateHot, strValue);
-    }
-    else if (strName == _T("pushed_border_color")) {
-        SetBorderColor(kControlStatePushed, strValue);
-    }
-    else if (strName == _T("disabled_border_color")) {
-        SetBorderColor(kControlStateDisabled, strValue);
-    }
-    else if (strName == _T("focus_border_color")) {
-        SetFocusBorderColor(strValue);
-    }
-    else if ((strName == _T("left_border_size")) || (strName == _T("leftbordersize"))) {
-        SetLeftBorderSize(StringUtil::StringToInt32(strValue), true);
-    }
-    else if ((strName == _T("top_border_size")) || (strName == _T("topbordersize"))) {
-        SetTopBorderSize(StringUtil::StringToInt32(strValue), true);
-    }
-    else if ((strName == _T("right_border_size")) || (strName == _T("rightbordersize"))) {
-        SetRightBorderSize(StringUtil::StringToInt32(strValue), true);
-    }
-    else if ((strName == _T("bottom_border_size")) || (strName == _T("bottombordersize"))) {
-        SetBottomBorderSize(StringUtil::StringToInt32(strValue), true);
-    }
-    else if (strName == _T("bkimage")) {
-        SetBkImage(strValue);
-    }
-    else if ((strName == _T("min_width")) || (strName == _T("minwidth"))) {
-        SetMinWidth(StringUtil::StringToInt32(strValue), true);
-    }
-    else if ((strName == _T("max_width")) || (strName == _T("maxwidth"))) {
-        SetMaxWidth(StringUtil::StringToInt32(strValue), true);
-    }
-    else if ((strName == _T("min_height")) || (strName == _T("minheight"))) {
-        SetMinHeight(StringUtil::StringToInt32(strValue), true);
-    }
-    else if ((strName == _T("max_height")) || (strName == _T("maxheight"))) {
-        SetMaxHeight(StringUtil::StringToInt32(strValue), true);
-    }
-    else if (strName == _T("name")) {
-        SetName(strValue);
-    }
-    else if ((strName == _T("tooltip_text")) || (strName == _T("tooltiptext"))) {
-        SetToolTipText(strValue);
-    }
-    else if ((strName == _T("tooltip_text_id")) || (strName == _T("tooltip_textid")) || (strName == _T("tooltiptextid"))) {
-        SetToolTipTextId(strValue);
-    }
-    else if (strName == _T("tooltip_width")) {
-
-        SetToolTipWidth(StringUtil::StringToInt32(strValue), true);
-    }
-    else if ((strName == _T("data_id")) || (strName == _T("dataid"))) {
-        SetDataID(strValue);
-    }
-    else if ((strName == _T("user_data_id")) || (strName == _T("user_dataid"))) {
-        SetUserDataID(StringUtil::StringToInt32(strValue));
-    }
-    else if (strName == _T("enabled")) {
-        SetEnabled(strValue == _T("true"));
-    }
-    else if ((strName == _T("mouse_enabled")) || (strName == _T("mouse"))) {
-        SetMouseEnabled(strValue == _T("true"));
-    }
-    else if ((strName == _T("keyboard_enabled")) || (strName == _T("keyboard"))) {
-        SetKeyboardEnabled(strValue == _T("true"));
-    }
-    else if (strName == _T("visible")) {
-        SetVisible(strValue == _T("true"));
-    }
-    else if ((strName == _T("fade_visible")) || (strName == _T("fadevisible"))) {
-        SetFadeVisible(strValue == _T("true"));
-    }
-    else if (strName == _T("float")) {
-        SetFloat(strValue == _T("true"));
-    }
-    else if (strName == _T("cache")) {
-        SetUseCache(strValue == _T("true"));
-    }
-    else if ((strName == _T("no_focus")) || (strName == _T("nofocus"))) {
-        SetNoFocus();
-    }
-    else if (strName == _T("alpha")) {
-        SetAlpha(StringUtil::StringToInt32(strValue));
-    }
-    else if ((strName == _T("normal_image")) || (strName == _T("normalimage"))) {
-        SetStateImage(kControlStateNormal, strValue);
-    }
-    else if ((strName == _T("hot_image")) || (strName == _T("hotimage"))) {
-        SetStateImage(kControlStateHot, strValue);
-    }
-    else if ((strName == _T("pushed_image")) || (strName == _T("pushedimage"))) {
-        SetStateImage(kControlStatePushed, strValue);
-    }
-    else if ((strName == _T("disabled_image")) || (strName == _T("disabledimage"))) {
-        SetStateImage(kControlStateDisabled, strValue);
-    }
-    else if ((strName == _T("fore_normal_image")) || (strName == _T("forenormalimage"))) {
-        SetForeStateImage(kControlStateNormal, strValue);
-    }
-    else if ((strName == _T("fore_hot_image")) || (strName == _T("forehotimage"))) {
-        SetForeStateImage(kControlStateHot, strValue);
-    }
-    else if ((strName == _T("fore_pushed_image")) || (strName == _T("forepushedimage"))) {
-        SetForeStateImage(kControlStatePushed, strValue);
-    }
-    else if ((strName == _T("fore_disabled_image")) || (strName == _T("foredisabledimage"))) {
-        SetForeStateImage(kControlStateDisabled, strValue);
-    }
-    else if ((strName == _T("fade_alpha")) || (strName == _T("fadealpha"))) {
-        GetAnimationManager().SetFadeAlpha(strValue == _T("true"));
-    }
-    else if ((strName == _T("fade_hot")) || (strName == _T("fadehot"))) {
-        GetAnimationManager().SetFadeHot(strValue == _T("true"));
-    }
-    else if ((strName == _T("fade_width")) || (strName == _T("fadewidth"))) {
-        GetAnimationManager().SetFadeWidth(strValue == _T("true"));
-    }
-    else if ((strName == _T("fade_height")) || (strName == _T("fadeheight"))) {
-        GetAnimationManager().SetFadeHeight(strValue == _T("true"));
-    }
-    else if ((strName == _T("fade_in_out_x_from_left")) || (strName == _T("fadeinoutxfromleft"))) {
-        GetAnimationManager().SetFadeInOutX(strValue == _T("true"), false);
-    }
-    else if ((strName == _T("fade_in_out_x_from_right")) || (strName == _T("fadeinoutxfromright"))) {
-        GetAnimationManager().SetFadeInOutX(strValue == _T("true"), true);
-    }
-    else if ((strName == _T("fade_in_out_y_from_top")) || (strName == _T("fadeinoutyfromtop"))) {
-        GetAnimationManager().SetFadeInOutY(strValue == _T("true"), false);
-    }
-    else if ((strName == _T("fade_in_out_y_from_bottom")) || (strName == _T("fadeinoutyfrombottom"))) {
-        GetAnimationManager().SetFadeInOutY(strValue == _T("true"), true);
-    }
-    else if ((strName == _T("tab_stop")) || (strName == _T("tabstop"))) {
-        SetTabStop(strValue == _T("true"));
-    }
-    else if ((strName == _T("loading_image")) || (strName == _T("loadingimage"))) {
-        SetLoadingImage(strValue);
-    }
-    else if ((strName == _T("loading_bkcolor")) || (strName == _T("loadingbkcolor"))) {
-        SetLoadingBkColor(strValue);
-    }
-    else if (strName == _T("show_focus_rect")) {
-        SetShowFocusRect(strValue == _T("true"));
-    }
-    else if (strName == _T("focus_rect_color")) {
-        SetFocusRectColor(strValue);
-    }
-    else if (strName == _T("paint_order")) {
-        uint8_t nPaintOrder = TruncateToUInt8(StringUtil::StringToInt32(strValue));
-        SetPaintOrder(nPaintOrder);
-    }
-    else if (strName == _T("start_gif_play")) {
-        int32_t nPlayCount = StringUtil::StringToInt32(strValue);
-        StartGifPlay(kGifFrameCurrent, nPlayCount);
-    }
-    else if (strName == _T("stop_gif_play")) {
-        GifFrameType nStopFrame = (GifFrameType)StringUtil::StringToInt32(strValue);
-        StopGifPlay(false, nStopFrame);
-    }
-    else {
+        break;
+    case ControlAttributeId::kMinHeight:
+        {
+            SetMinHeight(StringUtil::StringToInt32(strValue), true);
+        }
+        break;
+    case ControlAttributeId::kMaxHeight:
+        {
+            SetMaxHeight(StringUtil::StringToInt32(strValue), true);
+        }
+        break;
+    case ControlAttributeId::kName:
+        {
+            SetName(strValue);
+        }
+        break;
+    case ControlAttributeId::kTooltipText:
+        {
+            SetToolTipText(strValue);
+        }
+        break;
+    case ControlAttributeId::kTooltipTextId:
+        {
+            SetToolTipTextId(strValue);
+        }
+        break;
+    case ControlAttributeId::kTooltipWidth:
+        {
+            SetToolTipWidth(StringUtil::StringToInt32(strValue), true);
+        }
+        break;
+    case ControlAttributeId::kDataId:
+        {
+            SetDataID(strValue);
+        }
+        break;
+    case ControlAttributeId::kUserDataId:
+        {
+            SetUserDataID(StringUtil::StringToInt32(strValue));
+        }
+        break;
+    case ControlAttributeId::kEnabled:
+        {
+            SetEnabled(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kMouseEnabled:
+        {
+            SetMouseEnabled(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kKeyboardEnabled:
+        {
+            SetKeyboardEnabled(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kVisible:
+        {
+            SetVisible(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kFadeVisible:
+        {
+            SetFadeVisible(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kFloat:
+        {
+            SetFloat(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kCache:
+        {
+            SetUseCache(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kNoFocus:
+        {
+            SetNoFocus();
+        }
+        break;
+    case ControlAttributeId::kAlpha:
+        {
+            SetAlpha(StringUtil::StringToInt32(strValue));
+        }
+        break;
+    case ControlAttributeId::kNormalImage:
+        {
+            SetStateImage(kControlStateNormal, strValue);
+        }
+        break;
+    case ControlAttributeId::kHotImage:
+        {
+            SetStateImage(kControlStateHot, strValue);
+        }
+        break;
+    case ControlAttributeId::kPushedImage:
+        {
+            SetStateImage(kControlStatePushed, strValue);
+        }
+        break;
+    case ControlAttributeId::kDisabledImage:
+        {
+            SetStateImage(kControlStateDisabled, strValue);
+        }
+        break;
+    case ControlAttributeId::kForeNormalImage:
+        {
+            SetForeStateImage(kControlStateNormal, strValue);
+        }
+        break;
+    case ControlAttributeId::kForeHotImage:
+        {
+            SetForeStateImage(kControlStateHot, strValue);
+        }
+        break;
+    case ControlAttributeId::kForePushedImage:
+        {
+            SetForeStateImage(kControlStatePushed, strValue);
+        }
+        break;
+    case ControlAttributeId::kForeDisabledImage:
+        {
+            SetForeStateImage(kControlStateDisabled, strValue);
+        }
+        break;
+    case ControlAttributeId::kFadeAlpha:
+        {
+            GetAnimationManager().SetFadeAlpha(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kFadeHot:
+        {
+            GetAnimationManager().SetFadeHot(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kFadeWidth:
+        {
+            GetAnimationManager().SetFadeWidth(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kFadeHeight:
+        {
+            GetAnimationManager().SetFadeHeight(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kFadeInOutXFromLeft:
+        {
+            GetAnimationManager().SetFadeInOutX(strValue == _T("true"), false);
+        }
+        break;
+    case ControlAttributeId::kFadeInOutXFromRight:
+        {
+            GetAnimationManager().SetFadeInOutX(strValue == _T("true"), true);
+        }
+        break;
+    case ControlAttributeId::kFadeInOutYFromTop:
+        {
+            GetAnimationManager().SetFadeInOutY(strValue == _T("true"), false);
+        }
+        break;
+    case ControlAttributeId::kFadeInOutYFromBottom:
+        {
+            GetAnimationManager().SetFadeInOutY(strValue == _T("true"), true);
+        }
+        break;
+    case ControlAttributeId::kTabStop:
+        {
+            SetTabStop(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kLoadingImage:
+        {
+            SetLoadingImage(strValue);
+        }
+        break;
+    case ControlAttributeId::kLoadingBkcolor:
+        {
+            SetLoadingBkColor(strValue);
+        }
+        break;
+    case ControlAttributeId::kShowFocusRect:
+        {
+            SetShowFocusRect(strValue == _T("true"));
+        }
+        break;
+    case ControlAttributeId::kFocusRectColor:
+        {
+            SetFocusRectColor(strValue);
+        }
+        break;
+    case ControlAttributeId::kPaintOrder:
+        {
+            uint8_t nPaintOrder = TruncateToUInt8(StringUtil::StringToInt32(strValue));
+            SetPaintOrder(nPaintOrder);
+        }
+        break;
+    case ControlAttributeId::kStartGifPlay:
+        {
+            int32_t nPlayCount = StringUtil::StringToInt32(strValue);
+            StartGifPlay(kGifFrameCurrent, nPlayCount);
+        }
+        break;
+    case ControlAttributeId::kStopGifPlay:
+        {
+            GifFrameType nStopFrame = (GifFrameType)StringUtil::StringToInt32(strValue);
+            StopGifPlay(false, nStopFrame);
+        }
+        break;
+    default:
         ASSERT(!"Control::SetAttribute失败: 发现不能识别的属性");
+        break;
     }
 }
 
@@ -559,18 +932,29 @@ void Control::SetClass(const DString& strClass)
     if (strClass.empty()) {
         return;
     }
+    if (strClass.find(_T(' ')) == DString::npos) {
+        //只有一个class名称（常见情况），无需拆分
+        ApplyClass(strClass);
+        return;
+    }
     std::list<DString> splitList = StringUtil::Split(strClass, _T(" "));
     for (auto it = splitList.begin(); it != splitList.end(); it++) {
-        DString pDefaultAttributes = GlobalManager::Instance().GetClassAttributes((*it));
-        Window* pWindow = GetWindow();
-        if (pDefaultAttributes.empty() && (pWindow != nullptr)) {
-            pDefaultAttributes = pWindow->GetClassAttributes(*it);
-        }
+        ApplyClass(*it);
+    }
+}
 
-        ASSERT(!pDefaultAttributes.empty());
-        if (!pDefaultAttributes.empty()) {
-            ApplyAttributeList(pDefaultAttributes);
-        }
+void Control::ApplyClass(const DString& strClassName)
+{
+    //使用添加class时已经解析好的属性列表，避免每个控件都重新解析
+    std::shared_ptr<const AttributeList> spAttributeList = GlobalManager::Instance().GetClassAttributeList(strClassName);
+    Window* pWindow = GetWindow();
+    if ((spAttributeList == nullptr) && (pWindow != nullptr)) {
+        spAttributeList = pWindow->GetClassAttributeList(strClassName);
+    }
+
+    ASSERT(spAttributeList != nullptr);
+    if (spAttributeList != nullptr) {
+        ApplyAttributeList(*spAttributeList);
     }
 }
 
@@ -580,13 +964,13 @@ void Control::ApplyAttributeList(const DString& strList)
     if (strList.empty()) {
         return;
     }
-    std::vector<std::pair<DString, DString>> attributeList;
-    if (strList.find(_T('\"')) != DString::npos) {
-        AttributeUtil::ParseAttributeList(strList, _T('\"'), attributeList);
-    }    
-    else if (strList.find(_T('\'')) != DString::npos) {
-        AttributeUtil::ParseAttributeList(strList, _T('\''), attributeList);
-    }
+    AttributeList attributeList;
+    AttributeUtil::ParseAttributeList(strList, attributeList);
+    ApplyAttributeList(attributeList);
+}
+
+void Control::ApplyAttributeList(const AttributeList& attributeList)
+{
     for (const auto& attribute : attributeList) {
         SetAttribute(attribute.first, attribute.second);
     }
@@ -2258,10 +2642,44 @@ IRender* Control::GetRender()
 void Control::ClearRender()
 {
     if (m_render) {
+        Window* pWindow = GetWindow();
+        if (pWindow != nullptr) {
+            //放回窗口的复用池
+            pWindow->GetRenderSurfacePool().ReleaseRender(m_render);
+        }
         m_render.reset();
     }
 }
 
+IRender* Control::GetCacheRender(const UiSize& size, bool& bRenderChanged)
+{
+    bRenderChanged = false;
+    Window* pWindow = GetWindow();
+    if (pWindow == nullptr) {
+        //未关联窗口，不使用复用池
+        IRender* pRender = GetRender();
+        if ((pRender != nullptr) &&
+            ((size.cx != pRender->GetWidth()) || (size.cy != pRender->GetHeight()))) {
+            bRenderChanged = true;
+            if (!pRender->Resize(size.cx, size.cy)) {
+                return nullptr;
+            }
+        }
+        return pRender;
+    }
+    //复用池中的画布大小是对齐后的大小，只要对齐后的大小一致即可继续使用
+    if ((m_render != nullptr) &&
+        ((m_render->GetWidth() != RenderSurfacePool::AlignSize(size.cx)) ||
+         (m_render->GetHeight() != RenderSurfacePool::AlignSize(size.cy)))) {
+        ClearRender();
+    }
+    if (m_render == nullptr) {
+        m_render = pWindow->GetRenderSurfacePool().AcquireRender(size.cx, size.cy, pWindow->GetRenderDpi());
+        bRenderChanged = true;
+    }
+    return m_render.get();
+}
+
 void Control::AlphaPaint(IRender* pRender, const UiRect& rcPaint)
 {
     ASSERT(pRender != nullptr);
@@ -2296,19 +2714,19 @@ void Control::AlphaPaint(IRender* pRender, const UiRect& rcPaint)
             rcUnionRect = GetRect();
         }
         UiSize size{GetRect().Width(), GetRect().Height() };
-        IRender* pCacheRender = GetRender();
-        ASSERT(pCacheRender != nullptr);
-        if (pCacheRender == nullptr) {
+        if ((size.cx <= 0) || (size.cy <= 0)) {
             return;
         }
-        bool isSizeChanged = (size.cx != pCacheRender->GetWidth()) || (size.cy != pCacheRender->GetHeight());
-        if (!pCacheRender->Resize(size.cx, size.cy)) {
+        //画布从窗口的复用池中获取，大小可能大于控件的大小
+        bool isRenderChanged = false;
+        IRender* pCacheRender = GetCacheRender(size, isRenderChanged);
+        ASSERT(pCacheRender != nullptr);
+        if (pCacheRender == nullptr) {
             //存在错误，绘制失败
-            ASSERT(!"pCacheRender->Resize failed!");
             return;
         }
-        if (isSizeChanged) {
-            //Render画布大小发生变化，需要设置缓存脏标记
+        if (isRenderChanged) {
+            //Render画布发生变化，需要设置缓存脏标记
             SetCacheDirty(true);
         }            
         if (IsCacheDirty()) {
@@ -2360,8 +2778,9 @@ void Control::AlphaPaint(IRender* pRender, const UiRect& rcPaint)
             PaintChild(pRender, rcUnionRect);
         }
         if (isAlpha) {
+            //透明度绘制的画布，放回复用池，供下次绘制使用
             SetCacheDirty(true);
-            m_render.reset();
+            ClearRender();
         }
     }
     else {
@@ -2443,7 +2862,7 @@ void Control::PaintBkColor(IRender* pRender)
         return;
     }
 
-    UiColor dwBackColor = GetUiColor(m_strBkColor.c_str());
+    UiColor dwBackColor = GetUiColor(m_strBkColor, m_bkColorHandle);
     if(dwBackColor.GetARGB() != 0) {
         int32_t nBorderSize = 0;
         if ((m_rcBorderSize.left > 0) &&
@@ -2469,7 +2888,7 @@ void Control::PaintBkColor(IRender* pRender)
         else {            
             UiColor dwBackColor2;
             if (!m_strBkColor2.empty()) {
-                dwBackColor2 = GetUiColor(m_strBkColor2.c_str());
+                dwBackColor2 = GetUiColor(m_strBkColor2, m_bkColor2Handle);
             }
             if (!dwBackColor2.IsEmpty()) {
                 //渐变背景色
@@ -2503,7 +2922,7 @@ void Control::PaintBorder(IRender* pRender)
         borderColor = GetBorderColor(GetState());
     }
     if (!borderColor.empty()) {
-        dwBorderColor = GetUiColor(borderColor);
+        dwBorderColor = GetUiColor(borderColor, m_borderColorHandle);
     }
     if (dwBorderColor.GetARGB() == 0) {
         return;
@@ -2798,7 +3217,7 @@ void Control::FillRoundRect(IRender* pRender, const UiRect& rc, const UiSize& ro
                 AddRoundRectPath(path.get(), rc, roundSize);
                 UiColor dwBackColor2;
                 if (!m_strBkColor2.empty()) {
-                    dwBackColor2 = GetUiColor(m_strBkColor2.c_str());
+                    dwBackColor2 = GetUiColor(m_strBkColor2, m_bkColor2Handle);
                 }
                 if (!dwBackColor2.IsEmpty()) {
                     //渐变背景色
@@ -2815,7 +3234,7 @@ void Control::FillRoundRect(IRender* pRender, const UiRect& rc, const UiSize& ro
     if (!isDrawOk) {
         UiColor dwBackColor2;
         if (!m_strBkColor2.empty()) {
-            dwBackColor2 = GetUiColor(m_strBkColor2.c_str());
+            dwBackColor2 = GetUiColor(m_strBkColor2, m_bkColor2Handle);
         }
         if (!dwBackColor2.IsEmpty()) {
             //渐变背景色
@@ -2999,7 +3418,9 @@ bool Control::LoadImageData(Image& duiImage) const
     if ((imageCache == nullptr) || 
         (imageCache->GetLoadKey() != imageLoadAttr.GetCacheKey(Dpi().GetScale()))) {
         //如果图片没有加载则执行加载图片；如果图片发生变化，则重新加载该图片
-        imageCache = GlobalManager::Instance().Image().GetImage(GetWindow(), imageLoadAttr);
+        //（开启异步加载时，图片解码完成前返回nullptr，解码完成后会通知本控件重绘）
+        Control* pAsyncControl = const_cast<Control*>(this);
+        imageCache = GlobalManager::Instance().Image().GetImage(GetWindow(), imageLoadAttr, pAsyncControl);
         duiImage.SetImageCache(imageCache);
     }
     return imageCache ? true : false;
@@ -3203,6 +3624,31 @@ UiColor Control::GetUiColor(const DString& colorName) const
     return color;
 }
 
+UiColor Control::GetUiColor(const UiString& colorName, ColorHandle& colorHandle) const
+{
+    if (colorName.empty()) {
+        return UiColor();
+    }
+    const Window* pWindow = GetWindow();
+    if (!colorHandle.IsResolved(colorName, pWindow)) {
+        DString strColorName = colorName.c_str();
+        colorHandle.SetColor(strColorName, GetUiColor(strColorName), pWindow);
+    }
+    return colorHandle.GetColor();
+}
+
+UiColor Control::GetUiColor(const DString& colorName, ColorHandle& colorHandle) const
+{
+    if (colorName.empty()) {
+        return UiColor();
+    }
+    const Window* pWindow = GetWindow();
+    if (!colorHandle.IsResolved(colorName, pWindow)) {
+        colorHandle.SetColor(colorName, GetUiColor(colorName), pWindow);
+    }
+    return colorHandle.GetColor();
+}
+
 UiColor Control::GetUiColorByName(const DString& colorName) const
 {
     UiColor color;
@@ -3329,6 +3775,9 @@ bool Control::ClientToScreen(UiPoint& pt)
 
 void Control::SetPaintOrder(uint8_t nPaintOrder)
 {
+    if ((m_nPaintOrder != nPaintOrder) && (GetParent() != nullptr)) {
+        GetParent()->SetChildIndexDirty();
+    }
     m_nPaintOrder = nPaintOrder;
 }
 
@@ -3342,4 +3791,15 @@ IFont* Control::GetIFontById(const DString& strFontId) const
     return GlobalManager::Instance().Font().GetIFont(strFontId, this->Dpi());
 }
 
+IFont* Control::GetIFontById(const UiString& strFontId, FontHandle& fontHandle) const
+{
+    const DpiManager& dpi = this->Dpi();
+    if (!fontHandle.IsResolved(strFontId, dpi)) {
+        FontManager& fontManager = GlobalManager::Instance().Font();
+        IFont* pFont = fontManager.GetIFont(fontManager.GetFontIndex(strFontId.c_str()), dpi);
+        fontHandle.SetFont(strFontId, pFont, dpi);
+    }
+    return fontHandle.GetFont();
+}
+
 } // namespace ui
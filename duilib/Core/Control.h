@@ -3,6 +3,9 @@
 
 #include "duilib/Core/PlaceHolder.h"
 #include "duilib/Core/BoxShadow.h"
+#include "duilib/Core/ColorManager.h"
+#include "duilib/Core/FontManager.h"
+#include "duilib/Utils/AttributeUtil.h"
 #include "duilib/Utils/Delegate.h"
 #include "duilib/Core/Keyboard.h"
 #include <map>
@@ -589,6 +592,13 @@ public:
      */
     void ApplyAttributeList(const DString& strList);
 
+    /**
+     * @brief 应用一套已经解析好的属性列表
+     * @param[in] attributeList 属性列表（属性名称与属性值）
+     * @return 无
+     */
+    void ApplyAttributeList(const AttributeList& attributeList);
+
     /**
      * @brief 待补充
      * @param[in] 待补充
@@ -623,7 +633,7 @@ public:
     IRender* GetRender();
 
     /**
-    * @brief 清理绘制上下文对象
+    * @brief 清理绘制上下文对象（如果关联了窗口，放回窗口的离屏绘制引擎复用池）
     * @return 无
     */
     void ClearRender();
@@ -894,6 +904,14 @@ public:
     */
     UiColor GetUiColor(const DString& colorName) const;
 
+    /** 获取某个颜色对应的值，并通过颜色句柄缓存解析结果（绘制时使用，颜色表未变化时，无需按名称查找颜色）
+    * @param [in] colorName 颜色的名称，有效的颜色名称参见GetUiColor(const DString&)函数的说明
+    * @param [in,out] colorHandle 颜色句柄，保存上次的解析结果
+    * @return ARGB颜色值
+    */
+    UiColor GetUiColor(const UiString& colorName, ColorHandle& colorHandle) const;
+    UiColor GetUiColor(const DString& colorName, ColorHandle& colorHandle) const;
+
     /** 获取颜色值对应的字符串, 返回该颜色对应的字符串
     * @param [in] color 颜色值
     * @return 返回颜色值对应的字符串，比如"#FF123456"
@@ -1188,12 +1206,24 @@ public:
     */
     IFont* GetIFontById(const DString& strFontId) const;
 
+    /** 获取一个字体ID对应的字体数据接口，并通过字体句柄缓存解析结果（绘制和估算文本大小时使用）
+    * @param[in] strFontId 要设置的字体ID，该字体ID必须在 global.xml 中存在
+    * @param[in,out] fontHandle 字体句柄，保存上次的解析结果
+    * @return 成功返回字体接口，外部调用不需要释放资源；如果失败则返回nullptr
+    */
+    IFont* GetIFontById(const UiString& strFontId, FontHandle& fontHandle) const;
+
 private:
 
     /** 获取颜色名称对应的颜色值
     */
     UiColor GetUiColorByName(const DString& colorName) const;
 
+    /** 应用一个class的属性列表
+    * @param[in] strClassName class名称
+    */
+    void ApplyClass(const DString& strClassName);
+
     /** 是否含有BoxShadow
     */
     bool HasBoxShadow() const;
@@ -1207,6 +1237,12 @@ private:
     */
     int8_t GetColor2Direction(const UiString& bkColor2Direction) const;
 
+    /** 获取透明度绘制或者绘制缓存使用的离屏绘制引擎（优先从窗口的复用池中获取）
+    * @param [in] size 需要的画布大小
+    * @param [out] bRenderChanged 返回画布是否发生变化（发生变化时需要重新绘制缓存内容）
+    */
+    IRender* GetCacheRender(const UiSize& size, bool& bRenderChanged);
+
 private:
     /** 边框圆角大小(与m_rcBorderSize联合应用)或者阴影的圆角大小(与m_boxShadow联合应用)
         仅当 m_rcBorderSize 四个边框值都有效, 并且都相同时
@@ -1237,6 +1273,11 @@ private:
     //控件的第二背景色方向：："1": 左->右，"2": 上->下，"3": 左上->右下，"4": 右上->左下
     UiString m_strBkColor2Direction;
 
+    //背景颜色、第二背景色、边框颜色的颜色句柄（缓存解析后的颜色值）
+    mutable ColorHandle m_bkColorHandle;
+    mutable ColorHandle m_bkColor2Handle;
+    mutable ColorHandle m_borderColorHandle;
+
     //控件的背景图片
     std::shared_ptr<Image> m_pBkImage;
 
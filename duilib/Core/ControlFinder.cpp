@@ -29,8 +29,9 @@ Control* ControlFinder::FindControl(const UiPoint& pt) const
 {
     ASSERT(m_pRoot != nullptr);
     if (m_pRoot != nullptr) {
+        //从根节点开始查找时，FindControl函数已经按坐标做过命中测试，无需在回调函数中再次计算
         UiPoint ptLocal = pt;
-        return m_pRoot->FindControl(__FindControlFromPoint, &ptLocal, UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_TOP_FIRST, pt);
+        return m_pRoot->FindControl(__FindControlFromPointHitTest, &ptLocal, UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_TOP_FIRST, pt);
     }
     return nullptr;
 }
@@ -145,6 +146,15 @@ Control* CALLBACK ControlFinder::__FindControlFromPoint(Control* pThis, void* pD
     return rect.ContainsPt(pt) ? pThis : nullptr;
 }
 
+Control* CALLBACK ControlFinder::__FindControlFromPointHitTest(Control* pThis, void* pData)
+{
+    //只用于UIFIND_HITTEST方式的查找：调用前，控件的区域已经确认包含该坐标（已适配滚动条的偏移）
+    if ((pData == nullptr) || (pThis == nullptr)) {
+        return nullptr;
+    }
+    return pThis;
+}
+
 Control* CALLBACK ControlFinder::__FindControlFromTab(Control* pThis, void* pData)
 {
     if (pThis == nullptr) {
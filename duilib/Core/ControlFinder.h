@@ -103,6 +103,7 @@ public:
 
 public:
     static Control* CALLBACK __FindControlFromPoint(Control* pThis, void* pData);
+    static Control* CALLBACK __FindControlFromPointHitTest(Control* pThis, void* pData);
     static Control* CALLBACK __FindControlFromTab(Control* pThis, void* pData);
     static Control* CALLBACK __FindControlFromUpdate(Control* pThis, void* pData);
     static Control* CALLBACK __FindControlFromName(Control* pThis, void* pData);
@@ -6,6 +6,10 @@
 #include "duilib/Render/IRender.h"
 namespace ui 
 {
+//加载中图片每次旋转的角度，以及旋转的时间间隔（毫秒）
+static const int32_t kLoadingAngleStep = 10;
+static const int64_t kLoadingElapsed = 50;
+
 ControlLoading::ControlLoading(Control* pControl):
     m_bIsLoading(false),
     m_fCurrrentAngele(0),
@@ -115,10 +119,13 @@ void ControlLoading::Loading()
     if (!m_bIsLoading) {
         return;
     }
-    m_fCurrrentAngele += 10;
-    if (m_fCurrrentAngele == INT32_MIN) {
-        m_fCurrrentAngele = 0;
+    const std::chrono::steady_clock::time_point frameTime = GlobalManager::Instance().Clock().GetFrameTime();
+    int64_t nSteps = std::chrono::duration_cast<std::chrono::milliseconds>(frameTime - m_loadingTime).count() / kLoadingElapsed;
+    if (nSteps <= 0) {
+        return;
     }
+    m_loadingTime += std::chrono::milliseconds(nSteps * kLoadingElapsed);
+    m_fCurrrentAngele = (int32_t)((m_fCurrrentAngele + nSteps * kLoadingAngleStep) % 360);
     if (m_pControl != nullptr) {
         m_pControl->Invalidate();
     }    
@@ -133,9 +140,9 @@ bool ControlLoading::StartLoading(int32_t fStartAngle)
         return false;
     }
     m_bIsLoading = true;
-    GlobalManager::Instance().Timer().AddTimer(m_loadingImageFlag.GetWeakFlag(), 
-                                                         UiBind(&ControlLoading::Loading, this),
-                                                         50);
+    m_loadingTime = std::chrono::steady_clock::now();
+    GlobalManager::Instance().Clock().AddFrameCallback(m_loadingImageFlag.GetWeakFlag(),
+                                                       UiBind(&ControlLoading::Loading, this));
     return true;
 }
 
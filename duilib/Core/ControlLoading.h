@@ -4,6 +4,7 @@
 #include "duilib/Core/UiTypes.h"
 #include "duilib/Core/Callback.h"
 #include <memory>
+#include <chrono>
 
 namespace ui 
 {
@@ -64,6 +65,9 @@ private:
     //加载中图片旋转的角度（0-360）
     int32_t m_fCurrrentAngele;
 
+    //上次旋转图片的时间（由帧时钟驱动）
+    std::chrono::steady_clock::time_point m_loadingTime;
+
     //加载中状态时显示的图片
     std::unique_ptr<Image> m_pLoadingImage;
 
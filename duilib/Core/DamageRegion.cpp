@@ -0,0 +1,131 @@
+#include "DamageRegion.h"
+
+namespace ui
+{
+
+//默认最多记录的矩形个数
+static const size_t kDefaultMaxRectCount = 8;
+
+DamageRegion::DamageRegion():
+    m_nMaxRectCount(kDefaultMaxRectCount)
+{
+}
+
+int64_t DamageRegion::GetRectArea(const UiRect& rc)
+{
+    if (rc.IsEmpty()) {
+        return 0;
+    }
+    return (int64_t)rc.Width() * rc.Height();
+}
+
+int64_t DamageRegion::GetMergeWaste(const UiRect& rc1, const UiRect& rc2)
+{
+    UiRect rcUnion = rc1;
+    rcUnion.Union(rc2);
+    return GetRectArea(rcUnion) - GetRectArea(rc1) - GetRectArea(rc2);
+}
+
+void DamageRegion::AddRect(const UiRect& rc)
+{
+    if (rc.IsEmpty() || (m_nMaxRectCount == 0)) {
+        return;
+    }
+    MergeRect(rc);
+    Trim();
+}
+
+void DamageRegion::MergeRect(const UiRect& rc)
+{
+    UiRect rcNew = rc;
+    UiRect rcIntersect;
+    bool bMerged = true;
+    while (bMerged) {
+        bMerged = false;
+        for (size_t nIndex = 0; nIndex < m_rects.size(); ++nIndex) {
+            const UiRect& rcOld = m_rects[nIndex];
+            if (rcOld.ContainsRect(rcNew)) {
+                //已经包含在失效区域中
+                return;
+            }
+            const int64_t nWaste = GetMergeWaste(rcOld, rcNew);
+            if (rcNew.ContainsRect(rcOld) ||
+                UiRect::Intersect(rcIntersect, rcOld, rcNew) ||
+                (nWaste * 4 <= GetRectArea(rcOld) + GetRectArea(rcNew))) {
+                //合并后，再与其他矩形检查是否可以合并
+                rcNew.Union(rcOld);
+                m_rects.erase(m_rects.begin() + nIndex);
+                bMerged = true;
+                break;
+            }
+        }
+    }
+    m_rects.push_back(rcNew);
+}
+
+void DamageRegion::Trim()
+{
+    if (m_nMaxRectCount == 0) {
+        m_rects.clear();
+        return;
+    }
+    while (m_rects.size() > m_nMaxRectCount) {
+        size_t nFirst = 0;
+        size_t nSecond = 1;
+        int64_t nMinWaste = GetMergeWaste(m_rects[0], m_rects[1]);
+        for (size_t i = 0; i < m_rects.size(); ++i) {
+            for (size_t j = i + 1; j < m_rects.size(); ++j) {
+                int64_t nWaste = GetMergeWaste(m_rects[i], m_rects[j]);
+                if (nWaste < nMinWaste) {
+                    nMinWaste = nWaste;
+                    nFirst = i;
+                    nSecond = j;
+                }
+            }
+        }
+        //合并后的外接矩形可能与其他矩形重叠，重新按规则合并
+        UiRect rcUnion = m_rects[nFirst];
+        rcUnion.Union(m_rects[nSecond]);
+        m_rects.erase(m_rects.begin() + nSecond);
+        m_rects.erase(m_rects.begin() + nFirst);
+        MergeRect(rcUnion);
+    }
+}
+
+void DamageRegion::Clear()
+{
+    m_rects.clear();
+}
+
+UiRect DamageRegion::GetBounds() const
+{
+    UiRect rcBounds;
+    for (size_t nIndex = 0; nIndex < m_rects.size(); ++nIndex) {
+        if (nIndex == 0) {
+            rcBounds = m_rects[nIndex];
+        }
+        else {
+            rcBounds.Union(m_rects[nIndex]);
+        }
+    }
+    return rcBounds;
+}
+
+void DamageRegion::GetIntersectRects(const UiRect& rcPaint, std::vector<UiRect>& rects) const
+{
+    rects.clear();
+    UiRect rcIntersect;
+    for (const UiRect& rc : m_rects) {
+        if (UiRect::Intersect(rcIntersect, rc, rcPaint)) {
+            rects.push_back(rcIntersect);
+        }
+    }
+}
+
+void DamageRegion::SetMaxRectCount(size_t nMaxRectCount)
+{
+    m_nMaxRectCount = nMaxRectCount;
+    Trim();
+}
+
+} // namespace ui
@@ -0,0 +1,86 @@
+#ifndef UI_CORE_DAMAGE_REGION_H_
+#define UI_CORE_DAMAGE_REGION_H_
+
+#include "duilib/Core/UiRect.h"
+#include <vector>
+
+namespace ui
+{
+/** 窗口的失效区域：记录两次绘制之间所有需要重绘的矩形区域
+*   区域由有限个矩形组成，添加矩形时，按以下规则合并：
+*   (1) 被已有矩形包含的，忽略；包含已有矩形的，替换已有矩形
+*   (2) 与已有矩形有重叠的，合并为外接矩形，保证各个矩形之间互不重叠（重叠部分不会重复绘制）
+*   (3) 与已有矩形合并后，外接矩形中多出的面积不超过两者面积之和的1/4的，合并为外接矩形
+*   (4) 矩形个数超过上限时，合并多出面积最小的两个矩形（合并后的矩形再按以上规则与其他矩形合并）
+*   注意：只能在UI线程中使用
+*/
+class UILIB_API DamageRegion
+{
+public:
+    DamageRegion();
+
+public:
+    /** 添加一个失效的矩形区域
+    */
+    void AddRect(const UiRect& rc);
+
+    /** 是否为空
+    */
+    bool IsEmpty() const { return m_rects.empty(); }
+
+    /** 清空失效区域
+    */
+    void Clear();
+
+    /** 获取失效区域的矩形列表
+    */
+    const std::vector<UiRect>& GetRects() const { return m_rects; }
+
+    /** 获取失效区域的外接矩形
+    */
+    UiRect GetBounds() const;
+
+    /** 获取失效区域与指定区域的交集
+    * @param [in] rcPaint 指定区域
+    * @param [out] rects 交集的矩形列表（各个矩形之间互不重叠）
+    */
+    void GetIntersectRects(const UiRect& rcPaint, std::vector<UiRect>& rects) const;
+
+    /** 设置最多记录的矩形个数，如果为0表示不记录失效区域
+    */
+    void SetMaxRectCount(size_t nMaxRectCount);
+
+    /** 获取最多记录的矩形个数
+    */
+    size_t GetMaxRectCount() const { return m_nMaxRectCount; }
+
+    /** 计算矩形的面积
+    */
+    static int64_t GetRectArea(const UiRect& rc);
+
+private:
+    /** 计算两个矩形合并为外接矩形后，多出的面积（外接矩形面积 - 两个矩形的面积之和）
+    */
+    static int64_t GetMergeWaste(const UiRect& rc1, const UiRect& rc2);
+
+    /** 将矩形与已有矩形合并（包含、重叠或者多出的面积较小时），直到与其他矩形都不能合并，然后添加到列表中
+    */
+    void MergeRect(const UiRect& rc);
+
+    /** 合并多出面积最小的两个矩形，直到矩形个数不超过上限
+    */
+    void Trim();
+
+private:
+    /** 失效区域的矩形列表
+    */
+    std::vector<UiRect> m_rects;
+
+    /** 最多记录的矩形个数
+    */
+    size_t m_nMaxRectCount;
+};
+
+} // namespace ui
+
+#endif // UI_CORE_DAMAGE_REGION_H_
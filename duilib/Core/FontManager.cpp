@@ -9,6 +9,8 @@ namespace ui
 {
 
 FontManager::FontManager():
+    m_nDefaultFontIndex(-1),
+    m_nFontEpoch(1),
     m_bDefaultFontInited(false)
 {
 }
@@ -31,19 +33,26 @@ bool FontManager::AddFont(const DString& fontId, const UiFont& fontInfo, bool bD
         return false;
     }
 
-    auto iter = m_fontIdMap.find(fontId);
-    ASSERT(iter == m_fontIdMap.end());
-    if (iter != m_fontIdMap.end()) {
+    auto iter = m_fontIndexMap.find(fontId);
+    ASSERT(iter == m_fontIndexMap.end());
+    if (iter != m_fontIndexMap.end()) {
         //避免相同的字体ID重复添加
         return false;
     }
 
     //保存字体信息，但不创建字体数据
-    m_fontIdMap[fontId] = fontInfo;
+    const int32_t nFontIndex = (int32_t)m_fontList.size();
+    FontData fontData;
+    fontData.m_fontInfo = fontInfo;
+    m_fontList.push_back(std::move(fontData));
+    m_fontIndexMap[fontId] = nFontIndex;
     if (bDefault) {
         //默认字体ID
         m_defaultFontId = fontId;
+        m_nDefaultFontIndex = nFontIndex;
     }
+    //未定义的字体ID可能已经按默认字体解析，需要重新解析
+    ++m_nFontEpoch;
     return true;
 }
 
@@ -67,64 +76,55 @@ void FontManager::SetDefaultFontFamilyNames(const DString& defaultFontFamilyName
     }
 }
 
-DString FontManager::GetDpiFontId(const DString& fontId, const DpiManager& dpi) const
+IFont* FontManager::GetIFont(const DString& fontId, const DpiManager& dpi)
+{
+    return GetIFont(GetFontIndex(fontId), dpi);
+}
+
+int32_t FontManager::GetFontIndex(const DString& fontId) const
 {
-    DString dpiFontId;
     if (!fontId.empty()) {
-        dpiFontId = fontId + _T("@") + StringUtil::UInt32ToString(dpi.GetScale());
+        auto iter = m_fontIndexMap.find(fontId);
+        if (iter != m_fontIndexMap.end()) {
+            return iter->second;
+        }
     }
-    return dpiFontId;
+    //没有这个字体ID，使用默认的字体ID
+    return m_nDefaultFontIndex;
 }
 
-IFont* FontManager::GetIFont(const DString& fontId, const DpiManager& dpi)
+uint32_t FontManager::GetFontEpoch() const
 {
-    //先在缓存中查找
-    IFont* pFont = nullptr;
-    if (!fontId.empty()) {        
-        DString dpiFontId = GetDpiFontId(fontId, dpi);
-        auto iter = m_fontMap.find(dpiFontId);
-        if (iter != m_fontMap.end()) {
-            pFont = iter->second;
-        }
+    return m_nFontEpoch;
+}
+
+IFont* FontManager::GetIFont(int32_t nFontIndex, const DpiManager& dpi)
+{
+    ASSERT((nFontIndex >= 0) && (nFontIndex < (int32_t)m_fontList.size()));
+    if ((nFontIndex < 0) || (nFontIndex >= (int32_t)m_fontList.size())) {
+        //无此字体ID
+        return nullptr;
     }
-    if (pFont == nullptr) {
-        auto iter = m_fontIdMap.find(fontId);
-        if ((iter == m_fontIdMap.end()) && !m_defaultFontId.empty()) {
-            //没有这个字体ID，使用默认的字体ID
-            DString dpiFontId = GetDpiFontId(m_defaultFontId, dpi);
-            auto pos = m_fontMap.find(dpiFontId);
-            if (pos != m_fontMap.end()) {
-                pFont = pos->second;
-            }
+    //先在缓存中查找
+    FontData& fontData = m_fontList[nFontIndex];
+    const uint32_t nDpiScale = dpi.GetScale();
+    for (const auto& dpiFont : fontData.m_dpiFonts) {
+        if (dpiFont.first == nDpiScale) {
+            //使用缓存中已经创建好的字体数据
+            return dpiFont.second;
         }
     }
-    if (pFont != nullptr) {
-        //使用缓存中已经创建好的字体数据
-        return pFont;
-    }
 
     //缓存中不存在，需要创建字体
-    UiFont fontInfo;
-    DString realFontId = fontId;
-    auto iter = m_fontIdMap.find(realFontId);
-    if (iter == m_fontIdMap.end()) {
-        realFontId = m_defaultFontId;
-        iter = m_fontIdMap.find(realFontId);
-        if (iter != m_fontIdMap.end()) {
-            fontInfo = iter->second;
-        }
-        else {
-            realFontId.clear();
-        }
-    }
-    else {
-        fontInfo = iter->second;
-    }
-    ASSERT(!realFontId.empty());
-    if (realFontId.empty()) {
-        //无此字体ID
-        return nullptr;
+    IFont* pFont = CreateIFont(fontData.m_fontInfo, dpi);
+    if (pFont != nullptr) {
+        fontData.m_dpiFonts.push_back(std::make_pair(nDpiScale, pFont));
     }
+    return pFont;
+}
+
+IFont* FontManager::CreateIFont(UiFont fontInfo, const DpiManager& dpi)
+{
     IRenderFactory* pRenderFactory = GlobalManager::Instance().GetRenderFactory();
     ASSERT(pRenderFactory != nullptr);
     if (pRenderFactory == nullptr) {
@@ -151,7 +151,6 @@ IFont* FontManager::GetIFont(const DString& fontId, const DpiManager& dpi)
         }
     }
 
-    DString dpiFontId = GetDpiFontId(realFontId, dpi);    
     if (fontInfo.m_fontName.empty() || 
         StringUtil::IsEqualNoCase(fontInfo.m_fontName, _T("system"))) {        
         if (!m_defaultFontFamilyNames.empty()) {
@@ -167,7 +166,7 @@ IFont* FontManager::GetIFont(const DString& fontId, const DpiManager& dpi)
     dpi.ScaleInt(fontInfo.m_fontSize);
     ASSERT(fontInfo.m_fontSize > 0);
 
-    pFont = pRenderFactory->CreateIFont();
+    IFont* pFont = pRenderFactory->CreateIFont();
     ASSERT(pFont != nullptr);
     if (pFont == nullptr) {
         return nullptr;
@@ -179,21 +178,25 @@ IFont* FontManager::GetIFont(const DString& fontId, const DpiManager& dpi)
         pFont = nullptr;
         return nullptr;
     }
-    m_fontMap.insert(std::make_pair(dpiFontId, pFont));
     return pFont;
 }
 
 void FontManager::RemoveAllFonts()
 {
-    for (auto fontInfo : m_fontMap) {
-        IFont* pFont = fontInfo.second;
-        if (pFont != nullptr) {
-            delete pFont;
+    for (const FontData& fontData : m_fontList) {
+        for (const auto& dpiFont : fontData.m_dpiFonts) {
+            IFont* pFont = dpiFont.second;
+            if (pFont != nullptr) {
+                delete pFont;
+            }
         }
     }
-    m_fontMap.clear();
+    m_fontList.clear();
+    m_fontIndexMap.clear();
     m_defaultFontId.clear();
-    m_fontIdMap.clear();
+    m_nDefaultFontIndex = -1;
+    //字体接口已经释放，之前解析的字体句柄均失效
+    ++m_nFontEpoch;
 }
 
 bool FontManager::AddFontFile(const DString& strFontFile, const DString& /*strFontDesc*/)
@@ -315,4 +318,35 @@ void FontManager::GetFontSizeList(const DpiManager& dpi, std::vector<FontSizeInf
     }
 }
 
+FontHandle::FontHandle():
+    m_pFont(nullptr),
+    m_nDpiScale(0),
+    m_nFontEpoch(0)
+{
+}
+
+bool FontHandle::IsResolved(const UiString& fontId, const DpiManager& dpi) const
+{
+    return (m_nFontEpoch != 0) &&
+           (m_nFontEpoch == GlobalManager::Instance().Font().GetFontEpoch()) &&
+           (m_nDpiScale == dpi.GetScale()) &&
+           (m_fontId == fontId);
+}
+
+void FontHandle::SetFont(const UiString& fontId, IFont* pFont, const DpiManager& dpi)
+{
+    m_fontId = fontId;
+    m_pFont = pFont;
+    m_nDpiScale = dpi.GetScale();
+    m_nFontEpoch = GlobalManager::Instance().Font().GetFontEpoch();
+}
+
+void FontHandle::Reset()
+{
+    m_fontId.clear();
+    m_pFont = nullptr;
+    m_nDpiScale = 0;
+    m_nFontEpoch = 0;
+}
+
 }
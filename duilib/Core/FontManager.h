@@ -2,6 +2,7 @@
 #define UI_CORE_FONTMANAGER_H_
 
 #include "duilib/Core/UiFont.h"
+#include "duilib/Core/UiString.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -45,6 +46,24 @@ public:
     */
     IFont* GetIFont(const DString& fontId, const DpiManager& dpi);
 
+    /** 获取字体ID对应的字体索引号, 如果找不到该字体ID，那么返回默认字体的索引号
+    * @param [in] fontId 字体ID
+    * @return 字体索引号，如果失败则返回-1（索引号在字体列表变化前有效，参见GetFontEpoch函数）
+    */
+    int32_t GetFontIndex(const DString& fontId) const;
+
+    /** 按字体索引号获取字体接口
+    * @param [in] nFontIndex 字体索引号，由GetFontIndex函数返回
+    * @param [in] dpi DPI缩放管理器，用于对字体大小进行缩放
+    * @return 成功返回字体接口，外部调用不需要释放资源；如果失败则返回nullptr
+    */
+    IFont* GetIFont(int32_t nFontIndex, const DpiManager& dpi);
+
+    /** 获取字体列表的版本号，添加字体或者删除所有字体（重新加载资源等）时，版本号递增
+    *   版本号变化后，之前获取的字体索引号和字体接口不再有效
+    */
+    uint32_t GetFontEpoch() const;
+
     /** 删除所有字体, 不包含已经加载的字体文件
      */
     void RemoveAllFonts();
@@ -84,23 +103,44 @@ public:
     void GetFontSizeList(const DpiManager& dpi, std::vector<FontSizeInfo>& fontSizeList) const;
 
 private:
-    /** 获取DPI缩放后实际的字体ID
+    /** 创建字体接口
+    * @param [in] fontInfo 字体属性信息，字体大小未经DPI处理
+    * @param [in] dpi DPI缩放管理器，用于对字体大小进行缩放
     */
-    DString GetDpiFontId(const DString& fontId, const DpiManager& dpi) const;
+    IFont* CreateIFont(UiFont fontInfo, const DpiManager& dpi);
 
 private:
-    /** 自定义字体数据：Key时FontID，Value是字体描述信息
+    /** 字体数据
     */
-    std::unordered_map<DString, UiFont> m_fontIdMap;
+    struct FontData
+    {
+        //字体描述信息
+        UiFont m_fontInfo;
+
+        //已经创建的字体接口：DPI缩放比例与字体接口（同时使用的DPI通常只有一两种，线性查找即可）
+        std::vector<std::pair<uint32_t, IFont*>> m_dpiFonts;
+    };
 
-    /** 自定义字体信息：Key是FontId
+    /** 自定义字体数据列表，按字体索引号访问
     */
-    std::unordered_map<DString, IFont*> m_fontMap;
+    std::vector<FontData> m_fontList;
+
+    /** 字体ID与字体索引号的映射关系
+    */
+    std::unordered_map<DString, int32_t> m_fontIndexMap;
 
     /** 默认字体ID
     */
     DString m_defaultFontId;
 
+    /** 默认字体的索引号
+    */
+    int32_t m_nDefaultFontIndex;
+
+    /** 字体列表的版本号
+    */
+    uint32_t m_nFontEpoch;
+
     /** 默认字体列表
     */
     std::vector<DString> m_defaultFontFamilyNames;
@@ -110,5 +150,53 @@ private:
     bool m_bDefaultFontInited;
 };
 
+/** 字体句柄：缓存字体ID解析后的字体接口，绘制和估算文本大小时直接使用，避免每次都按字体ID查找字体
+*   字体ID、DPI缩放比例或者字体列表的版本号（参见FontManager::GetFontEpoch）发生变化时，需要重新解析
+*   使用方法参见：Control::GetIFontById(const UiString&, FontHandle&)
+*/
+class UILIB_API FontHandle
+{
+public:
+    FontHandle();
+
+    /** 缓存的字体接口是否有效
+    * @param [in] fontId 字体ID
+    * @param [in] dpi DPI缩放管理器
+    */
+    bool IsResolved(const UiString& fontId, const DpiManager& dpi) const;
+
+    /** 设置解析后的字体接口
+    * @param [in] fontId 字体ID
+    * @param [in] pFont 字体接口
+    * @param [in] dpi DPI缩放管理器
+    */
+    void SetFont(const UiString& fontId, IFont* pFont, const DpiManager& dpi);
+
+    /** 获取缓存的字体接口
+    */
+    IFont* GetFont() const { return m_pFont; }
+
+    /** 清除缓存的字体接口
+    */
+    void Reset();
+
+private:
+    /** 字体ID
+    */
+    UiString m_fontId;
+
+    /** 字体接口，资源由FontManager管理
+    */
+    IFont* m_pFont;
+
+    /** 解析时的DPI缩放比例
+    */
+    uint32_t m_nDpiScale;
+
+    /** 解析时字体列表的版本号，为0表示未解析
+    */
+    uint32_t m_nFontEpoch;
+};
+
 }
 #endif //UI_CORE_FONTMANAGER_H_
@@ -0,0 +1,144 @@
+#include "FrameClock.h"
+#include "duilib/Core/GlobalManager.h"
+#include "duilib/Utils/PerformanceUtil.h"
+#include <algorithm>
+
+namespace ui
+{
+
+//默认的帧间隔（毫秒）
+static const uint32_t kDefaultFrameInterval = 16;
+
+//帧数统计的计数项（预先注册，避免每帧构造名称和查找计数项）
+static PerformanceUtil::Counter* const s_pFrameCounter = PerformanceUtil::Instance().RegisterCounter(_T("FrameClock::OnFrame"));
+
+FrameClock::FrameClock():
+    m_nNextCallbackId(1),
+    m_nFrameInterval(kDefaultFrameInterval),
+    m_frameTime(std::chrono::steady_clock::now()),
+    m_bInFrame(false)
+{
+}
+
+FrameClock::~FrameClock()
+{
+    Clear();
+}
+
+size_t FrameClock::AddFrameCallback(const std::weak_ptr<WeakFlag>& weakFlag, const FrameCallback& callback)
+{
+    GlobalManager::Instance().AssertUIThread();
+    ASSERT(callback != nullptr);
+    if (callback == nullptr) {
+        return 0;
+    }
+    FrameCallbackInfo callbackInfo;
+    callbackInfo.m_nCallbackId = m_nNextCallbackId++;
+    callbackInfo.m_weakFlag = weakFlag;
+    callbackInfo.m_callback = callback;
+    m_frameCallbacks.push_back(callbackInfo);
+    StartClock();
+    return callbackInfo.m_nCallbackId;
+}
+
+void FrameClock::RemoveFrameCallback(size_t nCallbackId)
+{
+    GlobalManager::Instance().AssertUIThread();
+    for (FrameCallbackInfo& callbackInfo : m_frameCallbacks) {
+        if (callbackInfo.m_nCallbackId == nCallbackId) {
+            //在帧回调过程中，只做标记，帧回调结束后再移除
+            callbackInfo.m_nCallbackId = 0;
+            break;
+        }
+    }
+    if (!m_bInFrame) {
+        RemoveExpiredCallbacks();
+    }
+}
+
+void FrameClock::SetFrameInterval(uint32_t nFrameIntervalMs)
+{
+    if (nFrameIntervalMs == 0) {
+        nFrameIntervalMs = kDefaultFrameInterval;
+    }
+    if (m_nFrameInterval != nFrameIntervalMs) {
+        m_nFrameInterval = nFrameIntervalMs;
+        if (IsRunning()) {
+            //按新的帧间隔重新启动
+            StopClock();
+            StartClock();
+        }
+    }
+}
+
+uint32_t FrameClock::GetFrameInterval() const
+{
+    return m_nFrameInterval;
+}
+
+std::chrono::steady_clock::time_point FrameClock::GetFrameTime() const
+{
+    return m_frameTime;
+}
+
+bool FrameClock::IsRunning() const
+{
+    return const_cast<WeakCallbackFlag&>(m_clockFlag).HasUsed();
+}
+
+void FrameClock::Clear()
+{
+    StopClock();
+    m_frameCallbacks.clear();
+}
+
+void FrameClock::StartClock()
+{
+    if (IsRunning()) {
+        return;
+    }
+    GlobalManager::Instance().Timer().AddTimer(m_clockFlag.GetWeakFlag(),
+                                               UiBind(&FrameClock::OnFrame, this),
+                                               m_nFrameInterval);
+}
+
+void FrameClock::StopClock()
+{
+    m_clockFlag.Cancel();
+}
+
+void FrameClock::OnFrame()
+{
+    m_frameTime = std::chrono::steady_clock::now();
+    PerformanceUtil::AddCount(s_pFrameCounter);
+
+    //本帧内新添加的回调函数，从下一帧开始回调
+    m_bInFrame = true;
+    const size_t nCount = m_frameCallbacks.size();
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        if ((m_frameCallbacks[nIndex].m_nCallbackId == 0) || m_frameCallbacks[nIndex].m_weakFlag.expired()) {
+            continue;
+        }
+        //回调过程中容器可能会扩容，所以复制一份回调函数
+        FrameCallback callback = m_frameCallbacks[nIndex].m_callback;
+        callback();
+    }
+    m_bInFrame = false;
+
+    RemoveExpiredCallbacks();
+}
+
+void FrameClock::RemoveExpiredCallbacks()
+{
+    auto iter = std::remove_if(m_frameCallbacks.begin(), m_frameCallbacks.end(),
+                               [](const FrameCallbackInfo& callbackInfo) {
+                                   return (callbackInfo.m_nCallbackId == 0) || callbackInfo.m_weakFlag.expired();
+                               });
+    m_frameCallbacks.erase(iter, m_frameCallbacks.end());
+    if (m_frameCallbacks.empty()) {
+        //没有动画时，停止帧时钟
+        StopClock();
+    }
+}
+
+} // namespace ui
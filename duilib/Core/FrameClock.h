@@ -0,0 +1,120 @@
+#ifndef UI_CORE_FRAME_CLOCK_H_
+#define UI_CORE_FRAME_CLOCK_H_
+
+#include "duilib/Core/Callback.h"
+#include <vector>
+#include <chrono>
+
+namespace ui
+{
+
+/** 帧回调函数原型：void FunctionName();
+*/
+typedef std::function<void()> FrameCallback;
+
+/** 帧时钟：所有动画（动画播放器、GIF动画、进度条滚动效果、加载中动画等）共享一个定时器，
+*   只有存在动画时才运行，每帧依次回调所有动画，各个动画根据已经过的时间计算当前状态，
+*   同一帧内各个动画产生的重绘请求，会合并为一次绘制
+*   注意：只能在UI线程中使用
+*/
+class FrameClock: public SupportWeakCallback
+{
+public:
+    FrameClock();
+    virtual ~FrameClock() override;
+    FrameClock(const FrameClock&) = delete;
+    FrameClock& operator = (const FrameClock&) = delete;
+
+public:
+    /** 添加一个帧回调函数（从下一帧开始回调）
+    * @param [in] weakFlag 取消机制，如果weakFlag.expired()为true表示已经取消，不会再继续回调
+    * @param [in] callback 帧回调函数
+    * @return 成功返回回调函数ID（其值大于0），失败则返回0
+    */
+    size_t AddFrameCallback(const std::weak_ptr<WeakFlag>& weakFlag, const FrameCallback& callback);
+
+    /** 删除一个帧回调函数
+    * @param [in] nCallbackId 回调函数ID，即AddFrameCallback的返回值
+    */
+    void RemoveFrameCallback(size_t nCallbackId);
+
+    /** 设置帧间隔（毫秒），默认为16毫秒（约60帧/秒）
+    */
+    void SetFrameInterval(uint32_t nFrameIntervalMs);
+
+    /** 获取帧间隔（毫秒）
+    */
+    uint32_t GetFrameInterval() const;
+
+    /** 获取当前帧的时间（在帧回调函数中调用时，所有动画得到相同的时间）
+    */
+    std::chrono::steady_clock::time_point GetFrameTime() const;
+
+    /** 帧时钟是否正在运行中（存在有效的帧回调函数时运行）
+    */
+    bool IsRunning() const;
+
+    /** 清除所有帧回调函数，停止帧时钟
+    */
+    void Clear();
+
+private:
+    /** 启动帧时钟
+    */
+    void StartClock();
+
+    /** 停止帧时钟
+    */
+    void StopClock();
+
+    /** 帧时钟触发，回调所有帧回调函数
+    */
+    void OnFrame();
+
+    /** 移除已经失效或者取消的帧回调函数
+    */
+    void RemoveExpiredCallbacks();
+
+private:
+    /** 帧回调函数的数据
+    */
+    struct FrameCallbackInfo
+    {
+        //回调函数ID，为0表示已经删除
+        size_t m_nCallbackId;
+
+        //取消机制
+        std::weak_ptr<WeakFlag> m_weakFlag;
+
+        //回调函数
+        FrameCallback m_callback;
+    };
+
+    /** 所有注册的帧回调函数
+    */
+    std::vector<FrameCallbackInfo> m_frameCallbacks;
+
+    /** 下一个回调函数ID
+    */
+    size_t m_nNextCallbackId;
+
+    /** 帧间隔（毫秒）
+    */
+    uint32_t m_nFrameInterval;
+
+    /** 当前帧的时间
+    */
+    std::chrono::steady_clock::time_point m_frameTime;
+
+    /** 是否正在回调帧回调函数
+    */
+    bool m_bInFrame;
+
+    /** 帧时钟定时器的取消机制
+    */
+    WeakCallbackFlag m_clockFlag;
+};
+
+} // namespace ui
+
+#endif // UI_CORE_FRAME_CLOCK_H_
@@ -1,6 +1,7 @@
 #include "GlobalManager.h"
 #include "duilib/Utils/StringUtil.h"
 #include "duilib/Utils/FilePathUtil.h"
+#include "duilib/Utils/AttributeUtil.h"
 #include "duilib/Core/Window.h"
 #include "duilib/Core/Control.h"
 #include "duilib/Core/Box.h"
@@ -93,6 +94,7 @@ bool GlobalManager::Startup(const ResourceParam& resParam,
 void GlobalManager::Shutdown()
 {
     m_threadManager.Clear();
+    m_frameClock.Clear();
     m_timerManager.Clear();
     m_colorManager.Clear();    
     m_fontManager.RemoveAllFonts();
@@ -105,6 +107,8 @@ void GlobalManager::Shutdown()
     m_renderFactory = nullptr;
     m_pfnCreateControlCallback = nullptr;
     m_globalClass.clear();
+    m_globalClassAttributes.clear();
+    WindowBuilder::ClearXmlFileCache();
     m_windowList.clear();
     m_dwUiThreadId = std::thread::id();
     m_resourcePath.Clear();
@@ -209,6 +213,7 @@ bool GlobalManager::ReloadResource(const ResourceParam& resParam, bool bInvalida
     m_colorManager.RemoveAllColors();
     RemoveAllImages();
     RemoveAllClasss();
+    WindowBuilder::ClearXmlFileCache();
 
     //保存资源路径
     SetResourcePath(FilePathUtil::JoinFilePath(strResourcePath, resParam.themePath));
@@ -468,6 +473,9 @@ void GlobalManager::AddClass(const DString& strClassName, const DString& strCont
     ASSERT(!strClassName.empty() && !strControlAttrList.empty());
     if (!strClassName.empty() && !strControlAttrList.empty()) {
         m_globalClass[strClassName] = strControlAttrList;
+        std::shared_ptr<AttributeList> spAttributeList = std::make_shared<AttributeList>();
+        AttributeUtil::ParseAttributeList(strControlAttrList, *spAttributeList);
+        m_globalClassAttributes[strClassName] = spAttributeList;
     }    
 }
 
@@ -481,10 +489,21 @@ DString GlobalManager::GetClassAttributes(const DString& strClassName) const
     return DString();
 }
 
+std::shared_ptr<const AttributeList> GlobalManager::GetClassAttributeList(const DString& strClassName) const
+{
+    AssertUIThread();
+    auto it = m_globalClassAttributes.find(strClassName);
+    if (it != m_globalClassAttributes.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
 void GlobalManager::RemoveAllClasss()
 {
     AssertUIThread();
     m_globalClass.clear();
+    m_globalClassAttributes.clear();
 }
 
 ColorManager& GlobalManager::Color()
@@ -524,6 +543,11 @@ TimerManager& GlobalManager::Timer()
     return m_timerManager;
 }
 
+FrameClock& GlobalManager::Clock()
+{
+    return m_frameClock;
+}
+
 ThreadManager& GlobalManager::Thread()
 {
     return m_threadManager;
@@ -9,9 +9,11 @@
 #include "duilib/Core/LangManager.h"
 #include "duilib/Core/DpiManager.h"
 #include "duilib/Core/TimerManager.h"
+#include "duilib/Core/FrameClock.h"
 #include "duilib/Core/ThreadManager.h"
 #include "duilib/Core/ResourceParam.h"
 #include "duilib/Core/CursorManager.h"
+#include "duilib/Utils/AttributeUtil.h"
 
 #ifdef DUILIB_BUILD_FOR_WIN
     #include "duilib/Core/IconManager_Windows.h"
@@ -157,6 +159,12 @@ public:
      */
     DString GetClassAttributes(const DString& strClassName) const;
 
+    /** 获取一个全局 class 属性解析后的属性列表（添加时已经完成解析，应用时无需再次解析）
+     * @param[in] strClassName 全局 class 名称
+     * @return 返回解析后的属性列表，如果不存在则返回nullptr
+     */
+    std::shared_ptr<const AttributeList> GetClassAttributeList(const DString& strClassName) const;
+
     /** 从全局属性中删除所有 class 属性
      * @return 返回绘制区域对象
      */
@@ -198,6 +206,10 @@ public:
     */
     TimerManager& Timer();
 
+    /** 获取动画共享的帧时钟
+    */
+    FrameClock& Clock();
+
     /** 获取线程管理器
     */
     ThreadManager& Thread();
@@ -309,6 +321,10 @@ private:
     */
     std::map<DString, DString> m_globalClass;
 
+    /** 每个Class的名称(KEY)和解析后的属性列表(VALUE)
+    */
+    std::map<DString, std::shared_ptr<const AttributeList>> m_globalClassAttributes;
+
     /** 主线程ID
     */
     std::thread::id m_dwUiThreadId;
@@ -351,6 +367,10 @@ private:
     */
     TimerManager m_timerManager;
 
+    /** 动画共享的帧时钟
+    */
+    FrameClock m_frameClock;
+
     /** 线程管理器
     */
     ThreadManager m_threadManager;
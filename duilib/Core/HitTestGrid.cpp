@@ -0,0 +1,156 @@
+#include "HitTestGrid.h"
+#include "duilib/Core/Control.h"
+#include <cmath>
+
+namespace ui
+{
+
+//网格数量的上限
+static const int32_t kMaxCellCount = 4096;
+
+//索引中的子控件引用总数超过子控件数量的倍数时，认为子控件重叠严重，不使用网格索引
+static const size_t kMaxEntryRatio = 8;
+
+HitTestGrid::HitTestGrid():
+    m_nColumns(0),
+    m_nRows(0),
+    m_nCellWidth(0),
+    m_nCellHeight(0),
+    m_bDirty(true),
+    m_bValid(false)
+{
+}
+
+void HitTestGrid::Clear()
+{
+    m_rcBounds.Clear();
+    m_nColumns = 0;
+    m_nRows = 0;
+    m_nCellWidth = 0;
+    m_nCellHeight = 0;
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_bDirty = true;
+    m_bValid = false;
+}
+
+int32_t HitTestGrid::GetColumn(int32_t x) const
+{
+    int32_t nColumn = (x - m_rcBounds.left) / m_nCellWidth;
+    return std::max(0, std::min(nColumn, m_nColumns - 1));
+}
+
+int32_t HitTestGrid::GetRow(int32_t y) const
+{
+    int32_t nRow = (y - m_rcBounds.top) / m_nCellHeight;
+    return std::max(0, std::min(nRow, m_nRows - 1));
+}
+
+bool HitTestGrid::Rebuild(const std::vector<Control*>& items)
+{
+    Clear();
+    m_bDirty = false;
+
+    //计算所有有效子控件区域的外接矩形（区域为空的子控件，不可能命中，不加入索引）
+    size_t nItemCount = 0;
+    for (const Control* pControl : items) {
+        if ((pControl == nullptr) || pControl->GetRect().IsEmpty()) {
+            continue;
+        }
+        if (nItemCount == 0) {
+            m_rcBounds = pControl->GetRect();
+        }
+        else {
+            m_rcBounds.Union(pControl->GetRect());
+        }
+        ++nItemCount;
+    }
+    if (nItemCount == 0) {
+        //没有可命中的子控件
+        m_bValid = true;
+        return true;
+    }
+
+    //网格数量与子控件数量相当，按外接矩形的宽高比分配行列数
+    const int32_t nWidth = m_rcBounds.Width();
+    const int32_t nHeight = m_rcBounds.Height();
+    const int32_t nCellCount = static_cast<int32_t>(std::min(nItemCount, static_cast<size_t>(kMaxCellCount)));
+    int32_t nColumns = static_cast<int32_t>(std::sqrt((double)nCellCount * nWidth / nHeight) + 0.5);
+    nColumns = std::max(1, std::min(nColumns, nCellCount));
+    int32_t nRows = std::max(1, std::min((nCellCount + nColumns - 1) / nColumns, nCellCount));
+    m_nCellWidth = std::max(1, (nWidth + nColumns - 1) / nColumns);
+    m_nCellHeight = std::max(1, (nHeight + nRows - 1) / nRows);
+    m_nColumns = (nWidth + m_nCellWidth - 1) / m_nCellWidth;
+    m_nRows = (nHeight + m_nCellHeight - 1) / m_nCellHeight;
+
+    //第一遍：统计每个网格中的子控件数量
+    const size_t nMaxEntryCount = nItemCount * kMaxEntryRatio;
+    size_t nEntryCount = 0;
+    m_cellStart.resize(static_cast<size_t>(m_nColumns) * m_nRows + 1, 0);
+    for (const Control* pControl : items) {
+        if ((pControl == nullptr) || pControl->GetRect().IsEmpty()) {
+            continue;
+        }
+        const UiRect& rc = pControl->GetRect();
+        const int32_t nColumnBegin = GetColumn(rc.left);
+        const int32_t nColumnEnd = GetColumn(rc.right - 1);
+        const int32_t nRowBegin = GetRow(rc.top);
+        const int32_t nRowEnd = GetRow(rc.bottom - 1);
+        nEntryCount += static_cast<size_t>(nColumnEnd - nColumnBegin + 1) * (nRowEnd - nRowBegin + 1);
+        if (nEntryCount > nMaxEntryCount) {
+            //子控件重叠严重，网格索引没有优势
+            Clear();
+            m_bDirty = false;
+            return false;
+        }
+        for (int32_t nRow = nRowBegin; nRow <= nRowEnd; ++nRow) {
+            for (int32_t nColumn = nColumnBegin; nColumn <= nColumnEnd; ++nColumn) {
+                ++m_cellStart[static_cast<size_t>(nRow) * m_nColumns + nColumn + 1];
+            }
+        }
+    }
+    for (size_t nCell = 1; nCell < m_cellStart.size(); ++nCell) {
+        m_cellStart[nCell] += m_cellStart[nCell - 1];
+    }
+
+    //第二遍：按子控件的顺序填充索引号，保证每个网格中的索引号是升序的
+    m_cellItems.resize(nEntryCount);
+    std::vector<uint32_t> cellPos(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (size_t nIndex = 0; nIndex < items.size(); ++nIndex) {
+        const Control* pControl = items[nIndex];
+        if ((pControl == nullptr) || pControl->GetRect().IsEmpty()) {
+            continue;
+        }
+        const UiRect& rc = pControl->GetRect();
+        const int32_t nColumnBegin = GetColumn(rc.left);
+        const int32_t nColumnEnd = GetColumn(rc.right - 1);
+        const int32_t nRowBegin = GetRow(rc.top);
+        const int32_t nRowEnd = GetRow(rc.bottom - 1);
+        for (int32_t nRow = nRowBegin; nRow <= nRowEnd; ++nRow) {
+            for (int32_t nColumn = nColumnBegin; nColumn <= nColumnEnd; ++nColumn) {
+                m_cellItems[cellPos[static_cast<size_t>(nRow) * m_nColumns + nColumn]++] = static_cast<uint32_t>(nIndex);
+            }
+        }
+    }
+    m_bValid = true;
+    return true;
+}
+
+bool HitTestGrid::GetCandidates(const UiPoint& pt, const uint32_t*& pBegin, const uint32_t*& pEnd) const
+{
+    pBegin = nullptr;
+    pEnd = nullptr;
+    if (!IsValid()) {
+        return false;
+    }
+    if (m_cellItems.empty() || !m_rcBounds.ContainsPt(pt)) {
+        //坐标不在任何子控件的区域内
+        return true;
+    }
+    const size_t nCell = static_cast<size_t>(GetRow(pt.y)) * m_nColumns + GetColumn(pt.x);
+    pBegin = m_cellItems.data() + m_cellStart[nCell];
+    pEnd = m_cellItems.data() + m_cellStart[nCell + 1];
+    return true;
+}
+
+} // namespace ui
@@ -0,0 +1,94 @@
+#ifndef UI_CORE_HIT_TEST_GRID_H_
+#define UI_CORE_HIT_TEST_GRID_H_
+
+#include "duilib/Core/UiRect.h"
+#include <vector>
+
+namespace ui
+{
+class Control;
+
+/** 容器子控件的命中测试索引：将容器内子控件的矩形区域按均匀网格划分，
+*   按坐标查找控件时，只需要检查坐标所在网格内的子控件，避免逐个遍历所有子控件
+*   索引中只记录子控件的位置（GetRect()），子控件位置变化或者子控件列表变化时，需要标记为脏，下次查询前重建
+*   注意：只能在UI线程中使用
+*/
+class HitTestGrid
+{
+public:
+    HitTestGrid();
+    HitTestGrid(const HitTestGrid&) = delete;
+    HitTestGrid& operator = (const HitTestGrid&) = delete;
+
+public:
+    /** 标记索引需要重建
+    */
+    void SetDirty() { m_bDirty = true; }
+
+    /** 索引是否需要重建
+    */
+    bool IsDirty() const { return m_bDirty; }
+
+    /** 根据子控件列表重建索引
+    * @param [in] items 子控件列表
+    * @return 如果子控件的分布不适合使用网格索引（比如大量重叠的子控件），返回false，此时应逐个遍历子控件
+    */
+    bool Rebuild(const std::vector<Control*>& items);
+
+    /** 索引是否可用
+    */
+    bool IsValid() const { return m_bValid && !m_bDirty; }
+
+    /** 获取包含指定坐标的候选子控件索引号（子控件在列表中的下标，按升序排列）
+    * @param [in] pt 坐标（与子控件的GetRect()为同一坐标系）
+    * @param [out] pBegin 候选列表的起始位置
+    * @param [out] pEnd 候选列表的结束位置
+    * @return 如果索引不可用，返回false
+    */
+    bool GetCandidates(const UiPoint& pt, const uint32_t*& pBegin, const uint32_t*& pEnd) const;
+
+    /** 清除索引
+    */
+    void Clear();
+
+private:
+    /** 计算坐标所在的列号/行号（已限制在有效范围内）
+    */
+    int32_t GetColumn(int32_t x) const;
+    int32_t GetRow(int32_t y) const;
+
+private:
+    /** 所有子控件区域的外接矩形
+    */
+    UiRect m_rcBounds;
+
+    /** 网格的列数和行数
+    */
+    int32_t m_nColumns;
+    int32_t m_nRows;
+
+    /** 每个网格的宽度和高度
+    */
+    int32_t m_nCellWidth;
+    int32_t m_nCellHeight;
+
+    /** 每个网格在m_cellItems中的起始位置（共m_nColumns * m_nRows + 1个元素）
+    */
+    std::vector<uint32_t> m_cellStart;
+
+    /** 所有网格的子控件索引号，按网格顺序连续存储
+    */
+    std::vector<uint32_t> m_cellItems;
+
+    /** 索引是否需要重建
+    */
+    bool m_bDirty;
+
+    /** 索引是否可用
+    */
+    bool m_bValid;
+};
+
+} // namespace ui
+
+#endif // UI_CORE_HIT_TEST_GRID_H_
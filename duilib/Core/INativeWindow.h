@@ -108,6 +108,12 @@ public:
     */
     virtual IRender* OnNativeGetRender() const = 0;
 
+    /** 获取最近一次绘制实际重绘的区域
+    * @param [out] paintedRects 重绘的区域列表（客户区坐标）
+    * @return 如果返回false，表示最近一次绘制是按系统请求的区域整体重绘的
+    */
+    virtual bool OnNativeGetPaintedRects(std::vector<UiRect>& paintedRects) const = 0;
+
 public:
     /** @name 窗口消息处理相关
      * @{
@@ -4,40 +4,121 @@
 #include "duilib/Core/GlobalManager.h"
 #include "duilib/Core/DpiManager.h"
 #include "duilib/Core/Window.h"
+#include "duilib/Core/Control.h"
+#include "duilib/Core/FrameworkThread.h"
 #include "duilib/Utils/StringUtil.h"
 #include "duilib/Utils/FileUtil.h"
+#include <unordered_set>
 
 namespace ui 
 {
 
+//异步加载完成的图片，如果一直未被控件获取，延迟释放的时间（毫秒）
+static const int32_t kAsyncLoadedImageReleaseMs = 5000;
+
+//图片常驻缓存的默认内存预算（字节）
+static const size_t kDefaultImageCacheBudget = 32 * 1024 * 1024;
+
+//按需解码动画图片帧时，每个动画图片的图片帧位图默认最多占用的内存（字节）
+static const size_t kDefaultAnimationFrameCacheBytes = 4 * 1024 * 1024;
+
+/** 异步加载图片的任务
+*/
+struct ImageManager::AsyncLoadTask
+{
+    explicit AsyncLoadTask(const ImageLoadAttribute& loadAttribute):
+        m_loadAttribute(loadAttribute)
+    {
+    }
+
+    //图片的加载Key和图片Key
+    DString m_loadKey;
+    DString m_imageKey;
+
+    //图片文件的路径（本地文件和压缩包中的文件，都在后台线程中读取）
+    DString m_imageFullPath;
+    std::vector<uint8_t> m_fileData;
+
+    //图片文件是否在压缩包中
+    bool m_bZipFile = false;
+
+    //图片的加载属性
+    ImageLoadAttribute m_loadAttribute;
+    bool m_bEnableDpiScale = false;
+    uint32_t m_nImageDpiScale = 100;
+    bool m_bDpiScaledImageFile = false;
+
+    //动画图片的按需解码属性
+    bool m_bLazyDecodeFrames = false;
+    size_t m_nFrameCacheBytes = 0;
+
+    //请求加载时的DPI和DPI缩放百分比
+    uint32_t m_nDpi = 0;
+    uint32_t m_nLoadDpiScale = 100;
+
+    //任务的批次号
+    uint32_t m_nGeneration = 0;
+
+    //解码结果
+    bool m_bDecoded = false;
+    ImageDecoder::DecodedImage m_decodedImage;
+};
+
 ImageManager::ImageManager():
     m_bDpiScaleAllImages(true),
-    m_bAutoMatchScaleImage(true)
+    m_bAutoMatchScaleImage(true),
+    m_bLazyDecodeAnimation(false),
+    m_nAnimationFrameCacheBytes(kDefaultAnimationFrameCacheBytes),
+    m_nImageCacheBudget(kDefaultImageCacheBudget),
+    m_bAsyncLoadImage(false),
+    m_nAsyncLoadThreadCount(2),
+    m_nNextAsyncLoadThread(0),
+    m_bAsyncLoadFinishPosted(false),
+    m_nAsyncLoadGeneration(0)
 {
 }
 
 ImageManager::~ImageManager()
 {
+    ClearAsyncLoad();
+    ClearRetainedImages();
 }
 
 std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
-                                                  const ImageLoadAttribute& loadAtrribute)
+                                                  const ImageLoadAttribute& loadAtrribute,
+                                                  Control* pAsyncControl)
 {
     const DpiManager& dpi = (pWindow != nullptr) ? pWindow->Dpi() : GlobalManager::Instance().Dpi();
     //查找对应关系：LoadKey ->(多对一) ImageKey ->(一对一) SharedImage
     DString loadKey = loadAtrribute.GetCacheKey(dpi.GetScale());
-    auto iter = m_loadKeyMap.find(loadKey);
-    if (iter != m_loadKeyMap.end()) {
-        const DString& imageKey = iter->second;
-        auto it = m_imageMap.find(imageKey);
-        if (it != m_imageMap.end()) {
-            std::shared_ptr<ImageInfo> sharedImage = it->second.lock();
-            if (sharedImage) {
-                //从缓存中，找到有效图片资源，直接返回
-                return sharedImage;
+    std::shared_ptr<ImageInfo> cachedImage = FindImageCache(loadKey);
+    if (cachedImage != nullptr) {
+        if (!m_asyncLoadedImages.empty()) {
+            //异步加载完成的图片已被控件获取，不再需要保持引用
+            auto itLoaded = m_asyncLoadedImages.find(loadKey);
+            if (itLoaded != m_asyncLoadedImages.end()) {
+                if (itLoaded->second.m_nPendingCount <= 1) {
+                    m_asyncLoadedImages.erase(itLoaded);
+                }
+                else {
+                    itLoaded->second.m_nPendingCount--;
+                }
             }
         }
-    }    
+        //从缓存中，找到有效图片资源，直接返回
+        m_cacheStats.m_nHitCount++;
+        RetainImage(cachedImage);
+        return cachedImage;
+    }
+
+    if (pAsyncControl != nullptr) {
+        auto itLoading = m_asyncLoadWaiters.find(loadKey);
+        if (itLoading != m_asyncLoadWaiters.end()) {
+            //该图片正在异步加载中，合并请求
+            AddAsyncLoadWaiter(itLoading->second, pAsyncControl);
+            return nullptr;
+        }
+    }
 
     //重新加载资源    
     std::unique_ptr<ImageInfo> imageInfo;
@@ -90,11 +171,39 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
                 std::shared_ptr<ImageInfo> sharedImage = it->second.lock();
                 if ((sharedImage != nullptr) && (sharedImage->GetLoadDpiScale() == dpi.GetScale())) {
                     //与请求的DPI缩放百分比相同
+                    m_cacheStats.m_nHitCount++;
+                    RetainImage(sharedImage);
                     return sharedImage;
                 }
             }
         }
 
+        if ((pAsyncControl != nullptr) && IsAsyncLoadImage() &&
+            (GlobalManager::Instance().Thread().GetCurrentThreadIdentifier() == kThreadUI)) {
+            //异步加载：在后台线程中读取文件并解码，解码完成后通知控件重绘
+            std::shared_ptr<AsyncLoadTask> task = std::make_shared<AsyncLoadTask>(loadAtrribute);
+            task->m_loadKey = loadKey;
+            task->m_imageKey = imageKey;
+            task->m_imageFullPath = imageFullPath;
+            //压缩包支持多线程并发读取，在后台线程中读取数据
+            task->m_bZipFile = isUseZip;
+            if (isDpiScaledImageFile) {
+                task->m_loadAttribute.SetNeedDpiScale(false);
+            }
+            task->m_bEnableDpiScale = bEnableImageDpiScale;
+            task->m_nImageDpiScale = nImageDpiScale;
+            task->m_bDpiScaledImageFile = isDpiScaledImageFile;
+            task->m_bLazyDecodeFrames = IsLazyDecodeAnimation();
+            task->m_nFrameCacheBytes = GetAnimationFrameCacheBytes();
+            task->m_nDpi = dpi.GetDPI();
+            task->m_nLoadDpiScale = dpi.GetScale();
+            task->m_nGeneration = m_nAsyncLoadGeneration;
+            if ((!isUseZip || GlobalManager::Instance().Zip().IsZipResExist(FilePath(imageFullPath))) && StartAsyncLoad(task)) {
+                AddAsyncLoadWaiter(m_asyncLoadWaiters[loadKey], pAsyncControl);
+                return nullptr;
+            }
+        }
+
         //从内存数据加载文件
         std::vector<uint8_t> fileData;
         if (isUseZip) {
@@ -108,6 +217,8 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
         imageInfo.reset();
         if (!fileData.empty()) {
             ImageDecoder imageDecoder;
+            imageDecoder.SetLazyDecodeFrames(IsLazyDecodeAnimation());
+            imageDecoder.SetFrameCacheBytes(GetAnimationFrameCacheBytes());
             ImageLoadAttribute imageLoadAtrribute(loadAtrribute);
             if (isDpiScaledImageFile) {
                 imageLoadAtrribute.SetNeedDpiScale(false);
@@ -118,12 +229,20 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
             imageInfo->SetImageKey(imageKey);
         }
     }    
+    return AddImageCache(imageInfo, loadKey, dpi.GetScale(), isDpiScaledImageFile);
+}
+
+std::shared_ptr<ImageInfo> ImageManager::AddImageCache(std::unique_ptr<ImageInfo>& imageInfo,
+                                                       const DString& loadKey,
+                                                       uint32_t nLoadDpiScale,
+                                                       bool isDpiScaledImageFile)
+{
     std::shared_ptr<ImageInfo> sharedImage;
     if (imageInfo != nullptr) {
         DString imageKey = imageInfo->GetImageKey();
         sharedImage.reset(imageInfo.release(), &OnImageInfoDestroy);
         sharedImage->SetLoadKey(loadKey);
-        sharedImage->SetLoadDpiScale(dpi.GetScale());
+        sharedImage->SetLoadDpiScale(nLoadDpiScale);
         if (isDpiScaledImageFile) {
             //使用了DPI自适应的图片，做标记（必须位true时才能修改这个值）
             sharedImage->SetBitmapSizeDpiScaled(isDpiScaledImageFile);
@@ -136,6 +255,10 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
         m_loadKeyMap[loadKey] = imageKey;
         m_imageMap[imageKey] = sharedImage;
 
+        //新解码的图片，计入未命中次数，并放入常驻缓存
+        m_cacheStats.m_nMissCount++;
+        RetainImage(sharedImage);
+
 #ifdef _DEBUG
         //DString log = _T("Loaded Image: ") + imageKey + _T("\n");
         //::OutputDebugString(log.c_str());
@@ -144,6 +267,209 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
     return sharedImage;
 }
 
+std::shared_ptr<ImageInfo> ImageManager::FindImageCache(const DString& loadKey) const
+{
+    auto iter = m_loadKeyMap.find(loadKey);
+    if (iter != m_loadKeyMap.end()) {
+        const DString& imageKey = iter->second;
+        auto it = m_imageMap.find(imageKey);
+        if (it != m_imageMap.end()) {
+            return it->second.lock();
+        }
+    }
+    return nullptr;
+}
+
+void ImageManager::AddAsyncLoadWaiter(std::vector<AsyncLoadWaiter>& waiters, Control* pControl)
+{
+    ASSERT(pControl != nullptr);
+    if (pControl == nullptr) {
+        return;
+    }
+    for (const AsyncLoadWaiter& waiter : waiters) {
+        if ((waiter.m_pControl == pControl) && !waiter.m_weakFlag.expired()) {
+            return;
+        }
+    }
+    AsyncLoadWaiter waiter;
+    waiter.m_pControl = pControl;
+    waiter.m_weakFlag = pControl->GetWeakFlag();
+    waiters.push_back(waiter);
+}
+
+bool ImageManager::StartAsyncLoad(const std::shared_ptr<AsyncLoadTask>& task)
+{
+    ASSERT(task != nullptr);
+    if (task == nullptr) {
+        return false;
+    }
+    if (m_asyncLoadThreads.empty()) {
+        //首次使用时创建后台线程
+        const uint32_t nThreadCount = (m_nAsyncLoadThreadCount > 0) ? m_nAsyncLoadThreadCount : 1;
+        for (uint32_t nIndex = 0; nIndex < nThreadCount; ++nIndex) {
+            std::unique_ptr<FrameworkThread> pThread(new FrameworkThread(_T("ImageLoadThread"), kThreadNone));
+            if (pThread->Start()) {
+                m_asyncLoadThreads.push_back(std::move(pThread));
+            }
+        }
+        m_nNextAsyncLoadThread = 0;
+    }
+    if (m_asyncLoadThreads.empty()) {
+        return false;
+    }
+    //按顺序轮流分配给各个后台线程
+    FrameworkThread* pThread = m_asyncLoadThreads[m_nNextAsyncLoadThread % m_asyncLoadThreads.size()].get();
+    ++m_nNextAsyncLoadThread;
+    return pThread->PostTask([this, task]() { DecodeImageTask(task); }) != 0;
+}
+
+void ImageManager::DecodeImageTask(const std::shared_ptr<AsyncLoadTask>& task)
+{
+    //本函数在后台线程中执行：只能访问task中的数据、压缩包（支持多线程读取），以及解码结果队列
+    if (task->m_bZipFile) {
+        GlobalManager::Instance().Zip().GetZipData(FilePath(task->m_imageFullPath), task->m_fileData);
+    }
+    else if (task->m_fileData.empty()) {
+        FileUtil::ReadFileData(FilePath(task->m_imageFullPath), task->m_fileData);
+    }
+    if (!task->m_fileData.empty()) {
+        DpiManager dpi;
+        dpi.SetDPI(task->m_nDpi);
+        ImageDecoder imageDecoder;
+        imageDecoder.SetLazyDecodeFrames(task->m_bLazyDecodeFrames);
+        imageDecoder.SetFrameCacheBytes(task->m_nFrameCacheBytes);
+        task->m_bDecoded = imageDecoder.DecodeImage(task->m_fileData, task->m_loadAttribute,
+                                                    task->m_bEnableDpiScale, task->m_nImageDpiScale,
+                                                    dpi, task->m_decodedImage);
+    }
+    std::vector<uint8_t>().swap(task->m_fileData);
+
+    bool bPostTask = false;
+    {
+        std::lock_guard<std::mutex> guard(m_asyncLoadMutex);
+        m_asyncLoadResults.push_back(task);
+        if (!m_bAsyncLoadFinishPosted) {
+            //多个解码结果，合并到一个UI线程任务中处理
+            m_bAsyncLoadFinishPosted = true;
+            bPostTask = true;
+        }
+    }
+    if (bPostTask) {
+        bool bPosted = GlobalManager::Instance().Thread().PostTask(kThreadUI, []() {
+                GlobalManager::Instance().Image().OnAsyncLoadFinished();
+            });
+        if (!bPosted) {
+            std::lock_guard<std::mutex> guard(m_asyncLoadMutex);
+            m_bAsyncLoadFinishPosted = false;
+        }
+    }
+}
+
+void ImageManager::OnAsyncLoadFinished()
+{
+    std::vector<std::shared_ptr<AsyncLoadTask>> results;
+    {
+        std::lock_guard<std::mutex> guard(m_asyncLoadMutex);
+        results.swap(m_asyncLoadResults);
+        m_bAsyncLoadFinishPosted = false;
+    }
+
+    std::vector<AsyncLoadWaiter> waiters;
+    std::vector<DString> loadedKeys;
+    for (const std::shared_ptr<AsyncLoadTask>& task : results) {
+        if (task->m_nGeneration != m_nAsyncLoadGeneration) {
+            //缓存已经清除，丢弃过期的结果
+            continue;
+        }
+        std::vector<AsyncLoadWaiter> taskWaiters;
+        auto iter = m_asyncLoadWaiters.find(task->m_loadKey);
+        if (iter != m_asyncLoadWaiters.end()) {
+            taskWaiters.swap(iter->second);
+            m_asyncLoadWaiters.erase(iter);
+        }
+        if (!task->m_bDecoded) {
+            //解码失败时，不通知控件重绘，避免反复加载
+            continue;
+        }
+
+        std::shared_ptr<ImageInfo> sharedImage = FindImageCache(task->m_loadKey);
+        if (sharedImage == nullptr) {
+            //在UI线程中创建位图
+            ImageDecoder imageDecoder;
+            std::unique_ptr<ImageInfo> imageInfo = imageDecoder.CreateImageInfo(task->m_decodedImage);
+            if (imageInfo == nullptr) {
+                continue;
+            }
+            imageInfo->SetImageKey(task->m_imageKey);
+            sharedImage = AddImageCache(imageInfo, task->m_loadKey, task->m_nLoadDpiScale, task->m_bDpiScaledImageFile);
+        }
+        task->m_decodedImage.m_imageData.clear();
+        task->m_decodedImage.m_frameDecoder.reset();
+        if (sharedImage == nullptr) {
+            continue;
+        }
+
+        size_t nPendingCount = 0;
+        for (const AsyncLoadWaiter& waiter : taskWaiters) {
+            if (!waiter.m_weakFlag.expired()) {
+                ++nPendingCount;
+                waiters.push_back(waiter);
+            }
+        }
+        if (nPendingCount > 0) {
+            //在控件获取图片之前，保持图片的引用
+            AsyncLoadedImage& loadedImage = m_asyncLoadedImages[task->m_loadKey];
+            loadedImage.m_sharedImage = sharedImage;
+            loadedImage.m_nPendingCount = nPendingCount;
+            loadedKeys.push_back(task->m_loadKey);
+        }
+    }
+
+    if (!loadedKeys.empty()) {
+        const uint32_t nGeneration = m_nAsyncLoadGeneration;
+        GlobalManager::Instance().Thread().PostDelayedTask(kThreadUI, [loadedKeys, nGeneration]() {
+                GlobalManager::Instance().Image().ReleaseAsyncLoadedImages(loadedKeys, nGeneration);
+            }, kAsyncLoadedImageReleaseMs);
+    }
+
+    //批量通知等待的控件重绘（每个控件只通知一次）
+    std::unordered_set<Control*> notifiedControls;
+    for (const AsyncLoadWaiter& waiter : waiters) {
+        if (waiter.m_weakFlag.expired() || (waiter.m_pControl == nullptr)) {
+            continue;
+        }
+        if (notifiedControls.insert(waiter.m_pControl).second) {
+            waiter.m_pControl->RelayoutOrRedraw();
+        }
+    }
+}
+
+void ImageManager::ReleaseAsyncLoadedImages(const std::vector<DString>& loadKeys, uint32_t nGeneration)
+{
+    if (nGeneration != m_nAsyncLoadGeneration) {
+        return;
+    }
+    for (const DString& loadKey : loadKeys) {
+        m_asyncLoadedImages.erase(loadKey);
+    }
+}
+
+void ImageManager::ClearAsyncLoad()
+{
+    ++m_nAsyncLoadGeneration;
+    for (std::unique_ptr<FrameworkThread>& pThread : m_asyncLoadThreads) {
+        pThread->Stop();
+    }
+    m_asyncLoadThreads.clear();
+    m_nNextAsyncLoadThread = 0;
+    {
+        std::lock_guard<std::mutex> guard(m_asyncLoadMutex);
+        m_asyncLoadResults.clear();
+    }
+    m_asyncLoadWaiters.clear();
+    m_asyncLoadedImages.clear();
+}
+
 #ifdef DUILIB_BUILD_FOR_WIN
 void ImageManager::LoadIconData(const Window* pWindow, 
                                 const ImageLoadAttribute& loadAtrribute,
@@ -214,9 +540,132 @@ void ImageManager::OnImageInfoDestroy(ImageInfo* pImageInfo)
 
 void ImageManager::RemoveAllImages()
 {
+    ClearAsyncLoad();
+    ClearRetainedImages();
     m_imageMap.clear();
 }
 
+void ImageManager::RetainImage(const std::shared_ptr<ImageInfo>& sharedImage)
+{
+    if (sharedImage == nullptr) {
+        return;
+    }
+    auto iter = m_retainedIndex.find(sharedImage.get());
+    if (iter != m_retainedIndex.end()) {
+        //已经在常驻缓存中，移动到链表头部（迭代器仍然有效）
+        if (iter->second != m_retainedImages.begin()) {
+            m_retainedImages.splice(m_retainedImages.begin(), m_retainedImages, iter->second);
+        }
+        return;
+    }
+    const size_t nBytes = sharedImage->GetBitmapBytes();
+    if ((m_nImageCacheBudget == 0) || (nBytes > m_nImageCacheBudget)) {
+        //常驻缓存已关闭，或者图片超过内存预算，不保存
+        return;
+    }
+    TrimRetainedImages(m_nImageCacheBudget - nBytes);
+
+    RetainedImage retainedImage;
+    retainedImage.m_sharedImage = sharedImage;
+    retainedImage.m_nBytes = nBytes;
+    retainedImage.m_nDpiScale = sharedImage->GetLoadDpiScale();
+    m_retainedImages.push_front(retainedImage);
+    m_retainedIndex[sharedImage.get()] = m_retainedImages.begin();
+
+    m_cacheStats.m_nResidentBytes += nBytes;
+    m_cacheStats.m_nResidentCount++;
+    DpiScaleCacheStats& dpiStats = m_cacheStats.m_dpiScaleStats[retainedImage.m_nDpiScale];
+    dpiStats.m_nResidentBytes += nBytes;
+    dpiStats.m_nResidentCount++;
+}
+
+void ImageManager::OnImageBitmapBytesChanged(const ImageInfo* pImageInfo)
+{
+    auto iter = m_retainedIndex.find(pImageInfo);
+    if (iter == m_retainedIndex.end()) {
+        return;
+    }
+    RetainedImage& retainedImage = *(iter->second);
+    const size_t nBytes = pImageInfo->GetBitmapBytes();
+    if (nBytes == retainedImage.m_nBytes) {
+        return;
+    }
+    DpiScaleCacheStats& dpiStats = m_cacheStats.m_dpiScaleStats[retainedImage.m_nDpiScale];
+    m_cacheStats.m_nResidentBytes = m_cacheStats.m_nResidentBytes - retainedImage.m_nBytes + nBytes;
+    dpiStats.m_nResidentBytes = dpiStats.m_nResidentBytes - retainedImage.m_nBytes + nBytes;
+    retainedImage.m_nBytes = nBytes;
+    if (m_cacheStats.m_nResidentBytes > m_nImageCacheBudget) {
+        //超出内存预算，淘汰最久未使用的图片（该图片正在使用中，控件仍持有其引用，不会被释放）
+        TrimRetainedImages(m_nImageCacheBudget);
+    }
+}
+
+void ImageManager::TrimRetainedImages(size_t nBudgetBytes)
+{
+    while (!m_retainedImages.empty() && (m_cacheStats.m_nResidentBytes > nBudgetBytes)) {
+        RetainedImageList::iterator itItem = std::prev(m_retainedImages.end());
+        m_cacheStats.m_nResidentBytes -= itItem->m_nBytes;
+        m_cacheStats.m_nResidentCount--;
+        m_cacheStats.m_nEvictCount++;
+        m_cacheStats.m_nEvictBytes += itItem->m_nBytes;
+        DpiScaleCacheStats& dpiStats = m_cacheStats.m_dpiScaleStats[itItem->m_nDpiScale];
+        dpiStats.m_nResidentBytes -= itItem->m_nBytes;
+        dpiStats.m_nResidentCount--;
+        dpiStats.m_nEvictCount++;
+        dpiStats.m_nEvictBytes += itItem->m_nBytes;
+
+        //先移出链表再释放引用：图片释放时会回调OnImageInfoDestroy
+        std::shared_ptr<ImageInfo> sharedImage;
+        sharedImage.swap(itItem->m_sharedImage);
+        m_retainedIndex.erase(sharedImage.get());
+        m_retainedImages.erase(itItem);
+        sharedImage.reset();
+    }
+}
+
+void ImageManager::ClearRetainedImages()
+{
+    RetainedImageList retainedImages;
+    retainedImages.swap(m_retainedImages);
+    m_retainedIndex.clear();
+    m_cacheStats.m_nResidentBytes = 0;
+    m_cacheStats.m_nResidentCount = 0;
+    for (auto& iter : m_cacheStats.m_dpiScaleStats) {
+        iter.second.m_nResidentBytes = 0;
+        iter.second.m_nResidentCount = 0;
+    }
+    retainedImages.clear();
+}
+
+void ImageManager::SetImageCacheBudget(size_t nBudgetBytes)
+{
+    m_nImageCacheBudget = nBudgetBytes;
+    TrimRetainedImages(m_nImageCacheBudget);
+}
+
+size_t ImageManager::GetImageCacheBudget() const
+{
+    return m_nImageCacheBudget;
+}
+
+void ImageManager::GetImageCacheStats(ImageCacheStats& stats) const
+{
+    stats = m_cacheStats;
+    stats.m_nBudgetBytes = m_nImageCacheBudget;
+}
+
+void ImageManager::ResetImageCacheStats()
+{
+    m_cacheStats.m_nHitCount = 0;
+    m_cacheStats.m_nMissCount = 0;
+    m_cacheStats.m_nEvictCount = 0;
+    m_cacheStats.m_nEvictBytes = 0;
+    for (auto& iter : m_cacheStats.m_dpiScaleStats) {
+        iter.second.m_nEvictCount = 0;
+        iter.second.m_nEvictBytes = 0;
+    }
+}
+
 void ImageManager::SetDpiScaleAllImages(bool bEnable)
 {
     m_bDpiScaleAllImages = bEnable;
@@ -237,6 +686,49 @@ bool ImageManager::IsAutoMatchScaleImage() const
     return m_bAutoMatchScaleImage;
 }
 
+void ImageManager::SetLazyDecodeAnimation(bool bLazyDecode)
+{
+    m_bLazyDecodeAnimation = bLazyDecode;
+}
+
+bool ImageManager::IsLazyDecodeAnimation() const
+{
+    return m_bLazyDecodeAnimation;
+}
+
+void ImageManager::SetAnimationFrameCacheBytes(size_t nFrameCacheBytes)
+{
+    m_nAnimationFrameCacheBytes = nFrameCacheBytes;
+}
+
+size_t ImageManager::GetAnimationFrameCacheBytes() const
+{
+    return m_nAnimationFrameCacheBytes;
+}
+
+void ImageManager::SetAsyncLoadImage(bool bAsyncLoad)
+{
+    m_bAsyncLoadImage = bAsyncLoad;
+}
+
+bool ImageManager::IsAsyncLoadImage() const
+{
+    return m_bAsyncLoadImage;
+}
+
+void ImageManager::SetAsyncLoadThreadCount(uint32_t nThreadCount)
+{
+    ASSERT(nThreadCount > 0);
+    if (nThreadCount > 0) {
+        m_nAsyncLoadThreadCount = nThreadCount;
+    }
+}
+
+uint32_t ImageManager::GetAsyncLoadThreadCount() const
+{
+    return m_nAsyncLoadThreadCount;
+}
+
 bool ImageManager::GetDpiScaleImageFullPath(uint32_t dpiScale,
                                             bool bIsUseZip,
                                             const DString& imageFullPath,
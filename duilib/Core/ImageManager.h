@@ -2,10 +2,14 @@
 #define UI_CORE_IMAGEMANAGER_H_
 
 #include "duilib/duilib_defs.h"
+#include "duilib/Core/Callback.h"
 #include <string>
 #include <vector>
+#include <list>
+#include <map>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 
 namespace ui 
 {
@@ -13,6 +17,8 @@ class ImageInfo;
 class ImageLoadAttribute;
 class DpiManager;
 class Window;
+class Control;
+class FrameworkThread;
 
 /** 图片管理器
  */
@@ -28,10 +34,13 @@ public:
     /** 加载图片 ImageInfo 对象
      * @param [in] pWindow 图片关联的窗口（用于DPI缩放、HICON绘制等）
      * @param [in] loadAtrribute 图片的加载属性，包含图片路径等信息     
+     * @param [in] pAsyncControl 请求加载图片的控件，如果不为nullptr并且开启了异步加载功能，则在后台线程中解码图片，
+     *                           此时函数返回nullptr，图片解码完成后，会通知该控件重绘（控件重绘时再次调用本函数即可获取到图片）
      * @return 返回图片 ImageInfo 对象的智能指针
      */
     std::shared_ptr<ImageInfo> GetImage(const Window* pWindow,
-                                        const ImageLoadAttribute& loadAtrribute);
+                                        const ImageLoadAttribute& loadAtrribute,
+                                        Control* pAsyncControl = nullptr);
 
     /** 从缓存中删除所有图片
      */
@@ -56,6 +65,184 @@ public:
     */
     bool IsAutoMatchScaleImage() const;
 
+    /** 某个DPI缩放百分比下的图片缓存统计数据
+    */
+    struct DpiScaleCacheStats
+    {
+        size_t m_nResidentBytes = 0;    //常驻缓存中的图片占用的字节数
+        size_t m_nResidentCount = 0;    //常驻缓存中的图片个数
+        uint64_t m_nEvictCount = 0;     //从常驻缓存中淘汰的图片个数
+        uint64_t m_nEvictBytes = 0;     //从常驻缓存中淘汰的图片字节数
+    };
+
+    /** 图片缓存的统计数据
+    */
+    struct ImageCacheStats
+    {
+        size_t m_nBudgetBytes = 0;      //常驻缓存的内存预算（字节）
+        size_t m_nResidentBytes = 0;    //常驻缓存中的图片占用的字节数
+        size_t m_nResidentCount = 0;    //常驻缓存中的图片个数
+        uint64_t m_nHitCount = 0;       //从缓存中获取到图片的次数
+        uint64_t m_nMissCount = 0;      //缓存中无图片、需要解码图片的次数
+        uint64_t m_nEvictCount = 0;     //从常驻缓存中淘汰的图片个数
+        uint64_t m_nEvictBytes = 0;     //从常驻缓存中淘汰的图片字节数
+
+        /** 按图片加载时的DPI缩放百分比分类的统计数据
+        */
+        std::map<uint32_t, DpiScaleCacheStats> m_dpiScaleStats;
+
+        /** 获取缓存命中率，范围：[0, 1]
+        */
+        double GetHitRate() const
+        {
+            uint64_t nTotal = m_nHitCount + m_nMissCount;
+            return (nTotal > 0) ? ((double)m_nHitCount / (double)nTotal) : 0.0;
+        }
+    };
+
+    /** 设置是否对动画图片（GIF/WebP格式）按需解码图片帧，默认为false
+    *   开启后，加载动画图片时只解码第一帧，其他帧在播放到该帧时才解码，内存占用与动画的帧数无关
+    *  （APNG格式的解码库只支持一次解码所有帧，仍按原方式加载）
+    */
+    void SetLazyDecodeAnimation(bool bLazyDecode);
+
+    /** 判断是否对动画图片按需解码图片帧
+    */
+    bool IsLazyDecodeAnimation() const;
+
+    /** 设置按需解码动画图片帧时，每个动画图片的图片帧位图最多占用的内存（字节），默认为4MB，0表示不限制
+    *   小尺寸的动画（比如加载中的图标）所有帧都能保留，播放时不会反复解码；大尺寸的动画超出限制时，淘汰最久未使用的帧
+    *  （至少保留2帧：当前帧和下一帧）
+    */
+    void SetAnimationFrameCacheBytes(size_t nFrameCacheBytes);
+
+    /** 获取按需解码动画图片帧时，每个动画图片的图片帧位图最多占用的内存（字节）
+    */
+    size_t GetAnimationFrameCacheBytes() const;
+
+    /** 设置图片常驻缓存的内存预算（字节），默认为32MB，设置为0表示关闭常驻缓存
+    *   图片缓存默认只保存弱引用，图片不再被使用时立即释放；常驻缓存对最近使用的图片保持强引用，
+    *   在内存预算范围内按LRU策略淘汰，避免图片反复解码（比如切换TabBox页面、虚表控件回收子项时）
+    */
+    void SetImageCacheBudget(size_t nBudgetBytes);
+
+    /** 获取图片常驻缓存的内存预算（字节）
+    */
+    size_t GetImageCacheBudget() const;
+
+    /** 获取图片缓存的统计数据
+    */
+    void GetImageCacheStats(ImageCacheStats& stats) const;
+
+    /** 图片占用的位图内存发生变化（按需解码的动画图片解码或者淘汰图片帧时调用），更新常驻缓存的内存统计
+    * @param [in] pImageInfo 图片对象，如果不在常驻缓存中则忽略
+    */
+    void OnImageBitmapBytesChanged(const ImageInfo* pImageInfo);
+
+    /** 重置图片缓存的统计数据中的计数（命中、未命中、淘汰次数等）
+    */
+    void ResetImageCacheStats();
+
+    /** 设置是否开启图片异步加载功能，默认为false
+    *   开启后，控件加载图片时，图片在后台线程中解码，解码期间控件不绘制该图片，解码完成后通知控件重绘
+    *   （ICON句柄图片、非UI线程中发起的加载请求，仍然使用同步方式加载）
+    */
+    void SetAsyncLoadImage(bool bAsyncLoad);
+
+    /** 判断是否开启了图片异步加载功能
+    */
+    bool IsAsyncLoadImage() const;
+
+    /** 设置图片异步加载的后台线程个数（在后台线程创建前设置有效），默认为2
+    */
+    void SetAsyncLoadThreadCount(uint32_t nThreadCount);
+
+    /** 获取图片异步加载的后台线程个数
+    */
+    uint32_t GetAsyncLoadThreadCount() const;
+
+private:
+    /** 异步加载图片的任务
+    */
+    struct AsyncLoadTask;
+
+    /** 等待图片异步加载完成的控件
+    */
+    struct AsyncLoadWaiter
+    {
+        Control* m_pControl = nullptr;
+        std::weak_ptr<WeakFlag> m_weakFlag;
+    };
+
+    /** 异步加载完成，等待控件获取的图片
+    */
+    struct AsyncLoadedImage
+    {
+        std::shared_ptr<ImageInfo> m_sharedImage;
+        size_t m_nPendingCount = 0;
+    };
+
+    /** 将加载成功的图片保存到缓存中
+    * @param [in] imageInfo 图片对象
+    * @param [in] loadKey 图片的加载Key
+    * @param [in] nLoadDpiScale 加载图片时的DPI缩放百分比
+    * @param [in] isDpiScaledImageFile 是否使用了DPI自适应的图片文件
+    */
+    std::shared_ptr<ImageInfo> AddImageCache(std::unique_ptr<ImageInfo>& imageInfo,
+                                             const DString& loadKey,
+                                             uint32_t nLoadDpiScale,
+                                             bool isDpiScaledImageFile);
+
+    /** 根据图片的加载Key，从缓存中查找图片
+    */
+    std::shared_ptr<ImageInfo> FindImageCache(const DString& loadKey) const;
+
+    /** 启动异步加载图片的任务（在UI线程中调用）
+    */
+    bool StartAsyncLoad(const std::shared_ptr<AsyncLoadTask>& task);
+
+    /** 添加等待图片加载完成的控件
+    */
+    void AddAsyncLoadWaiter(std::vector<AsyncLoadWaiter>& waiters, Control* pControl);
+
+    /** 在后台线程中解码图片
+    */
+    void DecodeImageTask(const std::shared_ptr<AsyncLoadTask>& task);
+
+    /** 图片解码完成，发布到图片缓存中，并批量通知控件重绘（在UI线程中调用）
+    */
+    void OnAsyncLoadFinished();
+
+    /** 释放异步加载完成后，长时间未被控件获取的图片
+    */
+    void ReleaseAsyncLoadedImages(const std::vector<DString>& loadKeys, uint32_t nGeneration);
+
+    /** 停止后台线程，清除所有异步加载的任务
+    */
+    void ClearAsyncLoad();
+
+    /** 常驻缓存中的图片
+    */
+    struct RetainedImage
+    {
+        std::shared_ptr<ImageInfo> m_sharedImage;
+        size_t m_nBytes = 0;
+        uint32_t m_nDpiScale = 0;
+    };
+    typedef std::list<RetainedImage> RetainedImageList;
+
+    /** 将图片放入常驻缓存（已经存在时，移动到LRU链表头部）
+    */
+    void RetainImage(const std::shared_ptr<ImageInfo>& sharedImage);
+
+    /** 淘汰常驻缓存中最久未使用的图片，直到占用的字节数不超过nBudgetBytes
+    */
+    void TrimRetainedImages(size_t nBudgetBytes);
+
+    /** 清空常驻缓存（不计入淘汰统计）
+    */
+    void ClearRetainedImages();
+
 private:
     /** 图片被销毁的回调函数，用于释放图片资源
      * @param[in] pImageInfo 图片对应的 ImageInfo 对象
@@ -121,6 +308,70 @@ private:
     /** 图片资源Key映射表（图片的加载Key与图片Key）
     */
     std::unordered_map <DString, DString> m_loadKeyMap;
+
+    /** 是否对动画图片按需解码图片帧
+    */
+    bool m_bLazyDecodeAnimation;
+
+    /** 按需解码动画图片帧时，每个动画图片的图片帧位图最多占用的内存（字节）
+    */
+    size_t m_nAnimationFrameCacheBytes;
+
+    /** 图片常驻缓存，按LRU排序，最近使用的在头部
+    */
+    RetainedImageList m_retainedImages;
+
+    /** 图片常驻缓存的索引
+    */
+    std::unordered_map<const ImageInfo*, RetainedImageList::iterator> m_retainedIndex;
+
+    /** 图片常驻缓存的内存预算（字节）
+    */
+    size_t m_nImageCacheBudget;
+
+    /** 图片缓存的统计数据
+    */
+    ImageCacheStats m_cacheStats;
+
+    /** 是否开启图片异步加载功能
+    */
+    bool m_bAsyncLoadImage;
+
+    /** 图片异步加载的后台线程个数
+    */
+    uint32_t m_nAsyncLoadThreadCount;
+
+    /** 图片异步加载的后台线程
+    */
+    std::vector<std::unique_ptr<FrameworkThread>> m_asyncLoadThreads;
+
+    /** 下一个分配任务的后台线程
+    */
+    size_t m_nNextAsyncLoadThread;
+
+    /** 正在加载中的图片（图片的加载Key与等待该图片的控件列表），同一图片的多个加载请求合并为一个任务
+    */
+    std::unordered_map<DString, std::vector<AsyncLoadWaiter>> m_asyncLoadWaiters;
+
+    /** 异步加载完成，等待控件获取的图片（图片的加载Key与图片），在控件获取前保持图片的引用
+    */
+    std::unordered_map<DString, AsyncLoadedImage> m_asyncLoadedImages;
+
+    /** 已经解码完成的任务（后台线程写入，UI线程读取）
+    */
+    std::vector<std::shared_ptr<AsyncLoadTask>> m_asyncLoadResults;
+
+    /** 是否已经向UI线程发送了处理解码结果的任务
+    */
+    bool m_bAsyncLoadFinishPosted;
+
+    /** 解码结果的多线程同步锁
+    */
+    std::mutex m_asyncLoadMutex;
+
+    /** 异步加载的批次号，清除缓存后递增，用于丢弃过期的解码结果
+    */
+    uint32_t m_nAsyncLoadGeneration;
 };
 
 }
@@ -0,0 +1,376 @@
+#include "LayoutBinary.h"
+#include "duilib/Utils/FileUtil.h"
+#include "duilib/third_party/xml/pugixml.hpp"
+#include <filesystem>
+#include <unordered_map>
+#include <cstring>
+
+namespace ui
+{
+
+//预编译文件的标识："DLYB"
+static const uint32_t kLayoutBinaryMagic = 0x42594C44;
+
+//预编译文件的格式版本号，格式变化时需要增加版本号
+static const uint16_t kLayoutBinaryVersion = 1;
+
+//字符串ID：空字符串
+static const uint32_t kEmptyStringId = 0;
+
+/** 文件头
+*/
+struct LayoutBinaryHeader
+{
+    uint32_t nMagic;            //文件标识
+    uint16_t nVersion;          //格式版本号
+    uint16_t nCharSize;         //字符串的字符大小（字节），需要与pugi::char_t一致
+    uint32_t nNodeCount;        //节点个数（含文档节点）
+    uint32_t nAttrCount;        //属性个数
+    uint32_t nStringCount;      //字符串个数
+    uint32_t nStringDataSize;   //字符串数据的长度（字符个数，含结尾的0）
+    uint64_t nSourceSize;       //XML源文件的大小（字节）
+};
+
+/** 节点（按先序遍历的顺序保存）
+*/
+struct LayoutBinaryNode
+{
+    uint32_t nType;             //节点类型（pugi::xml_node_type）
+    uint32_t nNameId;           //名称的字符串ID
+    uint32_t nValueId;          //值的字符串ID
+    uint32_t nFirstAttr;        //第一个属性在属性表中的索引号
+    uint32_t nAttrCount;        //属性个数
+    uint32_t nChildCount;       //子节点个数（子节点紧随其后，按先序遍历的顺序保存）
+};
+
+/** 属性
+*/
+struct LayoutBinaryAttr
+{
+    uint32_t nNameId;           //名称的字符串ID
+    uint32_t nValueId;          //值的字符串ID
+};
+
+/** 编译时使用的字符串表，相同的字符串只保存一份
+*/
+class LayoutStringTable
+{
+public:
+    LayoutStringTable()
+    {
+        //ID为0的字符串为空字符串
+        m_offsets.push_back(0);
+        m_stringData.push_back(0);
+    }
+
+    uint32_t AddString(const pugi::char_t* str)
+    {
+        if ((str == nullptr) || (*str == 0)) {
+            return kEmptyStringId;
+        }
+        std::basic_string<pugi::char_t> key(str);
+        auto iter = m_stringIds.find(key);
+        if (iter != m_stringIds.end()) {
+            return iter->second;
+        }
+        const uint32_t nId = (uint32_t)m_offsets.size();
+        m_offsets.push_back((uint32_t)m_stringData.size());
+        m_stringData.insert(m_stringData.end(), key.c_str(), key.c_str() + key.size() + 1);
+        m_stringIds[key] = nId;
+        return nId;
+    }
+
+    const std::vector<uint32_t>& GetOffsets() const { return m_offsets; }
+    const std::vector<pugi::char_t>& GetStringData() const { return m_stringData; }
+
+private:
+    std::unordered_map<std::basic_string<pugi::char_t>, uint32_t> m_stringIds;
+    std::vector<uint32_t> m_offsets;
+    std::vector<pugi::char_t> m_stringData;
+};
+
+/** 节点类型是否保存在预编译文件中（与WindowBuilder使用的解析选项pugi::parse_default保留的节点类型一致）
+*/
+static bool IsLayoutNodeType(uint32_t nType)
+{
+    return (nType == pugi::node_element) || (nType == pugi::node_pcdata) || (nType == pugi::node_cdata);
+}
+
+/** 按先序遍历的顺序添加节点及其子孙节点
+*/
+static void AddLayoutNode(const pugi::xml_node& xmlNode,
+                          LayoutStringTable& stringTable,
+                          std::vector<LayoutBinaryNode>& nodes,
+                          std::vector<LayoutBinaryAttr>& attrs)
+{
+    const size_t nNodeIndex = nodes.size();
+    LayoutBinaryNode node;
+    node.nType = (uint32_t)xmlNode.type();
+    node.nNameId = stringTable.AddString(xmlNode.name());
+    node.nValueId = stringTable.AddString(xmlNode.value());
+    node.nFirstAttr = (uint32_t)attrs.size();
+    node.nAttrCount = 0;
+    node.nChildCount = 0;
+    for (pugi::xml_attribute xmlAttr : xmlNode.attributes()) {
+        LayoutBinaryAttr attr;
+        attr.nNameId = stringTable.AddString(xmlAttr.name());
+        attr.nValueId = stringTable.AddString(xmlAttr.value());
+        attrs.push_back(attr);
+        ++node.nAttrCount;
+    }
+    nodes.push_back(node);
+
+    uint32_t nChildCount = 0;
+    for (pugi::xml_node xmlChild : xmlNode.children()) {
+        if (!IsLayoutNodeType((uint32_t)xmlChild.type())) {
+            continue;
+        }
+        AddLayoutNode(xmlChild, stringTable, nodes, attrs);
+        ++nChildCount;
+    }
+    nodes[nNodeIndex].nChildCount = nChildCount;
+}
+
+/** 将数组追加到二进制数据中
+*/
+template<typename T>
+static void AppendLayoutData(std::vector<uint8_t>& binData, const T* pData, size_t nCount)
+{
+    if (nCount > 0) {
+        const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pData);
+        binData.insert(binData.end(), pBytes, pBytes + nCount * sizeof(T));
+    }
+}
+
+FilePath LayoutBinary::GetBinaryFilePath(const FilePath& xmlFilePath)
+{
+    FilePath binFilePath(xmlFilePath);
+    binFilePath += DString(_T(".bin"));
+    return binFilePath;
+}
+
+bool LayoutBinary::Compile(const pugi::xml_document& xmlDoc, uint64_t nSourceSize, std::vector<uint8_t>& binData)
+{
+    binData.clear();
+    LayoutStringTable stringTable;
+    std::vector<LayoutBinaryNode> nodes;
+    std::vector<LayoutBinaryAttr> attrs;
+    AddLayoutNode(xmlDoc, stringTable, nodes, attrs);
+    ASSERT(!nodes.empty() && (nodes[0].nType == pugi::node_document));
+    if (nodes.empty() || (nodes[0].nType != pugi::node_document)) {
+        return false;
+    }
+
+    const std::vector<uint32_t>& offsets = stringTable.GetOffsets();
+    std::vector<pugi::char_t> stringData = stringTable.GetStringData();
+    //字符串数据补齐到4字节对齐，使文件长度为4的整数倍
+    while (((stringData.size() * sizeof(pugi::char_t)) % sizeof(uint32_t)) != 0) {
+        stringData.push_back(0);
+    }
+
+    LayoutBinaryHeader header;
+    header.nMagic = kLayoutBinaryMagic;
+    header.nVersion = kLayoutBinaryVersion;
+    header.nCharSize = (uint16_t)sizeof(pugi::char_t);
+    header.nNodeCount = (uint32_t)nodes.size();
+    header.nAttrCount = (uint32_t)attrs.size();
+    header.nStringCount = (uint32_t)offsets.size();
+    header.nStringDataSize = (uint32_t)stringData.size();
+    header.nSourceSize = nSourceSize;
+
+    binData.reserve(sizeof(header) +
+                    nodes.size() * sizeof(LayoutBinaryNode) +
+                    attrs.size() * sizeof(LayoutBinaryAttr) +
+                    offsets.size() * sizeof(uint32_t) +
+                    stringData.size() * sizeof(pugi::char_t));
+    AppendLayoutData(binData, &header, 1);
+    AppendLayoutData(binData, nodes.data(), nodes.size());
+    AppendLayoutData(binData, attrs.data(), attrs.size());
+    AppendLayoutData(binData, offsets.data(), offsets.size());
+    AppendLayoutData(binData, stringData.data(), stringData.size());
+    return true;
+}
+
+bool LayoutBinary::CompileFile(const FilePath& xmlFilePath, const FilePath& binFilePath)
+{
+    std::vector<uint8_t> xmlFileData;
+    if (!FileUtil::ReadFileData(xmlFilePath, xmlFileData) || xmlFileData.empty()) {
+        return false;
+    }
+    //解析选项与WindowBuilder加载XML文件时一致
+    pugi::xml_document xmlDoc;
+    pugi::xml_parse_result result = xmlDoc.load_buffer(xmlFileData.data(), xmlFileData.size());
+    if (result.status != pugi::status_ok) {
+        return false;
+    }
+    std::vector<uint8_t> binData;
+    if (!Compile(xmlDoc, xmlFileData.size(), binData)) {
+        return false;
+    }
+    return FileUtil::WriteFileData(binFilePath.IsEmpty() ? GetBinaryFilePath(xmlFilePath) : binFilePath, binData);
+}
+
+bool LayoutBinary::Load(const uint8_t* pData, size_t nDataSize, uint64_t nSourceSize, pugi::xml_document& xmlDoc)
+{
+    xmlDoc.reset();
+    if ((pData == nullptr) || (nDataSize < sizeof(LayoutBinaryHeader))) {
+        return false;
+    }
+    //压缩包中未压缩存储的文件，数据的起始地址不一定对齐，需要复制后再读取
+    std::vector<uint64_t> alignedData;
+    if ((reinterpret_cast<uintptr_t>(pData) % alignof(uint64_t)) != 0) {
+        alignedData.resize((nDataSize + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        ::memcpy(alignedData.data(), pData, nDataSize);
+        pData = reinterpret_cast<const uint8_t*>(alignedData.data());
+    }
+
+    //检查文件头和各部分的长度
+    const LayoutBinaryHeader* pHeader = reinterpret_cast<const LayoutBinaryHeader*>(pData);
+    if ((pHeader->nMagic != kLayoutBinaryMagic) ||
+        (pHeader->nVersion != kLayoutBinaryVersion) ||
+        (pHeader->nCharSize != sizeof(pugi::char_t)) ||
+        (pHeader->nNodeCount == 0) ||
+        (pHeader->nStringCount == 0) ||
+        (pHeader->nStringDataSize == 0)) {
+        return false;
+    }
+    if ((nSourceSize != 0) && (pHeader->nSourceSize != nSourceSize)) {
+        //XML文件已经修改过，预编译文件已经过期
+        return false;
+    }
+    const uint64_t nExpectedSize = sizeof(LayoutBinaryHeader) +
+                                   (uint64_t)pHeader->nNodeCount * sizeof(LayoutBinaryNode) +
+                                   (uint64_t)pHeader->nAttrCount * sizeof(LayoutBinaryAttr) +
+                                   (uint64_t)pHeader->nStringCount * sizeof(uint32_t) +
+                                   (uint64_t)pHeader->nStringDataSize * sizeof(pugi::char_t);
+    if (nExpectedSize != nDataSize) {
+        return false;
+    }
+    const LayoutBinaryNode* pNodes = reinterpret_cast<const LayoutBinaryNode*>(pData + sizeof(LayoutBinaryHeader));
+    const LayoutBinaryAttr* pAttrs = reinterpret_cast<const LayoutBinaryAttr*>(pNodes + pHeader->nNodeCount);
+    const uint32_t* pOffsets = reinterpret_cast<const uint32_t*>(pAttrs + pHeader->nAttrCount);
+    const pugi::char_t* pStringData = reinterpret_cast<const pugi::char_t*>(pOffsets + pHeader->nStringCount);
+    const uint32_t nStringCount = pHeader->nStringCount;
+    const uint32_t nStringDataSize = pHeader->nStringDataSize;
+    if (pStringData[nStringDataSize - 1] != 0) {
+        return false;
+    }
+    //检查字符串偏移：递增，都在字符串数据范围内，并且每个字符串都以0结尾（下一个字符串的前一个字符为0）
+    for (uint32_t nId = 0; nId < nStringCount; ++nId) {
+        if ((pOffsets[nId] >= nStringDataSize) || ((nId > 0) && (pOffsets[nId] <= pOffsets[nId - 1]))) {
+            return false;
+        }
+        if ((nId > 0) && (pStringData[pOffsets[nId] - 1] != 0)) {
+            return false;
+        }
+    }
+    //获取字符串及其长度：每个字符串以0结尾，长度为到下一个字符串起始位置的字符个数减1（最后一个字符串之后可能有补齐的0）
+    auto getString = [pOffsets, pStringData, nStringCount, nStringDataSize](uint32_t nId, size_t& nLength) -> const pugi::char_t* {
+            const pugi::char_t* pString = pStringData + pOffsets[nId];
+            if (nId + 1 < nStringCount) {
+                nLength = pOffsets[nId + 1] - pOffsets[nId] - 1;
+            }
+            else {
+                nLength = 0;
+                while ((pOffsets[nId] + nLength < nStringDataSize) && (pString[nLength] != 0)) {
+                    ++nLength;
+                }
+            }
+            return pString;
+        };
+
+    const LayoutBinaryNode& docNode = pNodes[0];
+    if ((docNode.nType != pugi::node_document) || (docNode.nAttrCount != 0)) {
+        return false;
+    }
+    //按先序遍历的顺序重建节点：栈中保存父节点及其剩余未创建的子节点个数
+    struct ParentItem
+    {
+        pugi::xml_node xmlNode;
+        uint32_t nRemainCount;
+    };
+    std::vector<ParentItem> parentStack;
+    if (docNode.nChildCount > 0) {
+        parentStack.push_back({ xmlDoc, docNode.nChildCount });
+    }
+    bool bValid = true;
+    uint32_t nNodeIndex = 1;
+    for (; bValid && (nNodeIndex < pHeader->nNodeCount) && !parentStack.empty(); ++nNodeIndex) {
+        const LayoutBinaryNode& node = pNodes[nNodeIndex];
+        if (!IsLayoutNodeType(node.nType) ||
+            (node.nNameId >= nStringCount) ||
+            (node.nValueId >= nStringCount) ||
+            (node.nFirstAttr > pHeader->nAttrCount) ||
+            (node.nAttrCount > (pHeader->nAttrCount - node.nFirstAttr))) {
+            bValid = false;
+            break;
+        }
+        ParentItem& parentItem = parentStack.back();
+        pugi::xml_node xmlNode = parentItem.xmlNode.append_child((pugi::xml_node_type)node.nType);
+        --parentItem.nRemainCount;
+        size_t nLength = 0;
+        const pugi::char_t* pString = nullptr;
+        if (node.nNameId != kEmptyStringId) {
+            pString = getString(node.nNameId, nLength);
+            bValid = xmlNode.set_name(pString, nLength);
+        }
+        if (bValid && (node.nValueId != kEmptyStringId)) {
+            pString = getString(node.nValueId, nLength);
+            bValid = xmlNode.set_value(pString, nLength);
+        }
+        for (uint32_t nAttr = node.nFirstAttr; bValid && (nAttr < node.nFirstAttr + node.nAttrCount); ++nAttr) {
+            const LayoutBinaryAttr& attr = pAttrs[nAttr];
+            if ((attr.nNameId >= nStringCount) || (attr.nValueId >= nStringCount)) {
+                bValid = false;
+                break;
+            }
+            pugi::xml_attribute xmlAttr = xmlNode.append_attribute(PUGIXML_TEXT(""));
+            pString = getString(attr.nNameId, nLength);
+            bValid = xmlAttr.set_name(pString, nLength);
+            if (bValid) {
+                pString = getString(attr.nValueId, nLength);
+                bValid = xmlAttr.set_value(pString, nLength);
+            }
+        }
+        if (!bValid) {
+            break;
+        }
+        //出栈已经创建完所有子节点的父节点，然后入栈当前节点
+        while (!parentStack.empty() && (parentStack.back().nRemainCount == 0)) {
+            parentStack.pop_back();
+        }
+        if (node.nChildCount > 0) {
+            parentStack.push_back({ xmlNode, node.nChildCount });
+        }
+    }
+    //所有节点都已创建，并且节点个数与子节点个数一致
+    if (!bValid || !parentStack.empty() || (nNodeIndex != pHeader->nNodeCount)) {
+        xmlDoc.reset();
+        return false;
+    }
+    return true;
+}
+
+bool LayoutBinary::IsBinaryFileUpToDate(const FilePath& xmlFilePath, const FilePath& binFilePath, uint64_t& nSourceSize)
+{
+    nSourceSize = 0;
+    std::error_code errorCode;
+    const std::filesystem::path xmlPath(xmlFilePath.ToStringW());
+    const std::filesystem::path binPath(binFilePath.ToStringW());
+    const std::filesystem::file_time_type binTime = std::filesystem::last_write_time(binPath, errorCode);
+    if (errorCode) {
+        return false;
+    }
+    const std::filesystem::file_time_type xmlTime = std::filesystem::last_write_time(xmlPath, errorCode);
+    if (errorCode || (xmlTime > binTime)) {
+        return false;
+    }
+    const uintmax_t nFileSize = std::filesystem::file_size(xmlPath, errorCode);
+    if (errorCode) {
+        return false;
+    }
+    nSourceSize = (uint64_t)nFileSize;
+    return true;
+}
+
+} // namespace ui
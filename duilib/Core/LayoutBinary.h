@@ -0,0 +1,65 @@
+#ifndef UI_CORE_LAYOUT_BINARY_H_
+#define UI_CORE_LAYOUT_BINARY_H_
+
+#include "duilib/Utils/FilePath.h"
+#include <vector>
+
+namespace pugi
+{
+    //XML 解析器相关定义
+    class xml_document;
+}
+
+namespace ui
+{
+
+/** 预编译的二进制布局文件：将XML布局文件离线转换为扁平的二进制格式，加载时不需要解析XML文本
+*   文件结构（数值按本机字节序保存，各部分4字节对齐，可直接映射到内存中读取）：
+*       [文件头][节点表][属性表][字符串偏移表][字符串数据]
+*   (1) 节点表按先序遍历的顺序保存，第一个节点为文档节点，每个节点记录类型、名称、值、属性范围和子节点个数
+*   (2) 节点名称、属性名称和属性值合并为字符串表，相同的字符串只保存一份，以0结尾
+*   (3) 字符串按pugixml的字符类型保存（Unicode版本为UTF-16），加载时不需要转换编码，也不需要处理转义字符
+*   (4) 只保存解析XML时保留的节点（元素、文本、CDATA），注释等节点在编译时已经去除
+*   预编译文件与XML文件放在同一目录，文件名为XML文件名加".bin"后缀（比如：main.xml -> main.xml.bin），
+*   WindowBuilder加载XML文件时，如果存在可用的预编译文件，优先加载预编译文件
+*/
+class UILIB_API LayoutBinary
+{
+public:
+    /** 获取XML文件对应的预编译文件路径
+    * @param [in] xmlFilePath XML文件路径
+    */
+    static FilePath GetBinaryFilePath(const FilePath& xmlFilePath);
+
+    /** 将已解析的XML文档编译为二进制布局数据
+    * @param [in] xmlDoc 已解析的XML文档（解析选项需与WindowBuilder一致：pugi::parse_default）
+    * @param [in] nSourceSize XML源文件的大小（字节），加载本地文件时用于检查预编译文件是否过期
+    * @param [out] binData 返回二进制布局数据
+    */
+    static bool Compile(const pugi::xml_document& xmlDoc, uint64_t nSourceSize, std::vector<uint8_t>& binData);
+
+    /** 编译XML文件，并保存为预编译文件
+    * @param [in] xmlFilePath XML文件路径(绝对路径)
+    * @param [in] binFilePath 预编译文件的保存路径，如果为空，则保存到GetBinaryFilePath(xmlFilePath)
+    */
+    static bool CompileFile(const FilePath& xmlFilePath, const FilePath& binFilePath = FilePath());
+
+    /** 从二进制布局数据创建XML文档
+    * @param [in] pData 二进制布局数据
+    * @param [in] nDataSize 数据长度（字节）
+    * @param [in] nSourceSize 如果不为0，需要与编译时的XML源文件大小一致，否则认为预编译文件已过期
+    * @param [out] xmlDoc 返回XML文档，失败时为空文档
+    */
+    static bool Load(const uint8_t* pData, size_t nDataSize, uint64_t nSourceSize, pugi::xml_document& xmlDoc);
+
+    /** 检查本地的预编译文件是否可用（预编译文件存在，并且XML文件在编译后未修改过）
+    * @param [in] xmlFilePath XML文件路径(绝对路径)
+    * @param [in] binFilePath 预编译文件路径(绝对路径)
+    * @param [out] nSourceSize 返回XML文件的大小（字节）
+    */
+    static bool IsBinaryFileUpToDate(const FilePath& xmlFilePath, const FilePath& binFilePath, uint64_t& nSourceSize);
+};
+
+} // namespace ui
+
+#endif // UI_CORE_LAYOUT_BINARY_H_
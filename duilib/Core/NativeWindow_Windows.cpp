@@ -1106,6 +1106,16 @@ public:
     {
         return m_pNativeWindow->GetLayeredWindowAlpha();
     }
+
+    /** 回调接口，获取DoPaint实际重绘的区域
+    */
+    virtual bool GetPaintedRects(std::vector<UiRect>& paintedRects) override
+    {
+        if (m_pOwner != nullptr) {
+            return m_pOwner->OnNativeGetPaintedRects(paintedRects);
+        }
+        return false;
+    }
 };
 
 LRESULT NativeWindow_Windows::OnPaintMsg(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled)
@@ -0,0 +1,97 @@
+#include "PaintItemIndex.h"
+#include "duilib/Core/Control.h"
+#include <algorithm>
+
+namespace ui
+{
+
+PaintItemIndex::PaintItemIndex():
+    m_bVertical(true),
+    m_bDirty(true),
+    m_bValid(false)
+{
+}
+
+void PaintItemIndex::Clear()
+{
+    m_orderedItems.clear();
+    m_itemStarts.clear();
+    m_itemEnds.clear();
+    m_tailItems.clear();
+    m_delayItems.clear();
+    m_bDirty = true;
+    m_bValid = false;
+}
+
+bool PaintItemIndex::Rebuild(const std::vector<Control*>& items, bool bVertical)
+{
+    Clear();
+    m_bDirty = false;
+    m_bVertical = bVertical;
+
+    //绘制顺序与逐个绘制时保持一致：未设置绘制顺序的子控件按原顺序，然后是设置了绘制顺序的子控件
+    //浮动控件的位置不受布局控制，从第一个可见的浮动控件开始，剩余的子控件都按原顺序逐个绘制
+    bool bTail = false;
+    int32_t nMaxEnd = 0;
+    for (Control* pControl : items) {
+        if (pControl == nullptr) {
+            continue;
+        }
+        if (pControl->GetPaintOrder() != 0) {
+            if (pControl->IsVisible()) {
+                m_delayItems.push_back(pControl);
+            }
+            continue;
+        }
+        if (!bTail && pControl->IsVisible() && pControl->IsFloat()) {
+            bTail = true;
+        }
+        if (bTail) {
+            m_tailItems.push_back(pControl);
+            continue;
+        }
+        if (!pControl->IsVisible()) {
+            continue;
+        }
+        const UiRect& rc = pControl->GetRect();
+        const int32_t nStart = bVertical ? rc.top : rc.left;
+        const int32_t nEnd = bVertical ? rc.bottom : rc.right;
+        if (!m_itemStarts.empty() && (nStart < m_itemStarts.back())) {
+            //子控件不是有序排列的，不能使用索引
+            Clear();
+            m_bDirty = false;
+            return false;
+        }
+        nMaxEnd = m_orderedItems.empty() ? nEnd : std::max(nMaxEnd, nEnd);
+        m_orderedItems.push_back(pControl);
+        m_itemStarts.push_back(nStart);
+        m_itemEnds.push_back(nMaxEnd);
+    }
+    if (!m_delayItems.empty()) {
+        std::stable_sort(m_delayItems.begin(), m_delayItems.end(), [](const Control* a, const Control* b) {
+            return a->GetPaintOrder() < b->GetPaintOrder();
+            });
+    }
+    m_bValid = true;
+    return true;
+}
+
+void PaintItemIndex::GetVisibleRange(const UiRect& rcPaint, size_t& nBegin, size_t& nEnd) const
+{
+    nBegin = 0;
+    nEnd = 0;
+    if (!IsValid() || m_orderedItems.empty()) {
+        return;
+    }
+    const int32_t nPaintStart = m_bVertical ? rcPaint.top : rcPaint.left;
+    const int32_t nPaintEnd = m_bVertical ? rcPaint.bottom : rcPaint.right;
+    //起始位置：第一个结束坐标（前缀最大值）大于绘制区域起始坐标的子控件，之前的子控件都在绘制区域之前
+    nBegin = std::upper_bound(m_itemEnds.begin(), m_itemEnds.end(), nPaintStart) - m_itemEnds.begin();
+    //结束位置：第一个起始坐标不小于绘制区域结束坐标的子控件，之后的子控件都在绘制区域之后
+    nEnd = std::lower_bound(m_itemStarts.begin(), m_itemStarts.end(), nPaintEnd) - m_itemStarts.begin();
+    if (nBegin > nEnd) {
+        nBegin = nEnd;
+    }
+}
+
+} // namespace ui
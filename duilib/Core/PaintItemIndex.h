@@ -0,0 +1,100 @@
+#ifndef UI_CORE_PAINT_ITEM_INDEX_H_
+#define UI_CORE_PAINT_ITEM_INDEX_H_
+
+#include "duilib/Core/UiRect.h"
+#include <vector>
+
+namespace ui
+{
+class Control;
+
+/** 容器子控件的绘制索引：子控件沿纵向（或横向）依次排列时（如VLayout、HLayout、瓦片布局），
+*   按子控件的位置有序保存，绘制时通过二分查找得到与绘制区域相交的子控件范围，只绘制该范围内的子控件
+*   子控件位置、可见性、浮动属性、绘制顺序或者子控件列表变化时，需要标记为脏，下次绘制前重建
+*   注意：只能在UI线程中使用
+*/
+class PaintItemIndex
+{
+public:
+    PaintItemIndex();
+    PaintItemIndex(const PaintItemIndex&) = delete;
+    PaintItemIndex& operator = (const PaintItemIndex&) = delete;
+
+public:
+    /** 标记索引需要重建
+    */
+    void SetDirty() { m_bDirty = true; }
+
+    /** 索引是否需要重建
+    */
+    bool IsDirty() const { return m_bDirty; }
+
+    /** 根据子控件列表重建索引
+    * @param [in] items 子控件列表
+    * @param [in] bVertical true表示子控件沿纵向排列，false表示子控件沿横向排列
+    * @return 如果子控件不是按排列方向有序的，返回false，此时应逐个绘制子控件
+    */
+    bool Rebuild(const std::vector<Control*>& items, bool bVertical);
+
+    /** 索引是否可用
+    */
+    bool IsValid() const { return m_bValid && !m_bDirty; }
+
+    /** 获取与绘制区域相交的有序子控件范围：[nBegin, nEnd)，范围内的子控件仍需检查是否与绘制区域相交
+    * @param [in] rcPaint 绘制区域（与子控件的GetRect()为同一坐标系）
+    */
+    void GetVisibleRange(const UiRect& rcPaint, size_t& nBegin, size_t& nEnd) const;
+
+    /** 按位置有序排列的子控件（可见的、非浮动的、未设置绘制顺序的子控件）
+    */
+    const std::vector<Control*>& GetOrderedItems() const { return m_orderedItems; }
+
+    /** 需要在有序子控件之后按原顺序绘制的子控件（从第一个浮动控件开始，未设置绘制顺序的子控件）
+    */
+    const std::vector<Control*>& GetTailItems() const { return m_tailItems; }
+
+    /** 设置了绘制顺序的子控件（已按绘制顺序排序）
+    */
+    const std::vector<Control*>& GetDelayItems() const { return m_delayItems; }
+
+    /** 清除索引
+    */
+    void Clear();
+
+private:
+    /** 有序的子控件
+    */
+    std::vector<Control*> m_orderedItems;
+
+    /** 有序子控件在排列方向上的起始坐标（纵向为top，横向为left），非递减
+    */
+    std::vector<int32_t> m_itemStarts;
+
+    /** 有序子控件在排列方向上结束坐标（纵向为bottom，横向为right）的前缀最大值，非递减
+    */
+    std::vector<int32_t> m_itemEnds;
+
+    /** 在有序子控件之后绘制的子控件
+    */
+    std::vector<Control*> m_tailItems;
+
+    /** 设置了绘制顺序的子控件
+    */
+    std::vector<Control*> m_delayItems;
+
+    /** 子控件是否沿纵向排列
+    */
+    bool m_bVertical;
+
+    /** 索引是否需要重建
+    */
+    bool m_bDirty;
+
+    /** 索引是否可用
+    */
+    bool m_bValid;
+};
+
+} // namespace ui
+
+#endif // UI_CORE_PAINT_ITEM_INDEX_H_
@@ -76,6 +76,9 @@ void PlaceHolder::SetParent(Box* pParent)
 
 void PlaceHolder::SetWindow(Window* pWindow)
 {
+    if ((m_pWindow != nullptr) && (m_pWindow != pWindow)) {
+        m_pWindow->RemoveArrangeControl(this);
+    }
     m_pWindow = pWindow;
 }
 
@@ -99,6 +102,9 @@ void PlaceHolder::OnInit()
 
 void PlaceHolder::SetVisible(bool bVisible)
 {
+    if ((m_bVisible != bVisible) && (m_pParent != nullptr)) {
+        m_pParent->SetChildIndexDirty();
+    }
     m_bVisible = bVisible;
 }
 
@@ -108,6 +114,9 @@ void PlaceHolder::SetFloat(bool bFloat)
         return;
     }
     m_bFloat = bFloat;
+    if (m_pParent != nullptr) {
+        m_pParent->SetChildIndexDirty();
+    }
     ArrangeAncestor();
 }
 
@@ -473,7 +482,8 @@ void PlaceHolder::ArrangeSelf()
     Invalidate();
 
     if (m_pWindow != nullptr) {
-        m_pWindow->SetArrange(true);
+        //加入窗口的布局队列，在下次布局时统一处理，避免每次布局都遍历整个控件树
+        m_pWindow->AddArrangeControl(this);
     }
 }
 
@@ -503,6 +513,10 @@ void PlaceHolder::SetRect(const UiRect& rc)
     if (!m_uiRect.Equals(rc)) {
         //区域变化，标注绘制缓存脏标记位
         SetCacheDirty(true);
+        //父容器的子控件索引需要重建
+        if (m_pParent != nullptr) {
+            m_pParent->SetChildIndexDirty();
+        }
     }
     m_uiRect = rc;    
 }
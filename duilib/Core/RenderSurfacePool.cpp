@@ -0,0 +1,183 @@
+#include "RenderSurfacePool.h"
+#include "duilib/Core/GlobalManager.h"
+
+namespace ui
+{
+
+//画布宽高的对齐粒度（像素），同一分组内的画布可以复用
+static const int32_t kSizeAlignment = 64;
+
+//池中空闲绘制引擎最多占用的内存，默认值（字节）
+static const size_t kDefaultMaxBytes = 32 * 1024 * 1024;
+
+//空闲绘制引擎超过该时间未被使用时，自动释放（毫秒）
+static const int32_t kIdleTrimMs = 10 * 1000;
+
+RenderSurfacePool::RenderSurfacePool():
+    m_nMaxBytes(kDefaultMaxBytes)
+{
+}
+
+RenderSurfacePool::~RenderSurfacePool()
+{
+    Clear();
+}
+
+int32_t RenderSurfacePool::AlignSize(int32_t nSize)
+{
+    return (nSize + kSizeAlignment - 1) / kSizeAlignment * kSizeAlignment;
+}
+
+size_t RenderSurfacePool::GetRenderBytes(const IRender* pRender)
+{
+    if (pRender == nullptr) {
+        return 0;
+    }
+    return (size_t)pRender->GetWidth() * (size_t)pRender->GetHeight() * sizeof(uint32_t);
+}
+
+std::unique_ptr<IRender> RenderSurfacePool::AcquireRender(int32_t nWidth, int32_t nHeight, const IRenderDpiPtr& spRenderDpi)
+{
+    GlobalManager::Instance().AssertUIThread();
+    ASSERT((nWidth > 0) && (nHeight > 0));
+    if ((nWidth <= 0) || (nHeight <= 0)) {
+        return nullptr;
+    }
+    m_stats.m_nAcquireCount++;
+    const int32_t nAlignWidth = AlignSize(nWidth);
+    const int32_t nAlignHeight = AlignSize(nHeight);
+
+    //优先复用同一分组中最近放回的绘制引擎
+    for (auto iter = m_pooledRenders.begin(); iter != m_pooledRenders.end(); ++iter) {
+        IRender* pRender = iter->m_spRender.get();
+        if ((pRender->GetWidth() == nAlignWidth) && (pRender->GetHeight() == nAlignHeight)) {
+            std::unique_ptr<IRender> spRender = std::move(iter->m_spRender);
+            m_pooledRenders.erase(iter);
+            m_stats.m_nReuseCount++;
+            m_stats.m_nPooledCount--;
+            m_stats.m_nPooledBytes -= GetRenderBytes(spRender.get());
+            spRender->SetRenderDpi(spRenderDpi);
+            return spRender;
+        }
+    }
+
+    std::unique_ptr<IRender> spRender;
+    IRenderFactory* pRenderFactory = GlobalManager::Instance().GetRenderFactory();
+    ASSERT(pRenderFactory != nullptr);
+    if (pRenderFactory != nullptr) {
+        spRender.reset(pRenderFactory->CreateRender(spRenderDpi));
+    }
+    ASSERT(spRender != nullptr);
+    if (spRender == nullptr) {
+        return nullptr;
+    }
+    if (!spRender->Resize(nAlignWidth, nAlignHeight)) {
+        ASSERT(!"RenderSurfacePool: Resize failed!");
+        return nullptr;
+    }
+    m_stats.m_nCreateCount++;
+    return spRender;
+}
+
+void RenderSurfacePool::ReleaseRender(std::unique_ptr<IRender>& spRender)
+{
+    GlobalManager::Instance().AssertUIThread();
+    if (spRender == nullptr) {
+        return;
+    }
+    const size_t nBytes = GetRenderBytes(spRender.get());
+    if ((nBytes == 0) || (nBytes > m_nMaxBytes)) {
+        //不复用
+        spRender.reset();
+        return;
+    }
+    PooledRender pooledRender;
+    pooledRender.m_spRender = std::move(spRender);
+    pooledRender.m_releaseTime = std::chrono::steady_clock::now();
+    m_pooledRenders.push_front(std::move(pooledRender));
+    m_stats.m_nPooledCount++;
+    m_stats.m_nPooledBytes += nBytes;
+
+    TrimToSize(m_nMaxBytes);
+    StartIdleTrim();
+}
+
+void RenderSurfacePool::SetMaxBytes(size_t nMaxBytes)
+{
+    m_nMaxBytes = nMaxBytes;
+    TrimToSize(m_nMaxBytes);
+}
+
+size_t RenderSurfacePool::GetMaxBytes() const
+{
+    return m_nMaxBytes;
+}
+
+void RenderSurfacePool::Clear()
+{
+    m_idleTrimFlag.Cancel();
+    m_pooledRenders.clear();
+    m_stats.m_nPooledCount = 0;
+    m_stats.m_nPooledBytes = 0;
+}
+
+const RenderSurfacePool::Stats& RenderSurfacePool::GetStats() const
+{
+    return m_stats;
+}
+
+void RenderSurfacePool::ResetStats()
+{
+    m_stats.m_nAcquireCount = 0;
+    m_stats.m_nReuseCount = 0;
+    m_stats.m_nCreateCount = 0;
+    m_stats.m_nTrimCount = 0;
+}
+
+void RenderSurfacePool::TrimToSize(size_t nMaxBytes)
+{
+    while (!m_pooledRenders.empty() && (m_stats.m_nPooledBytes > nMaxBytes)) {
+        const size_t nBytes = GetRenderBytes(m_pooledRenders.back().m_spRender.get());
+        m_pooledRenders.pop_back();
+        m_stats.m_nPooledCount--;
+        m_stats.m_nPooledBytes -= nBytes;
+        m_stats.m_nTrimCount++;
+    }
+}
+
+void RenderSurfacePool::TrimIdleRenders()
+{
+    m_idleTrimFlag.Cancel();
+    const auto nowTime = std::chrono::steady_clock::now();
+    while (!m_pooledRenders.empty()) {
+        const PooledRender& pooledRender = m_pooledRenders.back();
+        auto idleTime = std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - pooledRender.m_releaseTime);
+        if (idleTime.count() < kIdleTrimMs) {
+            break;
+        }
+        const size_t nBytes = GetRenderBytes(pooledRender.m_spRender.get());
+        m_pooledRenders.pop_back();
+        m_stats.m_nPooledCount--;
+        m_stats.m_nPooledBytes -= nBytes;
+        m_stats.m_nTrimCount++;
+    }
+    if (!m_pooledRenders.empty()) {
+        StartIdleTrim();
+    }
+}
+
+void RenderSurfacePool::StartIdleTrim()
+{
+    if (m_idleTrimFlag.HasUsed()) {
+        //已经启动
+        return;
+    }
+    std::weak_ptr<WeakFlag> weakFlag = m_idleTrimFlag.GetWeakFlag();
+    GlobalManager::Instance().Thread().PostDelayedTask(kThreadUI, [this, weakFlag]() {
+            if (!weakFlag.expired()) {
+                TrimIdleRenders();
+            }
+        }, kIdleTrimMs);
+}
+
+} // namespace ui
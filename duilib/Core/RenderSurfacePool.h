@@ -0,0 +1,135 @@
+#ifndef UI_CORE_RENDER_SURFACE_POOL_H_
+#define UI_CORE_RENDER_SURFACE_POOL_H_
+
+#include "duilib/Render/IRender.h"
+#include "duilib/Core/Callback.h"
+#include <list>
+#include <chrono>
+
+namespace ui
+{
+
+/** 离屏绘制引擎（IRender）的复用池，每个窗口一个
+*   控件设置透明度或者使用绘制缓存时，需要一个与控件大小相同的离屏绘制引擎，
+*   为避免每次绘制都创建和释放画布，空闲的绘制引擎按大小分组（宽高按固定粒度向上对齐）保存在池中复用，
+*   池中空闲绘制引擎占用的内存超过限制时，淘汰最久未使用的；长时间未使用的，空闲时自动释放
+*   注意：只能在UI线程中使用
+*/
+class RenderSurfacePool: public SupportWeakCallback
+{
+public:
+    RenderSurfacePool();
+    virtual ~RenderSurfacePool() override;
+    RenderSurfacePool(const RenderSurfacePool&) = delete;
+    RenderSurfacePool& operator = (const RenderSurfacePool&) = delete;
+
+public:
+    /** 获取一个离屏绘制引擎，画布大小不小于指定的大小（画布的原有内容是不确定的）
+    * @param [in] nWidth 需要的宽度
+    * @param [in] nHeight 需要的高度
+    * @param [in] spRenderDpi 绘制引擎的DPI接口
+    * @return 成功返回绘制引擎，使用完成后，应调用ReleaseRender放回池中
+    */
+    std::unique_ptr<IRender> AcquireRender(int32_t nWidth, int32_t nHeight, const IRenderDpiPtr& spRenderDpi);
+
+    /** 将不再使用的离屏绘制引擎放回池中
+    * @param [in] spRender 由AcquireRender返回的绘制引擎，调用后被置为空
+    */
+    void ReleaseRender(std::unique_ptr<IRender>& spRender);
+
+    /** 设置池中空闲绘制引擎最多占用的内存（字节），为0表示不复用
+    */
+    void SetMaxBytes(size_t nMaxBytes);
+
+    /** 获取池中空闲绘制引擎最多占用的内存（字节）
+    */
+    size_t GetMaxBytes() const;
+
+    /** 释放池中所有空闲的绘制引擎
+    */
+    void Clear();
+
+    /** 复用池的统计数据
+    */
+    struct Stats
+    {
+        //获取绘制引擎的次数
+        size_t m_nAcquireCount = 0;
+
+        //从池中复用的次数（即避免创建绘制引擎的次数）
+        size_t m_nReuseCount = 0;
+
+        //创建绘制引擎的次数
+        size_t m_nCreateCount = 0;
+
+        //因超出内存限制或者空闲超时而释放的绘制引擎个数
+        size_t m_nTrimCount = 0;
+
+        //当前池中空闲的绘制引擎个数
+        size_t m_nPooledCount = 0;
+
+        //当前池中空闲的绘制引擎占用的内存（字节）
+        size_t m_nPooledBytes = 0;
+    };
+
+    /** 获取复用池的统计数据
+    */
+    const Stats& GetStats() const;
+
+    /** 重置统计数据（不包括当前池中的数据）
+    */
+    void ResetStats();
+
+    /** 计算对齐后的画布宽度或者高度（AcquireRender返回的画布大小）
+    */
+    static int32_t AlignSize(int32_t nSize);
+
+private:
+    /** 计算画布占用的内存（字节）
+    */
+    static size_t GetRenderBytes(const IRender* pRender);
+
+    /** 淘汰最久未使用的空闲绘制引擎，直到占用的内存不超过nMaxBytes
+    */
+    void TrimToSize(size_t nMaxBytes);
+
+    /** 空闲时释放长时间未使用的绘制引擎
+    */
+    void TrimIdleRenders();
+
+    /** 启动空闲释放任务
+    */
+    void StartIdleTrim();
+
+private:
+    /** 池中空闲的绘制引擎
+    */
+    struct PooledRender
+    {
+        //绘制引擎
+        std::unique_ptr<IRender> m_spRender;
+
+        //放回池中的时间
+        std::chrono::steady_clock::time_point m_releaseTime;
+    };
+
+    /** 空闲的绘制引擎，最近放回的在头部
+    */
+    std::list<PooledRender> m_pooledRenders;
+
+    /** 池中空闲绘制引擎最多占用的内存（字节）
+    */
+    size_t m_nMaxBytes;
+
+    /** 统计数据
+    */
+    Stats m_stats;
+
+    /** 空闲释放任务的取消机制
+    */
+    WeakCallbackFlag m_idleTrimFlag;
+};
+
+} // namespace ui
+
+#endif // UI_CORE_RENDER_SURFACE_POOL_H_
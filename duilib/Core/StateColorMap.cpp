@@ -55,6 +55,19 @@ void StateColorMap::SetStateColor(ControlStateType stateType, const DString& col
             m_stateColorMap.erase(iter);
         }
     }
+    m_colorHandleMap.erase(stateType);
+}
+
+UiColor StateColorMap::GetStateUiColor(ControlStateType stateType) const
+{
+    auto iter = m_stateColorMap.find(stateType);
+    if (iter == m_stateColorMap.end()) {
+        return UiColor();
+    }
+    if (m_pControl != nullptr) {
+        return m_pControl->GetUiColor(iter->second, m_colorHandleMap[stateType]);
+    }
+    return GlobalManager::Instance().Color().GetColor(iter->second.c_str());
 }
 
 void StateColorMap::PaintStateColor(IRender* pRender, const UiRect& rcPaint, ControlStateType stateType) const
@@ -68,12 +81,11 @@ void StateColorMap::PaintStateColor(IRender* pRender, const UiRect& rcPaint, Con
         int32_t nHotAlpha = m_pControl->GetHotAlpha();
         if (bFadeHot) {
             if ((stateType == kControlStateNormal || stateType == kControlStateHot) && HasStateColor(kControlStateHot)) {
-                DString strColor = GetStateColor(kControlStateNormal);
-                if (!strColor.empty()) {
-                    pRender->FillRect(rcPaint, m_pControl->GetUiColor(strColor));
+                if (HasStateColor(kControlStateNormal)) {
+                    pRender->FillRect(rcPaint, GetStateUiColor(kControlStateNormal));
                 }
                 if (nHotAlpha > 0) {
-                    pRender->FillRect(rcPaint, m_pControl->GetUiColor(GetStateColor(kControlStateHot)), static_cast<uint8_t>(nHotAlpha));
+                    pRender->FillRect(rcPaint, GetStateUiColor(kControlStateHot), static_cast<uint8_t>(nHotAlpha));
                 }
                 return;
             }
@@ -89,11 +101,8 @@ void StateColorMap::PaintStateColor(IRender* pRender, const UiRect& rcPaint, Con
     if (stateType == kControlStateDisabled && !HasStateColor(kControlStateDisabled)) {
         stateType = kControlStateNormal;
     }
-    DString strColor = GetStateColor(stateType);
-    if (!strColor.empty()) {
-        UiColor color = m_pControl ? m_pControl->GetUiColor(strColor) :
-                                     GlobalManager::Instance().Color().GetColor(strColor);
-        pRender->FillRect(rcPaint, color);
+    if (HasStateColor(stateType)) {
+        pRender->FillRect(rcPaint, GetStateUiColor(stateType));
     }
 }
 } // namespace ui
@@ -3,6 +3,7 @@
 
 #include "duilib/Render/IRender.h"
 #include "duilib/Core/UiTypes.h"
+#include "duilib/Core/ColorManager.h"
 #include <map>
 
 namespace ui 
@@ -44,6 +45,10 @@ public:
     */
     void PaintStateColor(IRender* pRender, const UiRect& rcPaint, ControlStateType stateType) const;
 
+    /** 获取指定状态的颜色值（使用缓存的解析结果），如果不包含此颜色，则返回空
+    */
+    UiColor GetStateUiColor(ControlStateType stateType) const;
+
 private:
     /** 关联的控件接口
     */
@@ -52,6 +57,10 @@ private:
     /** 状态与颜色值的映射表
     */
     std::map<ControlStateType, UiString> m_stateColorMap;
+
+    /** 状态与颜色句柄的映射表（缓存解析后的颜色值）
+    */
+    mutable std::map<ControlStateType, ColorHandle> m_colorHandleMap;
 };
 
 } // namespace ui
@@ -13,6 +13,9 @@
 
 namespace ui
 {
+//绘制像素数的计数项（预先注册，避免每次绘制构造名称和查找计数项）
+static PerformanceUtil::Counter* const s_pPaintedPixelsCounter = PerformanceUtil::Instance().RegisterCounter(_T("Window::PaintedPixels"));
+
 Window::Window() :
     m_pRoot(nullptr),
     m_pFocus(nullptr),
@@ -22,6 +25,9 @@ Window::Window() :
     m_rcAlphaFix(0, 0, 0, 0),
     m_bFirstLayout(true),
     m_bIsArranged(false),
+    m_nLastArrangeCount(0),
+    m_bPaintedRectsValid(false),
+    m_nLastPaintedPixels(0),
     m_bPostQuitMsgWhenClosed(false),
     m_renderBackendType(RenderBackendType::kRaster_BackendType),
     m_bWindowAttributesApplied(false)
@@ -228,7 +234,9 @@ void Window::ClearWindow(bool bSendClose)
     m_toolTip.reset();
     m_shadow.reset();
     m_render.reset();
+    m_renderSurfacePool.Clear();
     m_controlFinder.Clear();
+    m_arrangeControls.clear();
 }
 
 bool Window::AttachBox(Box* pRoot)
@@ -283,6 +291,7 @@ void Window::ReapObjects(Control* pControl)
     if (pControl == m_pFocus) {
         m_pFocus = nullptr;
     }
+    m_arrangeControls.erase(pControl);
     m_controlFinder.RemoveControl(pControl);
 }
 
@@ -320,6 +329,9 @@ void Window::AddClass(const DString& strClassName, const DString& strControlAttr
     }
 #endif
     m_defaultAttrHash[strClassName] = strControlAttrList;
+    std::shared_ptr<AttributeList> spAttributeList = std::make_shared<AttributeList>();
+    AttributeUtil::ParseAttributeList(strControlAttrList, *spAttributeList);
+    m_classAttributeMap[strClassName] = spAttributeList;
 }
 
 DString Window::GetClassAttributes(const DString& strClassName) const
@@ -331,8 +343,18 @@ DString Window::GetClassAttributes(const DString& strClassName) const
     return _T("");
 }
 
+std::shared_ptr<const AttributeList> Window::GetClassAttributeList(const DString& strClassName) const
+{
+    auto it = m_classAttributeMap.find(strClassName);
+    if (it != m_classAttributeMap.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
 bool Window::RemoveClass(const DString& strClassName)
 {
+    m_classAttributeMap.erase(strClassName);
     auto it = m_defaultAttrHash.find(strClassName);
     if (it != m_defaultAttrHash.end()) {
         m_defaultAttrHash.erase(it);
@@ -344,16 +366,19 @@ bool Window::RemoveClass(const DString& strClassName)
 void Window::RemoveAllClass()
 {
     m_defaultAttrHash.clear();
+    m_classAttributeMap.clear();
 }
 
 void Window::AddTextColor(const DString& strName, const DString& strValue)
 {
     m_colorMap.AddColor(strName, strValue);
+    GlobalManager::Instance().Color().IncreaseColorEpoch();
 }
 
 void Window::AddTextColor(const DString& strName, UiColor argb)
 {
     m_colorMap.AddColor(strName, argb);
+    GlobalManager::Instance().Color().IncreaseColorEpoch();
 }
 
 UiColor Window::GetTextColor(const DString& strName) const
@@ -891,6 +916,45 @@ bool Window::Paint(const UiRect& rcPaint)
         return false;
     }
 
+    //计算本次需要重绘的区域：只重绘失效区域与rcPaint的交集，rcPaint中的其他区域（比如窗口被遮挡后重新露出的区域），
+    //绘制引擎中保存的仍然是上次绘制的结果，无需重绘
+    //以下情况需要整体重绘rcPaint区域：没有记录失效区域（由系统发起的绘制）、绘制引擎不能保留上次的绘制结果（GL）、绘制引擎大小变化
+    DamageRegion& damageRegion = GetDamageRegion();
+    const UiSize renderSize(pRender->GetWidth(), pRender->GetHeight());
+    m_bPaintedRectsValid = !damageRegion.IsEmpty() &&
+                           (pRender->GetRenderBackendType() == RenderBackendType::kRaster_BackendType) &&
+                           (renderSize == m_lastPaintRenderSize);
+    if (m_bPaintedRectsValid) {
+        damageRegion.GetIntersectRects(rcPaint, m_paintedRects);
+    }
+    else {
+        m_paintedRects.clear();
+        m_paintedRects.push_back(rcPaint);
+    }
+    //绘制期间添加的失效区域，在下次绘制时处理
+    damageRegion.Clear();
+    m_lastPaintRenderSize = renderSize;
+
+    m_nLastPaintedPixels = 0;
+    for (const UiRect& rcPaintRect : m_paintedRects) {
+        m_nLastPaintedPixels += DamageRegion::GetRectArea(rcPaintRect);
+        PaintRect(pRender, rcPaintRect);
+    }
+    PerformanceUtil::AddCount(s_pPaintedPixelsCounter, m_nLastPaintedPixels);
+    return true;
+}
+
+bool Window::GetPaintedRects(std::vector<UiRect>& paintedRects) const
+{
+    if (!m_bPaintedRectsValid) {
+        return false;
+    }
+    paintedRects = m_paintedRects;
+    return true;
+}
+
+void Window::PaintRect(IRender* pRender, const UiRect& rcPaint)
+{
     //开始绘制前，去掉alpha通道
     if (IsLayeredWindow()) {
         pRender->ClearAlpha(rcPaint);
@@ -944,7 +1008,6 @@ bool Window::Paint(const UiRect& rcPaint)
             }
         }
     }
-    return true;
 }
 
 LRESULT Window::OnSetFocusMsg(WindowBase* /*pLostFocusWindow*/, const NativeMsg& /*nativeMsg*/, bool& bHandled)
@@ -1689,6 +1752,30 @@ void Window::SetArrange(bool bArrange)
     m_bIsArranged = bArrange;
 }
 
+void Window::AddArrangeControl(PlaceHolder* pControl)
+{
+    ASSERT(pControl != nullptr);
+    if (pControl != nullptr) {
+        m_arrangeControls.insert(pControl);
+        m_bIsArranged = true;
+    }
+}
+
+void Window::RemoveArrangeControl(PlaceHolder* pControl)
+{
+    m_arrangeControls.erase(pControl);
+}
+
+uint32_t Window::GetLastArrangeCount() const
+{
+    return m_nLastArrangeCount;
+}
+
+uint64_t Window::GetLastPaintedPixels() const
+{
+    return m_nLastPaintedPixels;
+}
+
 bool Window::SendNotify(EventType eventType, WPARAM wParam, LPARAM lParam)
 {
     EventArgs msg;
@@ -1758,6 +1845,11 @@ std::shared_ptr<IRenderDpi> Window::GetRenderDpi()
     return spRenderDpi;
 }
 
+RenderSurfacePool& Window::GetRenderSurfacePool()
+{
+    return m_renderSurfacePool;
+}
+
 void Window::SetWindowAttributesApplied(bool bApplied)
 {
     m_bWindowAttributesApplied = bApplied;
@@ -1837,15 +1929,13 @@ void Window::ArrangeRoot()
         GetClientRect(rcClient);
         if (!rcClient.IsEmpty()) {
             if (m_pRoot->IsArranged()) {
+                //整体重新布局，队列中的控件都会被重新布局，无需再单独处理
+                m_arrangeControls.clear();
                 m_pRoot->SetPos(rcClient);
+                m_nLastArrangeCount = 1;
             }
             else {
-                Control* pControl = m_pRoot->FindControl(ControlFinder::__FindControlFromUpdate, nullptr, UIFIND_VISIBLE | UIFIND_ME_FIRST);
-                while (pControl != nullptr) {
-                    pControl->SetPos(pControl->GetPos());
-                    //ASSERT(!pControl->IsArranged());
-                    pControl = m_pRoot->FindControl(ControlFinder::__FindControlFromUpdate, nullptr, UIFIND_VISIBLE | UIFIND_ME_FIRST);
-                }
+                m_nLastArrangeCount = ArrangeQueuedControls();
             }
 
             if (m_bFirstLayout) {
@@ -1856,6 +1946,73 @@ void Window::ArrangeRoot()
     }
 }
 
+uint32_t Window::ArrangeQueuedControls()
+{
+    //布局过程中，控件可能被删除（删除时会从队列中移除，但本地列表中仍然存在），所以使用弱引用标志检测控件是否仍然有效
+    struct ArrangeItem
+    {
+        size_t nDepth;
+        PlaceHolder* pControl;
+        std::weak_ptr<WeakFlag> controlFlag;
+    };
+    uint32_t nArrangeCount = 0;
+    //因控件不可见而暂不布局的控件，保留到下次布局时处理
+    std::vector<ArrangeItem> deferredItems;
+    std::vector<ArrangeItem> arrangeItems;
+    while (!m_arrangeControls.empty()) {
+        arrangeItems.clear();
+        arrangeItems.reserve(m_arrangeControls.size());
+        for (PlaceHolder* pControl : m_arrangeControls) {
+            if ((pControl->GetWindow() != this) || !pControl->IsArranged()) {
+                continue;
+            }
+            //计算控件在控件树中的深度，并检查是否在当前控件树中，以及是否可见
+            bool bVisible = pControl->IsVisible();
+            size_t nDepth = 0;
+            const PlaceHolder* pTopControl = pControl;
+            Box* pParent = pControl->GetParent();
+            while (pParent != nullptr) {
+                if (!pParent->IsVisible()) {
+                    bVisible = false;
+                }
+                pTopControl = pParent;
+                pParent = pParent->GetParent();
+                ++nDepth;
+            }
+            if (pTopControl != m_pRoot) {
+                //已经从控件树中移除
+                continue;
+            }
+            if (!bVisible) {
+                deferredItems.push_back({ nDepth, pControl, pControl->GetWeakFlag() });
+                continue;
+            }
+            arrangeItems.push_back({ nDepth, pControl, pControl->GetWeakFlag() });
+        }
+        m_arrangeControls.clear();
+
+        //按深度排序，祖先控件先布局；子控件如果已经随祖先控件完成布局，则跳过
+        std::stable_sort(arrangeItems.begin(), arrangeItems.end(),
+                         [](const ArrangeItem& a, const ArrangeItem& b) {
+                             return a.nDepth < b.nDepth;
+                         });
+        for (const ArrangeItem& item : arrangeItems) {
+            if (item.controlFlag.expired() || !item.pControl->IsArranged()) {
+                continue;
+            }
+            item.pControl->SetPos(item.pControl->GetPos());
+            ++nArrangeCount;
+        }
+        //布局过程中加入队列的控件，在本轮循环中继续处理
+    }
+    for (const ArrangeItem& item : deferredItems) {
+        if (!item.controlFlag.expired()) {
+            m_arrangeControls.insert(item.pControl);
+        }
+    }
+    return nArrangeCount;
+}
+
 void Window::SetRenderOffset(UiPoint renderOffset)
 {
     m_renderOffset = renderOffset;
@@ -5,14 +5,18 @@
 #include "duilib/Core/ControlFinder.h"
 #include "duilib/Core/ColorManager.h"
 #include "duilib/Render/IRender.h"
+#include "duilib/Core/RenderSurfacePool.h"
 #include "duilib/Utils/Delegate.h"
 #include "duilib/Utils/FilePath.h"
+#include "duilib/Utils/AttributeUtil.h"
+#include <unordered_set>
 
 namespace ui
 {
 
 class Box;
 class Control;
+class PlaceHolder;
 class Shadow;
 class ToolTip;
 
@@ -186,6 +190,24 @@ public:
     */
     void SetArrange(bool bArrange);
 
+    /** 将需要重新布局的控件加入窗口的布局队列（在下次布局时统一处理）
+    * @param [in] pControl 需要重新布局的控件
+    */
+    void AddArrangeControl(PlaceHolder* pControl);
+
+    /** 将控件从窗口的布局队列中移除（控件所属窗口变化时调用）
+    * @param [in] pControl 控件
+    */
+    void RemoveArrangeControl(PlaceHolder* pControl);
+
+    /** 获取最近一次布局时，重新布局的控件个数（可用于评估每帧的布局开销）
+    */
+    uint32_t GetLastArrangeCount() const;
+
+    /** 获取最近一次绘制时，重绘的像素数（可用于评估每帧的绘制开销）
+    */
+    uint64_t GetLastPaintedPixels() const;
+
     /** 清理图片缓存
     */
     void ClearImageCache();
@@ -284,6 +306,12 @@ public:
     */
     DString GetClassAttributes(const DString& strClassName) const;
 
+    /** 获取指定通用样式解析后的属性列表（添加时已经完成解析，应用时无需再次解析）
+    * @param [in] strClassName 通用样式名称
+    * @return 返回解析后的属性列表，如果不存在则返回nullptr
+    */
+    std::shared_ptr<const AttributeList> GetClassAttributeList(const DString& strClassName) const;
+
     /** 删除一个通用样式
     * @param [in] strClassName 要删除的通用样式名称
     */
@@ -348,6 +376,10 @@ public:
     */
     std::shared_ptr<IRenderDpi> GetRenderDpi();
 
+    /** 获取本窗口的离屏绘制引擎复用池（控件设置透明度或者使用绘制缓存时使用）
+    */
+    RenderSurfacePool& GetRenderSurfacePool();
+
     /** 设置窗口的属性是否已经设置完成(避免重复设置窗口属性)
     */
     void SetWindowAttributesApplied(bool bApplied);
@@ -387,6 +419,12 @@ protected:
     */
     virtual bool OnPreparePaint() override;
 
+    /** 获取最近一次绘制实际重绘的区域
+    * @param [out] paintedRects 重绘的区域列表（客户区坐标）
+    * @return 如果返回false，表示最近一次绘制是按系统请求的区域整体重绘的
+    */
+    virtual bool GetPaintedRects(std::vector<UiRect>& paintedRects) const override;
+
     /** 窗口的层窗口属性发生变化
     */
     virtual void OnLayeredWindowChanged() override;
@@ -737,6 +775,11 @@ private:
     */
     void ArrangeRoot();
 
+    /** 处理布局队列中的控件（按控件树的深度排序，祖先控件先布局，已被祖先布局过的子控件不再重复布局）
+    * @return 返回本次重新布局的控件个数
+    */
+    uint32_t ArrangeQueuedControls();
+
     /** 清理窗口资源
     * @param [in] bSendClose 是否发送关闭事件
     */
@@ -760,6 +803,12 @@ private:
     */
     bool Paint(const UiRect& rcPaint);
 
+    /** 绘制指定的区域
+    * @param [in] pRender 绘制引擎接口
+    * @param [in] rcPaint 绘制的矩形区域
+    */
+    void PaintRect(IRender* pRender, const UiRect& rcPaint);
+
     /** 调整Render的尺寸，与当前客户区的大小一致
     */
     bool ResizeRenderToClientSize() const;
@@ -807,6 +856,24 @@ private:
     //布局是否需要初始化
     bool m_bFirstLayout;
 
+    //需要重新布局的控件队列（由PlaceHolder::ArrangeSelf加入）
+    std::unordered_set<PlaceHolder*> m_arrangeControls;
+
+    //最近一次布局时，重新布局的控件个数
+    uint32_t m_nLastArrangeCount;
+
+    //最近一次绘制时，实际重绘的区域（只重绘失效区域时有效）
+    std::vector<UiRect> m_paintedRects;
+
+    //最近一次绘制时，是否只重绘了失效区域
+    bool m_bPaintedRectsValid;
+
+    //最近一次绘制时，绘制引擎的大小（大小变化后，需要整体重绘）
+    UiSize m_lastPaintRenderSize;
+
+    //最近一次绘制时，重绘的像素数
+    uint64_t m_nLastPaintedPixels;
+
     //绘制时的偏移量（动画用）
     UiPoint m_renderOffset;
 
@@ -816,6 +883,9 @@ private:
     //绘制引擎
     std::unique_ptr<IRender> m_render;
 
+    //离屏绘制引擎复用池
+    RenderSurfacePool m_renderSurfacePool;
+
 private:
     //每个窗口的资源路径(相对于资源根目录的路径)
     FilePath m_resourcePath;
@@ -826,6 +896,9 @@ private:
     //窗口配置中class名称与属性映射关系
     std::map<DString, DString> m_defaultAttrHash;
 
+    //窗口配置中class名称与解析后的属性列表映射关系
+    std::map<DString, std::shared_ptr<const AttributeList>> m_classAttributeMap;
+
     //窗口颜色字符串与颜色值（ARGB）的映射关系
     ColorMap m_colorMap;
 
@@ -563,9 +563,20 @@ void WindowBase::ClearWindowRgn(bool bRedraw)
 void WindowBase::Invalidate(const UiRect& rcItem)
 {
     GlobalManager::Instance().AssertUIThread();
+    m_damageRegion.AddRect(rcItem);
     m_pNativeWindow->Invalidate(rcItem);
 }
 
+void WindowBase::SetMaxDamageRectCount(size_t nMaxRectCount)
+{
+    m_damageRegion.SetMaxRectCount(nMaxRectCount);
+}
+
+size_t WindowBase::GetMaxDamageRectCount() const
+{
+    return m_damageRegion.GetMaxRectCount();
+}
+
 bool WindowBase::UpdateWindow() const
 {
     return m_pNativeWindow->UpdateWindow();
@@ -924,6 +935,11 @@ IRender* WindowBase::OnNativeGetRender() const
     return GetRender();
 }
 
+bool WindowBase::OnNativeGetPaintedRects(std::vector<UiRect>& paintedRects) const
+{
+    return GetPaintedRects(paintedRects);
+}
+
 void WindowBase::OnNativeProcessDpiChangedMsg(uint32_t nNewDPI, const UiRect& rcNewWindow)
 {
     ProcessDpiChangedMsg(nNewDPI, rcNewWindow);
@@ -2,6 +2,7 @@
 #define UI_CORE_WINDOW_BASE_H_
 
 #include "duilib/Core/INativeWindow.h"
+#include "duilib/Core/DamageRegion.h"
 #include "duilib/Utils/FilePath.h"
 
 #ifdef DUILIB_BUILD_FOR_WIN
@@ -303,6 +304,15 @@ public:
     */
     void Invalidate(const UiRect& rcItem);
 
+    /** 设置窗口失效区域最多记录的矩形个数（默认为8个）
+    * @param [in] nMaxRectCount 矩形个数，如果为0表示不记录失效区域，每次按系统请求的区域整体重绘
+    */
+    void SetMaxDamageRectCount(size_t nMaxRectCount);
+
+    /** 获取窗口失效区域最多记录的矩形个数
+    */
+    size_t GetMaxDamageRectCount() const;
+
     /** 更新窗口，执行重绘
     */
     bool UpdateWindow() const;
@@ -595,6 +605,12 @@ protected:
     */
     virtual bool OnPreparePaint() = 0;
 
+    /** 获取最近一次绘制实际重绘的区域（用于只将重绘的区域提交到窗口）
+    * @param [out] paintedRects 重绘的区域列表（客户区坐标）
+    * @return 如果返回false，表示最近一次绘制是按系统请求的区域整体重绘的
+    */
+    virtual bool GetPaintedRects(std::vector<UiRect>& paintedRects) const = 0;
+
     /** 窗口的层窗口属性发生变化
     */
     virtual void OnLayeredWindowChanged() = 0;
@@ -646,6 +662,10 @@ protected:
     */
     virtual IRender* GetRender() const = 0;
 
+    /** 获取窗口的失效区域（两次绘制之间，通过Invalidate函数添加的所有区域）
+    */
+    DamageRegion& GetDamageRegion() { return m_damageRegion; }
+
 protected:
     /** @name 窗口消息处理相关
      * @{
@@ -932,6 +952,7 @@ private:
     virtual void OnNativeUseSystemCaptionBarChanged() override;
     virtual bool OnNativePreparePaint() override;
     virtual IRender* OnNativeGetRender() const override;
+    virtual bool OnNativeGetPaintedRects(std::vector<UiRect>& paintedRects) const override;
 
     virtual void    OnNativeFinalMessage() override;
     virtual LRESULT OnNativeWindowMessage(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled) override;
@@ -1010,6 +1031,10 @@ private:
     /** 窗口的实现类
     */
     NativeWindow* m_pNativeWindow;
+
+    /** 窗口的失效区域
+    */
+    DamageRegion m_damageRegion;
 };
 
 } // namespace ui
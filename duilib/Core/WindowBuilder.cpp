@@ -7,6 +7,7 @@
 #include "duilib/Core/ScrollBar.h"
 
 #include "duilib/Control/TreeView.h"
+#include "duilib/Control/VirtualTreeView.h"
 #include "duilib/Control/Combo.h"
 #include "duilib/Control/ComboButton.h"
 #include "duilib/Control/FilterCombo.h"
@@ -45,15 +46,82 @@
 #include "duilib/Utils/StringUtil.h"
 #include "duilib/Utils/AttributeUtil.h"
 #include "duilib/Utils/FilePathUtil.h"
+#include "duilib/Utils/PerformanceUtil.h"
+#include "duilib/Utils/FileUtil.h"
+#include "duilib/Core/LayoutBinary.h"
 
 #include "duilib/third_party/xml/pugixml.hpp"
+#include <unordered_map>
+#include <list>
 
 namespace ui 
 {
 
+//XML文件缓存中，最多保存的XML文件个数
+static const size_t kMaxXmlFileCacheCount = 64;
+
+//XML文件缓存命中、未命中，以及从预编译文件加载的计数项（预先注册，避免每次加载构造名称和查找计数项）
+static PerformanceUtil::Counter* const s_pXmlFileCacheHitCounter = PerformanceUtil::Instance().RegisterCounter(_T("WindowBuilder::XmlFileCache::Hit"));
+static PerformanceUtil::Counter* const s_pXmlFileCacheMissCounter = PerformanceUtil::Instance().RegisterCounter(_T("WindowBuilder::XmlFileCache::Miss"));
+static PerformanceUtil::Counter* const s_pLayoutBinaryCounter = PerformanceUtil::Instance().RegisterCounter(_T("WindowBuilder::LayoutBinary::Load"));
+
+/** 已解析的XML文件缓存，只在UI线程中使用
+*/
+struct XmlFileCache
+{
+    //XML文件路径（实际路径）与解析后的XML文档
+    std::map<FilePath, std::shared_ptr<pugi::xml_document>> m_xmlFiles;
+
+    //XML文件的添加顺序，超过最大个数时，先淘汰最早添加的
+    std::list<FilePath> m_xmlFileOrder;
+};
+
+static XmlFileCache& GetXmlFileCache()
+{
+    static XmlFileCache xmlFileCache;
+    return xmlFileCache;
+}
+
+/** 加载XML文件对应的预编译文件（参见LayoutBinary）
+* @param [in] xmlFileFullPath XML文件的实际路径
+* @param [in] bUseZip 是否从压缩包中加载
+* @param [out] xmlDoc 返回XML文档
+* @return 如果预编译文件不存在、已过期或者格式不正确，返回false
+*/
+static bool LoadLayoutBinaryFile(const FilePath& xmlFileFullPath, bool bUseZip, pugi::xml_document& xmlDoc)
+{
+    const FilePath binFilePath = LayoutBinary::GetBinaryFilePath(xmlFileFullPath);
+    if (bUseZip) {
+        //压缩包中的预编译文件，需要在打包时与XML文件一起生成
+        ZipManager& zipManager = GlobalManager::Instance().Zip();
+        if (!zipManager.IsZipResExist(binFilePath)) {
+            return false;
+        }
+        const uint8_t* pFileData = nullptr;
+        size_t nFileDataSize = 0;
+        std::shared_ptr<const void> spFileDataHolder = zipManager.GetZipDataView(binFilePath, pFileData, nFileDataSize);
+        if (spFileDataHolder == nullptr) {
+            return false;
+        }
+        return LayoutBinary::Load(pFileData, nFileDataSize, 0, xmlDoc);
+    }
+    else {
+        //本地文件：XML文件在编译后修改过时，不使用预编译文件
+        uint64_t nSourceSize = 0;
+        if (!LayoutBinary::IsBinaryFileUpToDate(xmlFileFullPath, binFilePath, nSourceSize)) {
+            return false;
+        }
+        std::vector<uint8_t> fileData;
+        if (!FileUtil::ReadFileData(binFilePath, fileData)) {
+            return false;
+        }
+        return LayoutBinary::Load(fileData.data(), fileData.size(), nSourceSize, xmlDoc);
+    }
+}
+
 WindowBuilder::WindowBuilder()
 {
-    m_xml = std::make_unique<pugi::xml_document>();
+    m_xml = std::make_shared<pugi::xml_document>();
 }
 
 WindowBuilder::~WindowBuilder()
@@ -64,7 +132,7 @@ WindowBuilder::~WindowBuilder()
 Control* WindowBuilder::CreateControlByClass(const DString& strControlClass, Window* pWindow)
 {
     typedef std::function<Control* (Window* pWindow)> CreateControlFunction;
-    static std::map<DString, CreateControlFunction> createControlMap =
+    static const std::unordered_map<DString, CreateControlFunction> createControlMap =
     {
         {DUI_CTR_BOX,  [](Window* pWindow) { return new Box(pWindow); }},
         {DUI_CTR_HBOX, [](Window* pWindow) { return new HBox(pWindow); }},
@@ -105,6 +173,8 @@ Control* WindowBuilder::CreateControlByClass(const DString& strControlClass, Win
         {DUI_CTR_CHECKBOXBOX, [](Window* pWindow) { return new CheckBoxBox(pWindow); }},
         {DUI_CTR_TREEVIEW, [](Window* pWindow) { return new TreeView(pWindow); }},
         {DUI_CTR_TREENODE, [](Window* pWindow) { return new TreeNode(pWindow); }},
+        {DUI_CTR_VIRTUAL_TREEVIEW, [](Window* pWindow) { return new VirtualTreeView(pWindow); }},
+        {DUI_CTR_VIRTUAL_TREENODE, [](Window* pWindow) { return new VirtualTreeNode(pWindow); }},
         {DUI_CTR_COMBO, [](Window* pWindow) { return new Combo(pWindow); }},
         {DUI_CTR_COMBO_BUTTON, [](Window* pWindow) { return new ComboButton(pWindow); }},
         {DUI_CTR_FILTER_COMBO, [](Window* pWindow) { return new FilterCombo(pWindow); }},
@@ -187,6 +257,8 @@ Control* WindowBuilder::CreateFromXmlData(const DString& xmlFileData,
 #else
         pugi::xml_encoding encoding = pugi::xml_encoding::encoding_utf8;
 #endif
+        //不能修改XML文件缓存中共享的XML文档
+        m_xml = std::make_shared<pugi::xml_document>();
         pugi::xml_parse_result result = m_xml->load_buffer(xmlFileData.c_str(),
                                                            xmlFileData.size() * sizeof(DString::value_type),
                                                            pugi::parse_default, encoding);
@@ -210,40 +282,78 @@ Control* WindowBuilder::CreateFromXmlFile(const FilePath& xmlFilePath,
     if (xmlFilePath.IsEmpty()) {
         return nullptr;
     }
-    bool isLoaded = false;
-    if (GlobalManager::Instance().Zip().IsUseZip()) {
-        FilePath sFile = FilePathUtil::JoinFilePath(GlobalManager::Instance().GetResourcePath(), xmlFilePath);
-        std::vector<unsigned char> file_data;
-        if (GlobalManager::Instance().Zip().GetZipData(sFile, file_data)) {
-            pugi::xml_parse_result result = m_xml->load_buffer(file_data.data(), file_data.size());
-            if (result.status != pugi::status_ok) {
-                ASSERT(!_T("WindowBuilder::Create load xml from zip data failed!"));
-                return nullptr;
-            }
-            isLoaded = true;
-        }
+    std::shared_ptr<pugi::xml_document> spXml = LoadXmlFile(xmlFilePath);
+    if (spXml == nullptr) {
+        ASSERT(!_T("WindowBuilder::Create load xmlFilePath failed!"));
+        return nullptr;
+    }
+    m_xml = spXml;
+    m_xmlFilePath = xmlFilePath;
+    return CreateFromCachedXml(pCallback, pWindow, pParent, pUserDefinedBox);
+}
+
+std::shared_ptr<pugi::xml_document> WindowBuilder::LoadXmlFile(const FilePath& xmlFilePath) const
+{
+    //计算XML文件的实际路径，作为缓存的关键字
+    const bool bUseZip = GlobalManager::Instance().Zip().IsUseZip();
+    FilePath xmlFileFullPath;
+    if (bUseZip || xmlFilePath.IsRelativePath()) {
+        xmlFileFullPath = FilePathUtil::JoinFilePath(GlobalManager::Instance().GetResourcePath(), xmlFilePath);
     }
     else {
-        FilePath xmlFileFullPath;
-        if (xmlFilePath.IsRelativePath()) {
-            xmlFileFullPath = FilePathUtil::JoinFilePath(GlobalManager::Instance().GetResourcePath(), xmlFilePath);
+        xmlFileFullPath = xmlFilePath;
+    }
+
+    XmlFileCache& xmlFileCache = GetXmlFileCache();
+    auto iter = xmlFileCache.m_xmlFiles.find(xmlFileFullPath);
+    if (iter != xmlFileCache.m_xmlFiles.end()) {
+        PerformanceUtil::AddCount(s_pXmlFileCacheHitCounter);
+        return iter->second;
+    }
+    PerformanceUtil::AddCount(s_pXmlFileCacheMissCounter);
+
+    std::shared_ptr<pugi::xml_document> spXml = std::make_shared<pugi::xml_document>();
+    if (LoadLayoutBinaryFile(xmlFileFullPath, bUseZip, *spXml)) {
+        //有可用的预编译文件，不需要解析XML文本
+        PerformanceUtil::AddCount(s_pLayoutBinaryCounter);
+    }
+    else if (bUseZip) {
+        //未压缩存储的文件，直接引用压缩包中的数据，不再复制到临时缓冲区（解析时由pugixml复制一份）
+        const uint8_t* pFileData = nullptr;
+        size_t nFileDataSize = 0;
+        std::shared_ptr<const void> spFileDataHolder = GlobalManager::Instance().Zip().GetZipDataView(xmlFileFullPath, pFileData, nFileDataSize);
+        if (spFileDataHolder == nullptr) {
+            return nullptr;
         }
-        else {
-            xmlFileFullPath = xmlFilePath;
+        pugi::xml_parse_result result = spXml->load_buffer(pFileData, nFileDataSize);
+        if (result.status != pugi::status_ok) {
+            ASSERT(!_T("WindowBuilder::Create load xml from zip data failed!"));
+            return nullptr;
         }
-        pugi::xml_parse_result result = m_xml->load_file(xmlFileFullPath.NativePathA().c_str());
+    }
+    else {
+        pugi::xml_parse_result result = spXml->load_file(xmlFileFullPath.NativePathA().c_str());
         if (result.status != pugi::status_ok) {
             ASSERT(!_T("WindowBuilder::Create load xml file failed!"));
             return nullptr;
         }
-        isLoaded = true;
     }
-    if (!isLoaded) {
-        ASSERT(!_T("WindowBuilder::Create load xmlFilePath failed!"));
-        return nullptr;
+
+    //添加到缓存中，超过最大个数时，淘汰最早添加的
+    while (!xmlFileCache.m_xmlFileOrder.empty() && (xmlFileCache.m_xmlFiles.size() >= kMaxXmlFileCacheCount)) {
+        xmlFileCache.m_xmlFiles.erase(xmlFileCache.m_xmlFileOrder.front());
+        xmlFileCache.m_xmlFileOrder.pop_front();
     }
-    m_xmlFilePath = xmlFilePath;
-    return CreateFromCachedXml(pCallback, pWindow, pParent, pUserDefinedBox);
+    xmlFileCache.m_xmlFiles[xmlFileFullPath] = spXml;
+    xmlFileCache.m_xmlFileOrder.push_back(xmlFileFullPath);
+    return spXml;
+}
+
+void WindowBuilder::ClearXmlFileCache()
+{
+    XmlFileCache& xmlFileCache = GetXmlFileCache();
+    xmlFileCache.m_xmlFiles.clear();
+    xmlFileCache.m_xmlFileOrder.clear();
 }
 
 Control* WindowBuilder::CreateFromCachedXml(CreateControlCallback pCallback, Window* pWindow, Box* pParent, Box* pUserDefinedBox)
@@ -711,9 +821,18 @@ Control* WindowBuilder::ParseXmlNodeChildren(const pugi::xml_node& xmlNode, Cont
             if (sourceXmlFilePath.IsEmpty()) {
                 continue;
             }
+            //同一个文件只加载一次，后续直接使用已经解析的XML文档创建
+            WindowBuilder builder;
             for ( int i = 0; i < nCount; i++ ) {
-                WindowBuilder builder;
-                pControl = builder.CreateFromXmlFile(sourceXmlFilePath, m_createControlCallback, pWindow, ToBox(pParent));
+                if (i == 0) {
+                    pControl = builder.CreateFromXmlFile(sourceXmlFilePath, m_createControlCallback, pWindow, ToBox(pParent));
+                    if (pControl == nullptr) {
+                        break;
+                    }
+                }
+                else {
+                    pControl = builder.CreateFromCachedXml(m_createControlCallback, pWindow, ToBox(pParent));
+                }
             }
             continue;
         }
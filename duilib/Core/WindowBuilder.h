@@ -97,6 +97,11 @@ public:
     */
     static bool ParseRichTextXmlNode(const pugi::xml_node& xmlNode, Control* pControl, RichTextSlice* pTextSlice = nullptr);
 
+    /** 清空已解析的XML文件缓存（重新加载资源时调用）
+    *   CreateFromXmlFile解析过的XML文件会保存在缓存中，再次创建时（比如多次打开同一个窗口、Include标签多次包含同一个文件），直接使用缓存的解析结果
+    */
+    static void ClearXmlFileCache();
+
 private:
     /** 解析窗口的属性(根XML节点名称："Window")
     */
@@ -137,11 +142,18 @@ private:
     */
     void ParseFontXmlNode(const pugi::xml_node& xmlNode) const;
 
+    /** 加载XML文件，优先使用缓存中已经解析过的XML文档；
+    *   缓存中没有时，如果存在可用的预编译文件（参见LayoutBinary），从预编译文件加载，否则解析XML文件
+    * @param [in] xmlFilePath XML文件的路径
+    * @return 成功返回解析后的XML文档，失败返回nullptr
+    */
+    std::shared_ptr<pugi::xml_document> LoadXmlFile(const FilePath& xmlFilePath) const;
+
 private:
     
-    /** 当前解析的XML文档对象
+    /** 当前解析的XML文档对象（从XML文件加载时，与XML文件缓存共享，只读）
     */
-    std::unique_ptr<pugi::xml_document> m_xml;
+    std::shared_ptr<pugi::xml_document> m_xml;
 
     /** 创建Control的回调接口
     */
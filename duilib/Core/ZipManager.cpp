@@ -7,12 +7,333 @@
 #include "duilib/third_party/zlib/zlib.h"
 #include "duilib/third_party/zlib/contrib/minizip/unzip.h"
 
+#include <unordered_map>
+#include <cstring>
+#include <atomic>
+
+#ifndef DUILIB_BUILD_FOR_WIN
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
 namespace ui 
 {
 /** 压缩包内的路径，最大长度
 */
 #define MAX_PATH_LEN (size_t)(1024)
 
+/** 无效的偏移值
+*/
+static const uint64_t kInvalidZipOffset = (uint64_t)-1;
+
+/** 压缩包中的文件索引
+*/
+struct ZipEntry
+{
+    //压缩包内的文件路径（保持原始的大小写）
+    DString m_fileName;
+
+    //文件在unzip接口中的位置（通过unzip接口读取时使用）
+    unz64_file_pos m_filePos = { 0, 0 };
+
+    //本地文件头在压缩包中的偏移，无法获取时为kInvalidZipOffset
+    uint64_t m_nLocalHeaderOffset = kInvalidZipOffset;
+
+    //压缩后的大小和原始大小
+    uint64_t m_nCompressedSize = 0;
+    uint64_t m_nUncompressedSize = 0;
+
+    //文件内容的CRC32校验值
+    uint32_t m_nCrc32 = 0;
+
+    //压缩方法：0表示未压缩存储，8表示Deflate算法
+    uint32_t m_nMethod = 0;
+
+    //文件是否加密
+    bool m_bEncrypted = false;
+
+    //是否为目录
+    bool m_bDir = false;
+};
+
+/** 已建立索引的压缩包：压缩包数据通过内存映射（或者资源数据）直接访问，建立索引后只读，支持多线程并发读取
+*/
+class ZipArchive
+{
+public:
+    ZipArchive();
+    ~ZipArchive();
+    ZipArchive(const ZipArchive&) = delete;
+    ZipArchive& operator = (const ZipArchive&) = delete;
+
+public:
+    /** 将压缩包文件映射到内存
+    */
+    bool MapFile(const FilePath& path);
+
+    /** 设置压缩包的内存数据（数据由外部管理，需要在本对象的生命周期内保持有效）
+    */
+    void SetData(const uint8_t* pData, uint64_t nDataSize);
+
+    /** 从中央目录的文件记录中，读取本地文件头的偏移
+    * @param [in] nCentralDirOffset 中央目录中文件记录的偏移
+    */
+    uint64_t GetLocalHeaderOffset(uint64_t nCentralDirOffset) const;
+
+    /** 获取文件的数据（压缩后的数据），如果无法直接访问，返回nullptr
+    */
+    const uint8_t* GetEntryData(const ZipEntry& zipEntry) const;
+
+    /** 建立索引后，初始化每个文件的CRC32校验状态（均为未校验）
+    */
+    void InitCrcStates();
+
+    /** 校验未压缩存储的文件内容的CRC32（直接引用压缩包数据时使用），每个文件只校验一次，之后使用缓存的结果
+    * @param [in] zipEntry 文件的索引（必须是m_entries中的元素）
+    * @param [in] pData 文件内容
+    * @param [in] nDataSize 文件内容的长度
+    */
+    bool VerifyEntryCrc(const ZipEntry& zipEntry, const uint8_t* pData, size_t nDataSize) const;
+
+public:
+    /** 所有文件的索引
+    */
+    std::vector<ZipEntry> m_entries;
+
+    /** 文件路径（小写，路径分隔符为'/'）与索引号的映射表
+    */
+    std::unordered_map<DStringW, size_t> m_entryIndex;
+
+private:
+    /** 释放内存映射
+    */
+    void UnmapFile();
+
+    /** 读取小端字节序的整数
+    */
+    static uint16_t ReadUInt16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+    static uint32_t ReadUInt32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+private:
+    /** 压缩包数据
+    */
+    const uint8_t* m_pData;
+    uint64_t m_nDataSize;
+
+#ifdef DUILIB_BUILD_FOR_WIN
+    /** 文件映射句柄
+    */
+    HANDLE m_hFile;
+    HANDLE m_hFileMapping;
+#else
+    /** 文件映射的地址
+    */
+    void* m_pMapAddr;
+    size_t m_nMapSize;
+#endif
+
+    /** 每个文件的CRC32校验状态（与m_entries一一对应）：0表示未校验，1表示校验通过，2表示校验失败
+    *   多个线程同时首次校验同一个文件时，会重复计算，结果相同
+    */
+    std::unique_ptr<std::atomic<uint8_t>[]> m_crcStates;
+    size_t m_nCrcStateCount;
+};
+
+ZipArchive::ZipArchive():
+    m_pData(nullptr),
+    m_nDataSize(0),
+#ifdef DUILIB_BUILD_FOR_WIN
+    m_hFile(INVALID_HANDLE_VALUE),
+    m_hFileMapping(nullptr)
+#else
+    m_pMapAddr(nullptr),
+    m_nMapSize(0),
+#endif
+    m_nCrcStateCount(0)
+{
+}
+
+void ZipArchive::InitCrcStates()
+{
+    m_nCrcStateCount = m_entries.size();
+    m_crcStates.reset(new std::atomic<uint8_t>[m_nCrcStateCount]);
+    for (size_t nIndex = 0; nIndex < m_nCrcStateCount; ++nIndex) {
+        m_crcStates[nIndex].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool ZipArchive::VerifyEntryCrc(const ZipEntry& zipEntry, const uint8_t* pData, size_t nDataSize) const
+{
+    const size_t nEntryIndex = (size_t)(&zipEntry - m_entries.data());
+    ASSERT(nEntryIndex < m_nCrcStateCount);
+    if (nEntryIndex >= m_nCrcStateCount) {
+        return ::crc32(0, pData, (uInt)nDataSize) == zipEntry.m_nCrc32;
+    }
+    std::atomic<uint8_t>& crcState = m_crcStates[nEntryIndex];
+    uint8_t nState = crcState.load(std::memory_order_acquire);
+    if (nState == 0) {
+        //首次访问：计算并缓存校验结果
+        bool bValid = ::crc32(0, pData, (uInt)nDataSize) == zipEntry.m_nCrc32;
+        nState = bValid ? 1 : 2;
+        crcState.store(nState, std::memory_order_release);
+    }
+    return nState == 1;
+}
+
+ZipArchive::~ZipArchive()
+{
+    UnmapFile();
+}
+
+bool ZipArchive::MapFile(const FilePath& path)
+{
+    UnmapFile();
+#ifdef DUILIB_BUILD_FOR_WIN
+    m_hFile = ::CreateFileW(path.ToStringW().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize = { 0, };
+    if (!::GetFileSizeEx(m_hFile, &fileSize) || (fileSize.QuadPart <= 0)) {
+        UnmapFile();
+        return false;
+    }
+    m_hFileMapping = ::CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hFileMapping == nullptr) {
+        UnmapFile();
+        return false;
+    }
+    m_pData = (const uint8_t*)::MapViewOfFile(m_hFileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_pData == nullptr) {
+        UnmapFile();
+        return false;
+    }
+    m_nDataSize = (uint64_t)fileSize.QuadPart;
+#else
+    int fd = ::open(path.NativePathA().c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if ((::fstat(fd, &fileStat) != 0) || (fileStat.st_size <= 0)) {
+        ::close(fd);
+        return false;
+    }
+    void* pMapAddr = ::mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (pMapAddr == MAP_FAILED) {
+        return false;
+    }
+    m_pMapAddr = pMapAddr;
+    m_nMapSize = (size_t)fileStat.st_size;
+    m_pData = (const uint8_t*)pMapAddr;
+    m_nDataSize = (uint64_t)fileStat.st_size;
+#endif
+    return true;
+}
+
+void ZipArchive::UnmapFile()
+{
+#ifdef DUILIB_BUILD_FOR_WIN
+    if ((m_hFileMapping != nullptr) && (m_pData != nullptr)) {
+        ::UnmapViewOfFile(m_pData);
+    }
+    if (m_hFileMapping != nullptr) {
+        ::CloseHandle(m_hFileMapping);
+        m_hFileMapping = nullptr;
+    }
+    if (m_hFile != INVALID_HANDLE_VALUE) {
+        ::CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_pMapAddr != nullptr) {
+        ::munmap(m_pMapAddr, m_nMapSize);
+        m_pMapAddr = nullptr;
+        m_nMapSize = 0;
+    }
+#endif
+    m_pData = nullptr;
+    m_nDataSize = 0;
+}
+
+void ZipArchive::SetData(const uint8_t* pData, uint64_t nDataSize)
+{
+    UnmapFile();
+    m_pData = pData;
+    m_nDataSize = (pData != nullptr) ? nDataSize : 0;
+}
+
+uint64_t ZipArchive::GetLocalHeaderOffset(uint64_t nCentralDirOffset) const
+{
+    //中央目录的文件记录：固定部分46个字节，签名为0x02014b50，第42字节开始是本地文件头的偏移
+    const uint64_t kCentralDirItemSize = 46;
+    if ((m_pData == nullptr) || (nCentralDirOffset > m_nDataSize) || (m_nDataSize - nCentralDirOffset < kCentralDirItemSize)) {
+        return kInvalidZipOffset;
+    }
+    const uint8_t* p = m_pData + nCentralDirOffset;
+    if (ReadUInt32(p) != 0x02014b50) {
+        return kInvalidZipOffset;
+    }
+    uint32_t nOffset = ReadUInt32(p + 42);
+    if (nOffset == 0xFFFFFFFF) {
+        //ZIP64格式，偏移保存在扩展字段中，不直接读取
+        return kInvalidZipOffset;
+    }
+    return nOffset;
+}
+
+const uint8_t* ZipArchive::GetEntryData(const ZipEntry& zipEntry) const
+{
+    //本地文件头：固定部分30个字节，签名为0x04034b50，之后是文件名和扩展字段，然后是文件数据
+    const uint64_t kLocalHeaderSize = 30;
+    const uint64_t nOffset = zipEntry.m_nLocalHeaderOffset;
+    if ((m_pData == nullptr) || (nOffset == kInvalidZipOffset) ||
+        (nOffset > m_nDataSize) || (m_nDataSize - nOffset < kLocalHeaderSize)) {
+        return nullptr;
+    }
+    const uint8_t* p = m_pData + nOffset;
+    if (ReadUInt32(p) != 0x04034b50) {
+        return nullptr;
+    }
+    const uint64_t nDataOffset = nOffset + kLocalHeaderSize + ReadUInt16(p + 26) + ReadUInt16(p + 28);
+    if ((nDataOffset > m_nDataSize) || (m_nDataSize - nDataOffset < zipEntry.m_nCompressedSize)) {
+        return nullptr;
+    }
+    return m_pData + nDataOffset;
+}
+
+/** 解压Deflate算法压缩的数据
+*/
+static bool InflateZipData(const uint8_t* pData, uint64_t nDataSize, uint64_t nUncompressedSize,
+                           std::vector<unsigned char>& fileData)
+{
+    if ((nDataSize > UINT32_MAX) || (nUncompressedSize > UINT32_MAX)) {
+        return false;
+    }
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    //压缩包中的数据是不含zlib头的原始Deflate数据
+    if (::inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    fileData.resize((size_t)nUncompressedSize);
+    stream.next_in = (Bytef*)pData;
+    stream.avail_in = (uInt)nDataSize;
+    stream.next_out = fileData.data();
+    stream.avail_out = (uInt)fileData.size();
+    int nRet = ::inflate(&stream, Z_FINISH);
+    ::inflateEnd(&stream);
+    if ((nRet != Z_STREAM_END) || (stream.total_out != fileData.size())) {
+        fileData.clear();
+        return false;
+    }
+    return true;
+}
+
 ZipManager::ZipManager():
     m_hzip(nullptr)
 {
@@ -26,6 +347,8 @@ ZipManager::~ZipManager()
 
 bool ZipManager::IsUseZip() const
 {
+    //与打开、关闭压缩包及读取数据使用同一个锁，后台线程中调用也是安全的
+    std::lock_guard<std::mutex> guard(m_zipMutex);
     return m_hzip != nullptr;
 }
 
@@ -45,12 +368,19 @@ bool ZipManager::OpenResZip(HMODULE hModule, LPCTSTR resourceName, LPCTSTR resou
         return false;
     }
     CloseResZip();
+    std::lock_guard<std::mutex> guard(m_zipMutex);
     m_password = password;
     m_pZipStreamIO = std::make_unique<ZipStreamIO>(pData, nDataSize);
     zlib_filefunc_def pzlib_filefunc_def;
     m_pZipStreamIO->FillFopenFileFunc(&pzlib_filefunc_def);
     m_hzip = ::unzOpen2(nullptr, &pzlib_filefunc_def);
-    return m_hzip != nullptr;
+    if (m_hzip == nullptr) {
+        return false;
+    }
+    //资源数据在模块的生命周期内一直有效，可以直接访问
+    std::shared_ptr<ZipArchive> spZipArchive = std::make_shared<ZipArchive>();
+    spZipArchive->SetData(pData, nDataSize);
+    return BuildZipIndex(spZipArchive);
 }
 #endif
 
@@ -61,47 +391,191 @@ bool ZipManager::OpenZipFile(const FilePath& path, const DString& password)
     if (nativePath.empty()) {
         return false;
     }
+    std::lock_guard<std::mutex> guard(m_zipMutex);
     m_password = password;
     m_hzip = ::unzOpen(nativePath.c_str());
-    return m_hzip != nullptr;
+    if (m_hzip == nullptr) {
+        return false;
+    }
+    //映射失败时，仍然可以通过unzip接口读取文件内容
+    std::shared_ptr<ZipArchive> spZipArchive = std::make_shared<ZipArchive>();
+    bool bMapped = spZipArchive->MapFile(path);
+    ASSERT_UNUSED_VARIABLE(bMapped);
+    return BuildZipIndex(spZipArchive);
 }
 
-bool ZipManager::GetZipData(const FilePath& path, std::vector<unsigned char>& fileData) const
+bool ZipManager::BuildZipIndex(const std::shared_ptr<ZipArchive>& spZipArchive)
 {
-    fileData.clear();
-    GlobalManager::Instance().AssertUIThread();
+    //调用方已经加锁
+    //遍历中央目录一次，建立文件路径到文件位置的索引（::unzLocateFile函数是采用遍历所有文件的方式实现的，性能比较差）
     ASSERT(m_hzip != nullptr);
     if (m_hzip == nullptr) {
         return false;
     }
+    std::vector<char> szFileName;
+    szFileName.resize(MAX_PATH_LEN, 0);
+    int nRet = ::unzGoToFirstFile(m_hzip);
+    while (nRet == UNZ_OK) {
+        unz_file_info64 file_info;
+        memset(&file_info, 0, sizeof(file_info));
+        nRet = ::unzGetCurrentFileInfo64(m_hzip, &file_info, &szFileName[0], (uLong)szFileName.size() - 1, nullptr, 0, nullptr, 0);
+        if (nRet != UNZ_OK) {
+            break;
+        }
+        ZipEntry zipEntry;
+        if (::unzGetFilePos64(m_hzip, &zipEntry.m_filePos) != UNZ_OK) {
+            break;
+        }
+        zipEntry.m_nLocalHeaderOffset = spZipArchive->GetLocalHeaderOffset(::unzGetOffset64(m_hzip));
+        zipEntry.m_nCompressedSize = file_info.compressed_size;
+        zipEntry.m_nUncompressedSize = file_info.uncompressed_size;
+        zipEntry.m_nCrc32 = (uint32_t)file_info.crc;
+        zipEntry.m_nMethod = (uint32_t)file_info.compression_method;
+        zipEntry.m_bEncrypted = (file_info.flag & 1) != 0;
+
+        //文件名的编码是否为UTF8格式
+        bool bUtf8 = file_info.flag & (1 << 11);
+        zipEntry.m_fileName = GetZipFilePath(szFileName.data(), bUtf8);
+
+        // zip has an 'attribute' 32bit value. Its lower half is windows stuff
+        // its upper half is standard unix stat.st_mode. We'll start trying
+        // to read it in unix mode
+
+        //文件名是否是目录
+        bool bDir = (file_info.external_fa & 0x40000000) != 0;
+        // but in normal hostmodes these are overridden by the lower half...
+        int host = file_info.version >> 8;
+        if (host == 0 || host == 7 || host == 11 || host == 14) {
+            //0 - FAT filesystem (MS-DOS, OS/2, NT/Win32)
+            //7 - Macintosh
+            //11 - NTFS filesystem (NT)
+            //14 - VFAT
+            bDir = (file_info.external_fa & 0x00000010) != 0;
+        }
+        zipEntry.m_bDir = bDir;
+
+#ifdef DUILIB_BUILD_FOR_WIN
+        DStringW innerFilePath = StringUtil::MBCSToUnicode(szFileName.data(), bUtf8 ? CP_UTF8 : CP_ACP);
+#else
+        DStringW innerFilePath = StringUtil::UTF8ToUTF16(szFileName.data());
+#endif
+        //压缩包内的文件名，都不区分大小写，转换为小写再比较
+        innerFilePath = StringUtil::MakeLowerString(innerFilePath);
+        NormalizeZipFilePath(innerFilePath);
+        if (spZipArchive->m_entryIndex.find(innerFilePath) == spZipArchive->m_entryIndex.end()) {
+            spZipArchive->m_entryIndex[innerFilePath] = spZipArchive->m_entries.size();
+            spZipArchive->m_entries.push_back(std::move(zipEntry));
+        }
+
+        //下一个文件
+        nRet = ::unzGoToNextFile(m_hzip);
+    }
+    spZipArchive->InitCrcStates();
+    m_spZipArchive = spZipArchive;
+    return true;
+}
+
+std::shared_ptr<ZipArchive> ZipManager::GetZipArchive() const
+{
+    std::lock_guard<std::mutex> guard(m_zipMutex);
+    return m_spZipArchive;
+}
+
+const ZipEntry* ZipManager::FindZipEntry(const std::shared_ptr<ZipArchive>& spZipArchive, const FilePath& path) const
+{
+    if ((spZipArchive == nullptr) || path.IsEmpty()) {
+        return nullptr;
+    }
     const FilePath normalizePath = FilePathUtil::NormalizeFilePath(path);
-    std::string filePathA;
-    if (!LocateFile(normalizePath, filePathA)) {
-        return false;
+    DStringW innerFilePath = normalizePath.ToStringW();
+    innerFilePath = StringUtil::MakeLowerString(innerFilePath);
+    NormalizeZipFilePath(innerFilePath);
+    auto iter = spZipArchive->m_entryIndex.find(innerFilePath);
+    if (iter == spZipArchive->m_entryIndex.end()) {
+        return nullptr;
     }
+    return &spZipArchive->m_entries[iter->second];
+}
 
-    size_t fileNameLen = std::max(filePathA.size() + 1, MAX_PATH_LEN);
-    std::vector<char> szFileName;
-    szFileName.resize(fileNameLen, 0);
-    unz_file_info file_info = {0, };
-    int nRet = ::unzGetCurrentFileInfo(m_hzip, &file_info, &szFileName[0], (uLong)szFileName.size() - 1, nullptr, 0, nullptr, 0);
-    if (nRet != UNZ_OK) {
+bool ZipManager::GetZipData(const FilePath& path, std::vector<unsigned char>& fileData) const
+{
+    fileData.clear();
+    std::shared_ptr<ZipArchive> spZipArchive = GetZipArchive();
+    const ZipEntry* pZipEntry = FindZipEntry(spZipArchive, path);
+    if ((pZipEntry == nullptr) || (pZipEntry->m_nUncompressedSize == 0)) {
         return false;
     }
-    
-    if (file_info.uncompressed_size == 0) {
-        return false;
+
+    //未加密的文件，直接从压缩包数据中读取（无需加锁，支持多线程并发）
+    const uint8_t* pEntryData = pZipEntry->m_bEncrypted ? nullptr : spZipArchive->GetEntryData(*pZipEntry);
+    if (pEntryData != nullptr) {
+        bool bRet = false;
+        if ((pZipEntry->m_nMethod == 0) && (pZipEntry->m_nCompressedSize == pZipEntry->m_nUncompressedSize)) {
+            fileData.assign(pEntryData, pEntryData + pZipEntry->m_nUncompressedSize);
+            bRet = true;
+        }
+        else if (pZipEntry->m_nMethod == Z_DEFLATED) {
+            bRet = InflateZipData(pEntryData, pZipEntry->m_nCompressedSize, pZipEntry->m_nUncompressedSize, fileData);
+        }
+        if (bRet) {
+            if (::crc32(0, fileData.data(), (uInt)fileData.size()) == pZipEntry->m_nCrc32) {
+                return true;
+            }
+            ASSERT(!"ZipManager::GetZipData crc32 check failed!");
+            fileData.clear();
+            return false;
+        }
     }
+    return ReadZipDataByUnzip(spZipArchive, *pZipEntry, fileData);
+}
 
-    //文件是否加密
-    bool bFileEncrypted = file_info.flag & 1;
+std::shared_ptr<const void> ZipManager::GetZipDataView(const FilePath& path, const uint8_t*& pData, size_t& nDataSize) const
+{
+    pData = nullptr;
+    nDataSize = 0;
+    std::shared_ptr<ZipArchive> spZipArchive = GetZipArchive();
+    const ZipEntry* pZipEntry = FindZipEntry(spZipArchive, path);
+    if ((pZipEntry == nullptr) || (pZipEntry->m_nUncompressedSize == 0)) {
+        return nullptr;
+    }
+    if (!pZipEntry->m_bEncrypted && (pZipEntry->m_nMethod == 0) &&
+        (pZipEntry->m_nCompressedSize == pZipEntry->m_nUncompressedSize)) {
+        //未压缩存储的文件：直接引用压缩包中的数据，返回的持有对象保持压缩包数据有效
+        const uint8_t* pEntryData = spZipArchive->GetEntryData(*pZipEntry);
+        if ((pEntryData != nullptr) && (pZipEntry->m_nUncompressedSize <= SIZE_MAX)) {
+            //与GetZipData一致，校验文件内容（每个文件只校验一次）
+            if (!spZipArchive->VerifyEntryCrc(*pZipEntry, pEntryData, (size_t)pZipEntry->m_nUncompressedSize)) {
+                ASSERT(!"ZipManager::GetZipDataView crc32 check failed!");
+                return nullptr;
+            }
+            pData = pEntryData;
+            nDataSize = (size_t)pZipEntry->m_nUncompressedSize;
+            return spZipArchive;
+        }
+    }
+    std::shared_ptr<std::vector<unsigned char>> spFileData = std::make_shared<std::vector<unsigned char>>();
+    if (!GetZipData(path, *spFileData)) {
+        return nullptr;
+    }
+    pData = spFileData->data();
+    nDataSize = spFileData->size();
+    return spFileData;
+}
 
-    nRet = ::unzStringFileNameCompare(szFileName.data(), filePathA.c_str(), 0);
-    ASSERT(nRet == 0);
-    if (nRet != 0) {
+bool ZipManager::ReadZipDataByUnzip(const std::shared_ptr<ZipArchive>& spZipArchive, const ZipEntry& zipEntry,
+                                    std::vector<unsigned char>& fileData) const
+{
+    fileData.clear();
+    std::lock_guard<std::mutex> guard(m_zipMutex);
+    if ((m_hzip == nullptr) || (m_spZipArchive != spZipArchive)) {
+        //压缩包已经关闭或者重新打开
+        return false;
+    }
+    int nRet = ::unzGoToFilePos64(m_hzip, &zipEntry.m_filePos);
+    if (nRet != UNZ_OK) {
         return false;
     }
-    if (!m_password.empty() && bFileEncrypted) {
+    if (!m_password.empty() && zipEntry.m_bEncrypted) {
         //密码是本地编码的（ANSI）
         std::string password;
 #ifdef DUILIB_BUILD_FOR_WIN
@@ -122,7 +596,7 @@ bool ZipManager::GetZipData(const FilePath& path, std::vector<unsigned char>& fi
         return false;
     }
 
-    fileData.resize(file_info.uncompressed_size);
+    fileData.resize((size_t)zipEntry.m_nUncompressedSize);
     nRet = ::unzReadCurrentFile(m_hzip, &fileData[0], (uLong)fileData.size());
     ::unzCloseCurrentFile(m_hzip);
     ASSERT(nRet == fileData.size());
@@ -135,99 +609,25 @@ bool ZipManager::GetZipData(const FilePath& path, std::vector<unsigned char>& fi
 
 bool ZipManager::IsZipResExist(const FilePath& path) const
 {
-    GlobalManager::Instance().AssertUIThread();
-    if ((m_hzip == nullptr) || path.IsEmpty()) {
-        return false;
-    }
-    if (m_zipPathCache.empty()) {
-        //首次查询时，建立缓存，避免每次都需要遍历整个压缩包的文件（::unzLocateFile函数是采用遍历所有文件的方式实现的，性能比较差）
-        int nRet = ::unzGoToFirstFile(m_hzip);
-        while (nRet == UNZ_OK) {
-            size_t fileNameLen = MAX_PATH_LEN;
-            std::vector<char> szFileName;
-            szFileName.resize(fileNameLen, 0);
-            unz_file_info file_info = { 0, };
-            nRet = ::unzGetCurrentFileInfo(m_hzip, &file_info, &szFileName[0], (uLong)szFileName.size() - 1, nullptr, 0, nullptr, 0);
-            if (nRet == UNZ_OK) {
-                //文件名的编码是否为UTF8格式
-                bool bUtf8 = file_info.flag & (1 << 11);
-                DString fileName = GetZipFilePath(szFileName.data(), bUtf8);
-
-#ifdef DUILIB_BUILD_FOR_WIN
-                DStringW innerFilePath = StringUtil::MBCSToUnicode(szFileName.data(), bUtf8 ? CP_UTF8 : CP_ACP);
-#else
-                DStringW innerFilePath = StringUtil::UTF8ToUTF16(szFileName.data());
-#endif
-                //压缩包内的文件名，都不区分大小写，转换为小写再比较
-                innerFilePath = StringUtil::MakeLowerString(innerFilePath);
-                //加入缓存
-                m_zipPathCache.insert(innerFilePath);
-
-                //下一个文件
-                nRet = ::unzGoToNextFile(m_hzip);
-            }
-        }
-    }
-
-    const FilePath normalizePath = FilePathUtil::NormalizeFilePath(path);
-    DStringW innerFilePath = normalizePath.ToStringW();
-    innerFilePath = StringUtil::MakeLowerString(innerFilePath);
-    NormalizeZipFilePath(innerFilePath);
-    auto it = m_zipPathCache.find(innerFilePath);
-    if (it != m_zipPathCache.end()) {
-        return true;
-    }
-    return false;
-}
-
-bool ZipManager::LocateFile(const FilePath& normalizePath, std::string& filePathA) const
-{
-    //压缩包内文件路径的编码是每个文件都不同的，定位的时候无法确定文件名编码，只能依次尝试
-    filePathA = normalizePath.NativePathA();//优先尝试MBCS编码
-    ASSERT(!filePathA.empty());
-    if (filePathA.empty()) {
-        return false;
-    }
-    NormalizeZipFilePath(filePathA);
-    const int iCaseSensitivity = 2; //不区分大小写
-    int nRet = ::unzLocateFile(m_hzip, filePathA.c_str(), iCaseSensitivity);
-    if (nRet == UNZ_OK) {
-        return true;
-    }
-
-    std::string oldFilePathA = filePathA;
-    filePathA = normalizePath.ToStringA();//再尝试UTF8编码
-    ASSERT(!filePathA.empty());
-    if (filePathA.empty()) {
-        return false;
-    }
-    NormalizeZipFilePath(filePathA);
-    if (oldFilePathA == filePathA) {
-        //路径无变化，不再重复查询
-        return false;
-    }
-    nRet = ::unzLocateFile(m_hzip, filePathA.c_str(), iCaseSensitivity);
-    if (nRet == UNZ_OK) {
-        return true;
-    }
-    filePathA.clear();
-    return false;
+    std::shared_ptr<ZipArchive> spZipArchive = GetZipArchive();
+    return FindZipEntry(spZipArchive, path) != nullptr;
 }
 
 void ZipManager::CloseResZip()
 {
+    std::lock_guard<std::mutex> guard(m_zipMutex);
     if (m_hzip != nullptr) {
         ::unzClose(m_hzip);
         m_hzip = nullptr;
     }
-    m_zipPathCache.clear();
+    //其他线程正在读取的压缩包数据，在读取完成后释放
+    m_spZipArchive.reset();
     m_pZipStreamIO.reset();
 }
 
 bool ZipManager::GetZipFileList(const FilePath& dirPath, std::vector<DString>& fileList) const
 {
     fileList.clear();
-    GlobalManager::Instance().AssertUIThread();
     DString filePath = dirPath.NativePath();
     if (!filePath.empty() &&
         (filePath[filePath.size() - 1] != _T('\\')) &&
@@ -235,57 +635,24 @@ bool ZipManager::GetZipFileList(const FilePath& dirPath, std::vector<DString>& f
         filePath += _T("/");
     }
     DString innerPath = FilePathUtil::NormalizeFilePath(filePath);
-    if (innerPath.empty() || (m_hzip == nullptr)) {
+    std::shared_ptr<ZipArchive> spZipArchive = GetZipArchive();
+    if (innerPath.empty() || (spZipArchive == nullptr)) {
         return false;
     }
     //路径分隔符统一替换成 '/'
     NormalizeZipFilePath(innerPath);
-    int nRet = ::unzGoToFirstFile(m_hzip);
-    if (nRet != UNZ_OK) {
-        return false;
-    }
-    DString fileName;
-    while (nRet == UNZ_OK) {
-        size_t fileNameLen = MAX_PATH_LEN;
-        std::vector<char> szFileName;
-        szFileName.resize(fileNameLen, 0);
-        unz_file_info file_info = { 0, };
-        nRet = ::unzGetCurrentFileInfo(m_hzip, &file_info, &szFileName[0], (uLong)szFileName.size() - 1, nullptr, 0, nullptr, 0);
-        if (nRet != UNZ_OK) {
-            return false;
+    for (const ZipEntry& zipEntry : spZipArchive->m_entries) {
+        if (zipEntry.m_bDir) {
+            continue;
         }
-
-        //文件名的编码是否为UTF8格式
-        bool bUtf8 = file_info.flag & (1 << 11);
-        fileName = GetZipFilePath(szFileName.data(), bUtf8);
-
-        // zip has an 'attribute' 32bit value. Its lower half is windows stuff
-        // its upper half is standard unix stat.st_mode. We'll start trying
-        // to read it in unix mode
-
-        //文件名是否是目录
-        bool bDir = (file_info.external_fa & 0x40000000) != 0;
-        // but in normal hostmodes these are overridden by the lower half...
-        int host = file_info.version >> 8;
-        if (host == 0 || host == 7 || host == 11 || host == 14) {
-            //0 - FAT filesystem (MS-DOS, OS/2, NT/Win32)
-            //7 - Macintosh
-            //11 - NTFS filesystem (NT)
-            //14 - VFAT
-            bDir = (file_info.external_fa & 0x00000010) != 0;
-        }
-        if (!bDir) {
-            size_t nPos = fileName.find(innerPath);
-            if ((nPos == 0) && (fileName.size() > innerPath.size())) {
-                fileName = fileName.substr(innerPath.size());
-                if (fileName.find(_T('/')) == DString::npos) {
-                    fileList.push_back(fileName);
-                }
+        const DString& fileName = zipEntry.m_fileName;
+        size_t nPos = fileName.find(innerPath);
+        if ((nPos == 0) && (fileName.size() > innerPath.size())) {
+            DString subFileName = fileName.substr(innerPath.size());
+            if (subFileName.find(_T('/')) == DString::npos) {
+                fileList.push_back(subFileName);
             }
         }
-
-        //跳到下一个文件
-        nRet = ::unzGoToNextFile(m_hzip);
     }
     return true;
 }
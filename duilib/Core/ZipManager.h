@@ -4,18 +4,21 @@
 #include "duilib/Utils/FilePath.h"
 #include <string>
 #include <vector>
-#include <unordered_set>
 #include <memory>
+#include <mutex>
 
 namespace ui 
 {
 class ZipStreamIO;
+class ZipArchive;
+struct ZipEntry;
 
 /**ZIP压缩包管理器
  * 说明：
  * （1）Zip压缩包支持的压缩算法是：Deflate算法，其他算法均不支持(也不支持Deflate64算法)
  * （2）使用7-Zip做压缩包的时候，如果自定义参数：cu=on，可以制作出文件名编码为UTF-8的压缩包；若不设置，默认文件名编码是本机编码
  * （3）如果设置了密码，需要使用传统的密码加密算法，否则无法解压。（使用"ZIP legacy encryption"模式 或者 "ZipCrypto"算法的密码）
+ * （4）打开压缩包时，对所有文件建立索引；压缩包文件通过内存映射方式访问，读取文件内容的函数支持多线程并发调用
  */
 class UILIB_API ZipManager
 {
@@ -53,6 +56,15 @@ public:
      */
     bool GetZipData(const FilePath& path, std::vector<unsigned char>& fileData) const;
 
+    /** 获取压缩包中文件内容的只读视图：未压缩存储的文件，直接引用压缩包中的数据（无内存复制），其他文件解压到内存中
+     *  文件内容都会校验CRC32：直接引用的文件，每个文件只在首次访问时校验一次，校验失败时返回nullptr
+     * @param [in] path 要获取的文件的路径(压缩包内路径)
+     * @param [out] pData 返回文件内容的起始地址
+     * @param [out] nDataSize 返回文件内容的长度
+     * @return 返回文件内容的持有对象，文件内容在该对象释放前有效（关闭压缩包后仍然有效）；失败返回nullptr
+     */
+    std::shared_ptr<const void> GetZipDataView(const FilePath& path, const uint8_t*& pData, size_t& nDataSize) const;
+
     /** 判断资源是否存在zip当中
      * @param[in] path 要判断的资源路径(压缩包内路径)
      */
@@ -74,22 +86,38 @@ private:
     void NormalizeZipFilePath(std::string& innerFilePath) const;
     void NormalizeZipFilePath(std::wstring& innerFilePath) const;
 
-    /** 在压缩包中定位文件
-    * @param [in] normalizePath 文件路径
-    * @param [out] filePathA 返回压缩包内的文件路径（MBCS或者UTF8编码）
-    * @return 定位成功返回true，否则返回false
-    */
-    bool LocateFile(const FilePath& normalizePath, std::string& filePathA) const;
-
     /** 获取压缩包内的路径(转换字符串编码)
     * @param [in] szInZipFilePath 要获取的文件路径(压缩包内路径)
     * @param [in] bUtf8 true表示UTF8编码，否则为Ansi编码
     */
     DString GetZipFilePath(const char* szInZipFilePath, bool bUtf8) const;
 
+    /** 遍历压缩包中的所有文件，建立索引
+    * @param [in] spZipArchive 压缩包对象（如果压缩包数据已经映射到内存，可以直接读取文件内容）
+    */
+    bool BuildZipIndex(const std::shared_ptr<ZipArchive>& spZipArchive);
+
+    /** 获取当前打开的压缩包对象（多线程安全）
+    */
+    std::shared_ptr<ZipArchive> GetZipArchive() const;
+
+    /** 在压缩包中查找文件
+    * @param [in] spZipArchive 压缩包对象
+    * @param [in] path 文件路径(压缩包内路径)
+    */
+    const ZipEntry* FindZipEntry(const std::shared_ptr<ZipArchive>& spZipArchive, const FilePath& path) const;
+
+    /** 通过unzip接口读取文件内容（加密的文件，或者无法直接读取的文件），需要加锁，不支持并发
+    * @param [in] spZipArchive 压缩包对象
+    * @param [in] zipEntry 文件索引
+    * @param [out] fileData 返回文件内容
+    */
+    bool ReadZipDataByUnzip(const std::shared_ptr<ZipArchive>& spZipArchive, const ZipEntry& zipEntry,
+                            std::vector<unsigned char>& fileData) const;
+
 private:
     
-    /** 打开的压缩包句柄
+    /** 打开的压缩包句柄（访问时需要加锁）
     */
     void* m_hzip;
 
@@ -101,9 +129,13 @@ private:
     */
     std::unique_ptr<ZipStreamIO> m_pZipStreamIO;
 
-    /** 路径缓存
+    /** 已建立索引的压缩包对象
+    */
+    std::shared_ptr<ZipArchive> m_spZipArchive;
+
+    /** 压缩包句柄和压缩包对象的多线程保护锁
     */
-    mutable std::unordered_set<DStringW> m_zipPathCache;
+    mutable std::mutex m_zipMutex;
 };
 
 }
@@ -42,6 +42,7 @@
 #include "duilib/third_party/libwebp/src/webp/demux.h"
 
 #include "duilib/Utils/PerformanceUtil.h"
+#include "duilib/Utils/PixelUtil.h"
 
 namespace ui 
 {
@@ -142,18 +143,10 @@ namespace STBImageLoader
             argbData.resize((size_t)nHeight * nWidth * desired_channels);
             const size_t colorCount = (size_t)nHeight * nWidth;
 
-            //数据格式转换：ABGR[alpha, blue, green, red] -> ARGB[alpha, red, green, blue]                
-            for (size_t i = 0; i < colorCount; ++i) {
-                size_t colorIndex = i * 4;
-                if (channels_in_file == 4) {
-                    argbData[colorIndex + 3] = rgbaData[colorIndex + 3]; //A, alpha
-                }
-                else {
-                    argbData[colorIndex + 3] = 255; //A, alpha
-                }
-                argbData[colorIndex + 0] = rgbaData[colorIndex + 2]; //B, blue
-                argbData[colorIndex + 1] = rgbaData[colorIndex + 1]; //G, green
-                argbData[colorIndex + 2] = rgbaData[colorIndex + 0]; //R, red
+            //数据格式转换：ABGR[alpha, blue, green, red] -> ARGB[alpha, red, green, blue]
+            PixelUtil::SwapRedBlue(rgbaData, argbData.data(), colorCount);
+            if (channels_in_file != 4) {
+                PixelUtil::SetAlphaOpaque(argbData.data(), colorCount);
             }
 
             imageData.bFlipHeight = true;
@@ -187,24 +180,8 @@ namespace APNGImageLoader
         if (p == nullptr) {
             return false;
         }
-        int pixel_count = nWid * nHei * pngData->nFrames;
-        for (int i = 0; i < pixel_count; ++i) {
-            uint8_t a = p[3];
-            uint8_t t = p[0];
-            if (a)
-            {
-                p[0] = (p[2] * a) / 255;
-                p[1] = (p[1] * a) / 255;
-                p[2] = (t * a) / 255;
-            }
-            else
-            {
-                memset(p, 0, 4);
-            }
-            p += 4;
-        }
-
-        p = pngData->pdata;
+        const size_t pixel_count = (size_t)nWid * nHei * pngData->nFrames;
+        PixelUtil::PremultiplyAlpha(p, p, pixel_count, true);
 
         imageData.resize(pngData->nFrames);
         for (int i = 0; i < pngData->nFrames; ++i) {
@@ -321,17 +298,9 @@ namespace SVGImageLoader
         nsvgRasterize(rast.get(), svg.get(), 0, 0, scale, pBmpBits, width, height, width * dataSize);
 
         // nanosvg内部已经做过alpha预乘，这里只做R和B的交换
-        for (int y = 0; y < height; ++y) {
-            unsigned char* row = &pBmpBits[y * width * dataSize];
-            for (int x = 0; x < width; ++x) {
-                //SVG    数据的各个颜色值：row[0]:R, row[1]: G, row[2]: B, row[3]: A
-                //输出    数据的各个颜色值：row[0]:B, row[1]: G, row[2]: R, row[3]: A
-                unsigned char r = row[0];
-                row[0] = row[2];
-                row[2] = r;
-                row += 4;
-            }
-        }
+        //SVG    数据的各个颜色值：[0]:R, [1]: G, [2]: B, [3]: A
+        //输出    数据的各个颜色值：[0]:B, [1]: G, [2]: R, [3]: A
+        PixelUtil::SwapRedBlue(pBmpBits, pBmpBits, (size_t)height * width);
 
         imageData.m_frameInterval = 0;
         imageData.bFlipHeight = true;
@@ -347,6 +316,69 @@ namespace SVGImageLoader
 */
 namespace CxImageLoader
 {
+    /** 将一帧图片转换为ARGB格式的位图数据
+    */
+    bool ConvertFrameData(CxImage* cxFrame, ImageDecoder::ImageData& bitmapData)
+    {
+        ASSERT(cxFrame != nullptr);
+        if (cxFrame == nullptr) {
+            return false;
+        }
+        uint32_t nWidth = cxFrame->GetWidth();
+        uint32_t nHeight = cxFrame->GetHeight();
+        ASSERT((nWidth > 0) && (nHeight > 0));
+        if ((nWidth == 0) && (nHeight == 0)) {
+            return false;
+        }
+
+        int32_t lPx = 0;
+        int32_t lPy = 0;
+        bitmapData.m_bitmapData.resize((size_t)nHeight * nWidth * 4);
+        RGBQUAD* pBit = (RGBQUAD*)bitmapData.m_bitmapData.data();
+        bool bHasAlpha = false;
+        for (lPy = 0; lPy < (int32_t)nHeight; ++lPy) {
+            for (lPx = 0; lPx < (int32_t)nWidth; ++lPx) {
+                *pBit = cxFrame->GetPixelColor(lPx, lPy, true);
+                if (!cxFrame->AlphaIsValid() && !cxFrame->IsTransparent() && !cxFrame->AlphaPaletteIsEnabled()) {
+                    //如果不含有Alpha通道，则填充A值为固定值
+                    pBit->rgbReserved = 255;
+                }
+                else {
+                    //图片含有Alpha通道
+                    uint8_t a = pBit->rgbReserved;
+                    if (!cxFrame->AlphaIsValid()) {
+                        a = 255;
+                    }
+
+                    int32_t transIndex = cxFrame->GetTransIndex();//Gets the index used for transparency. Returns -1 for no transparancy.
+                    int32_t bitCount = cxFrame->GetBpp();//1, 4, 8, 24.
+                    int32_t numColors = cxFrame->GetNumColors();//2, 16, 256; 0 for RGB images.
+                    if ((transIndex >= 0) && (bitCount < 24) && (numColors != 0) && (cxFrame->GetDIB() != nullptr)) {
+                        RGBQUAD transColor = cxFrame->GetTransColor();
+                        if ((transColor.rgbRed == pBit->rgbRed) &&
+                            (transColor.rgbGreen == pBit->rgbGreen) &&
+                            (transColor.rgbBlue == pBit->rgbBlue)) {
+                            //透明色，标记Alpha通道为全透明
+                            a = 0;
+                        }
+                    }                                                                
+                    pBit->rgbReserved = a;
+                    bHasAlpha = true;
+                }
+                ++pBit;
+            }
+        }
+        if (bHasAlpha) {
+            //Alpha预乘
+            PixelUtil::PremultiplyAlpha(bitmapData.m_bitmapData.data(), bitmapData.m_bitmapData.data(),
+                                        (size_t)nHeight * nWidth, false);
+        }
+        bitmapData.m_imageWidth = nWidth;
+        bitmapData.m_imageHeight = nHeight;
+        bitmapData.bFlipHeight = false;
+        return true;
+    }
+
     bool LoadImageFromMemory(std::vector<uint8_t>& fileData, 
                              std::vector<ImageDecoder::ImageData>& imageData, 
                              bool isIconFile,
@@ -403,60 +435,12 @@ namespace CxImageLoader
             }
             frameNumColors[index] = cxFrame->GetNumColors();////2, 16, 256; 0 for RGB images.
 
-            uint32_t nWidth = cxFrame->GetWidth();
-            uint32_t nHeight = cxFrame->GetHeight();
-            ASSERT((nWidth > 0) && (nHeight > 0));
-            if ((nWidth == 0) && (nHeight == 0)) {
+            ImageDecoder::ImageData& bitmapData = imageData[index];
+            if (!ConvertFrameData(cxFrame, bitmapData)) {
                 imageData.clear();
                 return false;
             }
-
-            int32_t lPx = 0;
-            int32_t lPy = 0;
-            ImageDecoder::ImageData& bitmapData = imageData[index];
-            bitmapData.m_bitmapData.resize((size_t)nHeight * nWidth * 4);
-            RGBQUAD* pBit = (RGBQUAD*)bitmapData.m_bitmapData.data();
-            for (lPy = 0; lPy < (int32_t)nHeight; ++lPy) {
-                for (lPx = 0; lPx < (int32_t)nWidth; ++lPx) {
-                    *pBit = cxFrame->GetPixelColor(lPx, lPy, true);
-                    if (!cxFrame->AlphaIsValid() && !cxFrame->IsTransparent() && !cxFrame->AlphaPaletteIsEnabled()) {
-                        //如果不含有Alpha通道，则填充A值为固定值
-                        pBit->rgbReserved = 255;
-                    }
-                    else {
-                        //图片含有Alpha通道
-                        uint8_t a = pBit->rgbReserved;
-                        if (!cxFrame->AlphaIsValid()) {
-                            a = 255;
-                        }
-
-                        int32_t transIndex = cxFrame->GetTransIndex();//Gets the index used for transparency. Returns -1 for no transparancy.
-                        int32_t bitCount = cxFrame->GetBpp();//1, 4, 8, 24.
-                        int32_t numColors = cxFrame->GetNumColors();//2, 16, 256; 0 for RGB images.
-                        if ((transIndex >= 0) && (bitCount < 24) && (numColors != 0) && (cxFrame->GetDIB() != nullptr)) {
-                            RGBQUAD transColor = cxFrame->GetTransColor();
-                            if ((transColor.rgbRed == pBit->rgbRed) &&
-                                (transColor.rgbGreen == pBit->rgbGreen) &&
-                                (transColor.rgbBlue == pBit->rgbBlue)) {
-                                //透明色，标记Alpha通道为全透明
-                                a = 0;
-                            }
-                        }                                                                
-                        pBit->rgbReserved = a;
-
-                        if ((a > 0) && (a < 255)) {
-                            pBit->rgbRed = pBit->rgbRed * a / 255;
-                            pBit->rgbGreen = pBit->rgbGreen * a / 255;
-                            pBit->rgbBlue = pBit->rgbBlue * a / 255;
-                        }
-                    }
-                    ++pBit;
-                }
-            }
             bitmapData.m_frameInterval = frameDelay * 10;
-            bitmapData.m_imageWidth = nWidth;
-            bitmapData.m_imageHeight = nHeight;
-            bitmapData.bFlipHeight = false;
         }
 
         if (isIconFile) {
@@ -497,6 +481,70 @@ namespace CxImageLoader
         }
         return !imageData.empty();
     }
+
+    /** GIF动画的图片帧解码器：保留解码后的调色板格式图片帧，显示时才转换为ARGB格式的位图数据
+    *   （cximage不支持单独解码某一帧，但调色板格式的图片帧只占ARGB格式的1/4内存）
+    */
+    class GifFrameDecoder: public ImageFrameDecoder
+    {
+    public:
+        /** 解码GIF图片，返回每帧的播放时间间隔，如果不是多帧图片，返回false
+        */
+        bool Init(std::vector<uint8_t>& fileData, std::vector<int32_t>& frameIntervals)
+        {
+            frameIntervals.clear();
+            ASSERT(!fileData.empty());
+            if (fileData.empty()) {
+                return false;
+            }
+            CxMemFile stream(fileData.data(), (uint32_t)fileData.size());
+            m_cxImage = std::make_unique<CxImage>(CXIMAGE_FORMAT_GIF);
+            m_cxImage->SetRetreiveAllFrames(true);
+            bool isLoaded = m_cxImage->Decode(&stream, CXIMAGE_FORMAT_GIF);
+            const int32_t frameCount = m_cxImage->GetNumFrames();
+            if (!isLoaded || !m_cxImage->IsValid() || (frameCount < 2)) {
+                m_cxImage.reset();
+                return false;
+            }
+            uint32_t lastFrameDelay = 0;
+            for (int32_t index = 0; index < frameCount; ++index) {
+                CxImage* cxFrame = m_cxImage->GetFrame(index);
+                if (cxFrame == nullptr) {
+                    frameIntervals.clear();
+                    m_cxImage.reset();
+                    return false;
+                }
+                uint32_t frameDelay = cxFrame->GetFrameDelay();
+                if (frameDelay == 0) {
+                    frameDelay = lastFrameDelay;
+                }
+                else {
+                    lastFrameDelay = frameDelay;
+                }
+                frameIntervals.push_back((int32_t)frameDelay * 10);
+            }
+            m_nFrameCount = (uint32_t)frameCount;
+            return true;
+        }
+
+        virtual uint32_t GetFrameCount() const override
+        {
+            return m_nFrameCount;
+        }
+
+    protected:
+        virtual bool OnDecodeFrame(uint32_t nFrameIndex, ImageDecoder::ImageData& frameData) override
+        {
+            if ((m_cxImage == nullptr) || (nFrameIndex >= m_nFrameCount)) {
+                return false;
+            }
+            return ConvertFrameData(m_cxImage->GetFrame((int32_t)nFrameIndex), frameData);
+        }
+
+    private:
+        std::unique_ptr<CxImage> m_cxImage;
+        uint32_t m_nFrameCount = 0;
+    };
 }//CxImageLoader
 
 /** 使用libWebP加载图片
@@ -560,6 +608,152 @@ namespace WebPImageLoader
         playCount = (int32_t)loopCount;
         return !imageData.empty();
     }
+
+    /** WebP动画的图片帧解码器：保留原始的文件数据，显示时才解码该帧
+    */
+    class WebPFrameDecoder: public ImageFrameDecoder
+    {
+    public:
+        virtual ~WebPFrameDecoder() override
+        {
+            if (m_pDemuxer != nullptr) {
+                WebPDemuxDelete(m_pDemuxer);
+                m_pDemuxer = nullptr;
+            }
+        }
+
+        /** 解析WebP图片，返回每帧的播放时间间隔，如果不是多帧图片，返回false
+        */
+        bool Init(const std::vector<uint8_t>& fileData, std::vector<int32_t>& frameIntervals, int32_t& playCount)
+        {
+            frameIntervals.clear();
+            ASSERT(!fileData.empty());
+            if (fileData.empty()) {
+                return false;
+            }
+            m_fileData = fileData;
+            WebPData wd = { m_fileData.data() , m_fileData.size() };
+            m_pDemuxer = WebPDemux(&wd);
+            if (m_pDemuxer == nullptr) {
+                return false;
+            }
+            uint32_t frameCount = WebPDemuxGetI(m_pDemuxer, WEBP_FF_FRAME_COUNT);
+            if (frameCount < 2) {
+                return false;
+            }
+            // libwebp's index start with 1
+            for (int frame_idx = 1; frame_idx <= (int)frameCount; ++frame_idx) {
+                WebPIterator iter;
+                if (WebPDemuxGetFrame(m_pDemuxer, frame_idx, &iter) == 0) {
+                    WebPDemuxReleaseIterator(&iter);
+                    frameIntervals.clear();
+                    return false;
+                }
+                frameIntervals.push_back(iter.duration);
+                WebPDemuxReleaseIterator(&iter);
+            }
+            playCount = (int32_t)WebPDemuxGetI(m_pDemuxer, WEBP_FF_LOOP_COUNT);
+            m_nFrameCount = frameCount;
+            return true;
+        }
+
+        virtual uint32_t GetFrameCount() const override
+        {
+            return m_nFrameCount;
+        }
+
+    protected:
+        virtual bool OnDecodeFrame(uint32_t nFrameIndex, ImageDecoder::ImageData& frameData) override
+        {
+            if ((m_pDemuxer == nullptr) || (nFrameIndex >= m_nFrameCount)) {
+                return false;
+            }
+            WebPIterator iter;
+            if (WebPDemuxGetFrame(m_pDemuxer, (int)nFrameIndex + 1, &iter) == 0) {
+                WebPDemuxReleaseIterator(&iter);
+                return false;
+            }
+            int width = 0;
+            int hight = 0;
+            uint8_t* decode_data = WebPDecodeBGRA(iter.fragment.bytes, iter.fragment.size, &width, &hight);
+            bool bDecoded = (decode_data != nullptr) && (width > 0) && (hight > 0);
+            if (bDecoded) {
+                const size_t dataSize = (size_t)width * hight * 4;
+                frameData.m_bitmapData.resize(dataSize);
+                memcpy(frameData.m_bitmapData.data(), decode_data, dataSize);
+                frameData.m_imageWidth = width;
+                frameData.m_imageHeight = hight;
+                frameData.m_frameInterval = iter.duration;
+            }
+            if (decode_data != nullptr) {
+                WebPFree(decode_data);
+            }
+            WebPDemuxReleaseIterator(&iter);
+            return bDecoded;
+        }
+
+    private:
+        std::vector<uint8_t> m_fileData;
+        WebPDemuxer* m_pDemuxer = nullptr;
+        uint32_t m_nFrameCount = 0;
+    };
+}
+
+ImageFrameDecoder::ImageFrameDecoder():
+    m_nFrameWidth(0),
+    m_nFrameHeight(0)
+{
+}
+
+ImageFrameDecoder::~ImageFrameDecoder()
+{
+}
+
+void ImageFrameDecoder::SetFrameSize(uint32_t nWidth, uint32_t nHeight)
+{
+    m_nFrameWidth = nWidth;
+    m_nFrameHeight = nHeight;
+}
+
+bool ImageFrameDecoder::DecodeFrame(uint32_t nFrameIndex, ImageDecoder::ImageData& frameData)
+{
+    if (!OnDecodeFrame(nFrameIndex, frameData)) {
+        return false;
+    }
+    if ((m_nFrameWidth > 0) && (m_nFrameHeight > 0) &&
+        ((frameData.m_imageWidth != m_nFrameWidth) || (frameData.m_imageHeight != m_nFrameHeight))) {
+        std::vector<ImageDecoder::ImageData> imageData(1);
+        imageData[0] = std::move(frameData);
+        ImageDecoder::ResizeImageData(imageData, m_nFrameWidth, m_nFrameHeight);
+        frameData = std::move(imageData[0]);
+    }
+    return true;
+}
+
+ImageDecoder::ImageDecoder():
+    m_bLazyDecodeFrames(false),
+    m_nFrameCacheBytes(0)
+{
+}
+
+void ImageDecoder::SetLazyDecodeFrames(bool bLazyDecodeFrames)
+{
+    m_bLazyDecodeFrames = bLazyDecodeFrames;
+}
+
+bool ImageDecoder::IsLazyDecodeFrames() const
+{
+    return m_bLazyDecodeFrames;
+}
+
+void ImageDecoder::SetFrameCacheBytes(size_t nFrameCacheBytes)
+{
+    m_nFrameCacheBytes = nFrameCacheBytes;
+}
+
+size_t ImageDecoder::GetFrameCacheBytes() const
+{
+    return m_nFrameCacheBytes;
 }
 
 ImageDecoder::ImageFormat ImageDecoder::GetImageFormat(const DString& path)
@@ -604,27 +798,72 @@ std::unique_ptr<ImageInfo> ImageDecoder::LoadImageData(std::vector<uint8_t>& fil
                                                        uint32_t nImageDpiScale,
                                                        const DpiManager& dpi)
 {
+    DecodedImage decodedImage;
+    if (!DoDecodeImage(fileData, imageLoadAttribute, bEnableDpiScale, nImageDpiScale, dpi, true, decodedImage)) {
+        return nullptr;
+    }
+    return CreateImageInfo(decodedImage);
+}
+
+bool ImageDecoder::DecodeImage(std::vector<uint8_t>& fileData,
+                               const ImageLoadAttribute& imageLoadAttribute,
+                               bool bEnableDpiScale,
+                               uint32_t nImageDpiScale,
+                               const DpiManager& dpi,
+                               DecodedImage& decodedImage)
+{
+    return DoDecodeImage(fileData, imageLoadAttribute, bEnableDpiScale, nImageDpiScale, dpi, false, decodedImage);
+}
+
+bool ImageDecoder::DoDecodeImage(std::vector<uint8_t>& fileData,
+                                 const ImageLoadAttribute& imageLoadAttribute,
+                                 bool bEnableDpiScale,
+                                 uint32_t nImageDpiScale,
+                                 const DpiManager& dpi,
+                                 bool bPerformanceStat,
+                                 DecodedImage& decodedImage)
+{
+    decodedImage.m_imageData.clear();
+    decodedImage.m_playCount = -1;
+    decodedImage.m_bDpiScaled = false;
+    decodedImage.m_frameDecoder.reset();
+    decodedImage.m_frameIntervals.clear();
     ASSERT(!fileData.empty() && imageLoadAttribute.HasImageFullPath());
     if (fileData.empty() || !imageLoadAttribute.HasImageFullPath()) {
-        return nullptr;
+        return false;
     }
-    IRenderFactory* pRenderFactroy = GlobalManager::Instance().GetRenderFactory();
-    ASSERT(pRenderFactroy != nullptr);
-    if (pRenderFactroy == nullptr) {
-        return nullptr;
+
+    if (IsLazyDecodeFrames()) {
+        //动画图片：只解码第一帧，其他帧按需解码（非动画图片，按正常流程解码）
+        if (bPerformanceStat) {
+            PerformanceUtil::Instance().BeginStat(_T("DecodeImageFrames"));
+        }
+        bool bFramesDecoded = DecodeImageFrames(fileData, imageLoadAttribute,
+                                                bEnableDpiScale, nImageDpiScale, dpi, decodedImage);
+        if (bPerformanceStat) {
+            PerformanceUtil::Instance().EndStat(_T("DecodeImageFrames"));
+        }
+        if (bFramesDecoded) {
+            return true;
+        }
     }
 
-    std::vector<ImageData> imageData;
+    std::vector<ImageData>& imageData = decodedImage.m_imageData;
     bool bDpiScaled = false; //是否根据DPI做过按比例缩放操作
     int32_t playCount = -1;
 
-    PerformanceUtil::Instance().BeginStat(_T("DecodeImageData"));
+    if (bPerformanceStat) {
+        PerformanceUtil::Instance().BeginStat(_T("DecodeImageData"));
+    }
     bool isLoaded = DecodeImageData(fileData, imageLoadAttribute, 
                                     bEnableDpiScale, nImageDpiScale, dpi, 
                                     imageData, playCount, bDpiScaled);
-    PerformanceUtil::Instance().EndStat(_T("DecodeImageData"));
+    if (bPerformanceStat) {
+        PerformanceUtil::Instance().EndStat(_T("DecodeImageData"));
+    }
     if (!isLoaded || imageData.empty()) {
-        return nullptr;
+        imageData.clear();
+        return false;
     }
 
     ImageFormat imageFormat = GetImageFormat(imageLoadAttribute.GetImageFullPath());
@@ -641,13 +880,92 @@ std::unique_ptr<ImageInfo> ImageDecoder::LoadImageData(std::vector<uint8_t>& fil
         if ((nImageWidth != image.m_imageWidth) ||
             (nImageHeight != image.m_imageHeight)) {
             //加载图像后，根据配置属性，进行大小调整(用算法对原图缩放，图片质量显示效果会好些)
-            PerformanceUtil::Instance().BeginStat(_T("ResizeImageData"));
+            if (bPerformanceStat) {
+                PerformanceUtil::Instance().BeginStat(_T("ResizeImageData"));
+            }
             if (!ResizeImageData(imageData, nImageWidth, nImageHeight)) {
                 bDpiScaled = false;
             }
-            PerformanceUtil::Instance().EndStat(_T("ResizeImageData"));
+            if (bPerformanceStat) {
+                PerformanceUtil::Instance().EndStat(_T("ResizeImageData"));
+            }
         }
     }
+    decodedImage.m_playCount = playCount;
+    decodedImage.m_bDpiScaled = bDpiScaled;
+    return true;
+}
+
+bool ImageDecoder::DecodeImageFrames(std::vector<uint8_t>& fileData,
+                                     const ImageLoadAttribute& imageLoadAttribute,
+                                     bool bEnableDpiScale,
+                                     uint32_t nImageDpiScale,
+                                     const DpiManager& dpi,
+                                     DecodedImage& decodedImage)
+{
+    std::shared_ptr<ImageFrameDecoder> frameDecoder;
+    std::vector<int32_t> frameIntervals;
+    int32_t playCount = -1;
+    ImageFormat imageFormat = GetImageFormat(imageLoadAttribute.GetImageFullPath());
+    if (imageFormat == ImageFormat::kGIF) {
+        std::shared_ptr<CxImageLoader::GifFrameDecoder> gifDecoder = std::make_shared<CxImageLoader::GifFrameDecoder>();
+        if (gifDecoder->Init(fileData, frameIntervals)) {
+            frameDecoder = gifDecoder;
+        }
+    }
+    else if (imageFormat == ImageFormat::kWEBP) {
+        std::shared_ptr<WebPImageLoader::WebPFrameDecoder> webpDecoder = std::make_shared<WebPImageLoader::WebPFrameDecoder>();
+        if (webpDecoder->Init(fileData, frameIntervals, playCount)) {
+            frameDecoder = webpDecoder;
+        }
+    }
+    if ((frameDecoder == nullptr) || (frameDecoder->GetFrameCount() != frameIntervals.size())) {
+        //不支持的格式，或者不是多帧图片
+        return false;
+    }
+
+    //解码第一帧，以第一帧的大小计算缩放后的大小，其他帧解码后调整为相同大小
+    std::vector<ImageData> imageData(1);
+    if (!frameDecoder->DecodeFrame(0, imageData[0])) {
+        return false;
+    }
+    bool bDpiScaled = false;
+    uint32_t nImageWidth = imageData[0].m_imageWidth;
+    uint32_t nImageHeight = imageData[0].m_imageHeight;
+    ImageLoader::CalcImageLoadSize(imageLoadAttribute,
+                                   bEnableDpiScale, nImageDpiScale, dpi, bDpiScaled,
+                                   nImageWidth, nImageHeight);
+    if ((nImageWidth != imageData[0].m_imageWidth) ||
+        (nImageHeight != imageData[0].m_imageHeight)) {
+        if (ResizeImageData(imageData, nImageWidth, nImageHeight)) {
+            frameDecoder->SetFrameSize(nImageWidth, nImageHeight);
+        }
+        else {
+            bDpiScaled = false;
+        }
+    }
+
+    decodedImage.m_imageData.swap(imageData);
+    decodedImage.m_playCount = playCount;
+    decodedImage.m_bDpiScaled = bDpiScaled;
+    decodedImage.m_frameDecoder = frameDecoder;
+    decodedImage.m_frameIntervals.swap(frameIntervals);
+    decodedImage.m_nFrameCacheBytes = GetFrameCacheBytes();
+    return true;
+}
+
+std::unique_ptr<ImageInfo> ImageDecoder::CreateImageInfo(const DecodedImage& decodedImage)
+{
+    const std::vector<ImageData>& imageData = decodedImage.m_imageData;
+    ASSERT(!imageData.empty());
+    if (imageData.empty()) {
+        return nullptr;
+    }
+    IRenderFactory* pRenderFactroy = GlobalManager::Instance().GetRenderFactory();
+    ASSERT(pRenderFactroy != nullptr);
+    if (pRenderFactroy == nullptr) {
+        return nullptr;
+    }
 
     std::unique_ptr<ImageInfo> imageInfo(new ImageInfo);
     std::vector<IBitmap*> frameBitmaps;
@@ -675,14 +993,23 @@ std::unique_ptr<ImageInfo> ImageDecoder::LoadImageData(std::vector<uint8_t>& fil
         pBitmap->Init(bitmapData.m_imageWidth, bitmapData.m_imageHeight, bitmapData.bFlipHeight, bitmapData.m_bitmapData.data());
         frameBitmaps.push_back(pBitmap);
     }
+    if (decodedImage.m_frameDecoder != nullptr) {
+        //按需解码的动画图片：只有第一帧已经解码，其他帧在显示时解码
+        ASSERT(frameBitmaps.size() == 1);
+        frameBitmaps.resize(decodedImage.m_frameDecoder->GetFrameCount(), nullptr);
+        frameIntervals = decodedImage.m_frameIntervals;
+    }
     imageInfo->SetFrameBitmap(frameBitmaps);
     if (frameIntervals.size() > 1) {
         imageInfo->SetFrameInterval(frameIntervals);
     }
+    if (decodedImage.m_frameDecoder != nullptr) {
+        imageInfo->SetFrameDecoder(decodedImage.m_frameDecoder, decodedImage.m_nFrameCacheBytes);
+    }
     //多帧图片时，以第一帧图片作为图片的大小信息
     imageInfo->SetImageSize(imageWidth, imageHeight);
-    imageInfo->SetPlayCount(playCount);
-    imageInfo->SetBitmapSizeDpiScaled(bDpiScaled);
+    imageInfo->SetPlayCount(decodedImage.m_playCount);
+    imageInfo->SetBitmapSizeDpiScaled(decodedImage.m_bDpiScaled);
     return imageInfo;
 }
 
@@ -11,12 +11,32 @@ namespace ui
 class ImageInfo;
 class ImageLoadAttribute;
 class DpiManager;
+class ImageFrameDecoder;
 
 /** 图片格式解码类
 */
 class UILIB_API ImageDecoder
 {
 public:
+    ImageDecoder();
+
+    /** 设置是否对动画图片（GIF/WebP格式）按需解码图片帧，默认为false
+    *   开启后，加载时只解码第一帧，其他帧在播放到该帧时才解码，并且只保留最近使用的若干帧位图
+    */
+    void SetLazyDecodeFrames(bool bLazyDecodeFrames);
+
+    /** 是否对动画图片按需解码图片帧
+    */
+    bool IsLazyDecodeFrames() const;
+
+    /** 设置按需解码图片帧时，图片帧位图最多占用的内存（字节），0表示不限制（解码过的帧全部保留）
+    */
+    void SetFrameCacheBytes(size_t nFrameCacheBytes);
+
+    /** 获取按需解码图片帧时，图片帧位图最多占用的内存（字节）
+    */
+    size_t GetFrameCacheBytes() const;
+
     /** 从内存文件数据中加载图片并解码图片数据, 宽和高属性可以只设置一个，另外一个属性则默认按源图片等比计算得出
     * @param [in] fileData 图片文件的数据，部分格式加载过程中内部有增加尾0的写操作
     * @param [in] imageLoadAttribute 图片加载属性, 包括图片路径等
@@ -57,7 +77,67 @@ public:
         bool bFlipHeight = true;
     };
 
+    /** 解码后的图片数据（尚未创建位图）
+    */
+    struct DecodedImage
+    {
+        /** 图片数据，每个图片帧一个元素
+        */
+        std::vector<ImageData> m_imageData;
+
+        /** 动画播放的循环次数(-1表示无效值)
+        */
+        int32_t m_playCount = -1;
+
+        /** 图片加载的时候，图片大小是否进行了DPI自适应操作
+        */
+        bool m_bDpiScaled = false;
+
+        /** 图片帧解码器（仅按需解码动画图片帧时有效，此时m_imageData中只包含第一帧）
+        */
+        std::shared_ptr<ImageFrameDecoder> m_frameDecoder;
+
+        /** 每帧的播放时间间隔，单位为毫秒（仅按需解码动画图片帧时有效）
+        */
+        std::vector<int32_t> m_frameIntervals;
+
+        /** 图片帧位图最多占用的内存（字节）（仅按需解码动画图片帧时有效）
+        */
+        size_t m_nFrameCacheBytes = 0;
+    };
+
+    /** 从内存文件数据中解码图片，并按加载属性调整图片大小，但不创建位图（可在后台线程中调用）
+    * @param [in] fileData 图片文件的数据，部分格式加载过程中内部有增加尾0的写操作
+    * @param [in] imageLoadAttribute 图片加载属性, 包括图片路径等
+    * @param [in] bEnableDpiScale 是否允许按照DPI对图片大小进行缩放（此为功能开关）
+    * @param [in] nImageDpiScale 图片数据对应的DPI缩放百分比（比如：i.jpg为100，i@150.jpg为150）
+    * @param [in] dpi DPI缩放管理接口
+    * @param [out] decodedImage 返回解码后的图片数据
+    */
+    bool DecodeImage(std::vector<uint8_t>& fileData,
+                     const ImageLoadAttribute& imageLoadAttribute,
+                     bool bEnableDpiScale,
+                     uint32_t nImageDpiScale,
+                     const DpiManager& dpi,
+                     DecodedImage& decodedImage);
+
+    /** 使用解码后的图片数据创建图片对象（需要在UI线程中调用）
+    * @param [in] decodedImage 解码后的图片数据，如果包含图片帧解码器，则由图片对象共享该解码器
+    */
+    std::unique_ptr<ImageInfo> CreateImageInfo(const DecodedImage& decodedImage);
+
 private:
+    /** 解码图片，并按加载属性调整图片大小，参数含义同DecodeImage
+    * @param [in] bPerformanceStat 是否记录性能统计数据（性能统计不支持多线程，只能在UI线程中开启）
+    */
+    bool DoDecodeImage(std::vector<uint8_t>& fileData,
+                       const ImageLoadAttribute& imageLoadAttribute,
+                       bool bEnableDpiScale,
+                       uint32_t nImageDpiScale,
+                       const DpiManager& dpi,
+                       bool bPerformanceStat,
+                       DecodedImage& decodedImage);
+
     /** 对图片数据进行解码，生成位图数据
     * @param [in] fileData 原始图片数据
     * @param [in] imageLoadAttribute 图片的加载属性信息
@@ -77,14 +157,23 @@ private:
                          int32_t& playCount,
                          bool& bDpiScaled);
 
+    /** 创建动画图片的图片帧解码器，并解码第一帧（仅支持GIF/WebP格式的多帧图片），参数含义同DecodeImage
+    */
+    bool DecodeImageFrames(std::vector<uint8_t>& fileData,
+                           const ImageLoadAttribute& imageLoadAttribute,
+                           bool bEnableDpiScale,
+                           uint32_t nImageDpiScale,
+                           const DpiManager& dpi,
+                           DecodedImage& decodedImage);
+
     /** 对图片数据进行大小缩放
     * @param [in] imageData 需要缩放的图片数据
     * @param [in] nNewWidth 新的宽度
     * @param [in] nNewHeight 新的高度
     */
-    bool ResizeImageData(std::vector<ImageData>& imageData, 
-                         uint32_t nNewWidth,
-                         uint32_t nNewHeight);
+    static bool ResizeImageData(std::vector<ImageData>& imageData, 
+                                uint32_t nNewWidth,
+                                uint32_t nNewHeight);
 
     /** 支持的图片文件格式
     */
@@ -102,6 +191,55 @@ private:
     /** 根据图片文件的扩展名获取图片格式
     */
     static ImageFormat GetImageFormat(const DString& path);
+
+private:
+    /** 是否对动画图片按需解码图片帧
+    */
+    bool m_bLazyDecodeFrames;
+
+    /** 按需解码图片帧时，图片帧位图最多占用的内存（字节）
+    */
+    size_t m_nFrameCacheBytes;
+
+    friend class ImageFrameDecoder;
+};
+
+/** 动画图片的图片帧解码器：保存图片的原始数据，在需要显示某一帧时才解码该帧
+*   注意：可以在后台线程中创建，但创建完成后只能在UI线程中使用
+*/
+class UILIB_API ImageFrameDecoder
+{
+public:
+    ImageFrameDecoder();
+    virtual ~ImageFrameDecoder();
+    ImageFrameDecoder(const ImageFrameDecoder&) = delete;
+    ImageFrameDecoder& operator = (const ImageFrameDecoder&) = delete;
+
+public:
+    /** 获取图片的帧数
+    */
+    virtual uint32_t GetFrameCount() const = 0;
+
+    /** 解码一帧图片，并调整为SetFrameSize设置的大小
+    * @param [in] nFrameIndex 图片帧的索引号，范围：[0, GetFrameCount())
+    * @param [out] frameData 返回该帧的图片数据
+    */
+    bool DecodeFrame(uint32_t nFrameIndex, ImageDecoder::ImageData& frameData);
+
+    /** 设置解码后图片帧的大小（宽或者高为0时，保持原始大小）
+    */
+    void SetFrameSize(uint32_t nWidth, uint32_t nHeight);
+
+protected:
+    /** 解码一帧图片（原始大小）
+    */
+    virtual bool OnDecodeFrame(uint32_t nFrameIndex, ImageDecoder::ImageData& frameData) = 0;
+
+private:
+    /** 解码后图片帧的宽度和高度
+    */
+    uint32_t m_nFrameWidth;
+    uint32_t m_nFrameHeight;
 };
 
 } // namespace ui
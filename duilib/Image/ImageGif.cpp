@@ -76,58 +76,58 @@ bool ImageGif::StartGifPlay(GifFrameType nStartFrame, int32_t nPlayCount)
 
     m_nCycledCount = 0;
     m_bPlayingGif = true;
+    m_nextFrameTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(nTimerInterval);
     RedrawImage();
     auto gifPlayCallback = UiBind(&ImageGif::PlayGif, this);
-    bool bRet = GlobalManager::Instance().Timer().AddTimer(m_gifWeakFlag.GetWeakFlag(),
-                                                           gifPlayCallback,
-                                                           nTimerInterval) != 0;
+    bool bRet = GlobalManager::Instance().Clock().AddFrameCallback(m_gifWeakFlag.GetWeakFlag(),
+                                                                   gifPlayCallback) != 0;
     return bRet;
 }
 
 bool ImageGif::PlayGif()
 {
-    //定时器触发，播放下一帧
+    //帧时钟触发，检查是否需要播放下一帧
     if (!IsPlayingGif() || !IsMultiFrameImage()) {
         m_gifWeakFlag.Cancel();
         m_bPlayingGif = false;
         return false;
     }
+    const std::chrono::steady_clock::time_point frameTime = GlobalManager::Instance().Clock().GetFrameTime();
+    if (frameTime < m_nextFrameTime) {
+        //当前帧的播放时间未到
+        return true;
+    }
 
+    //按已经过的时间切换帧（如果界面卡顿，跳过已经超时的帧，保持播放进度与时间同步）
+    const uint32_t nFrameCount = m_pImage->GetImageCache()->GetFrameCount();
     uint32_t nFrameIndex = m_pImage->GetCurrentFrame();
-    int32_t nPreTimerInterval = m_pImage->GetImageCache()->GetFrameInterval(nFrameIndex);
-    nFrameIndex++;
-    if (nFrameIndex >= m_pImage->GetImageCache()->GetFrameCount()) {
-        nFrameIndex = 0;
-        m_nCycledCount += 1;
-        if ((m_nMaxPlayCount > 0) && (m_nCycledCount >= m_nMaxPlayCount)) {
-            //达到最大播放次数，停止播放
-            StopGifPlay(true, kGifFrameLast);
+    int32_t nNowTimerInterval = 0;
+    for (uint32_t nSkipCount = 0; (nSkipCount < nFrameCount) && (frameTime >= m_nextFrameTime); ++nSkipCount) {
+        nFrameIndex++;
+        if (nFrameIndex >= nFrameCount) {
+            nFrameIndex = 0;
+            m_nCycledCount += 1;
+            if ((m_nMaxPlayCount > 0) && (m_nCycledCount >= m_nMaxPlayCount)) {
+                //达到最大播放次数，停止播放
+                StopGifPlay(true, kGifFrameLast);
+                return false;
+            }
+        }
+        nNowTimerInterval = m_pImage->GetImageCache()->GetFrameInterval(nFrameIndex);
+        if (nNowTimerInterval <= 0) {
+            //播放间隔无效，停止播放
+            StopGifPlay(true, kGifFrameCurrent);
             return false;
         }
+        m_nextFrameTime += std::chrono::milliseconds(nNowTimerInterval);
     }
-    int32_t nNowTimerInterval = m_pImage->GetImageCache()->GetFrameInterval(nFrameIndex);
-    if (nNowTimerInterval <= 0) {
-        //播放间隔无效，停止播放
-        StopGifPlay(true, kGifFrameCurrent);
-        return false;
-    }
-    bool bRet = true;
-    if (nPreTimerInterval != nNowTimerInterval) {
-        m_gifWeakFlag.Cancel();
-        auto gifPlayCallback = UiBind(&ImageGif::PlayGif, this);
-        bRet = GlobalManager::Instance().Timer().AddTimer(m_gifWeakFlag.GetWeakFlag(),
-                                                          gifPlayCallback,
-                                                          nNowTimerInterval) != 0;
-    }
-    if (bRet) {
-        m_pImage->SetCurrentFrame(nFrameIndex);
-        RedrawImage();
+    if (frameTime >= m_nextFrameTime) {
+        //落后超过一个播放周期，从当前帧重新计时
+        m_nextFrameTime = frameTime + std::chrono::milliseconds(nNowTimerInterval);
     }
-    else {
-        //启动定时器失败
-        StopGifPlay(true, kGifFrameCurrent);
-    }    
-    return bRet;
+    m_pImage->SetCurrentFrame(nFrameIndex);
+    RedrawImage();
+    return true;
 }
 
 void ImageGif::StopGifPlay()
@@ -5,6 +5,7 @@
 #include "duilib/Utils/Delegate.h"
 #include "duilib/Core/Callback.h"
 #include <map>
+#include <chrono>
 
 namespace ui 
 {
@@ -73,7 +74,7 @@ private:
     */
     uint32_t GetGifFrameIndex(GifFrameType frame) const;
 
-    /** 定时器播放GIF的回调函数
+    /** 帧时钟播放GIF的回调函数
     */
     bool PlayGif();
 
@@ -122,6 +123,10 @@ private:
     */
     int32_t m_nMaxPlayCount;
 
+    /** 下一帧的播放时间（由帧时钟驱动，到达该时间后切换到下一帧）
+    */
+    std::chrono::steady_clock::time_point m_nextFrameTime;
+
     /** GIF背景图片播放完成事件的ID
     */
     static const int32_t m_nVirtualEventGifStop = 1;
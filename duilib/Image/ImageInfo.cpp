@@ -1,8 +1,29 @@
 #include "ImageInfo.h"
+#include "duilib/Image/ImageDecoder.h"
+#include "duilib/Core/GlobalManager.h"
+#include <algorithm>
 
 namespace ui 
 {
 
+//按需解码的动画图片，至少保留的图片帧个数（当前帧和下一帧）
+static const size_t kMinResidentFrames = 2;
+
+/** 获取位图占用的内存（字节）
+*/
+static size_t GetFrameBitmapBytes(const IBitmap* pBitmap)
+{
+    return (pBitmap != nullptr) ? ((size_t)pBitmap->GetWidth() * pBitmap->GetHeight() * 4) : 0;
+}
+
+/** 释放被淘汰的图片帧位图：调用方可能仍持有GetBitmap返回的指针（比如正在绘制），在当前UI线程任务执行完成后再释放
+*/
+static void ReleaseFrameBitmapLater(IBitmap* pBitmap)
+{
+    std::shared_ptr<IBitmap> spBitmap(pBitmap);
+    GlobalManager::Instance().Thread().PostTask(kThreadUI, [spBitmap]() {});
+}
+
 ImageInfo::ImageInfo():
     m_bDpiScaled(false),
     m_nWidth(0),
@@ -11,6 +32,7 @@ ImageInfo::ImageInfo():
     m_pFrameIntervals(nullptr),
     m_nFrameCount(0),
     m_pFrameBitmaps(nullptr),
+    m_pLazyFrames(nullptr),
     m_loadDpiScale(0)
 {
 }
@@ -29,6 +51,11 @@ ImageInfo::~ImageInfo()
         delete m_pFrameIntervals;
         m_pFrameIntervals = nullptr;
     }
+
+    if (m_pLazyFrames != nullptr) {
+        delete m_pLazyFrames;
+        m_pLazyFrames = nullptr;
+    }
 }
 
 void ImageInfo::SetFrameInterval(const std::vector<int32_t>& frameIntervals)
@@ -61,11 +88,84 @@ IBitmap* ImageInfo::GetBitmap(uint32_t nIndex) const
 {
     ASSERT((nIndex < m_nFrameCount) && (m_pFrameBitmaps != nullptr));
     if ((nIndex < m_nFrameCount) && (m_pFrameBitmaps != nullptr)){
-        return m_pFrameBitmaps[nIndex];
+        if ((m_pLazyFrames == nullptr) || (m_pLazyFrames->m_frameDecoder == nullptr)) {
+            return m_pFrameBitmaps[nIndex];
+        }
+        //按需解码的动画图片
+        std::vector<uint32_t>& residentFrames = m_pLazyFrames->m_residentFrames;
+        if (m_pFrameBitmaps[nIndex] != nullptr) {
+            //已经解码，标记为最近使用
+            auto iter = std::find(residentFrames.begin(), residentFrames.end(), nIndex);
+            if ((iter != residentFrames.end()) && ((iter + 1) != residentFrames.end())) {
+                residentFrames.erase(iter);
+                residentFrames.push_back(nIndex);
+            }
+            return m_pFrameBitmaps[nIndex];
+        }
+
+        ImageDecoder::ImageData frameData;
+        if (!m_pLazyFrames->m_frameDecoder->DecodeFrame(nIndex, frameData)) {
+            return nullptr;
+        }
+        IBitmap* pBitmap = nullptr;
+        IRenderFactory* pRenderFactroy = GlobalManager::Instance().GetRenderFactory();
+        ASSERT(pRenderFactroy != nullptr);
+        if (pRenderFactroy != nullptr) {
+            pBitmap = pRenderFactroy->CreateBitmap();
+        }
+        ASSERT(pBitmap != nullptr);
+        if (pBitmap == nullptr) {
+            return nullptr;
+        }
+        pBitmap->Init(frameData.m_imageWidth, frameData.m_imageHeight, frameData.bFlipHeight, frameData.m_bitmapData.data());
+        const size_t nBitmapBytes = GetFrameBitmapBytes(pBitmap);
+
+        //超出内存限制时，淘汰最久未使用的帧（淘汰的位图延迟释放，不复用，避免调用方持有的指针绘制出错误的帧）
+        const size_t nFrameCacheBytes = m_pLazyFrames->m_nFrameCacheBytes;
+        while ((nFrameCacheBytes > 0) && (residentFrames.size() >= kMinResidentFrames) &&
+               ((m_pLazyFrames->m_nResidentBytes + nBitmapBytes) > nFrameCacheBytes)) {
+            uint32_t nEvictIndex = residentFrames.front();
+            residentFrames.erase(residentFrames.begin());
+            IBitmap* pEvictBitmap = m_pFrameBitmaps[nEvictIndex];
+            m_pFrameBitmaps[nEvictIndex] = nullptr;
+            m_pLazyFrames->m_nResidentBytes -= GetFrameBitmapBytes(pEvictBitmap);
+            ReleaseFrameBitmapLater(pEvictBitmap);
+        }
+        m_pFrameBitmaps[nIndex] = pBitmap;
+        residentFrames.push_back(nIndex);
+        m_pLazyFrames->m_nResidentBytes += nBitmapBytes;
+        //图片帧占用的内存计入图片缓存的内存预算
+        GlobalManager::Instance().Image().OnImageBitmapBytesChanged(this);
+        return pBitmap;
     }
     return nullptr;
 }
 
+void ImageInfo::SetFrameDecoder(const std::shared_ptr<ImageFrameDecoder>& frameDecoder, size_t nFrameCacheBytes)
+{
+    if (frameDecoder == nullptr) {
+        if (m_pLazyFrames != nullptr) {
+            delete m_pLazyFrames;
+            m_pLazyFrames = nullptr;
+        }
+        return;
+    }
+    if (m_pLazyFrames == nullptr) {
+        m_pLazyFrames = new LazyFrames;
+    }
+    m_pLazyFrames->m_frameDecoder = frameDecoder;
+    m_pLazyFrames->m_nFrameCacheBytes = nFrameCacheBytes;
+    m_pLazyFrames->m_residentFrames.clear();
+    m_pLazyFrames->m_nResidentBytes = 0;
+    //已经解码的帧（通常只有第一帧）
+    for (uint32_t i = 0; i < m_nFrameCount; ++i) {
+        if ((m_pFrameBitmaps != nullptr) && (m_pFrameBitmaps[i] != nullptr)) {
+            m_pLazyFrames->m_residentFrames.push_back(i);
+            m_pLazyFrames->m_nResidentBytes += GetFrameBitmapBytes(m_pFrameBitmaps[i]);
+        }
+    }
+}
+
 void ImageInfo::SetImageSize(int32_t nWidth, int32_t nHeight)
 {
     ASSERT(nWidth > 0);
@@ -83,6 +183,20 @@ uint32_t ImageInfo::GetFrameCount() const
     return m_nFrameCount;
 }
 
+size_t ImageInfo::GetBitmapBytes() const
+{
+    if (m_pLazyFrames != nullptr) {
+        return m_pLazyFrames->m_nResidentBytes;
+    }
+    size_t nBytes = 0;
+    if (m_pFrameBitmaps != nullptr) {
+        for (uint32_t i = 0; i < m_nFrameCount; ++i) {
+            nBytes += GetFrameBitmapBytes(m_pFrameBitmaps[i]);
+        }
+    }
+    return nBytes;
+}
+
 bool ImageInfo::IsMultiFrameImage() const
 {
     return GetFrameCount() > 1;
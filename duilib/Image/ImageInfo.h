@@ -3,11 +3,13 @@
 
 #include "duilib/Render/IRender.h"
 #include "duilib/Core/UiTypes.h"
+#include <memory>
 
 namespace ui 
 {
     class IRender;
     class Control;
+    class ImageFrameDecoder;
 
 /** 图片信息
 */
@@ -46,10 +48,17 @@ public:
     */
     void SetFrameBitmap(const std::vector<IBitmap*>& frameBitmaps);
 
-    /** 获取一个图片帧数据
+    /** 获取一个图片帧数据（按需解码的动画图片，该帧未解码时，在此时解码）
+    *   按需解码的动画图片，返回的位图可能在之后被淘汰，调用方不应长期保存该指针（在当前UI线程任务执行完成前保持有效）
     */
     IBitmap* GetBitmap(uint32_t nIndex) const;
 
+    /** 设置图片帧解码器，用于按需解码动画图片的图片帧（SetFrameBitmap中未解码的帧为nullptr）
+    * @param [in] frameDecoder 图片帧解码器
+    * @param [in] nFrameCacheBytes 图片帧位图最多占用的内存（字节），超出时淘汰最久未使用的帧，0表示不限制
+    */
+    void SetFrameDecoder(const std::shared_ptr<ImageFrameDecoder>& frameDecoder, size_t nFrameCacheBytes);
+
     /** 设置图片的多帧播放事件间隔（毫秒为单位 ）
     */
     void SetFrameInterval(const std::vector<int32_t>& frameIntervals);
@@ -62,6 +71,10 @@ public:
     */
     uint32_t GetFrameCount() const;
 
+    /** 获取所有帧位图数据占用的内存字节数
+    */
+    size_t GetBitmapBytes() const;
+
     /** 是否位多帧图片(比如GIF等)
     */
     bool IsMultiFrameImage() const;
@@ -122,6 +135,26 @@ private:
     //图片帧数量
     uint32_t m_nFrameCount;
 
+    /** 按需解码的图片帧数据
+    */
+    struct LazyFrames
+    {
+        //图片帧解码器
+        std::shared_ptr<ImageFrameDecoder> m_frameDecoder;
+
+        //已经解码的图片帧索引号，按使用的先后顺序排列
+        std::vector<uint32_t> m_residentFrames;
+
+        //已经解码的图片帧位图占用的内存（字节）
+        size_t m_nResidentBytes = 0;
+
+        //图片帧位图最多占用的内存（字节），0表示不限制
+        size_t m_nFrameCacheBytes = 0;
+    };
+
+    //按需解码的图片帧数据（非按需解码的图片为nullptr）
+    LazyFrames* m_pLazyFrames;
+
     //循环播放次数(大于等于0，如果等于0，表示动画是循环播放的, APNG格式支持设置循环播放次数)
     int32_t m_nPlayCount;
 
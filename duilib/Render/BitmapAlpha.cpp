@@ -1,8 +1,23 @@
  #include "BitmapAlpha.h"
+#include "duilib/Utils/PixelUtil.h"
 
 namespace ui
 {
 
+/** 计算第nRow行中需要修正Alpha值的列范围[nColLeft, nColRight)：
+*   位于上下阴影之间的行，修正整行；位于上下阴影内的行，只修正左右阴影之间的部分
+*/
+static void GetRestoreAlphaRange(int nRow, int nLeft, int nRight, int nWidth, int nHeight,
+                                 const UiPadding& rcShadowPadding, int& nColLeft, int& nColRight)
+{
+    nColLeft = nLeft;
+    nColRight = nRight;
+    if ((nRow < rcShadowPadding.top) || (nRow >= nHeight - rcShadowPadding.bottom)) {
+        nColLeft = std::max(nLeft, (int)rcShadowPadding.left);
+        nColRight = std::min(nRight, nWidth - (int)rcShadowPadding.right);
+    }
+}
+
 BitmapAlpha::BitmapAlpha(uint8_t* pPiexl, int32_t nWidth, int32_t nHeight, int32_t nChannels):
     m_pPiexl(pPiexl),
     m_nWidth(nWidth),
@@ -55,23 +70,15 @@ void BitmapAlpha::RestoreAlpha(const UiRect& rcDirty, const UiPadding& rcShadowP
     int nLeft = std::max((int)rcDirty.left, 0);
     int nRight = std::min((int)rcDirty.right, (int)m_nWidth);
 
+    int nColLeft = 0;
+    int nColRight = 0;
     for (int i = nTop; i < nBottom; i++) {
-        for (int j = nLeft; j < nRight; j++) {
-            uint8_t* a = (uint8_t*)(pBmpBits + i * m_nWidth + j) + 3;
-
-            if (((j >= rcShadowPadding.left && j < m_nWidth - rcShadowPadding.right)
-                || (i >= rcShadowPadding.top && i < m_nHeight - rcShadowPadding.bottom))) {
-
-                // ClearAlpha时，把alpha通道设置为某个值
-                // 如果此值没有变化，则证明上面没有绘制任何内容，把alpha设为0
-                if (alpha != 0 && *a == alpha) {
-                    *a = 0;
-                }
-                // 如果此值变为0，则证明上面被类似DrawText等GDI函数绘制过导致alpha被设为0，此时alpha设为255
-                else if (*a == 0) {
-                    *a = 255;
-                }
-            }
+        GetRestoreAlphaRange(i, nLeft, nRight, m_nWidth, m_nHeight, rcShadowPadding, nColLeft, nColRight);
+        if (nColRight > nColLeft) {
+            // ClearAlpha时，把alpha通道设置为某个值
+            // 如果此值没有变化，则证明上面没有绘制任何内容，把alpha设为0
+            // 如果此值变为0，则证明上面被类似DrawText等GDI函数绘制过导致alpha被设为0，此时alpha设为255
+            PixelUtil::RestoreAlpha((uint8_t*)(pBmpBits + i * m_nWidth + nColLeft), nColRight - nColLeft, alpha);
         }
     }
 }
@@ -91,15 +98,12 @@ void BitmapAlpha::RestoreAlpha(const UiRect& rcDirty, const UiPadding& rcShadowP
     int nLeft = std::max((int)rcDirty.left, 0);
     int nRight = std::min((int)rcDirty.right, (int)m_nWidth);
 
+    int nColLeft = 0;
+    int nColRight = 0;
     for (int i = nTop; i < nBottom; i++) {
-        for (int j = nLeft; j < nRight; j++) {
-            uint8_t* a = (uint8_t*)(pBmpBits + i * m_nWidth + j) + 3;
-            if (((j >= rcShadowPadding.left && j < m_nWidth - rcShadowPadding.right) ||
-                 (i >= rcShadowPadding.top && i < m_nHeight - rcShadowPadding.bottom))) {
-                if (*a != 255) {
-                    *a = 255;
-                }
-            }
+        GetRestoreAlphaRange(i, nLeft, nRight, m_nWidth, m_nHeight, rcShadowPadding, nColLeft, nColRight);
+        if (nColRight > nColLeft) {
+            PixelUtil::SetAlphaOpaque((uint8_t*)(pBmpBits + i * m_nWidth + nColLeft), nColRight - nColLeft);
         }
     }
 }
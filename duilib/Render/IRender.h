@@ -428,6 +428,12 @@ public:
     /** 回调接口，获取当前窗口的透明度值
     */
     virtual uint8_t GetLayeredWindowAlpha() = 0;
+
+    /** 回调接口，获取DoPaint实际重绘的区域（在DoPaint之后调用），用于只将重绘的区域提交到窗口
+    * @param [out] paintedRects 重绘的区域列表（客户区坐标）
+    * @return 如果返回false，表示DoPaint按rcPaint整体重绘
+    */
+    virtual bool GetPaintedRects(std::vector<UiRect>& paintedRects) = 0;
 };
 
 /** 光栅操作代码
@@ -1,15 +1,22 @@
 #include "Bitmap_Skia.h"
+#include "duilib/Utils/PixelUtil.h"
 
 #pragma warning (push)
 #pragma warning (disable: 4244 4201)
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkImage.h"
 
 #pragma warning (pop)
 
 namespace ui
 {
 
+void Bitmap_Skia::SkImageUnref::operator()(SkImage* pSkImage) const
+{
+    SkSafeUnref(pSkImage);
+}
+
 Bitmap_Skia::Bitmap_Skia()
 {
     m_pSkBitmap = std::make_unique<SkBitmap>();
@@ -17,6 +24,7 @@ Bitmap_Skia::Bitmap_Skia()
 
 Bitmap_Skia::~Bitmap_Skia()
 {
+    m_pSkImage.reset();
     m_pSkBitmap.reset();
 }
 
@@ -41,6 +49,7 @@ bool Bitmap_Skia::Init(uint32_t nWidth, uint32_t nHeight, bool flipHeight,
         }
     }
 
+    m_pSkImage.reset();
     m_pSkBitmap->reset();
     m_pSkBitmap->setInfo(SkImageInfo::Make(nWidth, nHeight, kN32_SkColorType, static_cast<SkAlphaType>(alphaType)));
     m_pSkBitmap->allocPixels();
@@ -93,6 +102,8 @@ UiSize Bitmap_Skia::GetSize() const
 
 void* Bitmap_Skia::LockPixelBits()
 {
+    //位图数据即将被修改，缓存的图片失效
+    ReleaseSkImage();
     void* pPixelBits = nullptr;
     SkPixmap pixmap;
     if (m_pSkBitmap->peekPixels(&pixmap)) {
@@ -104,6 +115,7 @@ void* Bitmap_Skia::LockPixelBits()
 
 void Bitmap_Skia::UnLockPixelBits()
 {
+    ReleaseSkImage();
     void* pPixelBits = nullptr;
     SkPixmap pixmap;
     if (m_pSkBitmap->peekPixels(&pixmap)) {
@@ -150,12 +162,7 @@ void Bitmap_Skia::UpdateAlphaFlag(uint8_t* pPixelBits)
     }
     if (m_pSkBitmap->info().alphaType() == SkAlphaType::kOpaque_SkAlphaType) {
         //指定为不透明图片，不需要更新AlphaBitmap标志
-        for (int32_t i = 0; i < nHeight; ++i) {
-            for (int32_t j = 0; j < nWidth; ++j) {
-                uint8_t* a = (uint8_t*)pPixelBits + (i * nWidth + j) * sizeof(uint32_t) + 3;
-                *a = 255;
-            }
-        }
+        PixelUtil::SetAlphaOpaque(pPixelBits, (size_t)nHeight * nWidth);
     }
 }
 
@@ -165,4 +172,28 @@ const SkBitmap& Bitmap_Skia::GetSkBitmap() const
     return *m_pSkBitmap.get();
 }
 
+SkImage* Bitmap_Skia::GetSkImage() const
+{
+    if (m_pSkImage == nullptr) {
+        //标记为不可修改后，asImage()与位图共享像素数据，不再复制一份位图数据
+        m_pSkBitmap->setImmutable();
+        m_pSkImage.reset(m_pSkBitmap->asImage().release());
+    }
+    return m_pSkImage.get();
+}
+
+void Bitmap_Skia::ReleaseSkImage()
+{
+    m_pSkImage.reset();
+    if (m_pSkBitmap->isImmutable() && (m_pSkBitmap->getPixels() != nullptr)) {
+        //像素数据已经被图片共享（不可修改），复制一份新的像素数据，用于修改
+        SkBitmap skBitmap;
+        if (skBitmap.tryAllocPixels(m_pSkBitmap->info())) {
+            ASSERT(skBitmap.computeByteSize() == m_pSkBitmap->computeByteSize());
+            memcpy(skBitmap.getPixels(), m_pSkBitmap->getPixels(), m_pSkBitmap->computeByteSize());
+            *m_pSkBitmap = skBitmap;
+        }
+    }
+}
+
 } // namespace ui
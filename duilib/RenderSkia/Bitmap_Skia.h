@@ -5,6 +5,7 @@
 
 //Skia相关类的前置声明
 class SkBitmap;
+class SkImage;
 
 namespace ui
 {
@@ -59,7 +60,17 @@ public:
     */
     const SkBitmap& GetSkBitmap() const;
 
+    /** 获取位图对应的Skia图片（不可修改），用于绘制
+    *   首次调用时创建，与位图共享像素数据（不复制数据），调用LockPixelBits修改位图数据后重新创建
+    * @return 返回的指针由本对象管理，调用方如需保存，需要增加引用计数
+    */
+    SkImage* GetSkImage() const;
+
 private:
+    /** 释放缓存的Skia图片，如果位图数据已经被图片共享，则复制一份位图数据，确保修改位图数据不影响已创建的图片
+    */
+    void ReleaseSkImage();
+
     /** 更新图片的透明通道标志
     */
     void UpdateAlphaFlag(uint8_t* pPixelBits);
@@ -68,10 +79,21 @@ private:
     */
     void FlipPixelBits(const uint8_t* pPixelBits, uint32_t nWidth, uint32_t nHeight, std::vector<uint8_t>& flipBits);
 
+    /** Skia图片的释放器：减少其引用计数（在实现文件中定义，头文件中无需包含Skia的头文件）
+    */
+    struct SkImageUnref
+    {
+        void operator()(SkImage* pSkImage) const;
+    };
+
 private:
     /** Skia 位图
     */
     std::unique_ptr<SkBitmap> m_pSkBitmap;
+
+    /** 缓存的Skia图片（持有一个引用计数）
+    */
+    mutable std::unique_ptr<SkImage, SkImageUnref> m_pSkImage;
 };
 
 } // namespace ui
@@ -4,6 +4,8 @@
 #include "duilib/RenderSkia/Matrix_Skia.h"
 #include "duilib/RenderSkia/Font_Skia.h"
 #include "duilib/RenderSkia/SkTextBox.h"
+#include "duilib/RenderSkia/SkTextLayoutCache.h"
+#include "duilib/RenderSkia/SkBoxShadowCache.h"
 #include "duilib/Render/BitmapAlpha.h"
 
 #include "duilib/Utils/StringUtil.h"
@@ -34,6 +36,10 @@
 
 namespace ui {
 
+//文字布局缓存的格式标志：字体的下划线、删除线属性（不与DrawStringFormat的取值冲突）
+static const uint32_t kLayoutFormatUnderline = 0x10000;
+static const uint32_t kLayoutFormatStrikeOut = 0x20000;
+
 static inline void DrawFunction(SkCanvas* pSkCanvas, 
                                 const UiRect& rcDest,
                                 const SkPoint& skPointOrg,
@@ -466,8 +472,11 @@ void Render_Skia::DrawImage(const UiRect& rcPaint, IBitmap* pBitmap,
     if (skiaBitmap == nullptr) {
         return;
     }
-    const SkBitmap& skSrcBitmap = skiaBitmap->GetSkBitmap();
-    sk_sp<SkImage> skImage = skSrcBitmap.asImage();//这里是复制了一份位图数据的，有性能损耗
+    //使用位图缓存的图片，避免每次绘制都复制一份位图数据
+    sk_sp<SkImage> skImage = sk_ref_sp(skiaBitmap->GetSkImage());
+    if (skImage == nullptr) {
+        return;
+    }
 
     UiRect rcTemp;
     UiRect rcDrawSource;
@@ -783,8 +792,11 @@ void Render_Skia::DrawImageRect(const UiRect& rcPaint, IBitmap* pBitmap,
     if (skiaBitmap == nullptr) {
         return;
     }
-    const SkBitmap& skSrcBitmap = skiaBitmap->GetSkBitmap();
-    sk_sp<SkImage> skImage = skSrcBitmap.asImage();//这里是复制了一份位图数据的，有性能损耗
+    //使用位图缓存的图片，避免每次绘制都复制一份位图数据
+    sk_sp<SkImage> skImage = sk_ref_sp(skiaBitmap->GetSkImage());
+    if (skImage == nullptr) {
+        return;
+    }
 
     bool isMatrixSet = false;
     if (pMatrix != nullptr) {
@@ -1329,26 +1341,6 @@ void Render_Skia::DrawString(const UiRect& rc,
         return;
     }
 
-    SkCanvas* skCanvas = GetSkCanvas();
-    ASSERT(skCanvas != nullptr);
-    if (skCanvas == nullptr) {
-        return;
-    }
-    //文本编码
-    const SkTextEncoding textEncoding = GetTextEncoding();
-    
-    //获取字体接口    
-    Font_Skia* pSkiaFont = dynamic_cast<Font_Skia*>(pFont);
-    ASSERT(pSkiaFont != nullptr);
-    if (pSkiaFont == nullptr) {
-        return;
-    }
-    const SkFont* pSkFont = pSkiaFont->GetFontHandle();
-    ASSERT(pSkFont != nullptr);
-    if (pSkFont == nullptr) {
-        return;
-    }
-
     //绘制属性设置
     SkPaint skPaint = *m_pSkPaint;
     skPaint.setARGB(dwTextColor.GetA(), dwTextColor.GetR(), dwTextColor.GetG(), dwTextColor.GetB());
@@ -1356,72 +1348,8 @@ void Render_Skia::DrawString(const UiRect& rc,
         skPaint.setAlpha(uFade);
     }
 
-    //绘制区域
-    SkIRect rcSkDestI = { rc.left, rc.top, rc.right, rc.bottom };
-    SkRect rcSkDest = SkRect::Make(rcSkDestI);
-    rcSkDest.offset(*m_pSkPointOrg);
-
-    //设置绘制属性
-    SkTextBox skTextBox;
-    skTextBox.setBox(rcSkDest);
-    if (uFormat & DrawStringFormat::TEXT_SINGLELINE) {
-        //单行文本
-        skTextBox.setLineMode(SkTextBox::kOneLine_Mode);
-    }
-
-    //绘制区域不足时，自动在末尾绘制省略号
-    bool bEndEllipsis = false;
-    if (uFormat & DrawStringFormat::TEXT_END_ELLIPSIS) {
-        bEndEllipsis = true;
-    }
-    skTextBox.setEndEllipsis(bEndEllipsis);
-
-    bool bPathEllipsis = false;
-    if (uFormat & DrawStringFormat::TEXT_PATH_ELLIPSIS) {
-        bPathEllipsis = true;
-    }
-    skTextBox.setPathEllipsis(bPathEllipsis);
-
-    //绘制文字时，不使用裁剪区域（可能会导致文字绘制超出边界）
-    if (uFormat & DrawStringFormat::TEXT_NOCLIP) {
-        skTextBox.setClipBox(false);
-    }
-    //删除线
-    skTextBox.setStrikeOut(pFont->IsStrikeOut());
-    //下划线
-    skTextBox.setUnderline(pFont->IsUnderline());
-
-    if (uFormat & DrawStringFormat::TEXT_CENTER) {
-        //横向对齐：居中对齐
-        skTextBox.setTextAlign(SkTextBox::kCenter_Align);
-    }
-    else if (uFormat & DrawStringFormat::TEXT_RIGHT) {
-        //横向对齐：右对齐
-        skTextBox.setTextAlign(SkTextBox::kRight_Align);
-    }
-    else {
-        //横向对齐：左对齐
-        skTextBox.setTextAlign(SkTextBox::kLeft_Align);
-    }
-
-    if (uFormat & DrawStringFormat::TEXT_VCENTER) {
-        //纵向对齐：居中对齐
-        skTextBox.setSpacingAlign(SkTextBox::kCenter_SpacingAlign);
-    }
-    else if (uFormat & DrawStringFormat::TEXT_BOTTOM) {
-        //纵向对齐：下对齐
-        skTextBox.setSpacingAlign(SkTextBox::kEnd_SpacingAlign);
-    }
-    else {
-        //纵向对齐：上对齐
-        skTextBox.setSpacingAlign(SkTextBox::kStart_SpacingAlign);
-    }
-    skTextBox.draw(skCanvas, 
-                   (const char*)strText.c_str(), 
-                   strText.size() * sizeof(DString::value_type),
-                   textEncoding, 
-                   *pSkFont,
-                   skPaint);
+    //绘制文字（文字布局会被缓存，重复绘制时直接使用缓存的布局）
+    DrawTextString(rc, strText, uFormat, skPaint, pFont);
 }
 
 UiRect Render_Skia::MeasureString(const DString& strText, 
@@ -1461,6 +1389,15 @@ UiRect Render_Skia::MeasureString(const DString& strText,
         return UiRect();
     }
 
+    //查找缓存的测量结果
+    SkTextLayoutCache& layoutCache = SkTextLayoutCache::Instance();
+    const bool bCacheable = layoutCache.IsCacheable(strText);
+    const uint32_t uMeasureFormat = uFormat & DrawStringFormat::TEXT_SINGLELINE;
+    UiRect rcMeasure;
+    if (bCacheable && layoutCache.FindMeasureResult(strText, *pSkFont, uMeasureFormat, width, rcMeasure)) {
+        return rcMeasure;
+    }
+
     //绘制属性设置
     SkPaint skPaint = *m_pSkPaint;
 
@@ -1484,27 +1421,24 @@ UiRect Render_Skia::MeasureString(const DString& strText,
         if (textWidth > textIWidth) {
             textIWidth += 1;
         }
-        if (textIWidth <= 0) {
-            return UiRect();
-        }
-        UiRect rc;
-        rc.left = 0;
-        if (width <= 0) {
-            rc.right = textIWidth;
-        }
-        else if (textIWidth < width) {
-            rc.right = textIWidth;
-        }
-        else {
-            //返回限制宽度
-            rc.right = width;
-        }
-        rc.top = 0;
-        rc.bottom = SkScalarTruncToInt(fontHeight + 0.5f);
-        if (fontHeight > rc.bottom) {
-            rc.bottom += 1;
+        if (textIWidth > 0) {
+            rcMeasure.left = 0;
+            if (width <= 0) {
+                rcMeasure.right = textIWidth;
+            }
+            else if (textIWidth < width) {
+                rcMeasure.right = textIWidth;
+            }
+            else {
+                //返回限制宽度
+                rcMeasure.right = width;
+            }
+            rcMeasure.top = 0;
+            rcMeasure.bottom = SkScalarTruncToInt(fontHeight + 0.5f);
+            if (fontHeight > rcMeasure.bottom) {
+                rcMeasure.bottom += 1;
+            }
         }
-        return rc;
     }
     else {
         //多行模式，并且限制宽度width为有效值
@@ -1523,16 +1457,18 @@ UiRect Render_Skia::MeasureString(const DString& strText,
         if (lineCount > 0) {
             textHeight += scaledSpacing * (lineCount - 1);
         }
-        UiRect rc;
-        rc.left = 0;
-        rc.right = width;
-        rc.top = 0;
-        rc.bottom = SkScalarTruncToInt(textHeight + 0.5f);
-        if (textHeight > rc.bottom) {
-            rc.bottom += 1;
+        rcMeasure.left = 0;
+        rcMeasure.right = width;
+        rcMeasure.top = 0;
+        rcMeasure.bottom = SkScalarTruncToInt(textHeight + 0.5f);
+        if (textHeight > rcMeasure.bottom) {
+            rcMeasure.bottom += 1;
         }
-        return rc;
     }
+    if (bCacheable) {
+        layoutCache.AddMeasureResult(strText, *pSkFont, uMeasureFormat, width, rcMeasure);
+    }
+    return rcMeasure;
 }
 
 void Render_Skia::DrawRichText(const UiRect& rc,
@@ -1840,12 +1776,54 @@ void Render_Skia::DrawTextString(const UiRect& rc, const DString& strText, uint3
         //纵向对齐：上对齐
         skTextBox.setSpacingAlign(SkTextBox::kStart_SpacingAlign);
     }
-    skTextBox.draw(skCanvas,
-                   (const char*)strText.c_str(),
-                   strText.size() * sizeof(DString::value_type),
-                   textEncoding,
-                   *pSkFont,
-                   skPaint);
+    skTextBox.setText((const char*)strText.c_str(),
+                      strText.size() * sizeof(DString::value_type),
+                      textEncoding,
+                      *pSkFont,
+                      skPaint);
+
+    SkTextLayoutCache& layoutCache = SkTextLayoutCache::Instance();
+    if (!layoutCache.IsCacheable(strText)) {
+        //文本过长，不使用缓存
+        skTextBox.draw(skCanvas);
+        return;
+    }
+
+    //查找缓存的文字布局：布局只与文本、字体、区域大小和排版格式有关，与颜色和区域位置无关
+    uint32_t uLayoutFormat = uFormat & ~DrawStringFormat::TEXT_NOCLIP;
+    if (pSkiaFont->IsUnderline()) {
+        uLayoutFormat |= kLayoutFormatUnderline;
+    }
+    if (pSkiaFont->IsStrikeOut()) {
+        uLayoutFormat |= kLayoutFormatStrikeOut;
+    }
+    const SkTextLayoutCache::TextLayout* pLayout = layoutCache.FindDrawLayout(strText, *pSkFont, uLayoutFormat,
+                                                                              rc.Width(), rc.Height());
+    if (pLayout == nullptr) {
+        SkTextLayoutCache::TextLayout layout;
+        layout.textBlob = skTextBox.snapshotLayout(&layout.decorations);
+        pLayout = layoutCache.AddDrawLayout(strText, *pSkFont, uLayoutFormat,
+                                            rc.Width(), rc.Height(), std::move(layout));
+    }
+    if (pLayout == nullptr) {
+        skTextBox.draw(skCanvas);
+        return;
+    }
+
+    int saveCount = 0;
+    if (skTextBox.getClipBox()) {
+        saveCount = skCanvas->save();
+        skCanvas->clipRect(rcSkDest, true);
+    }
+    if (pLayout->textBlob != nullptr) {
+        skCanvas->drawTextBlob(pLayout->textBlob, rcSkDest.fLeft, rcSkDest.fTop, skPaint);
+    }
+    for (const SkRect& rcDecoration : pLayout->decorations) {
+        skCanvas->drawRect(rcDecoration.makeOffset(rcSkDest.fLeft, rcSkDest.fTop), skPaint);
+    }
+    if (skTextBox.getClipBox()) {
+        skCanvas->restoreToCount(saveCount);
+    }
 }
 
 void Render_Skia::DrawBoxShadow(const UiRect& rc,
@@ -1898,6 +1876,23 @@ void Render_Skia::DrawBoxShadow(const UiRect& rc,
     excludePath.offset(m_pSkPointOrg->fX, m_pSkPointOrg->fY, &skPathExclude);
     skCanvas->clipPath(skPathExclude, SkClipOp::kDifference);
 
+    //优先使用缓存的阴影图片，按九宫格方式绘制（避免每次绘制都做高斯模糊）
+    const SkBoxShadowCache::ShadowImage* pShadowImage = nullptr;
+    if ((destRc.Width() > 0) && (destRc.Height() > 0)) {
+        pShadowImage = SkBoxShadowCache::Instance().GetShadowImage(roundSize, nBlurRadius, dwColor);
+    }
+    if ((pShadowImage != nullptr) &&
+        (destRc.Width() >= pShadowImage->nMinWidth) && (destRc.Height() >= pShadowImage->nMinHeight)) {
+        SkRect dstRc = srcRc;
+        dstRc.offset(m_pSkPointOrg->fX + (SkScalar)cpOffset.x, m_pSkPointOrg->fY + (SkScalar)cpOffset.y);
+        dstRc.outset((SkScalar)pShadowImage->nPadding, (SkScalar)pShadowImage->nPadding);
+
+        SkPaint imagePaint = *m_pSkPaint;
+        imagePaint.setAlpha(0xFF);
+        skCanvas->drawImageNine(pShadowImage->image.get(), pShadowImage->center, dstRc, SkFilterMode::kNearest, &imagePaint);
+        return;
+    }
+
     SkPath skPath;
     shadowPath.offset(m_pSkPointOrg->fX, m_pSkPointOrg->fY, &skPath);
 
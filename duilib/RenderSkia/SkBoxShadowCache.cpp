@@ -0,0 +1,151 @@
+#include "SkBoxShadowCache.h"
+#include "duilib/Utils/PerformanceUtil.h"
+
+#pragma warning (push)
+#pragma warning (disable: 4244 4267)
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/effects/SkImageFilters.h"
+#pragma warning (pop)
+
+namespace ui
+{
+
+//默认最多缓存的条目数
+static const size_t kDefaultMaxCount = 128;
+
+//阴影图片的最大宽度和高度（像素），圆角或者模糊半径过大时，不缓存
+static const int32_t kMaxImageSize = 512;
+
+//命中率统计的计数项（预先注册，避免每次绘制时构造名称和查找计数项）
+static PerformanceUtil::Counter* const s_pHitCounter = PerformanceUtil::Instance().RegisterCounter(_T("SkBoxShadowCache::Hit"));
+static PerformanceUtil::Counter* const s_pMissCounter = PerformanceUtil::Instance().RegisterCounter(_T("SkBoxShadowCache::Miss"));
+
+SkBoxShadowCache::SkBoxShadowCache():
+    m_nMaxCount(kDefaultMaxCount)
+{
+}
+
+SkBoxShadowCache& SkBoxShadowCache::Instance()
+{
+    static SkBoxShadowCache self;
+    return self;
+}
+
+uint64_t SkBoxShadowCache::MakeKey(const UiSize& roundSize, int32_t nBlurRadius, UiColor dwColor)
+{
+    //各个值的范围已经由kMaxImageSize限制：圆角大小不超过12位，模糊半径不超过8位
+    uint64_t nKey = dwColor.GetARGB();
+    nKey |= (uint64_t)(roundSize.cx & 0xFFF) << 32;
+    nKey |= (uint64_t)(roundSize.cy & 0xFFF) << 44;
+    nKey |= (uint64_t)(nBlurRadius & 0xFF) << 56;
+    return nKey;
+}
+
+const SkBoxShadowCache::ShadowImage* SkBoxShadowCache::GetShadowImage(const UiSize& roundSize, int32_t nBlurRadius, UiColor dwColor)
+{
+    if ((m_nMaxCount == 0) || (roundSize.cx < 0) || (roundSize.cy < 0) || (nBlurRadius < 0)) {
+        return nullptr;
+    }
+    //图片大小：阴影形状（四角各含圆角和模糊影响的区域，中间留1个像素用于拉伸）+ 四周的模糊扩展区域
+    const int32_t nPadding = nBlurRadius * 3;
+    if (((roundSize.cx + nPadding) * 2 + 1 + nPadding * 2 > kMaxImageSize) ||
+        ((roundSize.cy + nPadding) * 2 + 1 + nPadding * 2 > kMaxImageSize)) {
+        return nullptr;
+    }
+
+    const uint64_t nKey = MakeKey(roundSize, nBlurRadius, dwColor);
+    auto iter = m_cacheIndex.find(nKey);
+    if (iter != m_cacheIndex.end()) {
+        PerformanceUtil::AddCount(s_pHitCounter);
+        CacheList::iterator itItem = iter->second;
+        //移动到链表头部（迭代器仍然有效）
+        if (itItem != m_cacheList.begin()) {
+            m_cacheList.splice(m_cacheList.begin(), m_cacheList, itItem);
+        }
+        return &itItem->shadowImage;
+    }
+    PerformanceUtil::AddCount(s_pMissCounter);
+
+    CacheItem item;
+    item.nKey = nKey;
+    if (!CreateShadowImage(roundSize, nBlurRadius, dwColor, item.shadowImage)) {
+        return nullptr;
+    }
+    Trim(m_nMaxCount - 1);
+    m_cacheList.push_front(std::move(item));
+    m_cacheIndex[nKey] = m_cacheList.begin();
+    return &m_cacheList.front().shadowImage;
+}
+
+bool SkBoxShadowCache::CreateShadowImage(const UiSize& roundSize, int32_t nBlurRadius, UiColor dwColor, ShadowImage& shadowImage)
+{
+    //模糊扩展区域（高斯模糊的影响范围约为3倍的sigma）
+    const int32_t nPadding = nBlurRadius * 3;
+
+    //阴影形状中，受圆角和模糊影响的四角区域大小
+    const int32_t nCornerX = roundSize.cx + nPadding;
+    const int32_t nCornerY = roundSize.cy + nPadding;
+
+    const int32_t nShapeWidth = nCornerX * 2 + 1;
+    const int32_t nShapeHeight = nCornerY * 2 + 1;
+    const int32_t nImageWidth = nShapeWidth + nPadding * 2;
+    const int32_t nImageHeight = nShapeHeight + nPadding * 2;
+
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocN32Pixels(nImageWidth, nImageHeight)) {
+        return false;
+    }
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+
+    //绘制方式与Render_Skia::DrawBoxShadow的非缓存方式相同
+    SkCanvas canvas(bitmap);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setStyle(SkPaint::kStrokeAndFill_Style);
+    paint.setColor(dwColor.GetARGB());
+    paint.setImageFilter(SkImageFilters::Blur((SkScalar)nBlurRadius, (SkScalar)nBlurRadius, SkTileMode::kDecal, nullptr));
+
+    SkRect shapeRect = SkRect::MakeXYWH((SkScalar)nPadding, (SkScalar)nPadding, (SkScalar)nShapeWidth, (SkScalar)nShapeHeight);
+    canvas.drawRoundRect(shapeRect, (SkScalar)roundSize.cx, (SkScalar)roundSize.cy, paint);
+
+    bitmap.setImmutable();
+    shadowImage.image = bitmap.asImage();
+    if (shadowImage.image == nullptr) {
+        return false;
+    }
+    shadowImage.center = SkIRect::MakeXYWH(nPadding + nCornerX, nPadding + nCornerY, 1, 1);
+    shadowImage.nPadding = nPadding;
+    shadowImage.nMinWidth = nCornerX * 2;
+    shadowImage.nMinHeight = nCornerY * 2;
+    return true;
+}
+
+void SkBoxShadowCache::Clear()
+{
+    m_cacheIndex.clear();
+    m_cacheList.clear();
+}
+
+void SkBoxShadowCache::SetMaxCount(size_t nMaxCount)
+{
+    m_nMaxCount = nMaxCount;
+    Trim(m_nMaxCount);
+}
+
+size_t SkBoxShadowCache::GetCount() const
+{
+    return m_cacheList.size();
+}
+
+void SkBoxShadowCache::Trim(size_t nMaxCount)
+{
+    while (m_cacheList.size() > nMaxCount) {
+        CacheList::iterator itItem = std::prev(m_cacheList.end());
+        m_cacheIndex.erase(itItem->nKey);
+        m_cacheList.erase(itItem);
+    }
+}
+
+} //namespace ui
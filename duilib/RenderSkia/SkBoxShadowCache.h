@@ -0,0 +1,109 @@
+#ifndef UI_RENDER_SKIA_SK_BOX_SHADOW_CACHE_H_
+#define UI_RENDER_SKIA_SK_BOX_SHADOW_CACHE_H_
+
+#include "duilib/Core/UiTypes.h"
+
+#pragma warning (push)
+#pragma warning (disable: 4244 4267)
+#include "include/core/SkImage.h"
+#include "include/core/SkRect.h"
+#pragma warning (pop)
+
+#include <list>
+#include <unordered_map>
+
+namespace ui
+{
+
+/** 阴影图片缓存：将模糊后的圆角矩形阴影绘制为九宫格图片，绘制阴影时按九宫格方式拉伸，避免每次绘制都做高斯模糊
+*   缓存项由(圆角大小、模糊半径、阴影颜色)确定（参数均为DPI缩放后的像素值，扩展半径只影响目标区域大小，与图片无关），按LRU策略淘汰
+*   注意：只能在UI线程中使用
+*/
+class SkBoxShadowCache
+{
+public:
+    SkBoxShadowCache();
+    SkBoxShadowCache(const SkBoxShadowCache&) = delete;
+    SkBoxShadowCache& operator = (const SkBoxShadowCache&) = delete;
+
+    /** 单例对象
+    */
+    static SkBoxShadowCache& Instance();
+
+    /** 阴影的九宫格图片
+    */
+    struct ShadowImage
+    {
+        //模糊后的阴影图片，图片中阴影形状的四周留有nPadding大小的模糊扩展区域
+        sk_sp<SkImage> image;
+
+        //九宫格的中间区域（可拉伸的区域）
+        SkIRect center;
+
+        //模糊扩展区域的大小（像素）
+        int32_t nPadding;
+
+        //阴影形状的最小宽度和高度，目标区域小于该值时，不能使用九宫格方式绘制
+        int32_t nMinWidth;
+        int32_t nMinHeight;
+    };
+
+    /** 获取阴影的九宫格图片，如果缓存中不存在，则生成并添加到缓存中
+    * @param [in] roundSize 圆角大小
+    * @param [in] nBlurRadius 模糊半径
+    * @param [in] dwColor 阴影颜色
+    * @return 如果参数超出可缓存的范围或者生成失败，返回nullptr
+    */
+    const ShadowImage* GetShadowImage(const UiSize& roundSize, int32_t nBlurRadius, UiColor dwColor);
+
+    /** 清空缓存
+    */
+    void Clear();
+
+    /** 设置最多缓存的条目数
+    */
+    void SetMaxCount(size_t nMaxCount);
+
+    /** 获取当前缓存的条目数
+    */
+    size_t GetCount() const;
+
+private:
+    /** 缓存条目
+    */
+    struct CacheItem
+    {
+        uint64_t nKey;
+        ShadowImage shadowImage;
+    };
+    typedef std::list<CacheItem> CacheList;
+
+    /** 计算缓存条目的键值
+    */
+    static uint64_t MakeKey(const UiSize& roundSize, int32_t nBlurRadius, UiColor dwColor);
+
+    /** 生成阴影的九宫格图片
+    */
+    static bool CreateShadowImage(const UiSize& roundSize, int32_t nBlurRadius, UiColor dwColor, ShadowImage& shadowImage);
+
+    /** 淘汰最久未使用的条目，直到条目数不超过nMaxCount
+    */
+    void Trim(size_t nMaxCount);
+
+private:
+    /** LRU链表，最近使用的在头部
+    */
+    CacheList m_cacheList;
+
+    /** 键值到缓存条目的索引
+    */
+    std::unordered_map<uint64_t, CacheList::iterator> m_cacheIndex;
+
+    /** 最多缓存的条目数
+    */
+    size_t m_nMaxCount;
+};
+
+} //namespace ui
+
+#endif //UI_RENDER_SKIA_SK_BOX_SHADOW_CACHE_H_
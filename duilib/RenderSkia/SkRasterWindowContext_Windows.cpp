@@ -118,6 +118,13 @@ bool SkRasterWindowContext_Windows::PaintAndSwapBuffers(IRender* pRender, IRende
     //窗口透明度
     uint8_t nLayeredWindowAlpha = pRenderPaint->GetLayeredWindowAlpha();
 
+    //系统的更新区域（BeginPaint之后会被清除）
+    HRGN hUpdateRgn = ::CreateRectRgn(0, 0, 0, 0);
+    if ((hUpdateRgn != nullptr) && (::GetUpdateRgn(hWnd, hUpdateRgn, FALSE) == ERROR)) {
+        ::DeleteObject(hUpdateRgn);
+        hUpdateRgn = nullptr;
+    }
+
     //开始绘制
     bool bRet = false;
     PAINTSTRUCT ps = { 0, };
@@ -132,7 +139,15 @@ bool SkRasterWindowContext_Windows::PaintAndSwapBuffers(IRender* pRender, IRende
         bRet = pRenderPaint->DoPaint(rcPaint);
 
         //绘制完成后，更新到窗口
-        SwapPaintBuffers(hPaintDC, rcPaint, pRender, nLayeredWindowAlpha);
+        std::vector<UiRect> swapRects;
+        if (GetSwapRects(hUpdateRgn, pRenderPaint, swapRects)) {
+            for (const UiRect& rcSwap : swapRects) {
+                SwapPaintBuffers(hPaintDC, rcSwap, pRender, nLayeredWindowAlpha);
+            }
+        }
+        else {
+            SwapPaintBuffers(hPaintDC, rcPaint, pRender, nLayeredWindowAlpha);
+        }
 
         //结束本次绘制
         ::EndPaint(hWnd, &ps);
@@ -161,9 +176,46 @@ bool SkRasterWindowContext_Windows::PaintAndSwapBuffers(IRender* pRender, IRende
         //标记绘制区域为有效区域
         ::ValidateRect(hWnd, &rectUpdate);
     }
+    if (hUpdateRgn != nullptr) {
+        ::DeleteObject(hUpdateRgn);
+        hUpdateRgn = nullptr;
+    }
     return false;
 }
 
+bool SkRasterWindowContext_Windows::GetSwapRects(HRGN hUpdateRgn, IRenderPaint* pRenderPaint, std::vector<UiRect>& swapRects) const
+{
+    swapRects.clear();
+    if ((hUpdateRgn == nullptr) || (pRenderPaint == nullptr)) {
+        return false;
+    }
+    if (::GetWindowLong(m_hWnd, GWL_EXSTYLE) & WS_EX_LAYERED) {
+        //分层窗口，每次都是整个窗口更新
+        return false;
+    }
+    if (!pRenderPaint->GetPaintedRects(swapRects) || swapRects.empty()) {
+        return false;
+    }
+    //系统的更新区域中，可能包含窗口被遮挡后重新露出的区域，这部分区域也需要提交
+    bool bCovered = false;
+    HRGN hPaintedRgn = ::CreateRectRgn(0, 0, 0, 0);
+    if (hPaintedRgn != nullptr) {
+        for (const UiRect& rc : swapRects) {
+            HRGN hRectRgn = ::CreateRectRgn(rc.left, rc.top, rc.right, rc.bottom);
+            if (hRectRgn != nullptr) {
+                ::CombineRgn(hPaintedRgn, hPaintedRgn, hRectRgn, RGN_OR);
+                ::DeleteObject(hRectRgn);
+            }
+        }
+        bCovered = ::CombineRgn(hPaintedRgn, hUpdateRgn, hPaintedRgn, RGN_DIFF) == NULLREGION;
+        ::DeleteObject(hPaintedRgn);
+    }
+    if (!bCovered) {
+        swapRects.clear();
+    }
+    return bCovered;
+}
+
 bool SkRasterWindowContext_Windows::SwapPaintBuffers(HDC hPaintDC, const UiRect& rcPaint, IRender* pRender, uint8_t nLayeredWindowAlpha) const
 {
     ASSERT(hPaintDC != nullptr);
@@ -66,6 +66,14 @@ protected:
     */
     bool SwapPaintBuffers(HDC hPaintDC, const UiRect& rcPaint, IRender* pRender, uint8_t nLayeredWindowAlpha) const;
 
+    /** 获取只需提交到窗口的重绘区域：系统的更新区域都包含在本次重绘的区域中时，只提交重绘的区域
+    * @param [in] hUpdateRgn 开始绘制前，系统的更新区域
+    * @param [in] pRenderPaint 界面绘制所需的回调接口
+    * @param [out] swapRects 需要提交到窗口的区域列表
+    * @return 如果返回false，表示需要提交整个绘制区域
+    */
+    bool GetSwapRects(HRGN hUpdateRgn, IRenderPaint* pRenderPaint, std::vector<UiRect>& swapRects) const;
+
     /** 获取当前窗口的客户区矩形
     * @param [out] rcClient 返回窗口的客户区坐标
     */
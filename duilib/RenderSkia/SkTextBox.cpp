@@ -325,7 +325,7 @@ void SkTextBox::setSpacing(SkScalar mul, SkScalar add)
 
 /////////////////////////////////////////////////////////////////////////////////////////////
 
-SkScalar SkTextBox::visit(Visitor& visitor) const {
+SkScalar SkTextBox::visit(Visitor& visitor, bool cullAboveTop) const {
     const char* text = fText;
     size_t len = fLen;
     SkTextEncoding textEncoding = fTextEncoding;
@@ -393,7 +393,7 @@ SkScalar SkTextBox::visit(Visitor& visitor) const {
                         font, paint, 
                         marginWidth, lineMode,
                         &trailing);
-        if (y + metrics.fDescent + metrics.fLeading > 0) {
+        if (!cullAboveTop || (y + metrics.fDescent + metrics.fLeading > 0)) {
 
             if (textAlign == kLeft_Align) {
                 //横向：左对齐
@@ -556,8 +556,58 @@ static bool EllipsisText(const char text[], size_t length, SkTextEncoding textEn
     return false;
 }
 
-static void TextBox_DrawText(SkTextBox* textBox, 
-                             SkCanvas* canvas,
+/** 文字绘制的目标：可以直接绘制到Canvas，也可以记录为文字布局(SkTextBlob)
+*/
+class TextBoxSink {
+public:
+    virtual ~TextBoxSink() {}
+    virtual void drawText(const char text[], size_t length, SkTextEncoding textEncoding,
+                          SkScalar x, SkScalar y,
+                          const SkFont& font, const SkPaint& paint) = 0;
+    virtual void drawRect(const SkRect& rect, const SkPaint& paint) = 0;
+};
+
+class CanvasSink : public TextBoxSink {
+    SkCanvas* fCanvas;
+public:
+    explicit CanvasSink(SkCanvas* canvas) : fCanvas(canvas) {}
+
+    void drawText(const char text[], size_t length, SkTextEncoding textEncoding,
+                  SkScalar x, SkScalar y,
+                  const SkFont& font, const SkPaint& paint) override {
+        fCanvas->drawSimpleText(text, length, textEncoding, x, y, font, paint);
+    }
+    void drawRect(const SkRect& rect, const SkPaint& paint) override {
+        fCanvas->drawRect(rect, paint);
+    }
+};
+
+class LayoutSink : public TextBoxSink {
+public:
+    SkTextBlobBuilder fBuilder;
+    std::vector<SkRect>* fDecorations;
+public:
+    explicit LayoutSink(std::vector<SkRect>* decorations) : fDecorations(decorations) {}
+
+    void drawText(const char text[], size_t length, SkTextEncoding textEncoding,
+                  SkScalar x, SkScalar y,
+                  const SkFont& font, const SkPaint& /*paint*/) override {
+        const int count = font.countText(text, length, textEncoding);
+        if (count <= 0) {
+            return;
+        }
+        SkTextBlobBuilder::RunBuffer runBuffer = fBuilder.allocRun(font, count, x, y);
+        font.textToGlyphs(text, length, textEncoding, runBuffer.glyphs, count);
+    }
+    void drawRect(const SkRect& rect, const SkPaint& /*paint*/) override {
+        if (fDecorations != nullptr) {
+            fDecorations->push_back(rect);
+        }
+    }
+};
+
+static void TextBox_DrawText(const SkTextBox* textBox, 
+                             TextBoxSink* canvas,
                              const char text[], size_t length, SkTextEncoding textEncoding, 
                              SkScalar x, SkScalar y,
                              const SkFont& font, const SkPaint& paint,
@@ -581,7 +631,7 @@ static void TextBox_DrawText(SkTextBox* textBox,
     bool isSingleLine = textBox->getLineMode() == SkTextBox::kOneLine_Mode;
 
     if (!bEndEllipsis && !bPathEllipsis && !bUnderline && !bStrikeOut) {
-        canvas->drawSimpleText(text, length, textEncoding, x, y, font, paint);
+        canvas->drawText(text, length, textEncoding, x, y, font, paint);
     }
     else {
         bool needEllipsis = false;
@@ -603,7 +653,7 @@ static void TextBox_DrawText(SkTextBox* textBox,
             }
         }
         if(!needEllipsis && !bUnderline && !bStrikeOut) {
-            canvas->drawSimpleText(text, length, textEncoding, x, y, font, paint);
+            canvas->drawText(text, length, textEncoding, x, y, font, paint);
         }
         else {
             std::string string_utf8;
@@ -626,7 +676,7 @@ static void TextBox_DrawText(SkTextBox* textBox,
                 }
             }
             //绘制文本
-            canvas->drawSimpleText(text, length, textEncoding, x, y, font, paint);
+            canvas->drawText(text, length, textEncoding, x, y, font, paint);
             if (bUnderline || bStrikeOut) {
                 SkScalar width = font.measureText(text, length, textEncoding, nullptr, &paint);
 
@@ -668,10 +718,10 @@ static void TextBox_DrawText(SkTextBox* textBox,
 ///////////////////////////////////////////////////////////////////////////////
 
 class CanvasVisitor : public SkTextBox::Visitor {
-    SkCanvas* fCanvas;
-    SkTextBox* fTextBox;
+    TextBoxSink* fCanvas;
+    const SkTextBox* fTextBox;
 public:
-    CanvasVisitor(SkCanvas* canvas, SkTextBox* textBox): 
+    CanvasVisitor(TextBoxSink* canvas, const SkTextBox* textBox): 
          fCanvas(canvas)
         ,fTextBox(textBox) {
     }
@@ -768,7 +818,8 @@ void SkTextBox::draw(SkCanvas* canvas) {
         saveCount = canvas->save();
         canvas->clipRect(fBox, true);
     }
-    CanvasVisitor sink(canvas, this);
+    CanvasSink canvasSink(canvas);
+    CanvasVisitor sink(&canvasSink, this);
     this->visit(sink);
     if (fClipBox) {
         canvas->restoreToCount(saveCount);
@@ -811,6 +862,22 @@ sk_sp<SkTextBlob> SkTextBox::snapshotTextBlob(SkScalar* computedBottom) const {
     return visitor.fBuilder.make();
 }
 
+sk_sp<SkTextBlob> SkTextBox::snapshotLayout(std::vector<SkRect>* decorations) const {
+    if (decorations != nullptr) {
+        decorations->clear();
+    }
+    if ((fText == nullptr) || (fLen == 0) || (fPaint == nullptr) || (fFont == nullptr)) {
+        return nullptr;
+    }
+    //布局的坐标相对于Box的左上角，绘制时再平移到实际位置
+    SkTextBox textBox(*this);
+    textBox.fBox.offsetTo(0, 0);
+    LayoutSink layoutSink(decorations);
+    CanvasVisitor visitor(&layoutSink, &textBox);
+    textBox.visit(visitor, false);
+    return layoutSink.fBuilder.make();
+}
+
 bool SkTextBox::TextToGlyphs(const void* text, size_t byteLength, SkTextEncoding textEncoding,
                              const SkFont& font,
                              std::vector<SkGlyphID>& glyphs,
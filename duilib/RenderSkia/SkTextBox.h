@@ -133,6 +133,12 @@ public:
 
     sk_sp<SkTextBlob> snapshotTextBlob(SkScalar* computedBottom) const;
 
+    /** 生成文字布局（含省略号处理），坐标相对于Box的左上角，可缓存后重复绘制
+    * @param [out] decorations 返回下划线、删除线的矩形区域（坐标相对于Box的左上角）
+    * @return 返回文字的SkTextBlob，绘制时按Box的左上角坐标平移
+    */
+    sk_sp<SkTextBlob> snapshotLayout(std::vector<SkRect>* decorations) const;
+
     class Visitor {
     public:
         virtual ~Visitor() {}
@@ -143,7 +149,10 @@ public:
     };
 
 private:
-    SkScalar visit(Visitor& visitor) const;
+    /** 逐行遍历文字
+    * @param [in] cullAboveTop 是否跳过完全位于画布顶部以上的行
+    */
+    SkScalar visit(Visitor& visitor, bool cullAboveTop = true) const;
 
     /** 将文本转换为Glyphs
     * @param [out] glyphs 转换结果Glyphs
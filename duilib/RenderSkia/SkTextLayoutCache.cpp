@@ -0,0 +1,191 @@
+#include "SkTextLayoutCache.h"
+#include "duilib/Utils/PerformanceUtil.h"
+
+#pragma warning (push)
+#pragma warning (disable: 4244 4267)
+#include "include/core/SkTypeface.h"
+#pragma warning (pop)
+
+#include <functional>
+
+namespace ui
+{
+
+//默认最多缓存的条目数
+static const size_t kDefaultMaxCount = 1024;
+
+//可缓存文本的最大长度（字符数），过长的文本（如编辑框中的大段文字）不缓存
+static const size_t kMaxTextLength = 1024;
+
+//命中率统计的计数项（预先注册，避免每次绘制时构造名称和查找计数项）
+static PerformanceUtil::Counter* const s_pDrawHitCounter = PerformanceUtil::Instance().RegisterCounter(_T("SkTextLayoutCache::DrawHit"));
+static PerformanceUtil::Counter* const s_pDrawMissCounter = PerformanceUtil::Instance().RegisterCounter(_T("SkTextLayoutCache::DrawMiss"));
+static PerformanceUtil::Counter* const s_pMeasureHitCounter = PerformanceUtil::Instance().RegisterCounter(_T("SkTextLayoutCache::MeasureHit"));
+static PerformanceUtil::Counter* const s_pMeasureMissCounter = PerformanceUtil::Instance().RegisterCounter(_T("SkTextLayoutCache::MeasureMiss"));
+
+SkTextLayoutCache::SkTextLayoutCache():
+    m_nMaxCount(kDefaultMaxCount)
+{
+}
+
+SkTextLayoutCache& SkTextLayoutCache::Instance()
+{
+    static SkTextLayoutCache self;
+    return self;
+}
+
+bool SkTextLayoutCache::IsCacheable(const DString& text) const
+{
+    return !text.empty() && (text.size() <= kMaxTextLength) && (m_nMaxCount > 0);
+}
+
+const SkTextLayoutCache::TextLayout* SkTextLayoutCache::FindDrawLayout(const DString& text, const SkFont& font,
+                                                                       uint32_t uFormat, int32_t nWidth, int32_t nHeight)
+{
+    CacheItem* pItem = Find(false, text, font, uFormat, nWidth, nHeight);
+    if (pItem != nullptr) {
+        PerformanceUtil::AddCount(s_pDrawHitCounter);
+        return &pItem->layout;
+    }
+    PerformanceUtil::AddCount(s_pDrawMissCounter);
+    return nullptr;
+}
+
+const SkTextLayoutCache::TextLayout* SkTextLayoutCache::AddDrawLayout(const DString& text, const SkFont& font,
+                                                                      uint32_t uFormat, int32_t nWidth, int32_t nHeight,
+                                                                      TextLayout&& layout)
+{
+    CacheItem* pItem = Add(false, text, font, uFormat, nWidth, nHeight, std::move(layout));
+    if (pItem != nullptr) {
+        return &pItem->layout;
+    }
+    return nullptr;
+}
+
+bool SkTextLayoutCache::FindMeasureResult(const DString& text, const SkFont& font,
+                                          uint32_t uFormat, int32_t nWidth, UiRect& rcMeasure)
+{
+    CacheItem* pItem = Find(true, text, font, uFormat, nWidth, 0);
+    if (pItem != nullptr) {
+        PerformanceUtil::AddCount(s_pMeasureHitCounter);
+        rcMeasure = pItem->layout.rcMeasure;
+        return true;
+    }
+    PerformanceUtil::AddCount(s_pMeasureMissCounter);
+    return false;
+}
+
+void SkTextLayoutCache::AddMeasureResult(const DString& text, const SkFont& font,
+                                         uint32_t uFormat, int32_t nWidth, const UiRect& rcMeasure)
+{
+    TextLayout layout;
+    layout.rcMeasure = rcMeasure;
+    Add(true, text, font, uFormat, nWidth, 0, std::move(layout));
+}
+
+void SkTextLayoutCache::Clear()
+{
+    m_cacheIndex.clear();
+    m_cacheList.clear();
+}
+
+void SkTextLayoutCache::SetMaxCount(size_t nMaxCount)
+{
+    m_nMaxCount = nMaxCount;
+    Trim(m_nMaxCount);
+}
+
+size_t SkTextLayoutCache::GetCount() const
+{
+    return m_cacheList.size();
+}
+
+size_t SkTextLayoutCache::HashKey(bool bMeasure, const DString& text, const SkFont& font,
+                                  uint32_t uFormat, int32_t nWidth, int32_t nHeight)
+{
+    size_t nHash = std::hash<DString>()(text);
+    auto hashCombine = [&nHash](size_t nValue) {
+            nHash ^= nValue + 0x9e3779b9 + (nHash << 6) + (nHash >> 2);
+        };
+    SkTypeface* pTypeface = font.getTypeface();
+    hashCombine((pTypeface != nullptr) ? pTypeface->uniqueID() : 0);
+    hashCombine(std::hash<float>()(font.getSize()));
+    hashCombine(bMeasure ? 1 : 0);
+    hashCombine(uFormat);
+    hashCombine((uint32_t)nWidth);
+    hashCombine((uint32_t)nHeight);
+    return nHash;
+}
+
+SkTextLayoutCache::CacheItem* SkTextLayoutCache::Find(bool bMeasure, const DString& text, const SkFont& font,
+                                                      uint32_t uFormat, int32_t nWidth, int32_t nHeight)
+{
+    if (m_cacheList.empty()) {
+        return nullptr;
+    }
+    const size_t nHash = HashKey(bMeasure, text, font, uFormat, nWidth, nHeight);
+    auto range = m_cacheIndex.equal_range(nHash);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        CacheList::iterator itItem = iter->second;
+        const CacheItem& item = *itItem;
+        if ((item.bMeasure == bMeasure) &&
+            (item.uFormat == uFormat) &&
+            (item.nWidth == nWidth) &&
+            (item.nHeight == nHeight) &&
+            (item.font == font) &&
+            (item.text == text)) {
+            //移动到链表头部（迭代器仍然有效）
+            if (itItem != m_cacheList.begin()) {
+                m_cacheList.splice(m_cacheList.begin(), m_cacheList, itItem);
+            }
+            return &(*itItem);
+        }
+    }
+    return nullptr;
+}
+
+SkTextLayoutCache::CacheItem* SkTextLayoutCache::Add(bool bMeasure, const DString& text, const SkFont& font,
+                                                     uint32_t uFormat, int32_t nWidth, int32_t nHeight,
+                                                     TextLayout&& layout)
+{
+    if (!IsCacheable(text)) {
+        return nullptr;
+    }
+    CacheItem* pItem = Find(bMeasure, text, font, uFormat, nWidth, nHeight);
+    if (pItem != nullptr) {
+        //已经存在，更新数据
+        pItem->layout = std::move(layout);
+        return pItem;
+    }
+    Trim(m_nMaxCount - 1);
+
+    CacheItem item;
+    item.nHash = HashKey(bMeasure, text, font, uFormat, nWidth, nHeight);
+    item.bMeasure = bMeasure;
+    item.text = text;
+    item.font = font;
+    item.uFormat = uFormat;
+    item.nWidth = nWidth;
+    item.nHeight = nHeight;
+    item.layout = std::move(layout);
+    m_cacheList.push_front(std::move(item));
+    m_cacheIndex.insert({ m_cacheList.front().nHash, m_cacheList.begin() });
+    return &m_cacheList.front();
+}
+
+void SkTextLayoutCache::Trim(size_t nMaxCount)
+{
+    while (m_cacheList.size() > nMaxCount) {
+        CacheList::iterator itItem = std::prev(m_cacheList.end());
+        auto range = m_cacheIndex.equal_range(itItem->nHash);
+        for (auto iter = range.first; iter != range.second; ++iter) {
+            if (iter->second == itItem) {
+                m_cacheIndex.erase(iter);
+                break;
+            }
+        }
+        m_cacheList.erase(itItem);
+    }
+}
+
+} //namespace ui
@@ -0,0 +1,149 @@
+#ifndef UI_RENDER_SKIA_SK_TEXT_LAYOUT_CACHE_H_
+#define UI_RENDER_SKIA_SK_TEXT_LAYOUT_CACHE_H_
+
+#include "duilib/Core/UiRect.h"
+
+#pragma warning (push)
+#pragma warning (disable: 4244 4267)
+#include "include/core/SkFont.h"
+#include "include/core/SkTextBlob.h"
+#pragma warning (pop)
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+
+namespace ui
+{
+
+/** 文字布局缓存：缓存文字的测量结果和绘制布局(SkTextBlob)，避免每次绘制都重新转换Glyph和分行
+*   缓存项由(文本内容、字体、区域宽高、格式标志)确定，按LRU策略淘汰
+*   注意：只能在UI线程中使用
+*/
+class SkTextLayoutCache
+{
+public:
+    SkTextLayoutCache();
+    SkTextLayoutCache(const SkTextLayoutCache&) = delete;
+    SkTextLayoutCache& operator = (const SkTextLayoutCache&) = delete;
+
+    /** 单例对象
+    */
+    static SkTextLayoutCache& Instance();
+
+    /** 文字的布局数据（坐标相对于绘制区域的左上角）
+    */
+    struct TextLayout
+    {
+        //文字绘制数据（DrawString使用）
+        sk_sp<SkTextBlob> textBlob;
+
+        //下划线、删除线的矩形区域（DrawString使用）
+        std::vector<SkRect> decorations;
+
+        //文字的测量结果（MeasureString使用）
+        UiRect rcMeasure;
+    };
+
+    /** 查找绘制文字的布局
+    * @param [in] text 文本内容
+    * @param [in] font 字体
+    * @param [in] uFormat 格式标志，取值参考：DrawStringFormat，以及下划线、删除线等字体属性
+    * @param [in] nWidth 绘制区域的宽度
+    * @param [in] nHeight 绘制区域的高度
+    * @return 如果缓存中不存在，返回nullptr
+    */
+    const TextLayout* FindDrawLayout(const DString& text, const SkFont& font,
+                                     uint32_t uFormat, int32_t nWidth, int32_t nHeight);
+
+    /** 添加绘制文字的布局，参数含义同FindDrawLayout
+    */
+    const TextLayout* AddDrawLayout(const DString& text, const SkFont& font,
+                                    uint32_t uFormat, int32_t nWidth, int32_t nHeight,
+                                    TextLayout&& layout);
+
+    /** 查找文字的测量结果
+    * @param [in] text 文本内容
+    * @param [in] font 字体
+    * @param [in] uFormat 格式标志，取值参考：DrawStringFormat
+    * @param [in] nWidth 限制宽度
+    * @param [out] rcMeasure 返回测量结果
+    * @return 如果缓存中不存在，返回false
+    */
+    bool FindMeasureResult(const DString& text, const SkFont& font,
+                           uint32_t uFormat, int32_t nWidth, UiRect& rcMeasure);
+
+    /** 添加文字的测量结果，参数含义同FindMeasureResult
+    */
+    void AddMeasureResult(const DString& text, const SkFont& font,
+                          uint32_t uFormat, int32_t nWidth, const UiRect& rcMeasure);
+
+    /** 文本是否可以缓存（过长的文本不缓存）
+    */
+    bool IsCacheable(const DString& text) const;
+
+    /** 清空缓存
+    */
+    void Clear();
+
+    /** 设置最多缓存的条目数
+    */
+    void SetMaxCount(size_t nMaxCount);
+
+    /** 获取当前缓存的条目数
+    */
+    size_t GetCount() const;
+
+private:
+    /** 缓存条目
+    */
+    struct CacheItem
+    {
+        size_t nHash;
+        bool bMeasure;
+        DString text;
+        SkFont font;
+        uint32_t uFormat;
+        int32_t nWidth;
+        int32_t nHeight;
+        TextLayout layout;
+    };
+    typedef std::list<CacheItem> CacheList;
+
+    /** 计算缓存条目的哈希值
+    */
+    static size_t HashKey(bool bMeasure, const DString& text, const SkFont& font,
+                          uint32_t uFormat, int32_t nWidth, int32_t nHeight);
+
+    /** 查找缓存条目，找到后移动到LRU链表头部
+    */
+    CacheItem* Find(bool bMeasure, const DString& text, const SkFont& font,
+                    uint32_t uFormat, int32_t nWidth, int32_t nHeight);
+
+    /** 添加缓存条目，超出最大条目数时，淘汰最久未使用的条目
+    */
+    CacheItem* Add(bool bMeasure, const DString& text, const SkFont& font,
+                   uint32_t uFormat, int32_t nWidth, int32_t nHeight,
+                   TextLayout&& layout);
+
+    /** 淘汰最久未使用的条目，直到条目数不超过nMaxCount
+    */
+    void Trim(size_t nMaxCount);
+
+private:
+    /** LRU链表，最近使用的在头部
+    */
+    CacheList m_cacheList;
+
+    /** 哈希值到缓存条目的索引
+    */
+    std::unordered_multimap<size_t, CacheList::iterator> m_cacheIndex;
+
+    /** 最多缓存的条目数
+    */
+    size_t m_nMaxCount;
+};
+
+} //namespace ui
+
+#endif //UI_RENDER_SKIA_SK_TEXT_LAYOUT_CACHE_H_
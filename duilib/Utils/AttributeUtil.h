@@ -9,6 +9,11 @@
 namespace ui
 {
 class Window;
+
+/** 解析后的属性列表：属性名称与属性值
+*/
+typedef std::vector<std::pair<DString, DString>> AttributeList;
+
 class UILIB_API AttributeUtil
 {
 public:
@@ -46,6 +51,10 @@ public:
                                    DString::value_type seperateChar,
                                    std::vector<std::pair<DString, DString>>& attributeList);
 
+    /** 解析属性列表，分隔符（双引号或者单引号）根据字符串内容自动识别
+    */
+    static void ParseAttributeList(const DString& strList, AttributeList& attributeList);
+
     /** 解析一个字符串（格式为："500,"或者"50%,"，逗号可有可无，也可以是其他字符），得到整型值或者浮点数
     * @param [in] strValue 待解析的字符串地址
     * @param [out] pEndPtr 解析完成后，字符串结束地址，用于继续解析后面的内容
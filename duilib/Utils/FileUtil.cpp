@@ -32,4 +32,26 @@ bool FileUtil::ReadFileData(const FilePath& filePath, std::vector<uint8_t>& file
     return isReadOk;
 }
 
+bool FileUtil::WriteFileData(const FilePath& filePath, const std::vector<uint8_t>& fileData)
+{
+    bool isWriteOk = false;
+    FILE* f = nullptr;
+#ifdef DUILIB_UNICODE
+    errno_t ret = ::_wfopen_s(&f, filePath.NativePath().c_str(), _T("wb"));
+#else
+    errno_t ret = ::fopen_s(&f, filePath.NativePath().c_str(), _T("wb"));
+#endif
+    if ((ret == 0) && (f != nullptr)) {
+        size_t writeLen = 0;
+        if (!fileData.empty()) {
+            writeLen = ::fwrite(fileData.data(), 1, fileData.size(), f);
+        }
+        isWriteOk = (writeLen == fileData.size());
+        if (::fclose(f) != 0) {
+            isWriteOk = false;
+        }
+    }
+    return isWriteOk;
+}
+
 }//namespace ui
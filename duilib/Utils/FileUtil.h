@@ -15,6 +15,12 @@ public:
     * @param [out] fileData 文件数据，按二进制数据读取
     */
     static bool ReadFileData(const FilePath& filePath, std::vector<uint8_t>& fileData);
+
+    /** 写入文件内容（如果文件已经存在，覆盖原文件）
+    * @param [in] filePath 本地文件路径(绝对路径)
+    * @param [in] fileData 文件数据，按二进制数据写入
+    */
+    static bool WriteFileData(const FilePath& filePath, const std::vector<uint8_t>& fileData);
 };
 
 }
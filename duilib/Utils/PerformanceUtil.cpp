@@ -23,6 +23,10 @@ PerformanceUtil::~PerformanceUtil()
                                         (int32_t)(iter.second.maxTime.count() / 1000));
         LogUtil::OutputLine(log);
     }
+    for (const auto& iter : m_count) {
+        DString log = StringUtil::Printf(_T("%s: %d"), iter.first.c_str(), (int32_t)iter.second.load());
+        LogUtil::OutputLine(log);
+    }
 }
 
 PerformanceUtil& PerformanceUtil::Instance()
@@ -55,4 +59,30 @@ void PerformanceUtil::EndStat(const DString& name)
     stat.maxTime = std::max(stat.maxTime, thisTime);
 }
 
+PerformanceUtil::Counter* PerformanceUtil::RegisterCounter(const DString& name)
+{
+    ASSERT(!name.empty());
+    std::lock_guard<std::mutex> threadGuard(m_countMutex);
+    auto iter = m_count.find(name);
+    if (iter == m_count.end()) {
+        iter = m_count.emplace(name, 0).first;
+    }
+    return &iter->second;
+}
+
+void PerformanceUtil::AddCount(const DString& name, uint64_t nCount)
+{
+    AddCount(RegisterCounter(name), nCount);
+}
+
+uint64_t PerformanceUtil::GetCount(const DString& name) const
+{
+    std::lock_guard<std::mutex> threadGuard(m_countMutex);
+    auto iter = m_count.find(name);
+    if (iter != m_count.end()) {
+        return iter->second.load();
+    }
+    return 0;
+}
+
 }
@@ -5,6 +5,8 @@
 #include <string>
 #include <map>
 #include <chrono>
+#include <atomic>
+#include <mutex>
 
 namespace ui 
 {
@@ -30,6 +32,36 @@ public:
     * @param [in] name 统计项的名称
     */
     void EndStat(const DString& name);
+
+    /** 计数项：注册后地址不变，热点代码中应保存注册返回的指针，直接累加计数
+    */
+    typedef std::atomic<uint64_t> Counter;
+
+    /** 注册计数项（如果已经存在，返回已有的计数项）
+    * @param [in] name 计数项的名称
+    * @return 返回计数项的指针，在进程生命周期内有效
+    */
+    Counter* RegisterCounter(const DString& name);
+
+    /** 累加计数，用于统计缓存命中次数等（每次调用需查找计数项，热点代码中请使用注册的计数项）
+    * @param [in] name 计数项的名称
+    * @param [in] nCount 增加的数值
+    */
+    void AddCount(const DString& name, uint64_t nCount = 1);
+
+    /** 累加计数（无锁、无查找，可在热点代码中使用）
+    * @param [in] pCounter 注册的计数项
+    * @param [in] nCount 增加的数值
+    */
+    static void AddCount(Counter* pCounter, uint64_t nCount = 1)
+    {
+        pCounter->fetch_add(nCount, std::memory_order_relaxed);
+    }
+
+    /** 获取计数项的当前值
+    * @param [in] name 计数项的名称
+    */
+    uint64_t GetCount(const DString& name) const;
     
 private:
     /** 记录每项统计的结果
@@ -57,6 +89,14 @@ private:
     };
 
     std::map<DString, TStat> m_stat;
+
+    /** 每个计数项的当前值（std::map的节点地址不变，计数项指针可长期保存）
+    */
+    std::map<DString, Counter> m_count;
+
+    /** 计数项表的锁
+    */
+    mutable std::mutex m_countMutex;
 };
 
 class PerformanceStat
@@ -0,0 +1,496 @@
+#include "PixelUtil.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define DUILIB_PIXEL_X86 1
+    #include <emmintrin.h>
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    #define DUILIB_PIXEL_NEON 1
+    #include <arm_neon.h>
+#endif
+
+//GCC/Clang需要对使用AVX2指令的函数单独指定目标指令集（MSVC不需要）
+#if defined(DUILIB_PIXEL_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define DUILIB_TARGET_SSE2 __attribute__((target("sse2")))
+    #define DUILIB_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define DUILIB_TARGET_SSE2
+    #define DUILIB_TARGET_AVX2
+#endif
+
+namespace ui
+{
+
+/** 像素处理函数表，每个SIMD指令集级别一个
+*/
+struct PixelKernels
+{
+    PixelUtil::SimdLevel level;
+    void (*swapRedBlue)(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels);
+    void (*premultiplyAlpha)(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels, bool bSwapRedBlue);
+    void (*setAlphaOpaque)(uint8_t* pPixels, size_t nPixels);
+    void (*restoreAlpha)(uint8_t* pPixels, size_t nPixels, uint8_t alpha);
+};
+
+/** 普通实现（也用于处理SIMD实现中不足一组的剩余像素）
+*/
+namespace PixelScalar
+{
+    /** 精确计算 v / 255（向下取整），v的范围：[0, 65025]
+    */
+    inline uint32_t Div255(uint32_t v)
+    {
+        return (v + 1 + (v >> 8)) >> 8;
+    }
+
+    void SwapRedBlue(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels)
+    {
+        for (size_t i = 0; i < nPixels; ++i) {
+            uint8_t r = pSrc[0];
+            uint8_t g = pSrc[1];
+            uint8_t b = pSrc[2];
+            uint8_t a = pSrc[3];
+            pDst[0] = b;
+            pDst[1] = g;
+            pDst[2] = r;
+            pDst[3] = a;
+            pSrc += 4;
+            pDst += 4;
+        }
+    }
+
+    void PremultiplyAlpha(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels, bool bSwapRedBlue)
+    {
+        for (size_t i = 0; i < nPixels; ++i) {
+            uint32_t a = pSrc[3];
+            uint8_t c0 = (uint8_t)Div255(pSrc[0] * a);
+            uint8_t c1 = (uint8_t)Div255(pSrc[1] * a);
+            uint8_t c2 = (uint8_t)Div255(pSrc[2] * a);
+            pDst[0] = bSwapRedBlue ? c2 : c0;
+            pDst[1] = c1;
+            pDst[2] = bSwapRedBlue ? c0 : c2;
+            pDst[3] = (uint8_t)a;
+            pSrc += 4;
+            pDst += 4;
+        }
+    }
+
+    void SetAlphaOpaque(uint8_t* pPixels, size_t nPixels)
+    {
+        for (size_t i = 0; i < nPixels; ++i) {
+            pPixels[i * 4 + 3] = 255;
+        }
+    }
+
+    void RestoreAlpha(uint8_t* pPixels, size_t nPixels, uint8_t alpha)
+    {
+        for (size_t i = 0; i < nPixels; ++i) {
+            uint8_t& a = pPixels[i * 4 + 3];
+            if ((alpha != 0) && (a == alpha)) {
+                a = 0;
+            }
+            else if (a == 0) {
+                a = 255;
+            }
+        }
+    }
+
+    const PixelKernels kKernels = {
+        PixelUtil::SimdLevel::kNone,
+        SwapRedBlue, PremultiplyAlpha, SetAlphaOpaque, RestoreAlpha
+    };
+} // namespace PixelScalar
+
+#ifdef DUILIB_PIXEL_X86
+
+/** SSE2实现，每次处理4个像素
+*/
+namespace PixelSSE2
+{
+    DUILIB_TARGET_SSE2 inline __m128i SwapRB(__m128i x)
+    {
+        const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+        __m128i rb = _mm_and_si128(x, maskRB);
+        __m128i ga = _mm_andnot_si128(maskRB, x);
+        rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+        return _mm_or_si128(ga, rb);
+    }
+
+    /** 对2个像素（已扩展为8个16位整数）进行Alpha预乘，Alpha值保持不变
+    */
+    DUILIB_TARGET_SSE2 inline __m128i Premultiply16(__m128i x16)
+    {
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i maskAlpha = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+        __m128i a16 = _mm_shufflelo_epi16(x16, _MM_SHUFFLE(3, 3, 3, 3));
+        a16 = _mm_shufflehi_epi16(a16, _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i v = _mm_mullo_epi16(x16, a16);
+        v = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(v, one), _mm_srli_epi16(v, 8)), 8);
+        return _mm_or_si128(_mm_andnot_si128(maskAlpha, v), _mm_and_si128(maskAlpha, x16));
+    }
+
+    DUILIB_TARGET_SSE2 void SwapRedBlue(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels)
+    {
+        size_t i = 0;
+        for (; i + 4 <= nPixels; i += 4) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(pSrc + i * 4));
+            _mm_storeu_si128((__m128i*)(pDst + i * 4), SwapRB(x));
+        }
+        PixelScalar::SwapRedBlue(pSrc + i * 4, pDst + i * 4, nPixels - i);
+    }
+
+    DUILIB_TARGET_SSE2 void PremultiplyAlpha(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels, bool bSwapRedBlue)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 4 <= nPixels; i += 4) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(pSrc + i * 4));
+            __m128i lo = Premultiply16(_mm_unpacklo_epi8(x, zero));
+            __m128i hi = Premultiply16(_mm_unpackhi_epi8(x, zero));
+            __m128i r = _mm_packus_epi16(lo, hi);
+            if (bSwapRedBlue) {
+                r = SwapRB(r);
+            }
+            _mm_storeu_si128((__m128i*)(pDst + i * 4), r);
+        }
+        PixelScalar::PremultiplyAlpha(pSrc + i * 4, pDst + i * 4, nPixels - i, bSwapRedBlue);
+    }
+
+    DUILIB_TARGET_SSE2 void SetAlphaOpaque(uint8_t* pPixels, size_t nPixels)
+    {
+        const __m128i maskAlpha = _mm_set1_epi32((int32_t)0xFF000000);
+        size_t i = 0;
+        for (; i + 4 <= nPixels; i += 4) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(pPixels + i * 4));
+            _mm_storeu_si128((__m128i*)(pPixels + i * 4), _mm_or_si128(x, maskAlpha));
+        }
+        PixelScalar::SetAlphaOpaque(pPixels + i * 4, nPixels - i);
+    }
+
+    DUILIB_TARGET_SSE2 void RestoreAlpha(uint8_t* pPixels, size_t nPixels, uint8_t alpha)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i maskAlpha = _mm_set1_epi32((int32_t)0xFF000000);
+        const __m128i alpha32 = _mm_set1_epi32(alpha);
+        size_t i = 0;
+        for (; i + 4 <= nPixels; i += 4) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(pPixels + i * 4));
+            __m128i a = _mm_srli_epi32(x, 24);
+            //Alpha值为0的像素，设置为255；Alpha值等于alpha的像素，设置为0
+            __m128i setOpaque = _mm_and_si128(_mm_cmpeq_epi32(a, zero), maskAlpha);
+            __m128i setClear = zero;
+            if (alpha != 0) {
+                setClear = _mm_and_si128(_mm_cmpeq_epi32(a, alpha32), maskAlpha);
+            }
+            x = _mm_or_si128(_mm_andnot_si128(setClear, x), setOpaque);
+            _mm_storeu_si128((__m128i*)(pPixels + i * 4), x);
+        }
+        PixelScalar::RestoreAlpha(pPixels + i * 4, nPixels - i, alpha);
+    }
+
+    const PixelKernels kKernels = {
+        PixelUtil::SimdLevel::kSSE2,
+        SwapRedBlue, PremultiplyAlpha, SetAlphaOpaque, RestoreAlpha
+    };
+} // namespace PixelSSE2
+
+/** AVX2实现，每次处理8个像素
+*/
+namespace PixelAVX2
+{
+    DUILIB_TARGET_AVX2 inline __m256i SwapRB(__m256i x)
+    {
+        const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        return _mm256_shuffle_epi8(x, shuffle);
+    }
+
+    /** 对4个像素（已扩展为16个16位整数）进行Alpha预乘，Alpha值保持不变
+    */
+    DUILIB_TARGET_AVX2 inline __m256i Premultiply16(__m256i x16)
+    {
+        const __m256i one = _mm256_set1_epi16(1);
+        const __m256i maskAlpha = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+        __m256i a16 = _mm256_shufflelo_epi16(x16, _MM_SHUFFLE(3, 3, 3, 3));
+        a16 = _mm256_shufflehi_epi16(a16, _MM_SHUFFLE(3, 3, 3, 3));
+        __m256i v = _mm256_mullo_epi16(x16, a16);
+        v = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(v, one), _mm256_srli_epi16(v, 8)), 8);
+        return _mm256_blendv_epi8(v, x16, maskAlpha);
+    }
+
+    DUILIB_TARGET_AVX2 void SwapRedBlue(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels)
+    {
+        size_t i = 0;
+        for (; i + 8 <= nPixels; i += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(pSrc + i * 4));
+            _mm256_storeu_si256((__m256i*)(pDst + i * 4), SwapRB(x));
+        }
+        PixelScalar::SwapRedBlue(pSrc + i * 4, pDst + i * 4, nPixels - i);
+    }
+
+    DUILIB_TARGET_AVX2 void PremultiplyAlpha(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels, bool bSwapRedBlue)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= nPixels; i += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(pSrc + i * 4));
+            //unpack和pack都是在每128位内进行的，像素顺序保持不变
+            __m256i lo = Premultiply16(_mm256_unpacklo_epi8(x, zero));
+            __m256i hi = Premultiply16(_mm256_unpackhi_epi8(x, zero));
+            __m256i r = _mm256_packus_epi16(lo, hi);
+            if (bSwapRedBlue) {
+                r = SwapRB(r);
+            }
+            _mm256_storeu_si256((__m256i*)(pDst + i * 4), r);
+        }
+        PixelScalar::PremultiplyAlpha(pSrc + i * 4, pDst + i * 4, nPixels - i, bSwapRedBlue);
+    }
+
+    DUILIB_TARGET_AVX2 void SetAlphaOpaque(uint8_t* pPixels, size_t nPixels)
+    {
+        const __m256i maskAlpha = _mm256_set1_epi32((int32_t)0xFF000000);
+        size_t i = 0;
+        for (; i + 8 <= nPixels; i += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(pPixels + i * 4));
+            _mm256_storeu_si256((__m256i*)(pPixels + i * 4), _mm256_or_si256(x, maskAlpha));
+        }
+        PixelScalar::SetAlphaOpaque(pPixels + i * 4, nPixels - i);
+    }
+
+    DUILIB_TARGET_AVX2 void RestoreAlpha(uint8_t* pPixels, size_t nPixels, uint8_t alpha)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i maskAlpha = _mm256_set1_epi32((int32_t)0xFF000000);
+        const __m256i alpha32 = _mm256_set1_epi32(alpha);
+        size_t i = 0;
+        for (; i + 8 <= nPixels; i += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(pPixels + i * 4));
+            __m256i a = _mm256_srli_epi32(x, 24);
+            __m256i setOpaque = _mm256_and_si256(_mm256_cmpeq_epi32(a, zero), maskAlpha);
+            __m256i setClear = zero;
+            if (alpha != 0) {
+                setClear = _mm256_and_si256(_mm256_cmpeq_epi32(a, alpha32), maskAlpha);
+            }
+            x = _mm256_or_si256(_mm256_andnot_si256(setClear, x), setOpaque);
+            _mm256_storeu_si256((__m256i*)(pPixels + i * 4), x);
+        }
+        PixelScalar::RestoreAlpha(pPixels + i * 4, nPixels - i, alpha);
+    }
+
+    const PixelKernels kKernels = {
+        PixelUtil::SimdLevel::kAVX2,
+        SwapRedBlue, PremultiplyAlpha, SetAlphaOpaque, RestoreAlpha
+    };
+} // namespace PixelAVX2
+
+/** 检测CPU支持的指令集
+*/
+static void DetectCpuFeatures(bool& bSSE2, bool& bAVX2)
+{
+    bSSE2 = false;
+    bAVX2 = false;
+#ifdef _MSC_VER
+    int cpuInfo[4] = { 0, };
+    __cpuid(cpuInfo, 0);
+    const int nMaxId = cpuInfo[0];
+    if (nMaxId >= 1) {
+        __cpuid(cpuInfo, 1);
+        bSSE2 = (cpuInfo[3] & (1 << 26)) != 0;
+        const bool bOSXSave = (cpuInfo[2] & (1 << 27)) != 0;
+        const bool bAVX = (cpuInfo[2] & (1 << 28)) != 0;
+        if (bOSXSave && bAVX && (nMaxId >= 7)) {
+            //操作系统需要支持保存YMM寄存器
+            const unsigned long long xcr0 = _xgetbv(0);
+            if ((xcr0 & 0x6) == 0x6) {
+                __cpuidex(cpuInfo, 7, 0);
+                bAVX2 = (cpuInfo[1] & (1 << 5)) != 0;
+            }
+        }
+    }
+#else
+    __builtin_cpu_init();
+    bSSE2 = __builtin_cpu_supports("sse2") != 0;
+    bAVX2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif //DUILIB_PIXEL_X86
+
+#ifdef DUILIB_PIXEL_NEON
+
+/** NEON实现，每次处理16个像素
+*/
+namespace PixelNEON
+{
+    inline uint8x8_t Div255(uint16x8_t v)
+    {
+        v = vaddq_u16(vaddq_u16(v, vdupq_n_u16(1)), vshrq_n_u16(v, 8));
+        return vshrn_n_u16(v, 8);
+    }
+
+    inline uint8x16_t Premultiply(uint8x16_t c, uint8x16_t a)
+    {
+        uint16x8_t lo = vmull_u8(vget_low_u8(c), vget_low_u8(a));
+        uint16x8_t hi = vmull_u8(vget_high_u8(c), vget_high_u8(a));
+        return vcombine_u8(Div255(lo), Div255(hi));
+    }
+
+    void SwapRedBlue(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels)
+    {
+        size_t i = 0;
+        for (; i + 16 <= nPixels; i += 16) {
+            uint8x16x4_t x = vld4q_u8(pSrc + i * 4);
+            uint8x16_t t = x.val[0];
+            x.val[0] = x.val[2];
+            x.val[2] = t;
+            vst4q_u8(pDst + i * 4, x);
+        }
+        PixelScalar::SwapRedBlue(pSrc + i * 4, pDst + i * 4, nPixels - i);
+    }
+
+    void PremultiplyAlpha(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels, bool bSwapRedBlue)
+    {
+        size_t i = 0;
+        for (; i + 16 <= nPixels; i += 16) {
+            uint8x16x4_t x = vld4q_u8(pSrc + i * 4);
+            uint8x16_t c0 = Premultiply(x.val[0], x.val[3]);
+            uint8x16_t c2 = Premultiply(x.val[2], x.val[3]);
+            x.val[0] = bSwapRedBlue ? c2 : c0;
+            x.val[1] = Premultiply(x.val[1], x.val[3]);
+            x.val[2] = bSwapRedBlue ? c0 : c2;
+            vst4q_u8(pDst + i * 4, x);
+        }
+        PixelScalar::PremultiplyAlpha(pSrc + i * 4, pDst + i * 4, nPixels - i, bSwapRedBlue);
+    }
+
+    void SetAlphaOpaque(uint8_t* pPixels, size_t nPixels)
+    {
+        const uint32x4_t maskAlpha = vdupq_n_u32(0xFF000000);
+        size_t i = 0;
+        for (; i + 4 <= nPixels; i += 4) {
+            uint32x4_t x = vld1q_u32((const uint32_t*)(pPixels + i * 4));
+            vst1q_u32((uint32_t*)(pPixels + i * 4), vorrq_u32(x, maskAlpha));
+        }
+        PixelScalar::SetAlphaOpaque(pPixels + i * 4, nPixels - i);
+    }
+
+    void RestoreAlpha(uint8_t* pPixels, size_t nPixels, uint8_t alpha)
+    {
+        size_t i = 0;
+        for (; i + 16 <= nPixels; i += 16) {
+            uint8x16x4_t x = vld4q_u8(pPixels + i * 4);
+            uint8x16_t setOpaque = vceqq_u8(x.val[3], vdupq_n_u8(0));
+            if (alpha != 0) {
+                uint8x16_t setClear = vceqq_u8(x.val[3], vdupq_n_u8(alpha));
+                x.val[3] = vbicq_u8(x.val[3], setClear);
+            }
+            x.val[3] = vorrq_u8(x.val[3], setOpaque);
+            vst4q_u8(pPixels + i * 4, x);
+        }
+        PixelScalar::RestoreAlpha(pPixels + i * 4, nPixels - i, alpha);
+    }
+
+    const PixelKernels kKernels = {
+        PixelUtil::SimdLevel::kNEON,
+        SwapRedBlue, PremultiplyAlpha, SetAlphaOpaque, RestoreAlpha
+    };
+} // namespace PixelNEON
+
+#endif //DUILIB_PIXEL_NEON
+
+/** 根据CPU支持的指令集和允许的最高级别，选择处理函数表
+*/
+static const PixelKernels* SelectKernels(PixelUtil::SimdLevel maxLevel)
+{
+#if defined(DUILIB_PIXEL_X86)
+    struct CpuFeatures
+    {
+        CpuFeatures() { DetectCpuFeatures(bSSE2, bAVX2); }
+        bool bSSE2;
+        bool bAVX2;
+    };
+    static const CpuFeatures s_cpuFeatures;
+    if (s_cpuFeatures.bAVX2 && (maxLevel >= PixelUtil::SimdLevel::kAVX2)) {
+        return &PixelAVX2::kKernels;
+    }
+    if (s_cpuFeatures.bSSE2 && (maxLevel >= PixelUtil::SimdLevel::kSSE2)) {
+        return &PixelSSE2::kKernels;
+    }
+#elif defined(DUILIB_PIXEL_NEON)
+    if (maxLevel >= PixelUtil::SimdLevel::kNEON) {
+        return &PixelNEON::kKernels;
+    }
+#else
+    (void)maxLevel;
+#endif
+    return &PixelScalar::kKernels;
+}
+
+/** 当前使用的处理函数表
+*/
+static std::atomic<const PixelKernels*> s_pKernels(nullptr);
+
+static const PixelKernels* GetKernels()
+{
+    const PixelKernels* pKernels = s_pKernels.load(std::memory_order_acquire);
+    if (pKernels == nullptr) {
+        static const PixelKernels* s_pDefaultKernels = SelectKernels(PixelUtil::SimdLevel::kNEON);
+        pKernels = s_pDefaultKernels;
+        s_pKernels.store(pKernels, std::memory_order_release);
+    }
+    return pKernels;
+}
+
+PixelUtil::SimdLevel PixelUtil::GetSimdLevel()
+{
+    return GetKernels()->level;
+}
+
+void PixelUtil::SetMaxSimdLevel(SimdLevel maxLevel)
+{
+    GetKernels();
+    s_pKernels.store(SelectKernels(maxLevel), std::memory_order_release);
+}
+
+void PixelUtil::SwapRedBlue(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels)
+{
+    ASSERT((pSrc != nullptr) && (pDst != nullptr));
+    if ((pSrc == nullptr) || (pDst == nullptr) || (nPixels == 0)) {
+        return;
+    }
+    GetKernels()->swapRedBlue(pSrc, pDst, nPixels);
+}
+
+void PixelUtil::PremultiplyAlpha(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels, bool bSwapRedBlue)
+{
+    ASSERT((pSrc != nullptr) && (pDst != nullptr));
+    if ((pSrc == nullptr) || (pDst == nullptr) || (nPixels == 0)) {
+        return;
+    }
+    GetKernels()->premultiplyAlpha(pSrc, pDst, nPixels, bSwapRedBlue);
+}
+
+void PixelUtil::SetAlphaOpaque(uint8_t* pPixels, size_t nPixels)
+{
+    ASSERT(pPixels != nullptr);
+    if ((pPixels == nullptr) || (nPixels == 0)) {
+        return;
+    }
+    GetKernels()->setAlphaOpaque(pPixels, nPixels);
+}
+
+void PixelUtil::RestoreAlpha(uint8_t* pPixels, size_t nPixels, uint8_t alpha)
+{
+    ASSERT(pPixels != nullptr);
+    if ((pPixels == nullptr) || (nPixels == 0)) {
+        return;
+    }
+    GetKernels()->restoreAlpha(pPixels, nPixels, alpha);
+}
+
+} // namespace ui
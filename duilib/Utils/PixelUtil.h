@@ -0,0 +1,68 @@
+#ifndef UI_UTILS_PIXEL_UTIL_H_
+#define UI_UTILS_PIXEL_UTIL_H_
+
+#include "duilib/duilib_defs.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace ui
+{
+
+/** 位图像素数据的批量处理函数（每个像素固定占4个字节，第3个字节为Alpha值）
+*   内部根据CPU支持的指令集，在运行时选择SIMD实现（x86: SSE2/AVX2，ARM64: NEON），不支持时使用普通实现
+*/
+class UILIB_API PixelUtil
+{
+public:
+    /** SIMD指令集级别
+    */
+    enum class SimdLevel
+    {
+        kNone,  //不使用SIMD指令
+        kSSE2,  //SSE2指令集
+        kAVX2,  //AVX2指令集
+        kNEON   //NEON指令集
+    };
+
+    /** 获取当前使用的SIMD指令集级别
+    */
+    static SimdLevel GetSimdLevel();
+
+    /** 设置允许使用的最高SIMD指令集级别（用于对比测试各个实现的性能，正常情况下不需要调用）
+    *   如果CPU不支持该级别，则使用CPU支持的最高级别
+    */
+    static void SetMaxSimdLevel(SimdLevel maxLevel);
+
+    /** 交换每个像素的第0和第2个字节（RGBA与BGRA格式互相转换）
+    * @param [in] pSrc 源数据
+    * @param [out] pDst 目标数据，可以与源数据相同
+    * @param [in] nPixels 像素个数
+    */
+    static void SwapRedBlue(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels);
+
+    /** 对每个像素的颜色值进行Alpha预乘（颜色值 = 颜色值 * Alpha / 255，Alpha值不变）
+    * @param [in] pSrc 源数据
+    * @param [out] pDst 目标数据，可以与源数据相同
+    * @param [in] nPixels 像素个数
+    * @param [in] bSwapRedBlue 是否同时交换第0和第2个字节（RGBA与BGRA格式互相转换）
+    */
+    static void PremultiplyAlpha(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels, bool bSwapRedBlue);
+
+    /** 将每个像素的Alpha值设置为255
+    * @param [in,out] pPixels 像素数据
+    * @param [in] nPixels 像素个数
+    */
+    static void SetAlphaOpaque(uint8_t* pPixels, size_t nPixels);
+
+    /** 修正Alpha值：如果Alpha值等于alpha（alpha不为0），设置为0；如果Alpha值为0，设置为255
+    *   用于GDI绘制后丢失Alpha通道时的修正，参见BitmapAlpha::RestoreAlpha
+    * @param [in,out] pPixels 像素数据
+    * @param [in] nPixels 像素个数
+    * @param [in] alpha 绘制前设置的Alpha值
+    */
+    static void RestoreAlpha(uint8_t* pPixels, size_t nPixels, uint8_t alpha);
+};
+
+} // namespace ui
+
+#endif // UI_UTILS_PIXEL_UTIL_H_
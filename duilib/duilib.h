@@ -48,6 +48,7 @@
 #include "Core/UiSize.h"
 #include "Core/UiPoint.h"
 #include "Core/WindowBuilder.h"
+#include "Core/LayoutBinary.h"
 #include "Core/GlobalManager.h"
 #include "Core/Window.h"
 #include "Core/FrameworkThread.h"
@@ -75,6 +76,7 @@
 #include "Control/FilterCombo.h"
 #include "Control/CheckCombo.h"
 #include "Control/TreeView.h"
+#include "Control/VirtualTreeView.h"
 
 #include "Control/Label.h"
 #include "Control/Button.h"
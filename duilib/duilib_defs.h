@@ -91,6 +91,8 @@ namespace ui
 
     #define  DUI_CTR_TREENODE                        (_T("TreeNode"))
     #define  DUI_CTR_TREEVIEW                        (_T("TreeView"))
+    #define  DUI_CTR_VIRTUAL_TREENODE                (_T("VirtualTreeNode"))
+    #define  DUI_CTR_VIRTUAL_TREEVIEW                (_T("VirtualTreeView"))
 
     #define  DUI_CTR_RICHEDIT                        (_T("RichEdit"))
     #define  DUI_CTR_COMBO                           (_T("Combo"))
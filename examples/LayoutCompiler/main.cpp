@@ -0,0 +1,73 @@
+//布局文件编译工具：将XML布局文件编译为预编译的二进制布局文件（参见ui::LayoutBinary）
+//用法：LayoutCompiler <XML文件或者目录> [<XML文件或者目录> ...]
+//     如果参数为目录，编译该目录及其子目录中的所有XML文件；预编译文件与XML文件放在同一目录，文件名为XML文件名加".bin"后缀
+//     使用压缩包(resources.zip)时，需要在打包前运行本工具，将预编译文件一起打包
+
+#include "duilib/Core/LayoutBinary.h"
+#include <filesystem>
+#include <cstdio>
+
+/** 编译一个XML文件
+* @return 成功返回true，失败返回false
+*/
+static bool CompileLayoutFile(const std::filesystem::path& xmlPath)
+{
+    const ui::FilePath xmlFilePath(xmlPath.wstring());
+    if (!ui::LayoutBinary::CompileFile(xmlFilePath)) {
+        ::fwprintf(stderr, L"编译失败: %s\n", xmlPath.wstring().c_str());
+        return false;
+    }
+    ::fwprintf(stdout, L"已编译: %s\n", xmlPath.wstring().c_str());
+    return true;
+}
+
+/** 判断是否为XML文件（按扩展名，不区分大小写）
+*/
+static bool IsXmlFile(const std::filesystem::path& filePath)
+{
+    std::wstring ext = filePath.extension().wstring();
+    for (wchar_t& ch : ext) {
+        ch = (wchar_t)::towlower(ch);
+    }
+    return ext == L".xml";
+}
+
+int wmain(int argc, wchar_t* argv[])
+{
+    if (argc < 2) {
+        ::fwprintf(stderr, L"用法: LayoutCompiler <XML文件或者目录> [<XML文件或者目录> ...]\n");
+        return 1;
+    }
+    int nFailedCount = 0;
+    int nCompiledCount = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::error_code errorCode;
+        const std::filesystem::path inputPath(argv[i]);
+        if (std::filesystem::is_directory(inputPath, errorCode)) {
+            std::filesystem::recursive_directory_iterator iter(inputPath, errorCode);
+            for (; !errorCode && (iter != std::filesystem::recursive_directory_iterator()); iter.increment(errorCode)) {
+                if (!iter->is_regular_file(errorCode) || !IsXmlFile(iter->path())) {
+                    continue;
+                }
+                if (CompileLayoutFile(iter->path())) {
+                    ++nCompiledCount;
+                }
+                else {
+                    ++nFailedCount;
+                }
+            }
+            if (errorCode) {
+                ::fwprintf(stderr, L"读取目录失败: %s\n", inputPath.wstring().c_str());
+                ++nFailedCount;
+            }
+        }
+        else if (CompileLayoutFile(inputPath)) {
+            ++nCompiledCount;
+        }
+        else {
+            ++nFailedCount;
+        }
+    }
+    ::fwprintf(stdout, L"编译完成: 成功 %d 个, 失败 %d 个\n", nCompiledCount, nFailedCount);
+    return (nFailedCount == 0) ? 0 : 2;
+}
@@ -1,5 +1,6 @@
 #include "MainForm.h"
 #include "MainThread.h"
+#include <chrono>
 
 MainForm::MainForm()
 {
@@ -418,6 +419,15 @@ void MainForm::OnInitWindow()
             });
     }
 
+    //性能测试
+    ui::Button* pBenchmarkButton = dynamic_cast<ui::Button*>(FindControl(_T("btn_run_benchmark")));
+    if (pBenchmarkButton != nullptr) {
+        pBenchmarkButton->AttachClick([this](const ui::EventArgs&) {
+            RunListCtrlBenchmark();
+            return true;
+            });
+    }
+
     //控制表头或者行首是否显示CheckBox
     if ((pHeaderCtrl != nullptr) && pHeaderCtrl->IsVisible() && pHeaderCtrl->IsShowCheckBox()) {
         pHeaderCheckBox->Selected(true, false);
@@ -674,6 +684,60 @@ void MainForm::InsertItemData(int32_t nRows, int32_t nColumns, int32_t nImageId)
     UpdateWindow();
 }
 
+void MainForm::RunListCtrlBenchmark()
+{
+    ui::ListCtrl* pListCtrl = dynamic_cast<ui::ListCtrl*>(FindControl(_T("list_ctrl")));
+    ASSERT(pListCtrl != nullptr);
+    if (pListCtrl == nullptr) {
+        return;
+    }
+    const size_t nColumns = pListCtrl->GetColumnCount();
+    if (nColumns == 0) {
+        return;
+    }
+    typedef std::chrono::steady_clock Clock;
+    auto ToMs = [](Clock::duration duration) {
+        return (double)std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
+        };
+
+    //填充数据：每个单元格一段文本
+    const size_t nRows = 100000;
+    const Clock::time_point fillStart = Clock::now();
+    pListCtrl->SetDataItemCount(nRows);
+    for (size_t itemIndex = 0; itemIndex < nRows; ++itemIndex) {
+        for (size_t columnIndex = 0; columnIndex < nColumns; ++columnIndex) {
+            pListCtrl->SetSubItemText(itemIndex, columnIndex,
+                                      ui::StringUtil::Printf(_T("第 %06d 行/第 %02d 列"), (int32_t)itemIndex, (int32_t)columnIndex));
+        }
+    }
+    const double fFillMs = ToMs(Clock::now() - fillStart);
+
+    //内存占用
+    const size_t nMemorySize = pListCtrl->GetDataMemorySize();
+    const double fBytesPerCell = (double)nMemorySize / (double)(nRows * nColumns);
+
+    //滚动：每次滚动一页，从头到尾，每次都立即重绘
+    const size_t nPageRows = 30;
+    const size_t nScrollSteps = 200;
+    const size_t nStepRows = nRows / nScrollSteps;
+    const Clock::time_point scrollStart = Clock::now();
+    for (size_t nStep = 0; nStep < nScrollSteps; ++nStep) {
+        pListCtrl->EnsureDataItemVisible(nStep * nStepRows + nPageRows, true);
+        UpdateWindow();
+    }
+    const double fScrollMs = ToMs(Clock::now() - scrollStart);
+    pListCtrl->EnsureDataItemVisible(0, true);
+
+    const DString result = ui::StringUtil::Printf(_T("%d 行 x %d 列：填充 %.1f ms，内存 %.1f MB（%.1f 字节/单元格），滚动 %d 次平均 %.2f ms"),
+                                                  (int32_t)nRows, (int32_t)nColumns, fFillMs,
+                                                  (double)nMemorySize / (1024.0 * 1024.0), fBytesPerCell,
+                                                  (int32_t)nScrollSteps, fScrollMs / nScrollSteps);
+    ui::Label* pResultLabel = dynamic_cast<ui::Label*>(FindControl(_T("benchmark_result")));
+    if (pResultLabel != nullptr) {
+        pResultLabel->SetText(result);
+    }
+}
+
 void MainForm::RunListCtrlTest()
 {
     ui::ListCtrl* pListCtrl = dynamic_cast<ui::ListCtrl*>(FindControl(_T("list_ctrl")));
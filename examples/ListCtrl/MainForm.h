@@ -33,6 +33,10 @@ private:
     */
     void RunListCtrlTest();
 
+    /** 性能测试：填充大量数据，统计数据存储的内存占用和滚动的耗时
+    */
+    void RunListCtrlBenchmark();
+
     /** 控制该列
     */
     void OnColumnChanged(size_t nColumnId);
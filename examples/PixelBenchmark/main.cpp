@@ -0,0 +1,209 @@
+//像素处理函数的性能测试：对比ui::PixelUtil中各个SIMD实现与原来的逐像素代码（图片解码、分层窗口绘制中使用的循环）
+//用法：PixelBenchmark [像素个数] [重复次数]
+//     默认为1920x1080个像素，每个测试重复100次；同时检查各个实现的结果与原来的代码是否完全一致
+
+#include "duilib/Utils/PixelUtil.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+/** 原来的逐像素代码（作为对比的基准）
+*/
+namespace ScalarReference
+{
+    //SVG解码后的格式转换：RGBA -> BGRA
+    static void SwapRedBlue(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels)
+    {
+        for (size_t i = 0; i < nPixels; ++i) {
+            const uint8_t r = pSrc[0];
+            pDst[1] = pSrc[1];
+            pDst[3] = pSrc[3];
+            pDst[0] = pSrc[2];
+            pDst[2] = r;
+            pSrc += 4;
+            pDst += 4;
+        }
+    }
+
+    //APNG解码后的格式转换和Alpha预乘：RGBA -> BGRA(预乘)
+    static void PremultiplyAlphaSwap(const uint8_t* pSrc, uint8_t* pDst, size_t nPixels)
+    {
+        for (size_t i = 0; i < nPixels; ++i) {
+            const uint8_t a = pSrc[3];
+            const uint8_t t = pSrc[0];
+            if (a) {
+                pDst[0] = (uint8_t)((pSrc[2] * a) / 255);
+                pDst[1] = (uint8_t)((pSrc[1] * a) / 255);
+                pDst[2] = (uint8_t)((t * a) / 255);
+                pDst[3] = a;
+            }
+            else {
+                memset(pDst, 0, 4);
+            }
+            pSrc += 4;
+            pDst += 4;
+        }
+    }
+
+    //BitmapAlpha::ClearAlpha(alpha为255时)
+    static void SetAlphaOpaque(uint8_t* pPixels, size_t nPixels)
+    {
+        for (size_t i = 0; i < nPixels; ++i) {
+            uint8_t* a = pPixels + i * 4 + 3;
+            if (*a != 255) {
+                *a = 255;
+            }
+        }
+    }
+
+    //BitmapAlpha::RestoreAlpha
+    static void RestoreAlpha(uint8_t* pPixels, size_t nPixels, uint8_t alpha)
+    {
+        for (size_t i = 0; i < nPixels; ++i) {
+            uint8_t* a = pPixels + i * 4 + 3;
+            if (alpha != 0 && *a == alpha) {
+                *a = 0;
+            }
+            else if (*a == 0) {
+                *a = 255;
+            }
+        }
+    }
+}
+
+/** 获取SIMD指令集级别的名称
+*/
+static const char* GetSimdLevelName(ui::PixelUtil::SimdLevel level)
+{
+    switch (level) {
+    case ui::PixelUtil::SimdLevel::kSSE2:
+        return "SSE2";
+    case ui::PixelUtil::SimdLevel::kAVX2:
+        return "AVX2";
+    case ui::PixelUtil::SimdLevel::kNEON:
+        return "NEON";
+    default:
+        return "Scalar";
+    }
+}
+
+/** 运行一个测试：每次运行前将源数据复制到目标缓冲区（复制不计入耗时），返回平均每次的耗时（毫秒）
+*/
+static double RunTest(const std::vector<uint8_t>& srcData, std::vector<uint8_t>& dstData, int nRepeat,
+                      const std::function<void(const uint8_t*, uint8_t*)>& testFunc)
+{
+    std::chrono::steady_clock::duration totalTime(0);
+    for (int i = 0; i < nRepeat; ++i) {
+        dstData = srcData;
+        const auto startTime = std::chrono::steady_clock::now();
+        testFunc(srcData.data(), dstData.data());
+        totalTime += std::chrono::steady_clock::now() - startTime;
+    }
+    return (double)std::chrono::duration_cast<std::chrono::microseconds>(totalTime).count() / 1000.0 / nRepeat;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t nPixels = 1920 * 1080;
+    int nRepeat = 100;
+    if (argc > 1) {
+        nPixels = (size_t)::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        nRepeat = ::atoi(argv[2]);
+    }
+    if ((nPixels == 0) || (nRepeat <= 0)) {
+        ::fprintf(stderr, "用法: PixelBenchmark [像素个数] [重复次数]\n");
+        return 1;
+    }
+
+    //测试数据：随机的颜色值，Alpha值包含0、255、清除时设置的值等特殊情况
+    const uint8_t kClearAlpha = 1;
+    std::vector<uint8_t> srcData(nPixels * 4);
+    ::srand(12345);
+    for (size_t i = 0; i < srcData.size(); ++i) {
+        srcData[i] = (uint8_t)(::rand() & 0xFF);
+    }
+    for (size_t i = 0; i < nPixels; i += 7) {
+        static const uint8_t kSpecialAlpha[] = { 0, 255, kClearAlpha };
+        srcData[i * 4 + 3] = kSpecialAlpha[(i / 7) % 3];
+    }
+
+    struct TestCase
+    {
+        const char* name;
+        std::function<void(const uint8_t*, uint8_t*)> refFunc;
+        std::function<void(const uint8_t*, uint8_t*)> testFunc;
+    };
+    const size_t nCount = nPixels;
+    std::vector<TestCase> testCases = {
+        { "SwapRedBlue",
+          [nCount](const uint8_t* pSrc, uint8_t* pDst) { ScalarReference::SwapRedBlue(pSrc, pDst, nCount); },
+          [nCount](const uint8_t* pSrc, uint8_t* pDst) { ui::PixelUtil::SwapRedBlue(pSrc, pDst, nCount); } },
+        { "PremultiplyAlpha",
+          [nCount](const uint8_t* pSrc, uint8_t* pDst) { ScalarReference::PremultiplyAlphaSwap(pSrc, pDst, nCount); },
+          [nCount](const uint8_t* pSrc, uint8_t* pDst) { ui::PixelUtil::PremultiplyAlpha(pSrc, pDst, nCount, true); } },
+        { "SetAlphaOpaque",
+          [nCount](const uint8_t*, uint8_t* pDst) { ScalarReference::SetAlphaOpaque(pDst, nCount); },
+          [nCount](const uint8_t*, uint8_t* pDst) { ui::PixelUtil::SetAlphaOpaque(pDst, nCount); } },
+        { "RestoreAlpha",
+          [nCount, kClearAlpha](const uint8_t*, uint8_t* pDst) { ScalarReference::RestoreAlpha(pDst, nCount, kClearAlpha); },
+          [nCount, kClearAlpha](const uint8_t*, uint8_t* pDst) { ui::PixelUtil::RestoreAlpha(pDst, nCount, kClearAlpha); } },
+    };
+
+    //依次测试CPU支持的各个指令集级别（相同的级别只测试一次）
+    const ui::PixelUtil::SimdLevel allLevels[] = {
+        ui::PixelUtil::SimdLevel::kNone,
+        ui::PixelUtil::SimdLevel::kSSE2,
+        ui::PixelUtil::SimdLevel::kAVX2,
+        ui::PixelUtil::SimdLevel::kNEON
+    };
+    std::vector<ui::PixelUtil::SimdLevel> levels;
+    for (ui::PixelUtil::SimdLevel level : allLevels) {
+        ui::PixelUtil::SetMaxSimdLevel(level);
+        const ui::PixelUtil::SimdLevel actualLevel = ui::PixelUtil::GetSimdLevel();
+        bool bFound = false;
+        for (ui::PixelUtil::SimdLevel existLevel : levels) {
+            if (existLevel == actualLevel) {
+                bFound = true;
+            }
+        }
+        if (!bFound) {
+            levels.push_back(actualLevel);
+        }
+    }
+
+    ::printf("像素个数: %zu, 重复次数: %d, 单位: 毫秒/次\n", nPixels, nRepeat);
+    ::printf("%-18s %10s", "函数", "原来的代码");
+    for (ui::PixelUtil::SimdLevel level : levels) {
+        ::printf(" %10s", GetSimdLevelName(level));
+    }
+    ::printf("\n");
+
+    bool bAllMatched = true;
+    std::vector<uint8_t> refData;
+    std::vector<uint8_t> dstData;
+    for (const TestCase& testCase : testCases) {
+        const double fRefTime = RunTest(srcData, refData, nRepeat, testCase.refFunc);
+        ::printf("%-18s %10.3f", testCase.name, fRefTime);
+        for (ui::PixelUtil::SimdLevel level : levels) {
+            ui::PixelUtil::SetMaxSimdLevel(level);
+            const double fTime = RunTest(srcData, dstData, nRepeat, testCase.testFunc);
+            const bool bMatched = (dstData == refData);
+            bAllMatched = bAllMatched && bMatched;
+            ::printf(" %9.3f%s", fTime, bMatched ? " " : "!");
+        }
+        ::printf("\n");
+    }
+    //恢复为CPU支持的最高级别
+    ui::PixelUtil::SetMaxSimdLevel(ui::PixelUtil::SimdLevel::kNEON);
+    if (!bAllMatched) {
+        ::printf("结果与原来的代码不一致（标记为\"!\"）\n");
+        return 2;
+    }
+    ::printf("所有实现的结果与原来的代码一致\n");
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "MainForm.h"
+
+MainForm::MainForm():
+    m_pTree(nullptr),
+    m_pStatus(nullptr)
+{
+}
+
+MainForm::~MainForm()
+{
+}
+
+DString MainForm::GetSkinFolder()
+{
+    return _T("virtual_tree_view");
+}
+
+DString MainForm::GetSkinFile()
+{
+    return _T("virtual_tree_view.xml");
+}
+
+void MainForm::OnInitWindow()
+{
+    m_pTree = dynamic_cast<ui::VirtualTreeView*>(FindControl(_T("tree")));
+    ASSERT(m_pTree != nullptr);
+    m_pStatus = dynamic_cast<ui::Label*>(FindControl(_T("status")));
+    ASSERT(m_pStatus != nullptr);
+    if (m_pTree == nullptr) {
+        return;
+    }
+    m_pTree->SetTreeDataProvider(&m_treeData);
+
+    //展开、收起和选择节点时，更新状态栏
+    auto updateStatus = [this](const ui::EventArgs&) {
+            UpdateStatus();
+            return true;
+        };
+    m_pTree->AttachExpand(updateStatus);
+    m_pTree->AttachCollapse(updateStatus);
+    m_pTree->AttachSelect(updateStatus);
+
+    GetRoot()->AttachBubbledEvent(ui::kEventClick, UiBind(&MainForm::OnClicked, this, std::placeholders::_1));
+    UpdateStatus();
+}
+
+bool MainForm::OnClicked(const ui::EventArgs& args)
+{
+    if (m_pTree == nullptr) {
+        return true;
+    }
+    DString sName = args.GetSender()->GetName();
+    if (sName == _T("btn_expand")) {
+        ExpandSelectedNodes(true);
+    }
+    else if (sName == _T("btn_collapse")) {
+        ExpandSelectedNodes(false);
+    }
+    else if (sName == _T("btn_collapse_all")) {
+        m_pTree->CollapseAll();
+        UpdateStatus();
+    }
+    else if (sName == _T("btn_reload")) {
+        m_pTree->ReloadNodes();
+        UpdateStatus();
+    }
+    return true;
+}
+
+void MainForm::ExpandSelectedNodes(bool bExpand)
+{
+    //展开或者收起节点后，其后的元素索引号会变化，所以先记录节点ID
+    std::vector<size_t> selectedIndexs;
+    m_pTree->GetSelectedElements(selectedIndexs);
+    std::vector<size_t> nodeIds;
+    for (size_t nElementIndex : selectedIndexs) {
+        size_t nNodeId = m_pTree->GetElementNodeId(nElementIndex);
+        if (nNodeId != ui::Box::InvalidIndex) {
+            nodeIds.push_back(nNodeId);
+        }
+    }
+    for (size_t nNodeId : nodeIds) {
+        m_pTree->SetNodeExpand(nNodeId, bExpand);
+    }
+    if (!nodeIds.empty()) {
+        //保证第一个选择的节点可见
+        size_t nElementIndex = m_pTree->GetNodeElementIndex(nodeIds.front());
+        if (nElementIndex != ui::Box::InvalidIndex) {
+            m_pTree->EnsureVisible(nElementIndex, false);
+        }
+    }
+    UpdateStatus();
+}
+
+void MainForm::UpdateStatus()
+{
+    if ((m_pTree == nullptr) || (m_pStatus == nullptr)) {
+        return;
+    }
+    std::vector<size_t> selectedIndexs;
+    m_pTree->GetSelectedElements(selectedIndexs);
+    DString selectedText;
+    if (selectedIndexs.empty()) {
+        selectedText = _T("无");
+    }
+    else {
+        selectedText = m_treeData.GetNodeName(m_pTree->GetElementNodeId(selectedIndexs.front()));
+        if (selectedIndexs.size() > 1) {
+            selectedText += ui::StringUtil::Printf(_T(" 等%d个节点"), (int)selectedIndexs.size());
+        }
+    }
+    DString statusText = ui::StringUtil::Printf(_T("选择的节点：%s    已展开的节点：%d个    可见行数：%d"),
+                                                selectedText.c_str(),
+                                                (int)m_treeData.GetExpandCount(),
+                                                (int)m_pTree->GetElementCount());
+    m_pStatus->SetText(statusText);
+}
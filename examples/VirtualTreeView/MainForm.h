@@ -0,0 +1,58 @@
+#ifndef EXAMPLES_MAIN_FORM_H_
+#define EXAMPLES_MAIN_FORM_H_
+
+#include "resource.h"
+
+// duilib
+#include "duilib/duilib.h"
+
+#include "TreeDataProvider.h"
+
+class MainForm : public ui::WindowImplBase
+{
+public:
+    MainForm();
+    virtual ~MainForm() override;
+
+    /**
+     * 一下三个接口是必须要覆写的接口，父类会调用这三个接口来构建窗口
+     * GetSkinFolder        接口设置你要绘制的窗口皮肤资源路径
+     * GetSkinFile            接口设置你要绘制的窗口的 xml 描述文件
+     */
+    virtual DString GetSkinFolder() override;
+    virtual DString GetSkinFile() override;
+
+    /** 当窗口创建完成以后调用此函数，供子类中做一些初始化的工作
+    */
+    virtual void OnInitWindow() override;
+
+private:
+    /** 按钮点击事件
+     * @param[in] args 消息体
+     * @return 始终返回 true
+     */
+    bool OnClicked(const ui::EventArgs& args);
+
+    /** 展开或者收起所有选择的节点
+    */
+    void ExpandSelectedNodes(bool bExpand);
+
+    /** 更新状态栏：选择的节点、已展开的节点个数、可见行数
+    */
+    void UpdateStatus();
+
+private:
+    /** 树的数据接口
+    */
+    TreeDataProvider m_treeData;
+
+    /** 树控件
+    */
+    ui::VirtualTreeView* m_pTree;
+
+    /** 状态栏
+    */
+    ui::Label* m_pStatus;
+};
+
+#endif //EXAMPLES_MAIN_FORM_H_
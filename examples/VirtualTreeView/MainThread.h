@@ -0,0 +1,27 @@
+#ifndef EXAMPLES_MAIN_THREAD_H_
+#define EXAMPLES_MAIN_THREAD_H_
+
+#include "resource.h"
+
+// duilib
+#include "duilib/duilib.h"
+
+/** 主线程
+*/
+class MainThread : public ui::FrameworkThread
+{
+public:
+    MainThread();
+    virtual ~MainThread() override;
+
+private:
+    /** 运行前初始化，在进入消息循环前调用
+    */
+    virtual void OnInit() override;
+
+    /** 退出时清理，在退出消息循环后调用
+    */
+    virtual void OnCleanup() override;
+};
+
+#endif //EXAMPLES_MAIN_THREAD_H_
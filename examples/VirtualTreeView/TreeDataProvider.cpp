@@ -0,0 +1,109 @@
+#include "TreeDataProvider.h"
+
+const size_t TreeDataProvider::kChildCounts[TreeDataProvider::kLevelCount] = { 100, 1000, 100 };
+
+TreeDataProvider::TreeDataProvider():
+    m_nExpandCount(0)
+{
+    size_t nLevelNodeCount = 1;
+    m_levelStartIds[0] = 0;
+    for (size_t nLevel = 0; nLevel < kLevelCount; ++nLevel) {
+        nLevelNodeCount *= kChildCounts[nLevel];
+        m_levelStartIds[nLevel + 1] = m_levelStartIds[nLevel] + nLevelNodeCount;
+    }
+}
+
+size_t TreeDataProvider::GetNodeLevel(size_t nNodeId) const
+{
+    for (size_t nLevel = 0; nLevel < kLevelCount; ++nLevel) {
+        if (nNodeId < m_levelStartIds[nLevel + 1]) {
+            return nLevel;
+        }
+    }
+    return kLevelCount;
+}
+
+size_t TreeDataProvider::GetChildNodeCount(size_t nParentId)
+{
+    if (nParentId == RootNodeId) {
+        return kChildCounts[0];
+    }
+    const size_t nLevel = GetNodeLevel(nParentId);
+    if ((nLevel + 1) < kLevelCount) {
+        return kChildCounts[nLevel + 1];
+    }
+    return 0;
+}
+
+size_t TreeDataProvider::GetChildNodeId(size_t nParentId, size_t nChildIndex)
+{
+    if (nParentId == RootNodeId) {
+        ASSERT(nChildIndex < kChildCounts[0]);
+        return nChildIndex;
+    }
+    const size_t nLevel = GetNodeLevel(nParentId);
+    ASSERT((nLevel + 1) < kLevelCount);
+    if ((nLevel + 1) >= kLevelCount) {
+        return ui::Box::InvalidIndex;
+    }
+    ASSERT(nChildIndex < kChildCounts[nLevel + 1]);
+    const size_t nParentIndex = nParentId - m_levelStartIds[nLevel];
+    return m_levelStartIds[nLevel + 1] + nParentIndex * kChildCounts[nLevel + 1] + nChildIndex;
+}
+
+bool TreeDataProvider::HasChildNodes(size_t nNodeId)
+{
+    //子节点个数可以直接计算，无需加载数据
+    return GetChildNodeCount(nNodeId) > 0;
+}
+
+ui::VirtualTreeNode* TreeDataProvider::CreateNodeElement(ui::VirtualTreeView* pTreeView)
+{
+    ui::VirtualTreeNode* pTreeNode = __super::CreateNodeElement(pTreeView);
+    if (pTreeNode != nullptr) {
+        pTreeNode->SetClass(_T("tree_node"));
+    }
+    return pTreeNode;
+}
+
+bool TreeDataProvider::FillNodeElement(ui::VirtualTreeNode* pTreeNode, size_t nNodeId)
+{
+    if (pTreeNode == nullptr) {
+        return false;
+    }
+    pTreeNode->SetText(GetNodeName(nNodeId));
+    return true;
+}
+
+void TreeDataProvider::OnNodeExpand(size_t /*nNodeId*/, bool bExpand)
+{
+    //实际应用中，可在节点展开前加载子节点的数据，收起后释放子节点的数据
+    if (bExpand) {
+        ++m_nExpandCount;
+    }
+    else if (m_nExpandCount > 0) {
+        --m_nExpandCount;
+    }
+}
+
+DString TreeDataProvider::GetNodeName(size_t nNodeId) const
+{
+    //由节点ID逐层换算出各层的子节点索引号
+    size_t nLevel = GetNodeLevel(nNodeId);
+    if (nLevel >= kLevelCount) {
+        return DString();
+    }
+    DString path;
+    size_t nLevelIndex = nNodeId - m_levelStartIds[nLevel];
+    while (true) {
+        const size_t nChildIndex = nLevelIndex % kChildCounts[nLevel];
+        DString item = ui::StringUtil::UInt64ToString(nChildIndex + 1);
+        path = path.empty() ? item : (item + _T("-") + path);
+        if (nLevel == 0) {
+            break;
+        }
+        nLevelIndex /= kChildCounts[nLevel];
+        --nLevel;
+    }
+    return _T("节点 ") + path;
+}
@@ -0,0 +1,56 @@
+#ifndef EXAMPLES_TREE_DATA_PROVIDER_H_
+#define EXAMPLES_TREE_DATA_PROVIDER_H_
+
+// duilib
+#include "duilib/duilib.h"
+
+/** 虚表树的数据接口：按层级生成的测试数据（共约一千万个节点），不保存任何节点数据
+*   节点ID按层级连续编号：第一层节点从0开始，每层节点的ID紧接在上一层之后，
+*   同一父节点的子节点ID是连续的，因此节点ID、父节点和层级之间可以直接换算
+*/
+class TreeDataProvider : public ui::VirtualTreeDataProvider
+{
+public:
+    TreeDataProvider();
+
+    /// 重写父类接口，提供个性化功能，请参考父类声明
+    virtual size_t GetChildNodeCount(size_t nParentId) override;
+    virtual size_t GetChildNodeId(size_t nParentId, size_t nChildIndex) override;
+    virtual bool HasChildNodes(size_t nNodeId) override;
+    virtual ui::VirtualTreeNode* CreateNodeElement(ui::VirtualTreeView* pTreeView) override;
+    virtual bool FillNodeElement(ui::VirtualTreeNode* pTreeNode, size_t nNodeId) override;
+    virtual void OnNodeExpand(size_t nNodeId, bool bExpand) override;
+
+public:
+    /** 获取节点的显示名称，比如"节点 3-25-7"
+    */
+    DString GetNodeName(size_t nNodeId) const;
+
+    /** 获取已展开的节点个数
+    */
+    size_t GetExpandCount() const { return m_nExpandCount; }
+
+private:
+    /** 获取节点所在的层级（从0开始），如果节点ID无效返回kLevelCount
+    */
+    size_t GetNodeLevel(size_t nNodeId) const;
+
+private:
+    /** 层级数
+    */
+    static constexpr size_t kLevelCount = 3;
+
+    /** 每层节点的子节点个数：kChildCounts[0]为第一层节点个数
+    */
+    static const size_t kChildCounts[kLevelCount];
+
+    /** 每层第一个节点的ID（最后一个元素为节点总数）
+    */
+    size_t m_levelStartIds[kLevelCount + 1];
+
+    /** 已展开的节点个数（由OnNodeExpand统计）
+    */
+    size_t m_nExpandCount;
+};
+
+#endif //EXAMPLES_TREE_DATA_PROVIDER_H_
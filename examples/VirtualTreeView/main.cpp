@@ -0,0 +1,21 @@
+// main.cpp : Defines the entry point for the application.
+//
+
+#include "MainThread.h"
+
+int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
+    _In_opt_ HINSTANCE hPrevInstance,
+    _In_ LPWSTR    lpCmdLine,
+    _In_ int       nCmdShow)
+{
+    UNREFERENCED_PARAMETER(hPrevInstance);
+    UNREFERENCED_PARAMETER(lpCmdLine);
+
+    // 创建主线程
+    MainThread thread;
+
+    // 执行主线程循环
+    thread.RunOnCurrentThreadWithLoop();
+
+    return 0;
+}